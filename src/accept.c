@@ -16,6 +16,7 @@
 #include <string.h>
 #include <signal.h>
 #include <time.h>
+#include <math.h>
 #include <stdlib.h>
 #include <unistd.h>
 #include <fcntl.h>
@@ -295,9 +296,13 @@ static int open_listener(struct listen_config_t *lc)
 	l->name   = hstrdup(lc->name);
 	l->portnum = lc->portnum;
 	l->ai_protocol = lc->ai->ai_protocol;
-	l->listener_id = keyhash(l->addr_s, strlen(l->addr_s), 0);
-	l->listener_id = keyhash(&lc->ai->ai_socktype, sizeof(lc->ai->ai_socktype), l->listener_id);
-	l->listener_id = keyhash(&lc->ai->ai_protocol, sizeof(lc->ai->ai_protocol), l->listener_id);
+	/* the listener id is passed on in a live upgrade, possibly to a
+	 * different version, so it is hashed with the FNV-1a which stays
+	 * the same
+	 */
+	l->listener_id = keyhash_fnv(l->addr_s, strlen(l->addr_s), 0);
+	l->listener_id = keyhash_fnv(&lc->ai->ai_socktype, sizeof(lc->ai->ai_socktype), l->listener_id);
+	l->listener_id = keyhash_fnv(&lc->ai->ai_protocol, sizeof(lc->ai->ai_protocol), l->listener_id);
 	hlog(LOG_DEBUG, "Opening listener %d/%d '%s': %s", lc->id, l->listener_id, lc->name, l->addr_s);
 	
 	if (lc->ai->ai_socktype == SOCK_DGRAM &&
@@ -1308,6 +1313,8 @@ static int accept_liveupgrade_single(cJSON *client, int *rxerr_map, int rxerr_ma
 		c->loc_known = 1;
 		c->lat = lat->valuedouble;
 		c->lng = lng->valuedouble;
+		c->cos_lat = cosf(c->lat);
+		range_point_set(&c->loc_pt, c->lat, c->lng, c->cos_lat);
 	}
 	
 	hlog(LOG_DEBUG, "%s - Accepted live upgrade client on fd %d from %s", c->addr_loc, c->fd, c->addr_rem);
@@ -1496,8 +1503,11 @@ void accept_thread(void *asdf)
 			/* stop the dupechecking and uplink threads while adjusting
 			 * the amount of workers... they walk the worker list, and
 			 * might get confused when workers are stopped or started.
+			 * The dupecheck database is split in a new number of
+			 * shards when the dupecheck is started again.
 			 */
-			if (workers_running != workers_configured) {
+			if (workers_running != workers_configured
+			    || dupecheck_shards_running != dupecheck_shards_configured) {
 				uplink_stop();
 				dupecheck_stop();
 				workers_start();
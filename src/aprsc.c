@@ -51,6 +51,7 @@
 #include "historydb.h"
 #include "client_heard.h"
 #include "keyhash.h"
+#include "cellmalloc.h"
 
 #ifdef USE_POSIX_CAP
 #include <sys/capability.h>
@@ -1072,6 +1073,9 @@ int main(int argc, char **argv)
 	signal(SIGURG, SIG_IGN);
 	
 	/* Early inits in single-thread mode */
+#ifndef _FOR_VALGRIND_
+	cellhugepages(huge_pages);
+#endif
 	keyhash_init();
 	filter_init();
 	pbuf_init();
@@ -1131,6 +1135,7 @@ int main(int argc, char **argv)
 				hlog(LOG_INFO, "New configuration read successfully. Applying....");
 				accept_reconfiguring = 1;
 				http_reconfiguring = 1;
+				pbuf_classes_adapt(1);
 			}
 		}
 		
@@ -1141,8 +1146,14 @@ int main(int argc, char **argv)
 			historydb_cleanup();
 			filter_wx_cleanup();
 			filter_entrycall_cleanup();
+			pbuf_classes_adapt(0);
 		}
 		
+#ifndef _FOR_VALGRIND_
+		/* give the memory left over from a traffic spike back to the system */
+		celltrim_all(tick, memory_release_delay);
+#endif
+		
 		if (version_tick < tick || version_tick > tick + 86500) {
 			version_tick = tick + 86400;
 			version_report("run");
@@ -0,0 +1,361 @@
+/*
+ *	aprsc
+ *
+ *	(c) Heikki Hannikainen, OH7LZB <hessu@hes.iki.fi>
+ *
+ *     This program is licensed under the BSD license, which can be found
+ *     in the file LICENSE.
+ *
+ */
+
+/*
+ *	callindex.c: a per-worker inverted index of the callsign set filters
+ *	(p/ b/ o/ e/ u/ d/ g/) of the worker's clients.
+ *
+ *	Clients in the geoindex may also have callsign set filters. Their
+ *	callsigns, and the prefixes of the wildcard and p/ filters, are
+ *	hashed together with the packet field they are matched against.
+ *	For a packet, callindex_lookup() hashes the packet's callsigns and
+ *	all of their prefixes having entries in the index, and returns the
+ *	entries found. The clients in those entries, and the clients in the
+ *	geoindex cell of the packet, are the only indexed clients which
+ *	may match it; filter_process() still makes the decision.
+ *
+ *	Like the geoindex, the index is only modified by the worker which
+ *	owns it. Entries left without clients are not freed right away, since
+ *	client_close() may be called from the outgoing loop while it walks
+ *	the entries - the worker calls callindex_gc() outside of it.
+ */
+
+#include <string.h>
+#include <strings.h>
+#include <stdlib.h>
+#include <ctype.h>
+
+#include "callindex.h"
+#include "filter.h"
+#include "keyhash.h"
+#include "hmalloc.h"
+#include "hlog.h"
+
+#define CALLINDEX_HASH_INITIAL	256
+
+/* seed the hash with the packet field, so that the same callsign
+ * in different fields goes to different entries
+ */
+#define CALLINDEX_SEED(cls)	((uint32_t)(cls) + 1)
+
+struct callindex_t *callindex_alloc(void)
+{
+	struct callindex_t *ci;
+
+	ci = hmalloc(sizeof(*ci));
+	memset(ci, 0, sizeof(*ci));
+
+	ci->hash_size = CALLINDEX_HASH_INITIAL;
+	ci->hash = hmalloc(sizeof(*ci->hash) * ci->hash_size);
+	memset(ci->hash, 0, sizeof(*ci->hash) * ci->hash_size);
+
+	return ci;
+}
+
+static void callindex_entry_free(struct callindex_t *ci, struct callindex_entry_t *e)
+{
+	if (e->prefix)
+		ci->prefix_entries[(int)e->cls][(int)e->len]--;
+	ci->entries--;
+
+	if (e->clients)
+		hfree(e->clients);
+	hfree(e);
+}
+
+void callindex_free(struct callindex_t *ci)
+{
+	struct callindex_entry_t *e, *next;
+	int i;
+
+	if (!ci)
+		return;
+
+	for (i = 0; i < ci->hash_size; i++) {
+		for (e = ci->hash[i]; (e); e = next) {
+			next = e->next;
+			callindex_entry_free(ci, e);
+		}
+	}
+
+	hfree(ci->hash);
+	hfree(ci);
+}
+
+/*
+ *	Hashing, one character at a time, so that the lookup can
+ *	check every prefix of a key while hashing it. This needs the
+ *	FNV-1a, which gives the same hash a byte at a time.
+ */
+
+static inline uint32_t callindex_hash_step(uint32_t hash, char c)
+{
+	return keyhashuc_fnv(&c, 1, hash);
+}
+
+static uint32_t callindex_hash(int cls, const char *call, int len)
+{
+	return keyhashuc_fnv(call, len, CALLINDEX_SEED(cls));
+}
+
+static struct callindex_entry_t *callindex_find(struct callindex_t *ci, uint32_t hash, int cls, int prefix, const char *call, int len)
+{
+	struct callindex_entry_t *e;
+
+	for (e = ci->hash[hash & (ci->hash_size - 1)]; (e); e = e->next) {
+		if (e->hash == hash && e->cls == cls && e->prefix == prefix
+		    && e->len == len && strncasecmp(e->call, call, len) == 0)
+			return e;
+	}
+
+	return NULL;
+}
+
+/*
+ *	Double the size of the hash table, when there are more entries
+ *	than buckets
+ */
+
+static void callindex_grow(struct callindex_t *ci)
+{
+	struct callindex_entry_t **hash, *e, *next;
+	int i, size = ci->hash_size * 2;
+
+	hash = hmalloc(sizeof(*hash) * size);
+	memset(hash, 0, sizeof(*hash) * size);
+
+	for (i = 0; i < ci->hash_size; i++) {
+		for (e = ci->hash[i]; (e); e = next) {
+			next = e->next;
+			e->next = hash[e->hash & (size - 1)];
+			hash[e->hash & (size - 1)] = e;
+		}
+	}
+
+	hfree(ci->hash);
+	ci->hash = hash;
+	ci->hash_size = size;
+}
+
+static struct callindex_entry_t *callindex_get(struct callindex_t *ci, const struct callindex_key_t *k)
+{
+	struct callindex_entry_t *e;
+	uint32_t hash;
+	int i;
+
+	hash = callindex_hash(k->cls, k->call, k->len);
+	e = callindex_find(ci, hash, k->cls, k->prefix, k->call, k->len);
+	if (e)
+		return e;
+
+	if (ci->entries >= ci->hash_size)
+		callindex_grow(ci);
+
+	e = hmalloc(sizeof(*e));
+	memset(e, 0, sizeof(*e));
+	e->hash = hash;
+	e->cls = k->cls;
+	e->prefix = k->prefix;
+	e->len = k->len;
+	for (i = 0; i < k->len; i++)
+		e->call[i] = toupper(k->call[i]);
+
+	e->next = ci->hash[hash & (ci->hash_size - 1)];
+	ci->hash[hash & (ci->hash_size - 1)] = e;
+	ci->entries++;
+	ci->empty++; /* until the client is added */
+	if (e->prefix)
+		ci->prefix_entries[(int)e->cls][(int)e->len]++;
+
+	return e;
+}
+
+static int callindex_cmp_ptr(const void *a, const void *b)
+{
+	const void *pa = *(const void **)a;
+	const void *pb = *(const void **)b;
+
+	return (pa < pb) ? -1 : (pa > pb);
+}
+
+/*
+ *	Add the callsign set filter keys of a client in the index.
+ *	The client must not be in the index already.
+ */
+
+void callindex_add(struct callindex_t *ci, struct client_t *c)
+{
+	struct callindex_key_t *keys;
+	struct callindex_entry_t **entries, *e;
+	int i, n, nkeys;
+
+	nkeys = filter_call_keys(c, &keys);
+	if (nkeys <= 0) {
+		if (keys)
+			hfree(keys);
+		c->call_entries = NULL;
+		c->call_entry_count = 0;
+		return;
+	}
+
+	entries = hmalloc(sizeof(*entries) * nkeys);
+	for (i = 0; i < nkeys; i++)
+		entries[i] = callindex_get(ci, &keys[i]);
+	hfree(keys);
+
+	/* a client is registered in an entry only once, even if
+	 * the same callsign is in multiple filters
+	 */
+	qsort(entries, nkeys, sizeof(*entries), callindex_cmp_ptr);
+	for (i = 0, n = 0; i < nkeys; i++)
+		if (n == 0 || entries[i] != entries[n-1])
+			entries[n++] = entries[i];
+
+	for (i = 0; i < n; i++) {
+		e = entries[i];
+		if (e->count == 0)
+			ci->empty--;
+		if (e->count == e->size) {
+			e->size = (e->size) ? e->size * 2 : 4;
+			e->clients = hrealloc(e->clients, sizeof(*e->clients) * e->size);
+		}
+		e->clients[e->count++] = c;
+	}
+
+	c->call_entries = entries;
+	c->call_entry_count = n;
+	ci->clients++;
+}
+
+/*
+ *	Remove a client from the index. Like in the geoindex, the last
+ *	client of an entry is moved in the place of the removed one, and
+ *	the outgoing loop walks the entries backwards.
+ */
+
+void callindex_remove(struct callindex_t *ci, struct client_t *c)
+{
+	struct callindex_entry_t *e;
+	int i, j;
+
+	if (!c->call_entries)
+		return;
+
+	for (i = 0; i < c->call_entry_count; i++) {
+		e = c->call_entries[i];
+		for (j = 0; j < e->count; j++)
+			if (e->clients[j] == c)
+				break;
+		
+		if (j == e->count) {
+			hlog(LOG_ERR, "callindex_remove: client %p not found in entry %.*s", c, e->len, e->call);
+			continue;
+		}
+		
+		e->clients[j] = e->clients[--e->count];
+		if (e->count == 0)
+			ci->empty++;
+	}
+
+	hfree(c->call_entries);
+	c->call_entries = NULL;
+	c->call_entry_count = 0;
+	ci->clients--;
+}
+
+/*
+ *	Free the entries which have no clients left
+ */
+
+void callindex_gc(struct callindex_t *ci)
+{
+	struct callindex_entry_t **prevp, *e;
+	int i;
+
+	if (!ci->empty)
+		return;
+
+	for (i = 0; i < ci->hash_size; i++) {
+		prevp = &ci->hash[i];
+		while ((e = *prevp)) {
+			if (e->count == 0) {
+				*prevp = e->next;
+				callindex_entry_free(ci, e);
+			} else {
+				prevp = &e->next;
+			}
+		}
+	}
+
+	ci->empty = 0;
+}
+
+/*
+ *	Find the entries matching a single key of a packet: the entry
+ *	having the whole key, and the prefix entries having any prefix
+ *	of it. Keys longer than a callsign are truncated, like the
+ *	filters do.
+ */
+
+static int callindex_lookup_key(struct callindex_t *ci, int cls, const char *key, int len, struct callindex_entry_t **matches, int n)
+{
+	struct callindex_entry_t *e;
+	uint32_t hash = CALLINDEX_SEED(cls);
+	int i;
+
+	if (len > CALLSIGNLEN_MAX)
+		len = CALLSIGNLEN_MAX;
+
+	for (i = 1; i <= len; i++) {
+		hash = callindex_hash_step(hash, key[i-1]);
+		if (ci->prefix_entries[cls][i] && (e = callindex_find(ci, hash, cls, 1, key, i)))
+			matches[n++] = e;
+	}
+
+	if (len > 0 && (e = callindex_find(ci, hash, cls, 0, key, len)))
+		matches[n++] = e;
+
+	return n;
+}
+
+/*
+ *	Find the entries which may match a packet. The matches array
+ *	must have room for CALLINDEX_MAX_MATCHES entries.
+ */
+
+int callindex_lookup(struct callindex_t *ci, struct pbuf_t *pb, struct callindex_entry_t **matches)
+{
+	int n = 0, i;
+
+	if (!ci->entries)
+		return 0;
+
+	/* source callsign, and the innermost one of 3rd-party packets */
+	n = callindex_lookup_key(ci, CALLINDEX_SRC, pb->data, pb->srccall_end - pb->data, matches, n);
+	if (pb->srcname != pb->data && (pb->packettype & (T_OBJECT|T_ITEM)) == 0)
+		n = callindex_lookup_key(ci, CALLINDEX_SRC, pb->srcname, pb->srcname_len, matches, n);
+
+	if (pb->packettype & (T_OBJECT|T_ITEM))
+		n = callindex_lookup_key(ci, CALLINDEX_OBJ, pb->srcname, pb->srcname_len, matches, n);
+
+	if (pb->qconst_start && pb->entrycall_len > 0)
+		n = callindex_lookup_key(ci, CALLINDEX_ENTRY, pb->qconst_start + 4, pb->entrycall_len, matches, n);
+
+	n = callindex_lookup_key(ci, CALLINDEX_DST, pb->srccall_end + 1, pb->dstcall_len, matches, n);
+
+	if ((pb->packettype & T_MESSAGE) && pb->dstname_len > 0)
+		n = callindex_lookup_key(ci, CALLINDEX_MSG, pb->dstname, pb->dstname_len, matches, n);
+
+	/* digipeaters, as split up by incoming_parse_path() */
+	for (i = 0; i < pb->path_count; i++)
+		n = callindex_lookup_key(ci, CALLINDEX_DIGI, pb->data + pb->path[i].off, pb->path[i].len, matches, n);
+
+	return n;
+}
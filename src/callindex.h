@@ -0,0 +1,68 @@
+/*
+ *	aprsc
+ *
+ *	(c) Heikki Hannikainen, OH7LZB <hessu@hes.iki.fi>
+ *
+ *     This program is licensed under the BSD license, which can be found
+ *     in the file LICENSE.
+ *
+ */
+
+#ifndef CALLINDEX_H
+#define CALLINDEX_H
+
+#include "worker.h"
+
+/*
+ *	The packet fields matched by the callsign set filters
+ */
+#define CALLINDEX_SRC		0	/* p/ b/: srccall, or srcname of 3rd-party packets */
+#define CALLINDEX_OBJ		1	/* o/: object or item name */
+#define CALLINDEX_ENTRY		2	/* e/: entry station from the q construct */
+#define CALLINDEX_DST		3	/* u/: destination callsign */
+#define CALLINDEX_DIGI		4	/* d/: digipeater callsigns */
+#define CALLINDEX_MSG		5	/* g/: message recipient */
+#define CALLINDEX_CLASSES	6
+
+/* most keys looked up for a single packet: 10 digipeaters and the rest */
+#define CALLINDEX_MAX_KEYS	16
+#define CALLINDEX_MAX_MATCHES	(CALLINDEX_MAX_KEYS * (CALLSIGNLEN_MAX + 1))
+
+/* a key of a client's filter, as provided by filter_call_keys() */
+struct callindex_key_t {
+	char cls;		/* CALLINDEX_* */
+	char prefix;		/* matches keys starting with call */
+	char len;
+	char call[CALLSIGNLEN_MAX+1];
+};
+
+struct callindex_entry_t {
+	struct callindex_entry_t *next;	/* in the hash bucket */
+	uint32_t hash;
+	char cls;
+	char prefix;
+	char len;
+	char call[CALLSIGNLEN_MAX+1];	/* upper case */
+	struct client_t **clients;
+	int count;
+	int size;
+};
+
+struct callindex_t {
+	struct callindex_entry_t **hash;
+	int hash_size;
+	int entries;		/* number of entries in the hash */
+	int empty;		/* entries without clients, freed by callindex_gc() */
+	int clients;		/* number of clients in the index */
+	int prefix_entries[CALLINDEX_CLASSES][CALLSIGNLEN_MAX+1]; /* prefix entries by length */
+};
+
+extern struct callindex_t *callindex_alloc(void);
+extern void callindex_free(struct callindex_t *ci);
+
+extern void callindex_add(struct callindex_t *ci, struct client_t *c);
+extern void callindex_remove(struct callindex_t *ci, struct client_t *c);
+extern void callindex_gc(struct callindex_t *ci);
+extern int callindex_lookup(struct callindex_t *ci, struct pbuf_t *pb, struct callindex_entry_t **matches);
+
+#endif
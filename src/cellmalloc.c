@@ -5,13 +5,15 @@
  *
  *	This program is licensed under the BSD license, which can be found
  *	in the file LICENSE.
- *	
+ *
  */
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <unistd.h>
 #include <string.h>
+#include <errno.h>
 #include <pthread.h>
 #include <sys/mman.h>
 #include <fcntl.h>
@@ -21,12 +23,44 @@
 #include "hlog.h"
 
 /*
- *   cellmalloc() -- manages arrays of cells of data 
+ *   cellmalloc() -- manages arrays of cells of data
+ *
+ *   The cells are carved out of blocks mmap'd from the system. A block
+ *   is aligned to its size (rounded up to a power of two), and starts
+ *   with a header, so the block of a cell is found by masking the
+ *   address of the cell. Each block has a free list of its own, and a
+ *   count of the cells handed out, so that a block with no cells in
+ *   use can be given back to the system.
+ *
+ *   The blocks are on the lists of the arena:
+ *	partial:  some cells in use, some free - cells are taken from these first
+ *	empty:    no cells in use, pages still resident - most recently emptied first
+ *	released: no cells in use, pages given back (or never touched)
+ *   and a block with all of its cells in use is on no list.
  *
+ *   The cells of a new block are handed out in address order, so that
+ *   the pages are only touched when needed. A block which has been
+ *   empty for long enough is released by celltrim() with
+ *   madvise(MADV_DONTNEED): the block stays mapped, so the address
+ *   space does not churn, and a stale pointer to a released cell
+ *   reads zeroes instead of crashing the server.
+ *
+ *   The blocks of an arena made with CELLMALLOC_POLICY_HUGEPAGES are
+ *   whole huge pages, aligned to them, and backed by them in the mode
+ *   picked with cellhugepages(). On MAP_HUGETLB pages, memory is
+ *   given back a huge page at a time, so the pages of a block of a
+ *   single huge page are kept.
  */
 
 #ifndef _FOR_VALGRIND_
 struct cellhead;
+struct cellblock_t;
+
+struct cellblock_list_t {
+	struct cellblock_t *head;
+	struct cellblock_t *tail;
+	int	 count;
+};
 
 struct cellarena_t {
 	int	cellsize;
@@ -40,19 +74,54 @@ struct cellarena_t {
 
 	pthread_mutex_t mutex;
 
-  	struct cellhead *free_head;
-  	struct cellhead *free_tail;
-
 	int	 freecount;
 	int	 createsize;
+	uintptr_t blockalign;	/* blocks are aligned to this */
+	int	 pagesize;
+	int	 cells_offset;	/* the first cell of a block, after the header */
+	int	 cells_per_block;
+	int	 huge;		/* CELLMALLOC_HUGEPAGES_* of the blocks */
+	int	 huge_failed;	/* ran out of MAP_HUGETLB pages, logged */
+
+	struct cellblock_list_t partial;
+	struct cellblock_list_t empty;
+	struct cellblock_list_t released;
 
 	int	 cellblocks_count;
-#define CELLBLOCKS_MAX 200 /* track client cell allocator limit! */
-	char	*cellblocks[CELLBLOCKS_MAX];	/* ref as 'char pointer' for pointer arithmetics... */
+	int	 cellblocks_peak;
+	long	 releases;	/* blocks given back to the system */
+	long	 rss_bytes;	/* bytes of the blocks touched, and not given back since */
+	time_t	 now;		/* the time of the last celltrim() */
+
+	/* the depot of the cell caches */
+	struct cellmag_t *depot_full;
+	struct cellmag_t *depot_empty;
+	int	 depot_full_count, depot_full_min;
+	int	 depot_empty_count, depot_empty_min;
+	long	 depot_cells;
+	time_t	 depot_trimmed;
+
+	struct cellarena_t *next_arena;
+};
+
+struct cellblock_t {
+	struct cellarena_t *ca;
+	struct cellblock_t *next, *prev;
+	struct cellblock_list_t *list;	/* the list the block is on, NULL if full */
+	struct cellhead *free_head;
+	struct cellhead *free_tail;
+	char	*bump;		/* the cells from here on have never been handed out */
+	char	*limit;		/* end of the last cell */
+	char	*touched;	/* end of the pages in memory */
+	int	 live;		/* cells in use */
+	time_t	 empty_since;
 };
 
 #define CELLHEAD_DEBUG 0
 
+/* the depot gives back what it did not need during this long */
+#define CELLMAG_DEPOT_INTERVAL	15
+
 struct cellhead {
 #if CELLHEAD_DEBUG == 1
 	struct cellarena_t *ca;
@@ -60,24 +129,89 @@ struct cellhead {
 	struct cellhead *next;
 };
 
+/* all arenas, for celltrim_all() */
+static struct cellarena_t *cellarenas;
+static pthread_mutex_t cellarenas_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* the huge pages of the arenas made from now on */
+static int cellhuge_mode = CELLMALLOC_HUGEPAGES_OFF;
+static long cellhuge_size = 2048 * 1024;
 
 /*
- * new_cellblock() -- must be called MUTEX PROTECTED
- *
+ *	Block lists
  */
 
-int new_cellblock(cellarena_t *ca)
+static void cellblock_unlink(struct cellblock_t *b)
 {
-	int i;
-	char *cb;
+	struct cellblock_list_t *l = b->list;
+
+	if (!l)
+		return;
+
+	if (b->prev)
+		b->prev->next = b->next;
+	else
+		l->head = b->next;
+	if (b->next)
+		b->next->prev = b->prev;
+	else
+		l->tail = b->prev;
+
+	b->next = b->prev = NULL;
+	b->list = NULL;
+	l->count--;
+}
 
-	// If we already have allocated the maximum amount of blocks, do not even try.
-	if (ca->cellblocks_count >= CELLBLOCKS_MAX) return -1;
+static void cellblock_push(struct cellblock_list_t *l, struct cellblock_t *b)
+{
+	cellblock_unlink(b);
+
+	b->prev = NULL;
+	b->next = l->head;
+	if (l->head)
+		l->head->prev = b;
+	else
+		l->tail = b;
+	l->head = b;
+	b->list = l;
+	l->count++;
+}
+
+static void cellblock_append(struct cellblock_list_t *l, struct cellblock_t *b)
+{
+	cellblock_unlink(b);
+
+	b->next = NULL;
+	b->prev = l->tail;
+	if (l->tail)
+		l->tail->next = b;
+	else
+		l->head = b;
+	l->tail = b;
+	b->list = l;
+	l->count++;
+}
+
+static inline struct cellblock_t *cellblock_of(cellarena_t *ca, void *p)
+{
+	return (struct cellblock_t *)((uintptr_t)p & ~(ca->blockalign - 1));
+}
+
+/*
+ *	mmap a block, aligned to ca->blockalign: map more than needed,
+ *	and give back the ends
+ */
+
+static char *cellblock_map(cellarena_t *ca)
+{
+	size_t len = ca->createsize + ca->blockalign;
+	char *m, *cb, *tail;
 
 #ifdef MEMDEBUG /* External backing-store files, unique ones for each cellblock,
 		   which at Linux names memory blocks in  /proc/nnn/smaps "file"
 		   with this filename.. */
 	int fd;
+	size_t i;
 	char name[2048];
 
 	sprintf(name, "/tmp/.-%d-%s-%d.mmap", getpid(), ca->arenaname, ca->cellblocks_count );
@@ -87,43 +221,90 @@ int new_cellblock(cellarena_t *ca)
 	if (fd >= 0) {
 	  memset(name, 0, sizeof(name));
 	  i = 0;
-	  while (i < ca->createsize) {
+	  while (i < len) {
 	    int rc = write(fd, name, sizeof(name));
 	    if (rc < 0) break;
 	    i += rc;
 	  }
 	}
 
-	cb = mmap( NULL, ca->createsize, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+	m = mmap( NULL, len, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
 	close(fd);
 #else
 
 #ifndef MAP_ANON
 #  define MAP_ANON 0
 #endif
-	cb = mmap( NULL, ca->createsize, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANON, -1, 0);
+	m = (char*)-1;
+#ifdef MAP_HUGETLB
+	if (ca->huge == CELLMALLOC_HUGEPAGES_HUGETLB) {
+		/* huge pages are reserved at mmap, so try without the slack first */
+		m = mmap( NULL, ca->createsize, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANON|MAP_HUGETLB, -1, 0);
+		if (m != (char*)-1 && ((uintptr_t)m & (ca->blockalign - 1)) == 0)
+			return m;
+		if (m != (char*)-1)
+			munmap(m, ca->createsize);
+		m = mmap( NULL, len, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANON|MAP_HUGETLB, -1, 0);
+		if (m == (char*)-1 && !ca->huge_failed) {
+			ca->huge_failed = 1;
+			hlog(LOG_WARNING, "cellmalloc: %s: out of huge pages, using normal pages: %s", ca->arenaname, strerror(errno));
+		}
+	}
+#endif
+	if (m == (char*)-1) {
+		m = mmap( NULL, len, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANON, -1, 0);
+#ifdef MADV_HUGEPAGE
+		/* transparent huge pages, also when MAP_HUGETLB ran out */
+		if (ca->huge != CELLMALLOC_HUGEPAGES_OFF && m != (char*)-1)
+			madvise(m, len, MADV_HUGEPAGE);
+#endif
+	}
 #endif
-	if (cb == NULL || cb == (char*)-1)
-	  return -1;
+	if (m == NULL || m == (char*)-1)
+	  return NULL;
 
-	ca->cellblocks[ca->cellblocks_count++] = cb;
+	cb = (char *)(((uintptr_t)m + ca->blockalign - 1) & ~(ca->blockalign - 1));
+	tail = (char *)(((uintptr_t)cb + ca->createsize + ca->pagesize - 1) & ~(uintptr_t)(ca->pagesize - 1));
 
-	for (i = 0; i <= ca->createsize-ca->increment; i += ca->increment) {
-		struct cellhead *ch = (struct cellhead *)(cb + i); /* pointer arithmentic! */
-		if (!ca->free_head) {
-		  ca->free_head = ch;
-		} else {
-		  ca->free_tail->next = ch;
-		}
-		ca->free_tail = ch;
-		ch->next = NULL;
-#if CELLHEAD_DEBUG == 1
-		ch->ca   = ca; // cellhead pointer space
-#endif
+	if (cb > m)
+		munmap(m, cb - m);
+	if (tail < m + len)
+		munmap(tail, m + len - tail);
+
+	return cb;
+}
+
+/*
+ * new_cellblock() -- must be called MUTEX PROTECTED
+ *
+ * The new block goes on the released list, since none of its pages
+ * have been touched yet.
+ */
+
+static int new_cellblock(cellarena_t *ca)
+{
+	struct cellblock_t *b;
+	char *cb;
 
-		ca->freecount += 1;
+	cb = cellblock_map(ca);
+	if (!cb) {
+		hlog(LOG_ERR, "cellmalloc: %s: failed to map a new block of %d kB", ca->arenaname, ca->createsize / 1024);
+		return -1;
 	}
 
+	b = (struct cellblock_t *)cb;
+	memset(b, 0, sizeof(*b));
+	b->ca = ca;
+	b->bump = b->touched = cb + ca->cells_offset;
+	b->limit = b->bump + ca->cells_per_block * ca->increment;
+	cellblock_push(&ca->released, b);
+
+	ca->cellblocks_count++;
+	if (ca->cellblocks_count > ca->cellblocks_peak)
+		ca->cellblocks_peak = ca->cellblocks_count;
+	ca->freecount += ca->cells_per_block;
+	ca->rss_bytes += ca->cells_offset;
+
 	// hlog( LOG_DEBUG, "new_cellblock(%p) of %dB freecount %d  returns to %p/%p",
 	//       ca, ca->cellsize, ca->freecount,
 	//       __builtin_return_address(1), __builtin_return_address(2) );
@@ -131,7 +312,128 @@ int new_cellblock(cellarena_t *ca)
 	return 0;
 }
 
+/*
+ *	Give the pages of an empty block back to the system, and start
+ *	handing out its cells from the beginning again
+ */
+
+static void cellblock_release(cellarena_t *ca, struct cellblock_t *b)
+{
+	char *from = (char *)(((uintptr_t)b + ca->cells_offset + ca->pagesize - 1) & ~(uintptr_t)(ca->pagesize - 1));
+
+#ifdef MADV_DONTNEED
+	/* the page of the header stays, and so do the cells on it */
+	if (b->touched > from && madvise(from, b->touched - from, MADV_DONTNEED) == 0) {
+		ca->rss_bytes -= b->touched - from;
+		b->touched = from;
+	}
+#endif
+	ca->releases++;
+
+	b->free_head = b->free_tail = NULL;
+	b->bump = (char *)b + ca->cells_offset;
+	cellblock_push(&ca->released, b);
+}
+
+const char *cellhugepages_name(int mode)
+{
+	switch (mode) {
+	case CELLMALLOC_HUGEPAGES_THP:
+		return "transparent";
+	case CELLMALLOC_HUGEPAGES_HUGETLB:
+		return "hugetlb";
+	}
+	return "off";
+}
+
+/* the size of a huge page, from /proc/meminfo */
+static long cellhuge_pagesize(void)
+{
+	FILE *fp;
+	char line[128];
+	long kb = 0;
+
+	if (!(fp = fopen("/proc/meminfo", "r")))
+		return cellhuge_size;
+
+	while (fgets(line, sizeof(line), fp))
+		if (sscanf(line, "Hugepagesize: %ld kB", &kb) == 1)
+			break;
+	fclose(fp);
+
+	return (kb > 0) ? kb * 1024 : cellhuge_size;
+}
+
+/* transparent huge pages are not turned off for the whole system */
+static int cellhuge_thp_enabled(void)
+{
+	FILE *fp;
+	char line[128];
+	int enabled = 1;
+
+	if (!(fp = fopen("/sys/kernel/mm/transparent_hugepage/enabled", "r")))
+		return 0;
+
+	if (!fgets(line, sizeof(line), fp) || strstr(line, "[never]"))
+		enabled = 0;
+	fclose(fp);
+
+	return enabled;
+}
+
+/*
+ *	cellhugepages() -- pick the huge pages of the arenas made with
+ *	CELLMALLOC_POLICY_HUGEPAGES after this call. A mode which the
+ *	system does not support falls back to the next one, from hugetlb
+ *	to transparent to off. Returns the mode in effect.
+ */
+
+int cellhugepages(int mode)
+{
+	char *m;
+
+	if (mode != CELLMALLOC_HUGEPAGES_OFF)
+		cellhuge_size = cellhuge_pagesize();
+
+	if (mode == CELLMALLOC_HUGEPAGES_HUGETLB) {
+#ifdef MAP_HUGETLB
+		m = mmap(NULL, cellhuge_size, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANON|MAP_HUGETLB, -1, 0);
+		if (m != (char*)-1) {
+			munmap(m, cellhuge_size);
+		} else {
+			hlog(LOG_WARNING, "cellmalloc: hugetlb pages not available (%s), see vm.nr_hugepages - trying transparent huge pages", strerror(errno));
+			mode = CELLMALLOC_HUGEPAGES_THP;
+		}
+#else
+		hlog(LOG_WARNING, "cellmalloc: hugetlb pages not supported on this system - trying transparent huge pages");
+		mode = CELLMALLOC_HUGEPAGES_THP;
+#endif
+	}
+
+	if (mode == CELLMALLOC_HUGEPAGES_THP) {
+#ifdef MADV_HUGEPAGE
+		m = mmap(NULL, cellhuge_size, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANON, -1, 0);
+		if (m == (char*)-1 || !cellhuge_thp_enabled() || madvise(m, cellhuge_size, MADV_HUGEPAGE) != 0) {
+			hlog(LOG_WARNING, "cellmalloc: transparent huge pages not available - using normal pages");
+			mode = CELLMALLOC_HUGEPAGES_OFF;
+		}
+		if (m != (char*)-1)
+			munmap(m, cellhuge_size);
+#else
+		hlog(LOG_WARNING, "cellmalloc: transparent huge pages not supported on this system - using normal pages");
+		mode = CELLMALLOC_HUGEPAGES_OFF;
+#endif
+	}
 
+	cellhuge_mode = mode;
+
+	if (mode == CELLMALLOC_HUGEPAGES_OFF)
+		hlog(LOG_INFO, "cellmalloc: huge pages: off");
+	else
+		hlog(LOG_INFO, "cellmalloc: huge pages: %s, %ld kB pages", cellhugepages_name(mode), cellhuge_size / 1024);
+
+	return mode;
+}
 
 /*
  * cellinit()  -- the main program calls this once for each used cell type/size
@@ -166,16 +468,37 @@ cellarena_t *cellinit( const char *arenaname, const int cellsize, const int alig
 	}
 	ca->lifo_policy =  policy & CELLMALLOC_POLICY_LIFO;
 	ca->use_mutex   = (policy & CELLMALLOC_POLICY_NOMUTEX) ? 0 : 1;
+	ca->huge        = (policy & CELLMALLOC_POLICY_HUGEPAGES) ? cellhuge_mode : CELLMALLOC_HUGEPAGES_OFF;
 
 	ca->createsize = createkb * 1024;
+	ca->pagesize = sysconf(_SC_PAGESIZE);
+	if (ca->pagesize <= 0)
+		ca->pagesize = 4096;
+	if (ca->huge != CELLMALLOC_HUGEPAGES_OFF) {
+		/* whole huge pages, and MAP_HUGETLB ones are mapped and given back as such */
+		ca->createsize = (ca->createsize + cellhuge_size - 1) / cellhuge_size * cellhuge_size;
+		if (ca->huge == CELLMALLOC_HUGEPAGES_HUGETLB)
+			ca->pagesize = cellhuge_size;
+	}
+	for (ca->blockalign = (ca->huge) ? cellhuge_size : ca->pagesize; ca->blockalign < (uintptr_t)ca->createsize; ca->blockalign <<= 1)
+		;
+	ca->cells_offset = (sizeof(struct cellblock_t) + alignment - 1) / alignment * alignment;
+	ca->cells_per_block = (ca->createsize - ca->cells_offset) / ca->increment;
 
-	n = ca->createsize / ca->increment;
-	hlog( LOG_DEBUG, "cellinit: %-12s block size %4d kB, cells/block: %d, %s", arenaname, createkb, n, ca->use_mutex ? "mutex" : "no mutex" );
+	n = ca->cells_per_block;
+	hlog( LOG_DEBUG, "cellinit: %-12s block size %4d kB, cells/block: %d, %s, huge pages: %s", arenaname, ca->createsize / 1024, n,
+		ca->use_mutex ? "mutex" : "no mutex", cellhugepages_name(ca->huge) );
 
 	pthread_mutex_init(&ca->mutex, NULL);
 
 	while (ca->freecount < ca->minfree)
-		new_cellblock(ca); /* more until minfree is full */
+		if (new_cellblock(ca)) /* more until minfree is full */
+			break;
+
+	pthread_mutex_lock(&cellarenas_mutex);
+	ca->next_arena = cellarenas;
+	cellarenas = ca;
+	pthread_mutex_unlock(&cellarenas_mutex);
 
 #if CELLHEAD_DEBUG == 1
 	hlog(LOG_DEBUG, "cellinit()  cellhead=%p", ca);
@@ -203,6 +526,93 @@ static struct cellhead *clientptr_to_cellhead(void *v)
 	return ch;
 }
 
+/*
+ *	Take a cell, from a partially used block if there is one, then
+ *	from an empty one, a released one, and finally a new one.
+ *	Must be called MUTEX PROTECTED.
+ */
+
+static struct cellhead *cell_take(cellarena_t *ca)
+{
+	struct cellblock_t *b;
+	struct cellhead *ch;
+
+	while (ca->freecount < ca->minfree)
+		if (new_cellblock(ca))
+			return NULL;
+
+	if (!(b = ca->partial.head)) {
+		if (!(b = ca->empty.head) && !(b = ca->released.head)) {
+			if (new_cellblock(ca))
+				return NULL;
+			b = ca->released.head;
+		}
+		cellblock_push(&ca->partial, b);
+	}
+
+	if ((ch = b->free_head)) {
+		b->free_head = ch->next;
+		if (!b->free_head)
+			b->free_tail = NULL;
+	} else {
+		ch = (struct cellhead *)b->bump;
+		b->bump += ca->increment;
+		if (b->bump > b->touched) {
+			ca->rss_bytes += b->bump - b->touched;
+			b->touched = b->bump;
+		}
+	}
+
+	ch->next = NULL;
+	b->live++;
+	ca->freecount -= 1;
+
+	/* full, off the lists */
+	if (!b->free_head && b->bump == b->limit)
+		cellblock_unlink(b);
+
+	return ch;
+}
+
+/*
+ *	Put a cell back in its block. Must be called MUTEX PROTECTED.
+ */
+
+static void cell_put(cellarena_t *ca, struct cellhead *ch)
+{
+	struct cellblock_t *b = cellblock_of(ca, ch);
+
+	if (b->ca != ca) {
+		hlog(LOG_ERR, "cellfree(%p to %s) cell is not in a block of the arena", ch, ca->arenaname);
+		return;
+	}
+
+	if (ca->lifo_policy || !b->free_head) {
+	  /* Put the cell on free-head */
+	  ch->next = b->free_head;
+	  b->free_head = ch;
+	  if (!b->free_tail)
+	    b->free_tail = ch;
+
+	} else {
+	  /* Put the cell on free-tail */
+	  b->free_tail->next = ch;
+	  b->free_tail = ch;
+	  ch->next = NULL;
+	}
+
+	ca->freecount += 1;
+
+	if (--b->live == 0) {
+		/* empty: wait for celltrim() on the empty list */
+		b->empty_since = ca->now;
+		cellblock_push(&ca->empty, b);
+	} else if (!b->list) {
+		/* was full */
+		cellblock_append(&ca->partial, b);
+	}
+}
+
 
 void *cellmalloc(cellarena_t *ca)
 {
@@ -217,26 +627,9 @@ void *cellmalloc(cellarena_t *ca)
 		}
 	}
 
-	while (!ca->free_head  || (ca->freecount < ca->minfree))
-		if (new_cellblock(ca)) {
-			if (ca->use_mutex) {
-				if ((me = pthread_mutex_unlock(&ca->mutex))) {
-					hlog(LOG_ERR, "cellmalloc: could not unlock mutex: %s", strerror(me));
-				}
-			}
-			
-			return NULL;
-		}
-
 	/* Pick new one off the free-head ! */
-	ch = ca->free_head;
-	ca->free_head = ch->next;
-	ch->next = NULL;
+	ch = cell_take(ca);
 	cp = ch;
-	if (ca->free_head == NULL)
-	  ca->free_tail = NULL;
-
-	ca->freecount -= 1;
 
 	if (ca->use_mutex) {
 		if ((me = pthread_mutex_unlock(&ca->mutex))) {
@@ -244,6 +637,9 @@ void *cellmalloc(cellarena_t *ca)
 		}
 	}
 
+	if (!cp)
+		return NULL;
+
 	// hlog(LOG_DEBUG, "cellmalloc(%p at %p) freecount %d", cellhead_to_clientptr(cp), ca, ca->freecount);
 
 	return cellhead_to_clientptr(cp);
@@ -269,36 +665,21 @@ int   cellmallocmany(cellarena_t *ca, void **array, int numcells)
 
 	for (count = 0; count < numcells; ++count) {
 
-		while (!ca->free_head ||
-		       ca->freecount < ca->minfree) {
-			/* Out of free cells ? alloc new set */
-			if (new_cellblock(ca)) {
-				/* Failed ! */
-				hlog(LOG_ERR, "cellmallocmany: failed to allocate new block!");
-				break;
-			}
-		}
-
 		/* Pick new one off the free-head ! */
 
-		ch = ca->free_head;
+		ch = cell_take(ca);
 
 		// hlog( LOG_DEBUG, "cellmallocmany(%d of %d); freecount %d; %p at %p",
 		//       count, numcells, ca->freecount, cellhead_to_clientptr(ch), ca );
 
-		if (!ch)
-		 	break;	// Should not happen...
-
-		ca->free_head = ch->next;
-		ch->next = NULL;
-
-		if (ca->free_head == NULL)
-			ca->free_tail = NULL;
+		if (!ch) {
+			/* Failed ! */
+			hlog(LOG_ERR, "cellmallocmany: failed to allocate new block!");
+			break;
+		}
 
 		array[count] = cellhead_to_clientptr(ch);
 
-		ca->freecount -= 1;
-
 	}
 
 	if (ca->use_mutex) {
@@ -333,22 +714,7 @@ void  cellfree(cellarena_t *ca, void *p)
 		}
 	}
 
-	if (ca->lifo_policy) {
-	  /* Put the cell on free-head */
-	  ch->next = ca->free_head;
-	  ca->free_head = ch;
-
-	} else {
-	  /* Put the cell on free-tail */
-	  if (ca->free_tail)
-	    ca->free_tail->next = ch;
-	  ca->free_tail = ch;
-	  if (!ca->free_head)
-	    ca->free_head = ch;
-	  ch->next = NULL;
-	}
-
-	ca->freecount += 1;
+	cell_put(ca, ch);
 
 	if (ca->use_mutex) {
 		if ((me = pthread_mutex_unlock(&ca->mutex))) {
@@ -386,22 +752,7 @@ void  cellfreemany(cellarena_t *ca, void **array, int numcells)
 
 	  // hlog(LOG_DEBUG, "cellfreemany() %p to %p", ch, ca);
 
-	  if (ca->lifo_policy) {
-	    /* Put the cell on free-head */
-	    ch->next = ca->free_head;
-	    ca->free_head = ch;
-
-	  } else {
-	    /* Put the cell on free-tail */
-	    if (ca->free_tail)
-	      ca->free_tail->next = ch;
-	    ca->free_tail = ch;
-	    if (!ca->free_head)
-	      ca->free_head = ch;
-	    ch->next = NULL;
-	  }
-
-	  ca->freecount += 1;
+	  cell_put(ca, ch);
 
 	}
 
@@ -412,25 +763,290 @@ void  cellfreemany(cellarena_t *ca, void **array, int numcells)
 	}
 }
 
+/*
+ *	Magazines and the depot, see cellmalloc.h
+ */
+
+static int cellarena_lock(cellarena_t *ca, const char *fn)
+{
+	int me;
+
+	if (ca->use_mutex && (me = pthread_mutex_lock(&ca->mutex))) {
+		hlog(LOG_ERR, "%s: could not lock mutex: %s", fn, strerror(me));
+		return -1;
+	}
+
+	return 0;
+}
+
+static void cellarena_unlock(cellarena_t *ca, const char *fn)
+{
+	int me;
+
+	if (ca->use_mutex && (me = pthread_mutex_unlock(&ca->mutex)))
+		hlog(LOG_ERR, "%s: could not unlock mutex: %s", fn, strerror(me));
+}
+
+static struct cellmag_t *cellmag_new(void)
+{
+	struct cellmag_t *m = hmalloc(sizeof(*m));
+
+	m->next = NULL;
+	m->count = 0;
+
+	return m;
+}
+
+/* put the cells of a magazine back in their blocks - MUTEX PROTECTED */
+static void cellmag_drain(cellarena_t *ca, struct cellmag_t *m)
+{
+	while (m->count)
+		cell_put(ca, clientptr_to_cellhead(m->cells[--m->count]));
+}
+
+static void depot_put_empty(cellarena_t *ca, struct cellmag_t *m)
+{
+	m->next = ca->depot_empty;
+	ca->depot_empty = m;
+	ca->depot_empty_count++;
+}
+
+static struct cellmag_t *depot_get_empty(cellarena_t *ca)
+{
+	struct cellmag_t *m;
+
+	if (!(m = ca->depot_empty))
+		return NULL;
+
+	ca->depot_empty = m->next;
+	if (--ca->depot_empty_count < ca->depot_empty_min)
+		ca->depot_empty_min = ca->depot_empty_count;
+
+	return m;
+}
+
+static struct cellmag_t *depot_get_full(cellarena_t *ca)
+{
+	struct cellmag_t *m;
+
+	if (!(m = ca->depot_full))
+		return NULL;
+
+	ca->depot_full = m->next;
+	ca->depot_cells -= m->count;
+	if (--ca->depot_full_count < ca->depot_full_min)
+		ca->depot_full_min = ca->depot_full_count;
+
+	return m;
+}
+
+void cellcache_init(struct cellcache_t *cc, cellarena_t *ca)
+{
+	memset(cc, 0, sizeof(*cc));
+	cc->ca = ca;
+}
+
+void *cellcache_alloc_slow(struct cellcache_t *cc)
+{
+	cellarena_t *ca = cc->ca;
+	struct cellmag_t *m;
+	struct cellhead *ch;
+
+	/* the previous one has cells in it */
+	if (cc->previous && cc->previous->count) {
+		m = cc->loaded;
+		cc->loaded = cc->previous;
+		cc->previous = m;
+		return cc->loaded->cells[--cc->loaded->count];
+	}
+
+	if (!cc->loaded)
+		cc->loaded = cellmag_new();
+
+	if (cellarena_lock(ca, "cellcache_alloc"))
+		return NULL;
+
+	if ((m = depot_get_full(ca))) {
+		/* a full one from the depot, an empty one goes there */
+		if (cc->previous)
+			depot_put_empty(ca, cc->previous);
+		cc->previous = cc->loaded;
+		cc->loaded = m;
+	} else {
+		/* none there, fill one from the blocks */
+		m = cc->loaded;
+		while (m->count < CELLMAG_SIZE && (ch = cell_take(ca)))
+			m->cells[m->count++] = cellhead_to_clientptr(ch);
+	}
+
+	cellarena_unlock(ca, "cellcache_alloc");
+
+	m = cc->loaded;
+
+	return (m->count) ? m->cells[--m->count] : NULL;
+}
+
+void cellcache_free_slow(struct cellcache_t *cc, void *p)
+{
+	cellarena_t *ca = cc->ca;
+	struct cellmag_t *m = NULL;
+
+	if (cc->previous && cc->previous->count < CELLMAG_SIZE) {
+		/* the previous one has room */
+		m = cc->loaded;
+		cc->loaded = cc->previous;
+		cc->previous = m;
+	} else if (cc->loaded) {
+		/* both are full: the previous one goes to the depot, for an empty one */
+		if (cellarena_lock(ca, "cellcache_free")) {
+			cellfree(ca, p);
+			return;
+		}
+		if (cc->previous) {
+			cc->previous->next = ca->depot_full;
+			ca->depot_full = cc->previous;
+			ca->depot_full_count++;
+			ca->depot_cells += cc->previous->count;
+		}
+		m = depot_get_empty(ca);
+		cellarena_unlock(ca, "cellcache_free");
+
+		cc->previous = cc->loaded;
+		cc->loaded = (m) ? m : cellmag_new();
+	} else {
+		cc->loaded = cellmag_new();
+	}
+
+	cc->loaded->cells[cc->loaded->count++] = p;
+}
+
+/*
+ *	Put the cells of a cache back in the blocks, when the thread
+ *	owning it goes away
+ */
+
+void cellcache_flush(struct cellcache_t *cc)
+{
+	cellarena_t *ca = cc->ca;
+	struct cellmag_t *mags[2] = { cc->loaded, cc->previous };
+	int i;
+
+	if (cellarena_lock(ca, "cellcache_flush"))
+		return;
+
+	for (i = 0; i < 2; i++) {
+		if (!mags[i])
+			continue;
+		cellmag_drain(ca, mags[i]);
+		depot_put_empty(ca, mags[i]);
+	}
+
+	cellarena_unlock(ca, "cellcache_flush");
+
+	cc->loaded = cc->previous = NULL;
+}
+
+/*
+ *	The magazines the depot has had all the time since the previous
+ *	time are not needed: the cells of the full ones go back in the
+ *	blocks, and the empty ones are freed - MUTEX PROTECTED
+ */
+
+static void depot_trim(cellarena_t *ca, time_t now)
+{
+	struct cellmag_t *m;
+	int n;
+
+	if (now - ca->depot_trimmed < CELLMAG_DEPOT_INTERVAL && now >= ca->depot_trimmed)
+		return;
+	ca->depot_trimmed = now;
+
+	for (n = ca->depot_full_min; n > 0 && (m = depot_get_full(ca)); n--) {
+		cellmag_drain(ca, m);
+		hfree(m);
+	}
+
+	for (n = ca->depot_empty_min; n > 0 && (m = depot_get_empty(ca)); n--)
+		hfree(m);
+
+	ca->depot_full_min = ca->depot_full_count;
+	ca->depot_empty_min = ca->depot_empty_count;
+}
+
+/*
+ *  celltrim() -- release the blocks which have been empty for delay
+ *  seconds. The time of emptying is the time of the previous call,
+ *  so this is called periodically, with a monotonic clock.
+ */
+
+void  celltrim(cellarena_t *ca, time_t now, int delay)
+{
+	struct cellblock_t *b;
+	int me;
+
+	if (ca->use_mutex) {
+		if ((me = pthread_mutex_lock(&ca->mutex))) {
+			hlog(LOG_ERR, "celltrim: could not lock mutex: %s", strerror(me));
+			return;
+		}
+	}
+
+	/* the first call starts the clock of the blocks emptied before it */
+	if (!ca->now)
+		for (b = ca->empty.head; (b); b = b->next)
+			b->empty_since = now;
+	ca->now = now;
+
+	depot_trim(ca, now);
+
+	/* the oldest ones are at the tail */
+	while ((b = ca->empty.tail) && now - b->empty_since >= delay)
+		cellblock_release(ca, b);
+
+	if (ca->use_mutex) {
+		if ((me = pthread_mutex_unlock(&ca->mutex))) {
+			hlog(LOG_ERR, "celltrim: could not unlock mutex: %s", strerror(me));
+		}
+	}
+}
+
+/*
+ *  celltrim_all() -- celltrim() all arenas which have a mutex; the
+ *  owner of a NOMUTEX arena trims it itself, if it wishes to
+ */
+
+void  celltrim_all(time_t now, int delay)
+{
+	cellarena_t *ca;
+
+	pthread_mutex_lock(&cellarenas_mutex);
+	for (ca = cellarenas; (ca); ca = ca->next_arena)
+		if (ca->use_mutex)
+			celltrim(ca, now, delay);
+	pthread_mutex_unlock(&cellarenas_mutex);
+}
+
 void  cellstatus(cellarena_t *cellarena, struct cellstatus_t *status)
 {
-	/* TODO: try this for atomic cellstatus collection:
-	if (ca->use_mutex)
-		pthread_mutex_lock(&ca->mutex);
-	*/
+	if (cellarena->use_mutex)
+		pthread_mutex_lock(&cellarena->mutex);
+
 	status->cellsize = cellarena->cellsize;
 	status->cellsize_aligned = cellarena->increment;
 	status->alignment = cellarena->alignment;
 	status->freecount = cellarena->freecount;
-	status->cellcount = (cellarena->createsize / cellarena->increment) * cellarena->cellblocks_count;
+	status->cellcount = cellarena->cells_per_block * cellarena->cellblocks_count;
 	status->blocks = cellarena->cellblocks_count;
-	status->blocks_max = CELLBLOCKS_MAX;
+	status->blocks_max = 0; /* no limit */
 	status->block_size = cellarena->createsize;
-	/* and this:
-	if (ca->use_mutex)
-		pthread_mutex_unlock(&ca->mutex);
-	*/
+	status->blocks_peak = cellarena->cellblocks_peak;
+	status->blocks_released = cellarena->released.count;
+	status->releases = cellarena->releases;
+	status->rss_bytes = cellarena->rss_bytes;
+	status->cached = cellarena->depot_cells;
+
+	if (cellarena->use_mutex)
+		pthread_mutex_unlock(&cellarena->mutex);
 }
 
 #endif /* (NOT) _FOR_VALGRIND_ */
-
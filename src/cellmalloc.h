@@ -17,6 +17,8 @@
  *
  */
 
+#include <time.h>
+
 struct cellstatus_t {
 	int cellsize;
 	int alignment;
@@ -24,8 +26,13 @@ struct cellstatus_t {
 	int cellcount;
 	int freecount;
 	int blocks;
-	int blocks_max;
+	int blocks_max;		/* 0: no limit */
 	int block_size;
+	int blocks_peak;	/* high-water mark of blocks */
+	int blocks_released;	/* blocks given back to the system, still mapped */
+	long releases;		/* times a block was given back */
+	long rss_bytes;		/* bytes of the blocks in memory */
+	long cached;		/* cells in the magazines of the depot */
 };
 
 typedef struct cellarena_t cellarena_t;
@@ -35,16 +42,103 @@ extern cellarena_t *cellinit(const char *arenaname, const int cellsize, const in
 #define CELLMALLOC_POLICY_FIFO    0
 #define CELLMALLOC_POLICY_LIFO    1
 #define CELLMALLOC_POLICY_NOMUTEX 2
+#define CELLMALLOC_POLICY_HUGEPAGES 4	/* blocks on huge pages, if cellhugepages() turned them on */
+
+/* huge page modes */
+#define CELLMALLOC_HUGEPAGES_OFF	0
+#define CELLMALLOC_HUGEPAGES_THP	1	/* transparent, madvise(MADV_HUGEPAGE) */
+#define CELLMALLOC_HUGEPAGES_HUGETLB	2	/* mmap(MAP_HUGETLB), from vm.nr_hugepages */
+
+extern int   cellhugepages(int mode);
+extern const char *cellhugepages_name(int mode);
 
 extern void *cellmalloc(cellarena_t *cellarena);
 extern int   cellmallocmany(cellarena_t *cellarena, void **array, const int numcells);
 extern void  cellfree(cellarena_t *cellarena, void *p);
 extern void  cellfreemany(cellarena_t *cellarena, void **array, const int numcells);
+
+/*
+ *   cellcache -- a thread-local cache of the cells of an arena, in two
+ *   magazines. Cells are taken from and put in the loaded magazine
+ *   without locking. When it runs empty or full, it is swapped with
+ *   the previous one, or exchanged for a full or an empty one from the
+ *   depot of the arena - a magazine at a time, under the lock of the
+ *   arena. celltrim() gives back the cells of the magazines the depot
+ *   has not needed for a while.
+ */
+
+#define CELLMAG_SIZE	64
+
+struct cellmag_t {
+	struct cellmag_t *next;
+	int count;
+	void *cells[CELLMAG_SIZE];
+};
+
+struct cellcache_t {
+	cellarena_t *ca;
+	struct cellmag_t *loaded;
+	struct cellmag_t *previous;
+};
+
+extern void  cellcache_init(struct cellcache_t *cc, cellarena_t *cellarena);
+extern void *cellcache_alloc_slow(struct cellcache_t *cc);
+extern void  cellcache_free_slow(struct cellcache_t *cc, void *p);
+extern void  cellcache_flush(struct cellcache_t *cc);
+
+static inline void *cellcache_alloc(struct cellcache_t *cc)
+{
+	struct cellmag_t *m = cc->loaded;
+
+	if (m && m->count)
+		return m->cells[--m->count];
+
+	return cellcache_alloc_slow(cc);
+}
+
+static inline void cellcache_free(struct cellcache_t *cc, void *p)
+{
+	struct cellmag_t *m = cc->loaded;
+
+	if (m && m->count < CELLMAG_SIZE) {
+		m->cells[m->count++] = p;
+		return;
+	}
+
+	cellcache_free_slow(cc, p);
+}
+
+/* the loaded magazine is empty */
+static inline int cellcache_empty(struct cellcache_t *cc)
+{
+	return !cc->loaded || !cc->loaded->count;
+}
+
+extern void  celltrim(cellarena_t *cellarena, time_t now, int delay);
+extern void  celltrim_all(time_t now, int delay);
 extern void  cellstatus(cellarena_t *cellarena, struct cellstatus_t *status);
 
 #endif
 #else /* _FOR_VALGRIND_  .. normal malloc/free is better */
 
+#ifndef _CELLMALLOC_H_
+#define _CELLMALLOC_H_
+
 #include "hmalloc.h"
 
+#define CELLMALLOC_HUGEPAGES_OFF	0
+#define CELLMALLOC_HUGEPAGES_THP	1
+#define CELLMALLOC_HUGEPAGES_HUGETLB	2
+
+/* without the arenas, a cell cache just mallocs */
+struct cellcache_t {
+	int cellsize;
+};
+
+#define cellcache_alloc(cc)	hmalloc((cc)->cellsize)
+#define cellcache_free(cc, p)	hfree(p)
+#define cellcache_empty(cc)	1
+#define cellcache_flush(cc)	do { } while (0)
+
+#endif
 #endif
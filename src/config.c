@@ -32,6 +32,7 @@
 #include "worker.h"
 #include "filter.h"
 #include "parse_qc.h"
+#include "dupecheck.h"
 #include "tls.h"
 
 char def_cfgfile[] = "aprsc.conf";
@@ -103,6 +104,10 @@ int fork_a_daemon;	/* fork a daemon */
 int dump_splay;	/* print splay tree information */
 
 int workers_configured =  2;	/* number of workers to run */
+int dupecheck_shards_configured = 1;	/* number of dupecheck shards (threads) */
+int latency_sampling = 100;	/* every n'th packet is sampled for the latency histograms, 0: none */
+int memory_release_delay = 5 * 60;	/* empty memory blocks are given back to the system after this */
+int huge_pages = CELLMALLOC_HUGEPAGES_OFF;	/* huge pages for the memory arenas, at startup only */
 
 int expiry_interval    = 30;
 int stats_interval     = 1 * 60;
@@ -115,9 +120,6 @@ int heard_list_storetime   =     3*60*60; /* how long to store "client X has hea
 int courtesy_list_storetime   =    30*60; /* how long to store "client X has been given MSG from station Y" information,
                                            * to support courtesy position transmission after text message routing */
 
-int pbuf_global_expiration       = 60;  /* 1 minute */ /* 10 sec for load testing */
-int pbuf_global_dupe_expiration  = 60;  /* 1 minute */ /* 10 sec for load testing */
-
 int upstream_timeout      = 30;		/* after N seconds of no input from an upstream, disconnect */
 int client_timeout        = 48*60*60;	/* after N seconds of no input from a client, disconnect */
 int client_login_timeout  = 30;		/* after N seconds of no login command from a client, disconnect */
@@ -150,6 +152,7 @@ int do_peergroup(struct peerip_config_t **lq, int argc, char **argv);
 int do_uplink(struct uplink_config_t **lq, int argc, char **argv);
 int do_uplinkbind(void *new, int argc, char **argv);
 int do_logrotate(int *dest, int argc, char **argv);
+int do_hugepages(int *dest, int argc, char **argv);
 
 /*
  *	Configuration file commands
@@ -165,6 +168,10 @@ static struct cfgcmd cfg_cmds[] = {
 	{ "myemail",		_CFUNC_ do_string,	&new_myemail		},
 	{ "myadmin",		_CFUNC_ do_string,	&new_myadmin		},
 	{ "workerthreads",	_CFUNC_ do_int,		&workers_configured	},
+	{ "dupecheckthreads",	_CFUNC_ do_int,		&dupecheck_shards_configured	},
+	{ "latencysampling",	_CFUNC_ do_int,		&latency_sampling	},
+	{ "memoryreleasedelay",	_CFUNC_ do_interval,	&memory_release_delay	},
+	{ "hugepages",		_CFUNC_ do_hugepages,	&huge_pages		},
 	{ "statsinterval",	_CFUNC_ do_interval,	&stats_interval		},
 	{ "expiryinterval",	_CFUNC_ do_interval,	&expiry_interval	},
 	{ "lastpositioncache",	_CFUNC_ do_interval,	&lastposition_storetime	},
@@ -1178,6 +1185,33 @@ int do_httpupload(char *new, int argc, char **argv)
 	return do_http_listener("HTTPUpload", 1, argc, argv);
 }
 
+/*
+ *	Huge pages for the memory arenas
+ *
+ *	HugePages {off|transparent|hugetlb}
+ */
+
+int do_hugepages(int *dest, int argc, char **argv)
+{
+	if (argc != 2) {
+		hlog(LOG_ERR, "HugePages: Invalid number of arguments");
+		return -1;
+	}
+	
+	if (strcasecmp(argv[1], "off") == 0) {
+		*dest = CELLMALLOC_HUGEPAGES_OFF;
+	} else if (strcasecmp(argv[1], "transparent") == 0 || strcasecmp(argv[1], "thp") == 0) {
+		*dest = CELLMALLOC_HUGEPAGES_THP;
+	} else if (strcasecmp(argv[1], "hugetlb") == 0) {
+		*dest = CELLMALLOC_HUGEPAGES_HUGETLB;
+	} else {
+		hlog(LOG_ERR, "HugePages: Unsupported mode '%s', use off, transparent or hugetlb", argv[1]);
+		return -2;
+	}
+	
+	return 0;
+}
+
 /*
  *	Log rotation config
  */
@@ -1452,6 +1486,24 @@ int read_config(void)
 		workers_configured = 32;
 	}
 	
+	if (dupecheck_shards_configured < 1) {
+		hlog(LOG_WARNING, "Configured less than 1 dupecheck threads. Using 1.");
+		dupecheck_shards_configured = 1;
+	} else if (dupecheck_shards_configured > DUPECHECK_SHARDS_MAX) {
+		hlog(LOG_WARNING, "Configured more than %d dupecheck threads. Using %d.", DUPECHECK_SHARDS_MAX, DUPECHECK_SHARDS_MAX);
+		dupecheck_shards_configured = DUPECHECK_SHARDS_MAX;
+	}
+	
+	if (latency_sampling < 0) {
+		hlog(LOG_WARNING, "Configured a negative LatencySampling. Not sampling.");
+		latency_sampling = 0;
+	}
+	
+	if (memory_release_delay < 0) {
+		hlog(LOG_WARNING, "Configured a negative MemoryReleaseDelay. Using 0.");
+		memory_release_delay = 0;
+	}
+	
 	if (!listen_config_new) {
 		hlog(LOG_ERR, "No Listen directives found in configuration.");
 		failed = 1;
@@ -48,6 +48,18 @@
 #endif
 #endif
 
+/* the workers are woken up with an eventfd when there are new packets
+ * to send, or with a pipe if eventfd is not available
+ */
+#ifdef HAVE_SYS_EVENTFD_H
+#include <sys/eventfd.h>
+#ifdef EFD_NONBLOCK
+#ifdef EFD_CLOEXEC
+#define USE_WORKER_EVENTFD
+#endif
+#endif
+#endif
+
 /* do we use clock_gettime to get monotonic time? */
 #include <time.h>
 #ifdef HAVE_CLOCK_GETTIME
@@ -69,13 +81,14 @@ extern int dump_requests;	/* print requests */
 extern int dump_splay;		/* print splay tree information */
 
 extern int workers_configured;	/* number of workers to run */
+extern int dupecheck_shards_configured;	/* number of dupecheck shards (threads) */
+extern int latency_sampling;	/* every n'th packet is sampled for the latency histograms, 0: none */
+extern int memory_release_delay;	/* empty memory blocks are given back to the system after this */
+extern int huge_pages;		/* huge pages for the memory arenas, at startup only */
 
 extern int stats_interval;
 extern int expiry_interval;
 
-extern int pbuf_global_expiration;
-extern int pbuf_global_dupe_expiration;
-
 
 extern int obuf_size;
 extern int ibuf_size;
@@ -24,6 +24,11 @@
 #include <sys/eventfd.h>
 #endif
 
+#if defined(__GNUC__) && defined(__x86_64__)
+#define DUPECHECK_X86
+#include <immintrin.h>
+#endif
+
 #include "dupecheck.h"
 #include "config.h"
 #include "hlog.h"
@@ -37,27 +42,126 @@
 
 int dupecheck_shutting_down;
 int dupecheck_running;
+static uint32_t dupecheck_loops; /* rounds of the dupecheck thread, for dupecheck_sync() */
 pthread_t dupecheck_th;
 long dupecheck_cellgauge;
 
-int pbuf_global_count;
-int pbuf_global_dupe_count;
-
-int pbuf_global_count_limit      =   5000; /* Real criteria is expirer..		 */
-int pbuf_global_dupe_count_limit =   100; /* .. but we set some minimum packet counts
-					     into the global pbuf queue anyway.  */
-
 long long dupecheck_outcount;  /* 64 bit counters for statistics */
 long long dupecheck_dupecount;
 long long dupecheck_dupetypes[DTYPE_MAX+1];
 
-#define DUPECHECK_DB_SIZE 8192		/* Hash index table size */
-struct dupe_record_t *dupecheck_db[DUPECHECK_DB_SIZE]; /* Hash index table      */
+/* of the sampled packets, from the worker putting them in the inbox to publishing them */
+struct latency_hist_t dupecheck_publish_latency;
 
-#ifndef _FOR_VALGRIND_
-struct dupe_record_t *dupecheck_free;
-cellarena_t *dupecheck_cells;
-#endif
+#define DUPECHECK_SLAB_BITS	16
+#define DUPECHECK_SLAB_SIZE	(1 << DUPECHECK_SLAB_BITS) /* 64 kB of records in a slab */
+#define DUPECHECK_SLAB_BLOCK	2048	/* kB, arena blocks for the slabs */
+#define DUPECHECK_TABLE_MIN	4096	/* hash table slots, at least */
+#define DUPECHECK_EXPIRE_MAX	10000	/* records expired at a time */
+#define DUPECHECK_MIGRATE_INSERT 16	/* old table slots moved on an insert */
+#define DUPECHECK_MIGRATE_EXPIRE 4096	/* and on a round of expiry */
+
+/*
+ *	The dupecheck database is split in shards by the source callsign
+ *	of the packets. The mangled copies of a packet have the same source
+ *	callsign, since a callsign can only have letters, digits and dashes
+ *	in it, so a packet only needs to be checked against a single shard.
+ *
+ *	With more than one shard configured, each shard is checked by a
+ *	thread of its own. The dupecheck thread hands out the packets to the
+ *	shards, and then goes through the verdicts in the original order of
+ *	the packets, so the seqnums, the historydb and the filters see
+ *	exactly the same things as with a single shard. A single shard is
+ *	checked in the dupecheck thread itself.
+ */
+
+/*
+ *	The records of a shard are stored in a ring of slabs, in the order
+ *	they were added in, which is also the order they expire in. The
+ *	expiry drops records from the tail of the ring, a limited number at
+ *	a time, and frees a slab when it gets through it - there is no
+ *	periodic scan of the whole database.
+ *
+ *	The hash table has the hash, length and dupe type of each record
+ *	inline, and its position in the ring, so that a lookup only needs
+ *	to look at the records having a matching hash. It is an open
+ *	addressing table with linear probing, and it grows and shrinks with
+ *	the number of records, keeping it at most half full. It is resized
+ *	incrementally: the old table is kept around while its slots are
+ *	moved to the new one, a few on each insert and more on each round
+ *	of expiry, and the lookups look in both until it is empty. The
+ *	table only shrinks by half, when it is less than 1/16 full, so that
+ *	it can not go back and forth between two sizes. A record's
+ *	position in the ring is a byte offset which only grows, so a
+ *	position is never reused; the first slab is number 1, so that a
+ *	position of 0 marks an empty slot.
+ *
+ *	The mangled versions of a packet are hashed by the workers, in
+ *	dupecheck_prepare(). They get slots of their own in the table, which
+ *	point to the record of the original packet, with the way it was
+ *	mangled. The bytes of a mangled version are only made up when its
+ *	hash and length match with something it is compared with. The record
+ *	has the hashes of its mangled versions, so that their slots can be
+ *	dropped with it.
+ */
+
+struct dupecheck_slot_t {
+	uint64_t pos;		/* position of the record in the ring, 0 if empty */
+	uint32_t hash;
+	uint16_t len;
+	uint8_t  dtype;		/* dupe type given for a match */
+	uint8_t  mangle;	/* DTYPE_* the record is mangled with, 0 for none */
+};
+
+struct dupecheck_table_t {
+	struct dupecheck_slot_t *slots;
+	uint32_t size;			/* slots, a power of two */
+	int bits;
+	uint32_t count;			/* records in the table */
+};
+
+struct dupecheck_db_t {
+	struct dupecheck_table_t table;	/* hash table */
+	struct dupecheck_table_t old;	/* being moved to the table, if slots is set */
+	uint32_t migrate_pos;		/* next slot of the old table to move */
+	
+	char **slabs;			/* ring of slabs, indexed by slab number */
+	uint32_t slabs_size;		/* a power of two */
+	int slabs_max;			/* most slabs in use, for stats */
+	char *slab_spare;		/* a free slab, to avoid malloc churn */
+	uint64_t head;			/* position of the next record */
+	uint64_t tail;			/* position of the oldest record */
+};
+
+struct dupecheck_shard_t {
+	int id;
+	struct dupecheck_db_t db;
+	
+	pthread_t th;
+	pthread_mutex_t mutex;	/* protects work_count and shutting_down */
+	pthread_cond_t cond;	/* signalled when work_count changes */
+	int running;
+	int shutting_down;
+	
+	struct pbuf_t **queue;	/* being filled by the dupecheck thread */
+	int queue_count;
+	int queue_size;
+	struct pbuf_t **work;	/* being checked by the shard thread */
+	int work_count;
+	int work_size;
+};
+
+int dupecheck_shards_running = 1;
+static struct dupecheck_shard_t *dupecheck_shards[DUPECHECK_SHARDS_MAX];
+
+/* the shards tell the dupecheck thread about new verdicts with this */
+static pthread_mutex_t dupecheck_verdict_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t dupecheck_verdict_cond = PTHREAD_COND_INITIALIZER;
+
+/* pb->dupecheck_result */
+#define DUPECHECK_PENDING	0
+#define DUPECHECK_UNIQUE	1
+#define DUPECHECK_DUPE		2	/* + dupe type */
 
 
 volatile uint32_t  dupecheck_seqnum      = -2000; // Explicit early wrap-around..
@@ -68,158 +172,651 @@ int dupecheck_eventfd = -1;
 struct pollfd dupecheck_eventfd_poll;
 #endif
 
-static int pbuf_seqnum_lag(const uint32_t seqnum, const uint32_t pbuf_seq)
+/*
+ *	Reclaim the packets which all of the workers have processed, and
+ *	put the ones waiting in the backlog in the ring. This runs on every
+ *	pass of the dupecheck thread, with a budget, so that the work is
+ *	spread out evenly instead of coming in bursts. The packets go back
+ *	to the pools of the workers which allocated them, in bulk, see
+ *	pbuf_return_many(). With all set, free everything, at shutdown.
+ */
+
+#define PBUF_RECLAIM_BUDGET	2000	/* packets reclaimed from a ring on a pass */
+#define PBUF_RECLAIM_CHUNK	500
+
+struct pbuf_reclaim_stats_t pbuf_reclaim_stats;
+static int pbuf_reclaim_pending;	/* the budget ran out, come back soon */
+
+static int global_pbuf_reclaim(struct pbuf_ring_t *r, uint32_t upto, const int all)
 {
-	// The lag calculation method takes care of the value space
-	// wrap-around, thus this is not limited on on first 4 billion
-	// packets, or whatever smallish..  As long as there are less
-	// than 2 billion packets in the in-core value spaces.
+	struct pbuf_t *freeset[PBUF_RECLAIM_CHUNK];
+	uint32_t lag;
+	int budget = PBUF_RECLAIM_BUDGET;
+	int n, want, freed = 0;
+	
+	/* if the workers have passed a lot more than the budget, catch
+	 * up in a few passes, and if new packets are waiting for room in
+	 * the ring, make the room right away
+	 */
+	lag = upto - r->tail;
+	if ((int32_t)lag < 0)
+		lag = 0;
+	if (all || r->backlog)
+		budget = lag;
+	else if (lag > PBUF_RECLAIM_BUDGET * 4)
+		budget = lag / 4;
+	
+	do {
+		want = (budget - freed < PBUF_RECLAIM_CHUNK) ? budget - freed : PBUF_RECLAIM_CHUNK;
+		if (want <= 0)
+			break;
+		n = pbuf_ring_reclaim(r, upto, freeset, want);
+		if (n > 0) {
+			if (all)
+				pbuf_free_many(freeset, n);
+			else
+				pbuf_reclaim_stats.returned += pbuf_return_many(freeset, n);
+		}
+		freed += n;
+	} while (n == want);
+	
+	if (freed < (int)lag)
+		pbuf_reclaim_pending = 1;
+	
+	if (freed && r->backlog)
+		pbuf_ring_publish(r, NULL);
+	
+	pbuf_reclaim_stats.reclaimed += freed;
+	
+	return freed;
+}
 
-	int lag = (int32_t)(seqnum - pbuf_seq);
+/* how long the oldest packet in a ring has been there */
+static uint32_t global_pbuf_age(struct pbuf_ring_t *r, uint64_t now)
+{
+	struct pbuf_t *pb;
+	
+	if (r->tail == r->head)
+		return 0;
+	
+	pb = pbuf_ring_get(r, r->tail);
+	
+	return (now > pb->published) ? (now - pb->published) / 1000 : 0;
+}
 
-	if (pbuf_seq == 0)	// Worker without data.
-		lag = 2000000000;
-	// Presumption is that above mentioned situation has very short
-	// existence, but as it can happen, we flag it with such a high
-	// value that temporarily the global_pbuf_purger() will not
-	// purge any items out of the global queue.
-	return lag;
+static void global_pbuf_purger(const int all)
+{
+	struct worker_t *w;
+	uint32_t upto = pbuf_ring_head(&pbuf_global);
+	uint32_t upto_dupe = pbuf_ring_head(&pbuf_global_dupe);
+	uint32_t age, age_dupe;
+	uint64_t now;
+	int n1, n2;
+	
+	if (!all) {
+		for (w = worker_threads; (w); w = w->next) {
+			/* a worker which has just started may not have
+			 * joined yet, and it may be reading from the tail.
+			 */
+			if (!pbuf_ring_cursor_min(&w->pbuf_cursor, &upto)
+			    || !pbuf_ring_cursor_min(&w->pbuf_dupe_cursor, &upto_dupe))
+				return;
+		}
+	}
+	
+	pbuf_reclaim_pending = 0;
+	n1 = global_pbuf_reclaim(&pbuf_global, upto, all);
+	n2 = global_pbuf_reclaim(&pbuf_global_dupe, upto_dupe, all);
+	
+	now = latency_now();
+	age = global_pbuf_age(&pbuf_global, now);
+	age_dupe = global_pbuf_age(&pbuf_global_dupe, now);
+	pbuf_reclaim_stats.oldest_age_ms = (age > age_dupe) ? age : age_dupe;
+	pbuf_reclaim_stats.queue = pbuf_global.head - pbuf_global.tail;
+	pbuf_reclaim_stats.dupe_queue = pbuf_global_dupe.head - pbuf_global_dupe.tail;
+	pbuf_reclaim_stats.backlog = pbuf_global.backlog_count;
+	pbuf_reclaim_stats.dupe_backlog = pbuf_global_dupe.backlog_count;
+	
+#ifdef GLOBAL_PBUF_PURGER_STATS
+	if (n1 || n2)
+		hlog(LOG_DEBUG, "global_pbuf_purger() freed %d main pbufs, %d dupe bufs, backlogs: %d/%d",
+			n1, n2, pbuf_global.backlog_count, pbuf_global_dupe.backlog_count);
+#else
+	(void)n1;
+	(void)n2;
+#endif
+	
+	if (all) {
+		/* at shutdown, also free the packets which never got in */
+		struct pbuf_t *pb, *pbnext;
+		for (pb = pbuf_global.backlog; (pb); pb = pbnext) {
+			pbnext = pb->next;
+			pbuf_free_many(&pb, 1);
+		}
+		for (pb = pbuf_global_dupe.backlog; (pb); pb = pbnext) {
+			pbnext = pb->next;
+			pbuf_free_many(&pb, 1);
+		}
+		pbuf_global.backlog = pbuf_global_dupe.backlog = NULL;
+		pbuf_global.backlog_prevp = &pbuf_global.backlog;
+		pbuf_global_dupe.backlog_prevp = &pbuf_global_dupe.backlog;
+		pbuf_global.backlog_count = pbuf_global_dupe.backlog_count = 0;
+		
+		/* and the ones on their way back to the workers */
+		pbuf_homes_free();
+	}
 }
 
 
+
 /*
- *	Global pbuf purger cleans out pbufs that are too old..
+ *	Finding and mangling the characters packets get mangled by. The
+ *	scan tells which kinds of them a packet has, and for most packets
+ *	it has none, so it is done with SSE2 or AVX2 on x86-64, as selected
+ *	at startup by dupecheck_init(). The mangle kernels do the same with
+ *	the packets having some: replacing characters is done 16 or 32 bytes
+ *	at a time, and stripping them copies a block as it is, if there is
+ *	nothing to strip in it. The AVX2 kernel compacts the blocks having
+ *	something to strip with a byte shuffle, 8 bytes at a time. All of
+ *	the kernels give exactly the same results as the scalar ones.
  */
-static void global_pbuf_purger(const int all, int pbuf_lag, int pbuf_dupe_lag)
+
+static inline int dupecheck_strips(int dtype)
 {
-	struct pbuf_t *pb, *pb2;
-	struct pbuf_t *freeset[2002];
-	int n, n1, n2, lag;
+	return dtype == DTYPE_STRIP_8BIT || dtype == DTYPE_LOWDATA_STRIP || dtype == DTYPE_DEL_STRIP;
+}
 
-	time_t expire2 = tick - pbuf_global_dupe_expiration;
-	time_t expire1 = tick - pbuf_global_expiration;
+static int dupecheck_scan_scalar(const char *s, int len)
+{
+	unsigned char c;
+	int i, have = 0;
+	
+	for (i = 0; i < len; i++) {
+		c = s[i];
+		if (c & 0x80)
+			have |= DUPECHECK_HAVE_8BIT;
+		else if (c == 0x7f)
+			have |= DUPECHECK_HAVE_DEL;
+		else if (c < 0x20 && c > 0)
+			have |= DUPECHECK_HAVE_LOW;
+	}
+	
+	return have;
+}
 
-	if (all) {
-		pbuf_global_count_limit       = 0;
-		pbuf_global_dupe_count_limit  = 0;
-		expire1  = expire2       = tick+10;
+static int dupecheck_mangle_scalar(const char *s, int len, int dtype, char *out)
+{
+	unsigned char c;
+	int i, n = 0;
+	
+	for (i = 0; i < len; i++) {
+		c = s[i];
+		switch (dtype) {
+		case DTYPE_STRIP_8BIT:		/* 8th bit data deleted */
+			if (c & 0x80)
+				continue;
+			break;
+		case DTYPE_CLEAR_8BIT:		/* 8th bit is cleared */
+			c &= 0x7f;
+			break;
+		case DTYPE_SPACED_8BIT:		/* 8th bit replaced with a space */
+			if (c & 0x80)
+				c = ' ';
+			break;
+		case DTYPE_LOWDATA_STRIP:	/* low data (0 < x < 0x20) deleted */
+			if (c > 0 && c < 0x20)
+				continue;
+			break;
+		case DTYPE_LOWDATA_SPACED:	/* low data replaced with spaces */
+			if (c > 0 && c < 0x20)
+				c = ' ';
+			break;
+		case DTYPE_DEL_STRIP:		/* DEL characters (0x7f) deleted */
+			if (c == 0x7f)
+				continue;
+			break;
+		case DTYPE_DEL_SPACED:		/* DEL characters replaced with spaces */
+			if (c == 0x7f)
+				c = ' ';
+			break;
+		}
+		out[n++] = c;
+	}
+	
+	return n;
+}
+
+#ifdef DUPECHECK_X86
+
+/* the bytes of v which are mangled with dtype */
+static inline __m128i dupecheck_hits_sse2(__m128i v, int dtype)
+{
+	switch (dtype) {
+	case DTYPE_STRIP_8BIT:
+	case DTYPE_CLEAR_8BIT:
+	case DTYPE_SPACED_8BIT:
+		return _mm_cmplt_epi8(v, _mm_setzero_si128());
+	case DTYPE_LOWDATA_STRIP:
+	case DTYPE_LOWDATA_SPACED:
+		return _mm_and_si128(_mm_cmpgt_epi8(v, _mm_setzero_si128()), _mm_cmplt_epi8(v, _mm_set1_epi8(0x20)));
+	default:
+		return _mm_cmpeq_epi8(v, _mm_set1_epi8(0x7f));
 	}
+}
 
-	pb = pbuf_global;
+/* the 16-byte versions are inlined in the AVX2 kernels too, so that they
+ * are VEX-encoded there, and there are no transitions between SSE and AVX
+ */
+static inline __attribute__((always_inline)) int dupecheck_scan16(const char *s, int len)
+{
+	__m128i zero = _mm_setzero_si128();
+	__m128i hi = zero, low = zero, del = zero, v;
+	int i;
+	
+	if (len < 16)
+		return dupecheck_scan_scalar(s, len);
+	
+	/* the last block overlaps the previous one, which does no harm */
+	for (i = 0; i < len; i += 16) {
+		v = _mm_loadu_si128((const __m128i *)(s + ((i + 16 <= len) ? i : len - 16)));
+		hi = _mm_or_si128(hi, v);
+		low = _mm_or_si128(low, _mm_and_si128(_mm_cmpgt_epi8(v, zero), _mm_cmplt_epi8(v, _mm_set1_epi8(0x20))));
+		del = _mm_or_si128(del, _mm_cmpeq_epi8(v, _mm_set1_epi8(0x7f)));
+	}
+	
+	return ((_mm_movemask_epi8(hi)) ? DUPECHECK_HAVE_8BIT : 0)
+		| ((_mm_movemask_epi8(low)) ? DUPECHECK_HAVE_LOW : 0)
+		| ((_mm_movemask_epi8(del)) ? DUPECHECK_HAVE_DEL : 0);
+}
 
-#ifdef GLOBAL_PBUF_PURGER_STATS
-	time_t lastage1 = 0, lastage2 = 0;
-	if (pb)
-		lastage1 = pb->t;
-#endif
+static int dupecheck_scan_sse2(const char *s, int len)
+{
+	return dupecheck_scan16(s, len);
+}
 
-	n = 0;
-	n1 = 0;
-	while ( pbuf_global_count > pbuf_global_count_limit && pb ) {
+/* copy the bytes of a block which do not have their bit set in the mask */
+static inline int dupecheck_strip_block(const char *s, int len, uint32_t mask, char *out)
+{
+	int i, n = 0;
+	
+	for (i = 0; i < len; i++)
+		if (!(mask & (1U << i)))
+			out[n++] = s[i];
+	
+	return n;
+}
 
-#ifdef GLOBAL_PBUF_PURGER_STATS
-		lastage1 = pb->t;
-#endif
-		if (pb->t >= expire1)
-			break; // stop at newer than expire1
-			
-		lag = pbuf_seqnum_lag(dupecheck_seqnum, pb->seqnum);
-		if (pbuf_lag >= lag) {
-			hlog(LOG_DEBUG, "global_pbuf_purger: stop at lag %d, dupecheck at %d, pb %d", lag, dupecheck_seqnum, pb->seqnum);
-			break; // some output-worker is lagging behind this item!
-		}
-		
-		freeset[n++] = pb;
-		++n1;
-		--pbuf_global_count;
-		// dissociate the pbuf from the chain
-		pb2 = pb->next; pb->next = NULL; pb = pb2;
-		if (n >= 2000) {
-			pbuf_free_many(freeset, n);
-			n = 0;
+static inline __attribute__((always_inline)) int dupecheck_mangle16(const char *s, int len, int dtype, char *out)
+{
+	__m128i v, hit;
+	uint32_t mask;
+	int i, n = 0;
+	
+	for (i = 0; i + 16 <= len; i += 16) {
+		v = _mm_loadu_si128((const __m128i *)(s + i));
+		hit = dupecheck_hits_sse2(v, dtype);
+		if (dupecheck_strips(dtype)) {
+			if ((mask = _mm_movemask_epi8(hit))) {
+				n += dupecheck_strip_block(s + i, 16, mask, out + n);
+				continue;
+			}
+		} else if (dtype == DTYPE_CLEAR_8BIT) {
+			v = _mm_and_si128(v, _mm_set1_epi8(0x7f));
+		} else {
+			v = _mm_or_si128(_mm_andnot_si128(hit, v), _mm_and_si128(hit, _mm_set1_epi8(' ')));
 		}
+		_mm_storeu_si128((__m128i *)(out + n), v);
+		n += 16;
+	}
+	
+	return n + dupecheck_mangle_scalar(s + i, len - i, dtype, out + n);
+}
+
+static int dupecheck_mangle_sse2(const char *s, int len, int dtype, char *out)
+{
+	return dupecheck_mangle16(s, len, dtype, out);
+}
+
+/* the shuffles which move the bytes to keep, by a mask of them, to the
+ * beginning of an 8-byte group
+ */
+static uint8_t dupecheck_compact_lut[256][16] __attribute__((aligned(16)));
+
+static void dupecheck_compact_lut_init(void)
+{
+	int m, i, n;
+	
+	for (m = 0; m < 256; m++) {
+		memset(dupecheck_compact_lut[m], 0x80, sizeof(dupecheck_compact_lut[m]));
+		for (i = n = 0; i < 8; i++)
+			if (m & (1 << i))
+				dupecheck_compact_lut[m][n++] = i;
 	}
-	pbuf_global = pb;
-	if (n > 0) {
-		pbuf_free_many(freeset, n);
+}
+
+__attribute__((target("avx2")))
+static inline __m256i dupecheck_hits_avx2(__m256i v, int dtype)
+{
+	switch (dtype) {
+	case DTYPE_STRIP_8BIT:
+	case DTYPE_CLEAR_8BIT:
+	case DTYPE_SPACED_8BIT:
+		return _mm256_cmpgt_epi8(_mm256_setzero_si256(), v);
+	case DTYPE_LOWDATA_STRIP:
+	case DTYPE_LOWDATA_SPACED:
+		return _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_setzero_si256()),
+			_mm256_cmpgt_epi8(_mm256_set1_epi8(0x20), v));
+	default:
+		return _mm256_cmpeq_epi8(v, _mm256_set1_epi8(0x7f));
 	}
+}
 
-	pb = pbuf_global_dupe;
-#ifdef GLOBAL_PBUF_PURGER_STATS
-	if (pb)
-		lastage2 = pb->t;
-#endif
-	n = 0;
-	n2 = 0;
-	while ( pbuf_global_dupe_count > pbuf_global_dupe_count_limit && pb ) {
-#ifdef GLOBAL_PBUF_PURGER_STATS
-		lastage2 = pb->t;
-#endif
-		if (pb->t >= expire2)
-			break; // stop at newer than expire2
-		lag = pbuf_seqnum_lag(dupecheck_dupe_seqnum, pb->seqnum);
-		if (pbuf_dupe_lag >= lag) {
-			hlog(LOG_DEBUG, "global_pbuf_purger: dupe stop at lag %d, dupecheck at %d, pb %d", lag, dupecheck_seqnum, pb->seqnum);
-			break; // some output-worker is lagging behind this item!
-		}
-		
-		freeset[n++] = pb;
-		++n2;
-		--pbuf_global_dupe_count;
-		// dissociate the pbuf from the chain
-		pb2 = pb->next; pb->next = NULL; pb = pb2;
-		if (n >= 2000) {
-			pbuf_free_many(freeset, n);
-			n = 0;
-		}
+__attribute__((target("avx2")))
+static int dupecheck_scan_avx2(const char *s, int len)
+{
+	__m256i zero = _mm256_setzero_si256();
+	__m256i hi = zero, low = zero, del = zero, v;
+	int i;
+	
+	if (len < 32)
+		return dupecheck_scan16(s, len);
+	
+	for (i = 0; i < len; i += 32) {
+		v = _mm256_loadu_si256((const __m256i *)(s + ((i + 32 <= len) ? i : len - 32)));
+		hi = _mm256_or_si256(hi, v);
+		low = _mm256_or_si256(low, _mm256_and_si256(_mm256_cmpgt_epi8(v, zero),
+			_mm256_cmpgt_epi8(_mm256_set1_epi8(0x20), v)));
+		del = _mm256_or_si256(del, _mm256_cmpeq_epi8(v, _mm256_set1_epi8(0x7f)));
 	}
-	pbuf_global_dupe = pb;
-	if (n > 0) {
-		pbuf_free_many(freeset, n);
+	
+	return ((_mm256_movemask_epi8(hi)) ? DUPECHECK_HAVE_8BIT : 0)
+		| ((_mm256_movemask_epi8(low)) ? DUPECHECK_HAVE_LOW : 0)
+		| ((_mm256_movemask_epi8(del)) ? DUPECHECK_HAVE_DEL : 0);
+}
+
+__attribute__((target("avx2")))
+static int dupecheck_mangle_avx2(const char *s, int len, int dtype, char *out)
+{
+	__m256i v, hit;
+	__m128i g;
+	uint32_t mask, keep;
+	int i, j, n = 0;
+	
+	for (i = 0; i + 32 <= len; i += 32) {
+		v = _mm256_loadu_si256((const __m256i *)(s + i));
+		hit = dupecheck_hits_avx2(v, dtype);
+		if (dupecheck_strips(dtype)) {
+			if ((mask = _mm256_movemask_epi8(hit))) {
+				for (j = 0; j < 32; j += 8) {
+					keep = ~(mask >> j) & 0xff;
+					g = _mm_loadl_epi64((const __m128i *)(s + i + j));
+					g = _mm_shuffle_epi8(g, _mm_load_si128((const __m128i *)dupecheck_compact_lut[keep]));
+					_mm_storel_epi64((__m128i *)(out + n), g);
+					n += __builtin_popcount(keep);
+				}
+				continue;
+			}
+		} else if (dtype == DTYPE_CLEAR_8BIT) {
+			v = _mm256_and_si256(v, _mm256_set1_epi8(0x7f));
+		} else {
+			v = _mm256_blendv_epi8(v, _mm256_set1_epi8(' '), hit);
+		}
+		_mm256_storeu_si256((__m256i *)(out + n), v);
+		n += 32;
 	}
+	
+	return n + dupecheck_mangle16(s + i, len - i, dtype, out + n);
+}
 
-#ifdef GLOBAL_PBUF_PURGER_STATS
-	// debug printout time...  map "undefined" lag values to zero.
+#endif
 
-	if (pbuf_lag      == 2000000000) pbuf_lag      = 0;
-	if (pbuf_dupe_lag == 2000000000) pbuf_dupe_lag = 0;
-	if (lastage1 == 0) lastage1 = tick+2; // makes printout of "-2" (or "-1")
-	if (lastage2 == 0) lastage2 = tick+2;
+static struct dupecheck_kernel_t dupecheck_kernel_list[4] = {
+	{ "scalar", dupecheck_scan_scalar, dupecheck_mangle_scalar }
+};
+const struct dupecheck_kernel_t *dupecheck_kernel = &dupecheck_kernel_list[0];
 
-	static int show_zeros = 1;
+const struct dupecheck_kernel_t *dupecheck_kernels(void)
+{
+	return dupecheck_kernel_list;
+}
 
-	if (show_zeros || n1 || n2 || pbuf_lag  || pbuf_dupe_lag) {
-		// report only when there is something to report...
-		hlog( LOG_DEBUG,
-		      "global_pbuf_purger()  freed %d/%d main pbufs, %d/%d dupe bufs, lags: %d/%d  Ages: %d/%d",
-		      n1, pbuf_global_count, n2, pbuf_global_dupe_count,
-		      pbuf_lag, pbuf_dupe_lag,
-		      (int)(tick-lastage1), (int)(tick-lastage2) );
+/*
+ *	Find the kernels supported by the CPU, and pick the widest one
+ */
 
-		if (!(n1 || n2 || pbuf_lag || pbuf_dupe_lag))
-			show_zeros = 0;
-		else
-			show_zeros = 1;
+static void dupecheck_kernel_init(void)
+{
+	int n = 1;
+	
+#ifdef DUPECHECK_X86
+	dupecheck_compact_lut_init();
+	
+	dupecheck_kernel_list[n].name = "sse2";
+	dupecheck_kernel_list[n].scan = dupecheck_scan_sse2;
+	dupecheck_kernel_list[n++].mangle = dupecheck_mangle_sse2;
+	
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) {
+		dupecheck_kernel_list[n].name = "avx2";
+		dupecheck_kernel_list[n].scan = dupecheck_scan_avx2;
+		dupecheck_kernel_list[n++].mangle = dupecheck_mangle_avx2;
 	}
 #endif
+	
+	dupecheck_kernel_list[n].name = NULL;
+	dupecheck_kernel = &dupecheck_kernel_list[n - 1];
+	
+	hlog(LOG_DEBUG, "dupecheck: using %s kernel", dupecheck_kernel->name);
 }
 
+/*
+ *	Mangle a packet in one of the common ways, returns the new length
+ */
+
+static int dupecheck_mangle(const char *s, int len, int dtype, char *out)
+{
+	if (dtype == DTYPE_SPACE_TRIM) {
+		/* remove spaces from the end of the packet */
+		while (len > 0 && s[len-1] == ' ')
+			len--;
+		memcpy(out, s, len);
+		return len;
+	}
+	
+	return dupecheck_kernel->mangle(s, len, dtype, out);
+}
 
+static void dupecheck_prepare_variant(struct pbuf_t *pb, const char *ib, int ilen, int dtype)
+{
+	struct pbuf_dupe_variant_t *v = &pb->dupe_variant[pb->dupe_variant_count++];
+	char tb[PACKETLEN_MAX];
+	
+	v->len = dupecheck_mangle(ib, ilen, dtype, tb);
+	v->hash = keyhash(tb, v->len, 0);
+	v->dtype = dtype;
+	v->pad = 0;
+}
 
 /*
- *	The cellmalloc does not need internal MUTEX, it is being used in single thread..
+ *	Hash a packet, and the versions of it mangled in the common ways,
+ *	so that the mangled versions can be dropped, too. This is called
+ *	by the workers for each packet they send to the dupecheck, so that
+ *	the dupecheck thread does not need to.
  */
 
-void dupecheck_init(void)
+void dupecheck_prepare(struct pbuf_t *pb)
+{
+	char ib[PACKETLEN_MAX];
+	const char *addr, *data;
+	int addrlen, datalen, ilen;
+	int have, have_space;
+	
+	// the canonic rep of the packet, without the path and the CRLF
+	addr    = pb->data;
+	addrlen = pb->dstcall_end_or_ssid - addr;
+	data    = pb->info_start;
+	datalen = pb->packet_len - (data - pb->data) - 2;
+	
+	pb->dupe_variant_count = 0;
+	ilen = addrlen + datalen;
+	if (ilen > PACKETLEN_MAX) {
+		/* too long to be a mangled version of anything, or to be
+		 * mangled, calculate checksum from disjoint memory areas
+		 */
+		pb->dupe_hash = keyhash(addr, addrlen, 0);
+		pb->dupe_hash = keyhash(data, datalen, pb->dupe_hash);
+		return;
+	}
+	
+	/* the hash of a mangled version of a packet must be the same
+	 * as the hash of a packet looking the same, so the packet is
+	 * hashed in one piece, too
+	 */
+	memcpy(ib, addr, addrlen);
+	memcpy(ib + addrlen, data, datalen);
+	pb->dupe_hash = keyhash(ib, ilen, 0);
+	
+	/* most packets do not need any mangling */
+	have = dupecheck_kernel->scan(ib, ilen);
+	have_space = (ilen && ib[ilen-1] == ' ');
+	if (!have && !have_space)
+		return;
+	
+	if (have_space)
+		dupecheck_prepare_variant(pb, ib, ilen, DTYPE_SPACE_TRIM);
+	
+	if (have & DUPECHECK_HAVE_8BIT) {
+		dupecheck_prepare_variant(pb, ib, ilen, DTYPE_STRIP_8BIT);
+		dupecheck_prepare_variant(pb, ib, ilen, DTYPE_CLEAR_8BIT);
+		dupecheck_prepare_variant(pb, ib, ilen, DTYPE_SPACED_8BIT);
+	}
+	
+	if (have & DUPECHECK_HAVE_LOW) {
+		dupecheck_prepare_variant(pb, ib, ilen, DTYPE_LOWDATA_STRIP);
+		dupecheck_prepare_variant(pb, ib, ilen, DTYPE_LOWDATA_SPACED);
+	}
+	
+	if (have & DUPECHECK_HAVE_DEL) {
+		dupecheck_prepare_variant(pb, ib, ilen, DTYPE_DEL_STRIP);
+		dupecheck_prepare_variant(pb, ib, ilen, DTYPE_DEL_SPACED);
+	}
+}
+
+/*
+ *	The database of a shard is only ever touched by a single thread at
+ *	a time, so it does not need any locking of its own.
+ *
+ *	The slabs of all shards come from a single arena, which may be
+ *	backed by huge pages, since the lookups hop around all of them.
+ */
+
+#ifndef _FOR_VALGRIND_
+static cellarena_t *dupecheck_slab_cells;
+#endif
+
+static char *dupecheck_slab_alloc(void)
+{
+#ifndef _FOR_VALGRIND_
+	char *slab = cellmalloc(dupecheck_slab_cells);
+	
+	if (!slab) {
+		hlog(LOG_CRIT, "dupecheck: Out of memory! Could not allocate a slab.");
+		exit(1);
+	}
+	
+	return slab;
+#else
+	return hmalloc(DUPECHECK_SLAB_SIZE);
+#endif
+}
+
+static void dupecheck_slab_release(char *slab)
 {
+	if (!slab)
+		return;
 #ifndef _FOR_VALGRIND_
-	dupecheck_cells = cellinit( "dupecheck",
-				    sizeof(struct dupe_record_t),
-				    __alignof__(struct dupe_record_t),
-				    CELLMALLOC_POLICY_LIFO | CELLMALLOC_POLICY_NOMUTEX,
-				    2048 /* 2 MB at the time */,
-				    0 /* minfree */);
+	cellfree(dupecheck_slab_cells, slab);
+#else
+	hfree(slab);
 #endif
+}
+
+static void dupecheck_table_alloc(struct dupecheck_table_t *t, int bits)
+{
+	t->bits = bits;
+	t->size = 1 << bits;
+	t->count = 0;
+	/* not memset, so that the pages are zeroed as the slots are
+	 * moved in, instead of all at once
+	 */
+	t->slots = hcalloc(t->size, sizeof(*t->slots));
+}
+
+static void dupecheck_db_init(struct dupecheck_db_t *db)
+{
+	int bits = 0;
+	
+	memset(db, 0, sizeof(*db));
+	
+#ifndef _FOR_VALGRIND_
+	/* first called by dupecheck_init(), before the threads are running */
+	if (!dupecheck_slab_cells)
+		dupecheck_slab_cells = cellinit( "dupecheck",
+						 DUPECHECK_SLAB_SIZE, 16,
+						 CELLMALLOC_POLICY_FIFO | CELLMALLOC_POLICY_HUGEPAGES,
+						 DUPECHECK_SLAB_BLOCK, 0 /* minfree */ );
+#endif
+	
+	while ((1 << bits) < DUPECHECK_TABLE_MIN)
+		bits++;
+	dupecheck_table_alloc(&db->table, bits);
+	
+	/* the first slab is number 1, so that no record is at position 0 */
+	db->slabs_size = 16;
+	db->slabs = hmalloc(sizeof(*db->slabs) * db->slabs_size);
+	memset(db->slabs, 0, sizeof(*db->slabs) * db->slabs_size);
+	db->head = db->tail = DUPECHECK_SLAB_SIZE;
+	db->slabs[1] = dupecheck_slab_alloc();
+	db->slabs_max = 1;
+}
+
+static void dupecheck_db_free(struct dupecheck_db_t *db)
+{
+	uint64_t s;
+	
+	for (s = db->tail >> DUPECHECK_SLAB_BITS; s <= db->head >> DUPECHECK_SLAB_BITS; s++)
+		dupecheck_slab_release(db->slabs[s & (db->slabs_size - 1)]);
+	dupecheck_slab_release(db->slab_spare);
+	hfree(db->slabs);
+	hfree(db->table.slots);
+	hfree(db->old.slots);
+}
+
+/* the shards are never freed, so that the status thread may look at them */
+static struct dupecheck_shard_t *dupecheck_shard_alloc(int id)
+{
+	struct dupecheck_shard_t *sh;
+	
+	sh = hmalloc(sizeof(*sh));
+	memset(sh, 0, sizeof(*sh));
+	sh->id = id;
+	dupecheck_db_init(&sh->db);
+	
+	pthread_mutex_init(&sh->mutex, NULL);
+	pthread_cond_init(&sh->cond, NULL);
+	
+	return sh;
+}
+
+void dupecheck_init(void)
+{
+	dupecheck_kernel_init();
+	
+	dupecheck_shards[0] = dupecheck_shard_alloc(0);
+
+	/* the global packet queues start from the next seqnums */
+	pbuf_ring_init(&pbuf_global, PBUF_GLOBAL_RING_SIZE, dupecheck_seqnum + 1);
+	pbuf_ring_init(&pbuf_global_dupe, PBUF_GLOBAL_DUPE_RING_SIZE, dupecheck_dupe_seqnum + 1);
 
 #ifdef USE_EVENTFD
 	dupecheck_eventfd = eventfd(0, EFD_NONBLOCK|EFD_CLOEXEC);
@@ -234,312 +831,472 @@ void dupecheck_init(void)
 
 }
 
-static struct dupe_record_t *dupecheck_db_alloc(int len)
+/*
+ *	The ring of slabs
+ */
+
+static inline struct dupe_record_t *dupecheck_record(struct dupecheck_db_t *db, uint64_t pos)
+{
+	return (struct dupe_record_t *)(db->slabs[(pos >> DUPECHECK_SLAB_BITS) & (db->slabs_size - 1)]
+		+ (pos & (DUPECHECK_SLAB_SIZE - 1)));
+}
+
+/* start a new slab at the head of the ring */
+static void dupecheck_slab_add(struct dupecheck_db_t *db)
+{
+	uint64_t first = db->tail >> DUPECHECK_SLAB_BITS;
+	uint64_t slab = (db->head >> DUPECHECK_SLAB_BITS) + 1;
+	char **slabs;
+	uint32_t size;
+	uint64_t s;
+	
+	if (slab - first >= db->slabs_size) {
+		size = db->slabs_size * 2;
+		slabs = hmalloc(sizeof(*slabs) * size);
+		for (s = first; s < slab; s++)
+			slabs[s & (size - 1)] = db->slabs[s & (db->slabs_size - 1)];
+		hfree(db->slabs);
+		db->slabs = slabs;
+		db->slabs_size = size;
+	}
+	
+	if (db->slab_spare) {
+		db->slabs[slab & (db->slabs_size - 1)] = db->slab_spare;
+		db->slab_spare = NULL;
+	} else {
+		db->slabs[slab & (db->slabs_size - 1)] = dupecheck_slab_alloc();
+	}
+	
+	db->head = slab << DUPECHECK_SLAB_BITS;
+	if (slab - first + 1 > db->slabs_max)
+		db->slabs_max = slab - first + 1;
+}
+
+/* the tail has passed a slab, free it */
+static void dupecheck_slab_free(struct dupecheck_db_t *db, uint64_t slab)
+{
+	char **sp = &db->slabs[slab & (db->slabs_size - 1)];
+	
+	if (db->slab_spare)
+		dupecheck_slab_release(*sp);
+	else
+		db->slab_spare = *sp;
+	*sp = NULL;
+}
+
+/*
+ *	Append a record at the head of the ring. A record never ends right at
+ *	the end of a slab, so there is always room for the end marker.
+ */
+
+static struct dupe_record_t *dupecheck_ring_append(struct dupecheck_db_t *db, uint32_t hash, int len, int variants, time_t t, uint64_t *pos)
 {
 	struct dupe_record_t *dp;
-#ifndef _FOR_VALGRIND_
-	if (dupecheck_free) { /* pick from free chain */
-		dp = dupecheck_free;
-		dupecheck_free = dp->next;
-	} else
-		dp = cellmalloc(dupecheck_cells);
-	if (!dp) {
-		hlog(LOG_ERR, "dupecheck: cellmalloc failed");
-		return NULL;
+	int size = DUPECHECK_RECORD_SIZE(len, variants);
+	
+	if ((db->head & (DUPECHECK_SLAB_SIZE - 1)) + size >= DUPECHECK_SLAB_SIZE) {
+		dp = dupecheck_record(db, db->head);
+		dp->len = 0;
+		dupecheck_slab_add(db);
 	}
-#else
-	dp = hmalloc(len + sizeof(*dp));
-#endif
-	memset(dp, 0, sizeof(*dp));
+	
+	*pos = db->head;
+	dp = dupecheck_record(db, db->head);
+	db->head += size;
+	
+	dp->t = t;
+	dp->hash = hash;
 	dp->len = len;
-	dp->packet = dp->packetbuf;
-	if (len > sizeof(dp->packetbuf))
-		dp->packet = hmalloc(len+1);
+	dp->variant_count = variants;
+	
+	return dp;
+}
 
-	++dupecheck_cellgauge;
+/*
+ *	The hash table
+ */
 
-	return dp;
+static inline uint32_t dupecheck_table_idx(const struct dupecheck_table_t *t, uint32_t hash)
+{
+	/* the keyhash bits are not quite even, mix them up */
+	return (hash * 0x9E3779B1U) >> (32 - t->bits);
 }
 
-static void dupecheck_db_free(struct dupe_record_t *dp)
+static inline uint32_t dupecheck_table_records(const struct dupecheck_db_t *db)
 {
-	if (dp->packet != dp->packetbuf)
-		hfree(dp->packet);
-#ifndef _FOR_VALGRIND_
-	dp->next = dupecheck_free;
-	dupecheck_free = dp;
-	// cellfree(dupecheck_cells, dp);
-#else
-	hfree(dp);
-#endif
-	--dupecheck_cellgauge;
+	return db->table.count + db->old.count;
+}
+
+/* put a slot in a table which does not have it yet */
+static void dupecheck_table_put(struct dupecheck_table_t *t, const struct dupecheck_slot_t *slot)
+{
+	uint32_t j;
+	
+	for (j = dupecheck_table_idx(t, slot->hash); t->slots[j].pos; j = (j + 1) & (t->size - 1))
+		;
+	t->slots[j] = *slot;
+	t->count++;
+}
+
+/*
+ *	Empty the slot at i. The slots after it are shifted back, so that
+ *	there is no need for tombstones.
+ */
+
+static void dupecheck_table_delete(struct dupecheck_table_t *t, uint32_t i)
+{
+	uint32_t mask = t->size - 1;
+	uint32_t j, k;
+	
+	for (j = (i + 1) & mask; t->slots[j].pos; j = (j + 1) & mask) {
+		k = dupecheck_table_idx(t, t->slots[j].hash);
+		/* move the slot at j to the hole at i, unless it belongs
+		 * cyclically in (i, j]
+		 */
+		if ((i <= j) ? (k <= i || k > j) : (k <= i && k > j)) {
+			t->slots[i] = t->slots[j];
+			i = j;
+		}
+	}
+	
+	t->slots[i].pos = 0;
+	t->count--;
+}
+
+/*
+ *	Move up to n slots of the old table to the new one, and free the
+ *	old table when it is empty. The slots before migrate_pos have been
+ *	moved, and nothing is shifted back over them, since the old table
+ *	only loses slots: a slot shifted back in the hole left at
+ *	migrate_pos is moved on the next round.
+ */
+
+static void dupecheck_table_migrate(struct dupecheck_db_t *db, uint32_t n)
+{
+	struct dupecheck_table_t *old = &db->old;
+	
+	if (!old->slots)
+		return;
+	
+	while (old->count && db->migrate_pos < old->size && n-- > 0) {
+		if (!old->slots[db->migrate_pos].pos) {
+			db->migrate_pos++;
+			continue;
+		}
+		dupecheck_table_put(&db->table, &old->slots[db->migrate_pos]);
+		dupecheck_table_delete(old, db->migrate_pos);
+	}
+	
+	if (!old->count) {
+		hfree(old->slots);
+		old->slots = NULL;
+	}
+}
+
+/* start moving the slots to a new table of 2^bits slots */
+static void dupecheck_table_resize(struct dupecheck_db_t *db, int bits)
+{
+	/* only one resize at a time - the steps are big enough that
+	 * the last one is done long before the next one is due
+	 */
+	dupecheck_table_migrate(db, UINT32_MAX);
+	
+	db->old = db->table;
+	db->migrate_pos = 0;
+	dupecheck_table_alloc(&db->table, bits);
+	dupecheck_table_migrate(db, 0);
 }
 
-/*	The  dupecheck_cleanup() is for regular database cleanups,
- *	Call this about once a minute.
- *
- *	Note: entry validity is possibly shorter time than the cleanup
- *	invocation interval!
+/*
+ *	Compare the contents of a slot, having a matching hash and length,
+ *	with a packet in two parts. A mangled version of a record is made
+ *	up here, only when it is needed.
  */
-static void dupecheck_cleanup(void)
+
+static int dupecheck_slot_match(struct dupecheck_db_t *db, struct dupecheck_slot_t *slot,
+	const char *a, int alen, const char *b, int blen)
 {
-	struct dupe_record_t *dp, **dpp;
-	time_t expiretime = tick - dupefilter_storetime;
-	time_t futuretime = tick + dupefilter_storetime;
-	int cleancount = 0, i;
-
-	for (i = 0; i < DUPECHECK_DB_SIZE; ++i) {
-		dpp = & dupecheck_db[i];
-		while (( dp = *dpp )) {
-			if (dp->t < expiretime || dp->t > futuretime) {
-				/* Old... or too far in the future, discard. */
-				*dpp = dp->next;
-				dp->next = NULL;
-				dupecheck_db_free(dp);
-				++cleancount;
-				continue;
-			}
-			/* No expiry, just advance the pointer */
-			dpp = &dp->next;
-		}
+	struct dupe_record_t *dp = dupecheck_record(db, slot->pos);
+	const char *s = dupe_record_packet(dp);
+	char mb[PACKETLEN_MAX];
+	
+	if (slot->mangle) {
+		dupecheck_mangle(s, dp->len, slot->mangle, mb);
+		s = mb;
 	}
-	// hlog( LOG_DEBUG, "dupecheck_cleanup() removed %d entries, count now %ld",
-	//       cleancount, dupecheck_cellgauge );
+	
+	return memcmp(a, s, alen) == 0 && memcmp(b, s + alen, blen) == 0;
 }
 
 /*
- *	Append a dupecheck record in a leaf list of the hash
+ *	Find the slot of a record with the given contents, which may be in
+ *	two parts. If there is none, returns the empty slot where it would go.
  */
 
-static int dupecheck_append(struct dupe_record_t **dpp, uint32_t hash, int addrlen, const char *addr, int datalen, const char *data)
+static struct dupecheck_slot_t *dupecheck_table_find_in(struct dupecheck_db_t *db, struct dupecheck_table_t *t,
+	uint32_t hash, const char *a, int alen, const char *b, int blen)
 {
-	struct dupe_record_t *dp;
+	struct dupecheck_slot_t *slot;
+	uint32_t mask = t->size - 1;
+	uint32_t i;
 	
-	dp = dupecheck_db_alloc(addrlen + datalen);
-	if (!dp)
-		return -1; // alloc error!
+	for (i = dupecheck_table_idx(t, hash); (slot = &t->slots[i])->pos; i = (i + 1) & mask) {
+		if (slot->hash == hash && slot->len == alen + blen
+		    && dupecheck_slot_match(db, slot, a, alen, b, blen))
+			return slot;
+	}
 	
-	*dpp = dp;
-	memcpy(dp->packet, addr, addrlen);
-	memcpy(dp->packet + addrlen, data, datalen);
-	//hlog(LOG_DEBUG, "dupecheck_append '%.*s'", addrlen+datalen, dp->packet);
-	dp->hash = hash;
-	dp->t   = tick; /* Use the current timestamp instead of the arrival time.
-			  If our incoming worker, or dupecheck, is lagging for
-			  reason or another (for example, a huge incoming burst
-			  of traffic), using the arrival time instead of current
-			  time could make the dupecheck db entry expire too early.
-			  In an extreme trouble case, we could expire dupecheck db
-			  entries very soon after the packet has gone out from us,
-			  which would make loops more likely and possibly increase
-			  the traffic and make us lag even more.
-			  This timestamp should be closer to the *outgoing* time
-			  than the *incoming* time, and current timestamp is a
-			  good middle ground. Simulator is not important.
-			*/
-	return 0;
+	return slot;
 }
 
-static int dupecheck_add_buf(const char *s, int len, int dtype)
+static struct dupecheck_slot_t *dupecheck_table_find(struct dupecheck_db_t *db, uint32_t hash,
+	const char *a, int alen, const char *b, int blen)
 {
-	uint32_t hash, idx;
-	struct dupe_record_t **dpp, *dp;
+	struct dupecheck_slot_t *slot, *old;
+	
+	slot = dupecheck_table_find_in(db, &db->table, hash, a, alen, b, blen);
 	
-	//hlog(LOG_DEBUG, "dupecheck_add_buf '%.*s'", len, s);
+	/* during a resize, the record may not have been moved yet */
+	if (!slot->pos && db->old.slots
+	    && (old = dupecheck_table_find_in(db, &db->old, hash, a, alen, b, blen))->pos)
+		return old;
 	
-	hash = keyhash(s, len, 0);
-	idx  = hash;
+	return slot;
+}
+
+/*
+ *	Find the slot of a mangled version of a packet. The mangled version
+ *	is made up only if there is something with the same hash and length.
+ */
 
-	idx ^= (idx >> 13); /* fold the hash bits.. */
-	idx ^= (idx >> 26); /* fold the hash bits.. */
-	idx = idx % DUPECHECK_DB_SIZE;
-	dpp = &dupecheck_db[idx];
+static struct dupecheck_slot_t *dupecheck_table_find_variant_in(struct dupecheck_db_t *db, struct dupecheck_table_t *t,
+	const struct pbuf_dupe_variant_t *v, const char *s, int len, char *tb, int *mangled)
+{
+	struct dupecheck_slot_t *slot;
+	uint32_t mask = t->size - 1;
+	uint32_t i;
 	
-	while (*dpp) {
-		dp = *dpp;
-		if (dp->hash == hash) {
-			// HASH match!
-			if (dp->len == len &&
-			    memcmp(s, dp->packet, len) == 0) {
-				// PACKET MATCH!
-				//hlog(LOG_DEBUG, "dupecheck_add_buf got it already: %.*s", len, s);
-				dp->t = tick;
-				return 0; /* no need to add, we have it */
-			}
-			// no packet match.. check next
+	for (i = dupecheck_table_idx(t, v->hash); (slot = &t->slots[i])->pos; i = (i + 1) & mask) {
+		if (slot->hash != v->hash || slot->len != v->len)
+			continue;
+		if (!*mangled) {
+			dupecheck_mangle(s, len, v->dtype, tb);
+			*mangled = 1;
 		}
-		dpp = &dp->next;
+		if (dupecheck_slot_match(db, slot, tb, v->len, "", 0))
+			return slot;
 	}
-	// dpp points to pointer at the tail of the chain
 	
-	dp = dupecheck_db_alloc(len);
-	if (!dp)
-		return -1; // alloc error!
+	return slot;
+}
+
+static struct dupecheck_slot_t *dupecheck_table_find_variant(struct dupecheck_db_t *db,
+	const struct pbuf_dupe_variant_t *v, const char *s, int len)
+{
+	struct dupecheck_slot_t *slot, *old;
+	char tb[PACKETLEN_MAX];
+	int mangled = 0;
 	
-	*dpp = dp;
-	memcpy(dp->packet, s, len);
-	//hlog(LOG_DEBUG, "dupecheck_add_buf appended '%.*s'", len, s);
-	dp->hash = hash;
-	dp->t = tick;
-	dp->dtype = dtype;
+	slot = dupecheck_table_find_variant_in(db, &db->table, v, s, len, tb, &mangled);
 	
-	return 0;
+	if (!slot->pos && db->old.slots
+	    && (old = dupecheck_table_find_variant_in(db, &db->old, v, s, len, tb, &mangled))->pos)
+		return old;
+	
+	return slot;
+}
+
+/* a new record goes in the empty slot found by dupecheck_table_find(),
+ * which is always in the new table
+ */
+static void dupecheck_table_set(struct dupecheck_db_t *db, struct dupecheck_slot_t *slot,
+	uint64_t pos, uint32_t hash, int len, int dtype, int mangle)
+{
+	if (!slot->pos)
+		db->table.count++;
+	
+	slot->pos = pos;
+	slot->hash = hash;
+	slot->len = len;
+	slot->dtype = dtype;
+	slot->mangle = mangle;
+}
+
+/* make room for one more record, before looking for its slot */
+static inline void dupecheck_table_reserve(struct dupecheck_db_t *db)
+{
+	if (db->old.slots)
+		dupecheck_table_migrate(db, DUPECHECK_MIGRATE_INSERT);
+	
+	if ((dupecheck_table_records(db) + 1) * 2 > db->table.size)
+		dupecheck_table_resize(db, db->table.bits + 1);
 }
 
 /*
- *	mangle packet in common ways and store mangled versions
- *	in dupecheck db, so that the mangled versions will be dropped
+ *	Find the slot pointing to the record at pos, mangled or not, if it
+ *	is still in the table - a record may have been replaced by a newer
+ *	copy. Returns the table it is in, or NULL.
  */
 
-static int dupecheck_mangle_store(const char *addr, int addrlen, const char *data, int datalen)
+static int dupecheck_table_has_in(struct dupecheck_table_t *t, uint32_t hash, uint64_t pos, int mangle, uint32_t *idx)
 {
-	char ib[PACKETLEN_MAX];
-	char tb1[PACKETLEN_MAX];
-	char tb2[PACKETLEN_MAX];
-	char tb3[PACKETLEN_MAX];
-	int ilen;
-	int tlen1, tlen2, tlen3;
-	int i;
-	char c;
-	int have_del = 0;
-	int have_low_values = 0;
+	uint32_t mask = t->size - 1;
+	uint32_t i;
 	
-	ilen = addrlen + datalen;
+	for (i = dupecheck_table_idx(t, hash); t->slots[i].pos != pos || t->slots[i].mangle != mangle; i = (i + 1) & mask)
+		if (!t->slots[i].pos)
+			return 0;
 	
-	if (ilen > PACKETLEN_MAX)
-		return -1;
+	*idx = i;
 	
-	/* create a copy of normal packet data */
-	memcpy(ib, addr, addrlen);
-	memcpy(ib + addrlen, data, datalen);
+	return 1;
+}
+
+static struct dupecheck_table_t *dupecheck_table_has(struct dupecheck_db_t *db, uint32_t hash, uint64_t pos, int mangle, uint32_t *idx)
+{
+	if (dupecheck_table_has_in(&db->table, hash, pos, mangle, idx))
+		return &db->table;
+	
+	if (db->old.slots && dupecheck_table_has_in(&db->old, hash, pos, mangle, idx))
+		return &db->old;
 	
-	//hlog(LOG_DEBUG, "dupecheck_mangle_store ib: '%.*s'", ilen, ib);
+	return NULL;
+}
+
+static void dupecheck_table_remove(struct dupecheck_db_t *db, uint32_t hash, uint64_t pos, int mangle)
+{
+	struct dupecheck_table_t *t;
+	uint32_t i;
 	
-	/********************************************/
-	/* remove spaces from the end of the packet */
-	tlen1 = ilen;
-	while (tlen1 > 0 && ib[tlen1-1] == ' ')
-		--tlen1;
+	if ((t = dupecheck_table_has(db, hash, pos, mangle, &i)))
+		dupecheck_table_delete(t, i);
+}
+
+/*
+ *	Drop the expired records from the tail of the ring, at most max of
+ *	them. Call this often, it only looks at the tail.
+ *
+ *	Note: a slot refreshed by dupecheck_add_variant() points to a newer
+ *	record at the head of the ring, and is not dropped with the old one.
+ */
+
+static void dupecheck_expire(struct dupecheck_db_t *db, int max)
+{
+	struct dupe_record_t *dp;
+	time_t expiretime = tick - dupefilter_storetime;
+	time_t futuretime = tick + dupefilter_storetime;
+	int i;
 	
-	if (tlen1 != ilen) {
-		//hlog(LOG_DEBUG, "dupecheck_mangle_store: removed %d spaces: '%.*s'", ilen-tlen1, tlen1, tb1);
-		dupecheck_add_buf(ib, tlen1, DTYPE_SPACE_TRIM);
+	while (db->tail != db->head && max > 0) {
+		dp = dupecheck_record(db, db->tail);
+		if (dp->len == 0) {
+			/* end of the slab */
+			dupecheck_slab_free(db, db->tail >> DUPECHECK_SLAB_BITS);
+			db->tail = ((db->tail >> DUPECHECK_SLAB_BITS) + 1) << DUPECHECK_SLAB_BITS;
+			continue;
+		}
+		
+		/* Old... or too far in the future, discard. */
+		if (dp->t >= expiretime && dp->t <= futuretime)
+			break;
+		
+		dupecheck_table_remove(db, dp->hash, db->tail, 0);
+		for (i = 0; i < dp->variant_count; i++)
+			dupecheck_table_remove(db, dp->variant[i].hash, db->tail, dp->variant[i].dtype);
+		db->tail += DUPECHECK_RECORD_SIZE(dp->len, dp->variant_count);
+		max--;
 	}
 	
-	/*************************/
-	/* tb1: 8th bit data deleted
-	 * tb2: 8th bit is cleared
-	 * tb3: 8th bit replaced with a space
+	/* move on with a resize, or shrink the table after a burst, by
+	 * half at a time, when it is less than 1/16 full
 	 */
+	if (db->old.slots)
+		dupecheck_table_migrate(db, DUPECHECK_MIGRATE_EXPIRE);
+	else if (db->table.size > DUPECHECK_TABLE_MIN && db->table.count * 16 < db->table.size)
+		dupecheck_table_resize(db, db->table.bits - 1);
+}
 
-	/* Check for the necessity to do
-	 * any futher packet scans when doing the initial scan
-	 * (check for DEL bytes / low data => optimize /shortcut)
-	 */
+/*
+ *	Store a record, with the current timestamp and the hashes of its
+ *	mangled versions, in the slot found for it
+ */
 
-	tlen1 = tlen2 = tlen3 = 0;
-	for (i = 0; i < ilen; i++) {
-		c = ib[i];
-		if (c == 0x7F)
-			have_del = 1;
-		if (c < 0x20 && c > 0)
-			have_low_values = 1;
-
-		c = c & 0x7F;
-		tb2[tlen2++] = c;
-		if (ib[i] != c) {
-			/* high bit is on */
-			tb3[tlen3++] = ' ';
-		} else {
-			/* 7-bit char */
-			tb1[tlen1++] = c;
-			tb3[tlen3++] = c;
-		}
-	}
+static void dupecheck_store(struct dupecheck_db_t *db, struct dupecheck_slot_t *slot, uint32_t hash,
+	const char *a, int alen, const char *b, int blen,
+	const struct pbuf_dupe_variant_t *variants, int variant_count, uint64_t *pos)
+{
+	struct dupe_record_t *dp;
 	
-	if (tlen1 != ilen) {
-		//hlog(LOG_DEBUG, "dupecheck_mangle_store: removed  %d 8-bit chars: '%.*s'", ilen-tlen1, tlen1, tb1);
-		//hlog(LOG_DEBUG, "dupecheck_mangle_store: ANDed    %d 8-bit chars: '%.*s'", ilen-tlen1, tlen2, tb2);
-		//hlog(LOG_DEBUG, "dupecheck_mangle_store: replaced %d 8-bit chars: '%.*s'", ilen-tlen1, tlen3, tb3);
-		dupecheck_add_buf(tb1, tlen1, DTYPE_STRIP_8BIT);
-		dupecheck_add_buf(tb2, tlen2, DTYPE_CLEAR_8BIT);
-		dupecheck_add_buf(tb3, tlen3, DTYPE_SPACED_8BIT);
-	}
+	dp = dupecheck_ring_append(db, hash, alen + blen, variant_count, tick, pos);
+		/* Use the current timestamp instead of the arrival time.
+		  If our incoming worker, or dupecheck, is lagging for
+		  reason or another (for example, a huge incoming burst
+		  of traffic), using the arrival time instead of current
+		  time could make the dupecheck db entry expire too early.
+		  In an extreme trouble case, we could expire dupecheck db
+		  entries very soon after the packet has gone out from us,
+		  which would make loops more likely and possibly increase
+		  the traffic and make us lag even more.
+		  This timestamp should be closer to the *outgoing* time
+		  than the *incoming* time, and current timestamp is a
+		  good middle ground. Simulator is not important.
+		*/
+	memcpy(dp->variant, variants, sizeof(*variants) * variant_count);
+	memcpy(dupe_record_packet(dp), a, alen);
+	memcpy(dupe_record_packet(dp) + alen, b, blen);
+	//hlog(LOG_DEBUG, "dupecheck_store '%.*s'", alen+blen, dupe_record_packet(dp));
 	
-	/**********************************************
-	 * tb1: Low data (0 <= x < 0x20 deleted
-	 * tb2: Low data replaced with spaces
-	 */
-	if (have_low_values) {
-		tlen1 = tlen2 = 0;
-		for (i = 0; i < ilen; i++) {
-			c = ib[i];
-			if (c < 0x20 && c > 0) {
-				/* low data, tb2 gets a space and tb1 gets nothing */
-				tb2[tlen2++] = ' ';
-			} else {
-				/* regular stuff */
-				tb1[tlen1++] = c;
-				tb2[tlen2++] = c;
-			}
-		}
+	dupecheck_table_set(db, slot, *pos, hash, alen + blen, 0, 0);
+}
 
-		if (tlen1 != ilen) {
-			/* if there was low data, store it */
-			//hlog(LOG_DEBUG, "dupecheck_mangle_store: removed  %d low chars: '%.*s'", ilen-tlen1, tlen1, tb1);
-			//hlog(LOG_DEBUG, "dupecheck_mangle_store: replaced %d low chars: '%.*s'", ilen-tlen1, tlen2, tb2);
-			dupecheck_add_buf(tb1, tlen1, DTYPE_LOWDATA_STRIP);
-			dupecheck_add_buf(tb2, tlen2, DTYPE_LOWDATA_SPACED);
-		}
-	}
+/*
+ *	Store a mangled version of the record at pos in the dupecheck db, so
+ *	that the mangled version will be dropped
+ */
+
+static void dupecheck_add_variant(struct dupecheck_db_t *db, uint64_t pos, const struct pbuf_dupe_variant_t *v)
+{
+	struct dupecheck_slot_t *slot;
+	struct dupe_record_t *dp;
 	
-	/**********************************************
-	 * tb1: Del characters (0x7f) deleted
-	 * tb2: Del characters replaced with spaces
-	 */
-	if (have_del) {
-		tlen1 = tlen2 = 0;
-		for (i = 0; i < ilen; i++) {
-			c = ib[i];
-			if (c == 0x7f) {
-				/* low data, tb2 gets a space and tb1 gets nothing */
-				tb2[tlen2++] = ' ';
-			} else {
-				/* regular stuff */
-				tb1[tlen1++] = c;
-				tb2[tlen2++] = c;
-			}
-		}
-		
-		if (tlen1 != ilen) {
-			/* if there was low data, store it */
-			//hlog(LOG_DEBUG, "dupecheck_mangle_store: removed  %d low chars: '%.*s'", ilen-tlen1, tlen1, tb1);
-			//hlog(LOG_DEBUG, "dupecheck_mangle_store: replaced %d low chars: '%.*s'", ilen-tlen1, tlen2, tb2);
-			dupecheck_add_buf(tb1, tlen1, DTYPE_DEL_STRIP);
-			dupecheck_add_buf(tb2, tlen2, DTYPE_DEL_SPACED);
+	dupecheck_table_reserve(db);
+	dp = dupecheck_record(db, pos);
+	slot = dupecheck_table_find_variant(db, v, dupe_record_packet(dp), dp->len);
+	
+	if (slot->pos) {
+		// PACKET MATCH!
+		/* no need to add, we have it - but it is fresh again,
+		 * so it moves to the new record at the head of the ring,
+		 * keeping its dupe type
+		 */
+		if (dupecheck_record(db, slot->pos)->t != tick) {
+			slot->pos = pos;
+			slot->mangle = v->dtype;
 		}
+		return;
 	}
 	
-	return 0;
+	dupecheck_table_set(db, slot, pos, v->hash, v->len, v->dtype, v->dtype);
 }
 
 /*
- *	check a single packet for duplicates
+ *	check a single packet for duplicates, returns the verdict for
+ *	pb->dupecheck_result
  */
 
-static int dupecheck(struct pbuf_t *pb)
+static int dupecheck(struct dupecheck_db_t *db, struct pbuf_t *pb)
 {
 	/* check a single packet */
 	// pb->flags |= F_DUPE; /* this is a duplicate! */
 
-	int i;
 	int addrlen;  // length of the address part
 	int datalen;  // length of the payload
-	uint32_t hash, idx;
 	const char *addr;
 	const char *data;
-	struct dupe_record_t **dpp, *dp;
+	struct dupecheck_slot_t *slot;
+	uint64_t pos;
 	time_t expiretime = tick -  dupefilter_storetime;
+	int i;
 
 	// 1) collect canonic rep of the packet
 	addr    = pb->data;
@@ -561,50 +1318,29 @@ static int dupecheck(struct pbuf_t *pb)
 	
 	// there are no 3rd-party frames in APRS-IS ...
 
-	// 2) calculate checksum (from disjoint memory areas)
-
-	hash = keyhash(addr, addrlen, 0);
-	hash = keyhash(data, datalen, hash);
-	idx  = hash;
-
-	// 3) lookup if same checksum is in some hash bucket chain
-	//  3b) compare packet...
-	//    3b1) flag as F_DUPE if so
-	idx ^= (idx >> 13); /* fold the hash bits.. */
-	idx ^= (idx >> 26); /* fold the hash bits.. */
-	i = idx % DUPECHECK_DB_SIZE;
-	dpp = &dupecheck_db[i];
-	while (*dpp) {
-		dp = *dpp;
-		if (dp->hash == hash &&
-		    dp->t >= expiretime) {
-			// HASH match!  And not too old!
-			if (dp->len == addrlen + datalen &&
-			    memcmp(addr, dp->packet, addrlen) == 0 &&
-			    memcmp(data, dp->packet + addrlen, datalen) == 0) {
-				// PACKET MATCH!
-				//hlog(LOG_DEBUG, "Dupe: %.*s", pb->packet_len - 2, pb->data);
-				//hlog(LOG_DEBUG, "Orig: %.*s %.*s", addrlen, dp->addresses, datalen, dp->packet);
-				pb->flags |= F_DUPE;
-				filter_postprocess_dupefilter(pb);
-				if (dp->dtype >= 0 && dp->dtype < DTYPE_MAX)
-					dupecheck_dupetypes[dp->dtype]++;
-				return F_DUPE;
-			}
-			// no packet match.. check next
-		}
-		dpp = &dp->next;
+	// 2) the checksum was calculated by the worker, in dupecheck_prepare()
+
+	// 3) lookup the packet in the hash table
+	//    3b) flag as F_DUPE if it is there, and not too old
+	dupecheck_table_reserve(db);
+	slot = dupecheck_table_find(db, pb->dupe_hash, addr, addrlen, data, datalen);
+	if (slot->pos && dupecheck_record(db, slot->pos)->t >= expiretime) {
+		// PACKET MATCH!
+		//hlog(LOG_DEBUG, "Dupe: %.*s", pb->packet_len - 2, pb->data);
+		return DUPECHECK_DUPE + slot->dtype;
 	}
-	// dpp points to pointer at the tail of the chain
 	
-	// 4) Add comparison copy of non-dupe into dupe-db
-	if (dupecheck_append(dpp, hash, addrlen, addr, datalen, data) == -1)
-		return -1;
+	// 4) Add comparison copy of non-dupe into dupe-db, replacing
+	//    an expired copy which has not been dropped yet
+	dupecheck_store(db, slot, pb->dupe_hash, addr, addrlen, data, datalen,
+		pb->dupe_variant, pb->dupe_variant_count, &pos);
 	
-	// 5) mangle packet in a few common ways, and store to dupe-db
-	dupecheck_mangle_store(addr, addrlen, data, datalen);
+	// 5) store the versions of the packet mangled in a few common
+	//    ways, hashed by the worker, to dupe-db
+	for (i = 0; i < pb->dupe_variant_count; i++)
+		dupecheck_add_variant(db, pos, &pb->dupe_variant[i]);
 	
-	return 0;
+	return DUPECHECK_UNIQUE;
 }
 
 /*
@@ -614,20 +1350,136 @@ static int dupecheck(struct pbuf_t *pb)
 
 int  outgoing_lag_report(struct worker_t *self, int *lag, int *dupelag)
 {
-	int lag1 = pbuf_seqnum_lag(dupecheck_seqnum, self->last_pbuf_seqnum);
-	int lag2 = pbuf_seqnum_lag(dupecheck_dupe_seqnum, self->last_pbuf_dupe_seqnum);
+	int lag1 = pbuf_ring_head(&pbuf_global) - self->pbuf_cursor.seq;
+	int lag2 = pbuf_ring_head(&pbuf_global_dupe) - self->pbuf_dupe_cursor.seq;
 
 	if (lag)     *lag     = lag1;
 	if (dupelag) *dupelag = lag2;
 
-	if (lag1 == 2000000000) lag1 = 0;
-	if (lag2 == 2000000000) lag2 = 0;
-
 	if (lag1 < lag2) lag1 = lag2;
 
 	return lag1; // Higher of the two..
 }
 
+/*
+ *	The shard of a packet, by the hash of its source callsign
+ */
+
+static inline int dupecheck_shard_of(uint32_t srccall_hash)
+{
+	return srccall_hash % dupecheck_shards_running;
+}
+
+/*
+ *	Shard threads. The dupecheck thread puts packets in the queue of a
+ *	shard, and when it has gone through all of them, swaps the queue
+ *	with the work array of the shard, once the shard thread is done
+ *	with the previous work. The verdicts are stored in the packets.
+ */
+
+static void dupecheck_verdicts_signal(void)
+{
+	pthread_mutex_lock(&dupecheck_verdict_mutex);
+	pthread_cond_broadcast(&dupecheck_verdict_cond);
+	pthread_mutex_unlock(&dupecheck_verdict_mutex);
+}
+
+static void dupecheck_shard_thread(struct dupecheck_shard_t *sh)
+{
+	struct timespec ts;
+	char name[32];
+	int i, n;
+	
+	/* the signals are blocked already, by the accept thread starting us */
+	snprintf(name, sizeof(name), "aprsc dupe %d", sh->id);
+	thread_name_set(name);
+	
+	pthread_mutex_lock(&sh->mutex);
+	while (!sh->shutting_down) {
+		if (!sh->work_count) {
+			/* wake up once a second to expire old records */
+			ts.tv_sec = time(NULL) + 1;
+			ts.tv_nsec = 0;
+			pthread_cond_timedwait(&sh->cond, &sh->mutex, &ts);
+		}
+		n = sh->work_count;
+		pthread_mutex_unlock(&sh->mutex);
+		
+		for (i = 0; i < n; i++) {
+			__atomic_store_n(&sh->work[i]->dupecheck_result, dupecheck(&sh->db, sh->work[i]), __ATOMIC_RELEASE);
+			/* let the dupecheck thread go on with a large batch */
+			if ((i & 63) == 63)
+				dupecheck_verdicts_signal();
+		}
+		if (n)
+			dupecheck_verdicts_signal();
+		
+		dupecheck_expire(&sh->db, DUPECHECK_EXPIRE_MAX);
+		
+		pthread_mutex_lock(&sh->mutex);
+		if (n) {
+			sh->work_count = 0;
+			pthread_cond_broadcast(&sh->cond);
+		}
+	}
+	pthread_mutex_unlock(&sh->mutex);
+}
+
+static void dupecheck_shards_dispatch(struct pbuf_t *pb_list)
+{
+	struct dupecheck_shard_t *sh;
+	struct pbuf_t *pb, **swap;
+	int i, swap_size;
+	
+	for (pb = pb_list; (pb); pb = pb->next) {
+		pb->dupecheck_result = DUPECHECK_PENDING;
+		sh = dupecheck_shards[dupecheck_shard_of(pb->srccall_hash)];
+		if (sh->queue_count == sh->queue_size) {
+			sh->queue_size = (sh->queue_size) ? sh->queue_size * 2 : 256;
+			sh->queue = hrealloc(sh->queue, sizeof(*sh->queue) * sh->queue_size);
+		}
+		sh->queue[sh->queue_count++] = pb;
+	}
+	
+	for (i = 0; i < dupecheck_shards_running; i++) {
+		sh = dupecheck_shards[i];
+		if (!sh->queue_count)
+			continue;
+		
+		pthread_mutex_lock(&sh->mutex);
+		while (sh->work_count)
+			pthread_cond_wait(&sh->cond, &sh->mutex);
+		
+		swap = sh->work;
+		swap_size = sh->work_size;
+		sh->work = sh->queue;
+		sh->work_size = sh->queue_size;
+		sh->work_count = sh->queue_count;
+		sh->queue = swap;
+		sh->queue_size = swap_size;
+		sh->queue_count = 0;
+		
+		pthread_cond_broadcast(&sh->cond);
+		pthread_mutex_unlock(&sh->mutex);
+	}
+}
+
+static int dupecheck_verdict_wait(struct pbuf_t *pb)
+{
+	int rc;
+	
+	rc = __atomic_load_n(&pb->dupecheck_result, __ATOMIC_ACQUIRE);
+	if (rc != DUPECHECK_PENDING)
+		return rc;
+	
+	pthread_mutex_lock(&dupecheck_verdict_mutex);
+	while ((rc = __atomic_load_n(&pb->dupecheck_result, __ATOMIC_ACQUIRE)) == DUPECHECK_PENDING)
+		pthread_cond_wait(&dupecheck_verdict_cond, &dupecheck_verdict_mutex);
+	pthread_mutex_unlock(&dupecheck_verdict_mutex);
+	
+	return rc;
+}
+
 static int dupecheck_drain_worker(struct worker_t *w,
 	struct pbuf_t ***pb_out_prevp, struct pbuf_t **pb_out_last,
 	struct pbuf_t ***pb_out_dupe_prevp, struct pbuf_t **pb_out_dupe_last,
@@ -635,26 +1487,14 @@ static int dupecheck_drain_worker(struct worker_t *w,
 {
 	struct pbuf_t *pb_list;
 	struct pbuf_t *pb, *pbnext;
-	int n = 0;
-	int me;
+	int n = 0, count;
 	int pb_out_count_local = 0, pb_out_dupe_count_local = 0;
 	
-	/* grab worker's list of packets */
-	if ((me = pthread_mutex_lock(&w->pbuf_incoming_mutex))) {
-		hlog(LOG_ERR, "dupecheck_drain_worker: could not lock pbuf_incoming_mutex: %s", strerror(me));
-		return 0;
-	}
-	pb_list = w->pbuf_incoming;
-	w->pbuf_incoming = NULL;
-	w->pbuf_incoming_last = &w->pbuf_incoming;
-	//int c = w->pbuf_incoming_count;
-	w->pbuf_incoming_count = 0;
-	if ((me = pthread_mutex_unlock(&w->pbuf_incoming_mutex))) {
-		hlog(LOG_ERR, "dupecheck_drain_worker: could not unlock pbuf_incoming_mutex: %s", strerror(me));
-	}
+	/* grab worker's list of packets, without locking */
+	pb_list = pbuf_inbox_take(&w->pbuf_incoming, &count);
 	
 	//hlog(LOG_DEBUG, "Dupecheck got %d packets from worker %d; n=%d",
-	//     c, w->id, dupecheck_seqnum);
+	//     count, w->id, dupecheck_seqnum);
 
 	// check that the first packet isn't very old, it indicates we're not doing well
 	if ((pb_list) && tick - pb_list->t > 10) {
@@ -662,11 +1502,14 @@ static int dupecheck_drain_worker(struct worker_t *w,
 			pb_list->seqnum, tick - pb_list->t, w->id, pb_list->packet_len-2, pb_list->data);
 	}
 
+	if (dupecheck_shards_running > 1)
+		dupecheck_shards_dispatch(pb_list);
+	
 	for (pb = pb_list; (pb); pb = pbnext) {
-		int rc = dupecheck(pb);
+		int rc = (dupecheck_shards_running > 1) ? dupecheck_verdict_wait(pb) : dupecheck(&dupecheck_shards[0]->db, pb);
 		pbnext = pb->next; // it may get modified below..
 		
-		if (rc == 0) {
+		if (rc == DUPECHECK_UNIQUE) {
 			/* put non-duplicate packet in history database
 			 * and let filter module do it's thing, if historydb
 			 * is enabled (disabled if no filtered listeners
@@ -685,6 +1528,10 @@ static int dupecheck_drain_worker(struct worker_t *w,
 			pb_out_count_local++;
 		} else {
 			// Duplicate
+			pb->flags |= F_DUPE;
+			filter_postprocess_dupefilter(pb);
+			if (rc - DUPECHECK_DUPE < DTYPE_MAX)
+				dupecheck_dupetypes[rc - DUPECHECK_DUPE]++;
 			**pb_out_dupe_prevp = pb;
 			*pb_out_dupe_prevp = &pb->next;
 			*pb_out_dupe_last  = pb;
@@ -711,10 +1558,11 @@ static void dupecheck_thread(void)
 	struct worker_t *w;
 	struct pbuf_t *pb_out, **pb_out_prevp, *pb_out_last;
 	struct pbuf_t *pb_out_dupe, **pb_out_dupe_prevp, *pb_out_dupe_last;
-	int e;
-	int c;
+	struct pbuf_t *pb;
 	int pb_out_count, pb_out_dupe_count;
-	time_t cleanup_tick = tick;
+	uint64_t published;
+	uint32_t woken_head = pbuf_ring_head(&pbuf_global);
+	uint32_t woken_dupe_head = pbuf_ring_head(&pbuf_global_dupe);
 
 	thread_name_set("aprsc dupecheck");
 
@@ -741,6 +1589,8 @@ static void dupecheck_thread(void)
 	hlog(LOG_INFO, "Dupecheck thread ready.");
 
 	while (!dupecheck_shutting_down) {
+		__atomic_add_fetch(&dupecheck_loops, 1, __ATOMIC_SEQ_CST);
+		
 		pb_out       = NULL;
 		pb_out_prevp = &pb_out;
 		pb_out_dupe  = NULL;
@@ -751,7 +1601,7 @@ static void dupecheck_thread(void)
 		/* walk through worker threads */
 		for (w = worker_threads; (w); w = w->next) {
 			/* if there are items in the worker's pbuf_incoming, grab them and process */
-			if (!w->pbuf_incoming)
+			if (!pbuf_inbox_pending(&w->pbuf_incoming))
 				continue;
 			
 			dupecheck_drain_worker(w,
@@ -760,14 +1610,14 @@ static void dupecheck_thread(void)
 				&pb_out_count, &pb_out_dupe_count);
 		}
 		
-		if ((http_worker) && http_worker->pbuf_incoming) {
+		if ((http_worker) && pbuf_inbox_pending(&http_worker->pbuf_incoming)) {
 			dupecheck_drain_worker(http_worker,
 				&pb_out_prevp, &pb_out_last,
 				&pb_out_dupe_prevp, &pb_out_dupe_last,
 				&pb_out_count, &pb_out_dupe_count);
 		}
 		
-		if ((udp_worker) && udp_worker->pbuf_incoming) {
+		if ((udp_worker) && pbuf_inbox_pending(&udp_worker->pbuf_incoming)) {
 			dupecheck_drain_worker(udp_worker,
 				&pb_out_prevp, &pb_out_last,
 				&pb_out_dupe_prevp, &pb_out_dupe_last,
@@ -778,77 +1628,46 @@ static void dupecheck_thread(void)
 		*pb_out_prevp = NULL;
 		*pb_out_dupe_prevp = NULL;
 
-		/* put packets in the global buffer */
+		/* publish the packets to the workers */
 		if (pb_out || pb_out_dupe) {
-			if ((e = rwl_wrlock(&pbuf_global_rwlock))) {
-				hlog(LOG_CRIT, "dupecheck: Failed to wrlock pbuf_global_rwlock!");
-				exit(1);
-			}
-
-			if (pb_out) {
-				*pbuf_global_prevp = pb_out;
-				pbuf_global_prevp  = pb_out_prevp;
-				pbuf_global_count += pb_out_count;
-			}
-
-			if (pb_out_dupe) {
-				*pbuf_global_dupe_prevp = pb_out_dupe;
-				pbuf_global_dupe_prevp  = pb_out_dupe_prevp;
-				pbuf_global_dupe_count += pb_out_dupe_count;
-			}
-			
-			if ((e = rwl_wrunlock(&pbuf_global_rwlock))) {
-				hlog(LOG_CRIT, "dupecheck: Failed to wrunlock pbuf_global_rwlock!");
-				exit(1);
+			published = latency_now();
+			for (pb = pb_out; (pb); pb = pb->next) {
+				pb->published = published;
+				if (pb->flushed)
+					latency_add(&dupecheck_publish_latency, published - pb->flushed);
 			}
+			for (pb = pb_out_dupe; (pb); pb = pb->next)
+				pb->published = published;
 		}
+		if (pb_out)
+			pbuf_ring_publish(&pbuf_global, pb_out);
+		if (pb_out_dupe)
+			pbuf_ring_publish(&pbuf_global_dupe, pb_out_dupe);
 
 		dupecheck_outcount  += pb_out_count;
 		dupecheck_dupecount += pb_out_dupe_count;
 
-		if (cleanup_tick <= tick) { // once in a (simulated) minute or so..
-			cleanup_tick = tick + 10;
-			
-			/*
-			if ((e = rwl_wrlock(&pbuf_global_rwlock))) {
-				hlog(LOG_CRIT, "dupecheck: Failed to wrlock pbuf_global_rwlock!");
-				exit(1);
-			}
-			*/
-			
-			/* walk through worker threads */
-			int worker_pbuf_lag;
-			int worker_pbuf_dupe_lag;
-			worker_pbuf_lag = worker_pbuf_dupe_lag = -1;
-			for (w = worker_threads; (w); w = w->next) {
-				/* Find the highest worker lag count after we have appended
-				 * the packets in the buffer.
-				 */
-				c = pbuf_seqnum_lag(dupecheck_seqnum, w->last_pbuf_seqnum);
-				if (w->last_pbuf_seqnum == 0)
-					c = 2000000000;
-				if (c > worker_pbuf_lag)
-					worker_pbuf_lag = c;
-				c = pbuf_seqnum_lag(dupecheck_dupe_seqnum, w->last_pbuf_dupe_seqnum);
-				if (c > worker_pbuf_dupe_lag)
-					worker_pbuf_dupe_lag = c;
-			}
-			
-			global_pbuf_purger(0, worker_pbuf_lag, worker_pbuf_dupe_lag);
-			
-			/*
-			if ((e = rwl_wrunlock(&pbuf_global_rwlock))) {
-				hlog(LOG_CRIT, "dupecheck: Failed to wrunlock pbuf_global_rwlock!");
-				exit(1);
-			}
-			*/
-			
-			dupecheck_cleanup();
+		/* free the packets the workers are done with */
+		global_pbuf_purger(0);
+		
+		/* wake up the workers, if there is anything new for them,
+		 * including the packets which got out of the backlog
+		 */
+		if (pbuf_ring_head(&pbuf_global) != woken_head || pbuf_ring_head(&pbuf_global_dupe) != woken_dupe_head) {
+			woken_head = pbuf_ring_head(&pbuf_global);
+			woken_dupe_head = pbuf_ring_head(&pbuf_global_dupe);
+			__atomic_thread_fence(__ATOMIC_SEQ_CST);
+			for (w = worker_threads; (w); w = w->next)
+				worker_wakeup(w);
 		}
 
+		/* the shard threads clean up their own shards */
+		if (dupecheck_shards_running == 1)
+			dupecheck_expire(&dupecheck_shards[0]->db, DUPECHECK_EXPIRE_MAX);
+
 		/* sleep a little */
 #ifdef USE_EVENTFD
-		int p = poll(&dupecheck_eventfd_poll, 1, 1000);
+		int p = poll(&dupecheck_eventfd_poll, 1, (pbuf_reclaim_pending) ? 0 : 1000);
 		//hlog(LOG_DEBUG, "dupecheck: poll returned %d", p);
 		if (p > 0) {
 			uint64_t u;
@@ -856,17 +1675,175 @@ static void dupecheck_thread(void)
 			//hlog(LOG_DEBUG, "dupecheck: eventfd read %d: %lu", p, u);
 		}
 #else
-		nanosleep(&sleepspec, NULL);
+		if (!pbuf_reclaim_pending)
+			nanosleep(&sleepspec, NULL);
 #endif
 	}
 	
 	hlog( LOG_INFO, "Dupecheck thread shut down; seqnum=%u/%u",
-	      pbuf_seqnum_lag(dupecheck_seqnum,(uint32_t)-2000),     // initial bias..
-	      pbuf_seqnum_lag(dupecheck_dupe_seqnum,(uint32_t)-2000));
+	      dupecheck_seqnum - (uint32_t)-2000,     // initial bias..
+	      dupecheck_dupe_seqnum - (uint32_t)-2000);
 	
 	dupecheck_running = 0;
 }
 
+/*
+ *	Split the database in a different number of shards. The records
+ *	are copied to new shards, oldest first, so the rings of the new
+ *	shards are in the order the records expire in, too.
+ */
+
+/* move the slot of a record, if it is still there, to the record's new place */
+static int dupecheck_reshard_slot(struct dupecheck_db_t *db, uint32_t hash, int mangle, struct dupecheck_db_t *to, uint64_t pos)
+{
+	struct dupecheck_table_t *t;
+	struct dupecheck_slot_t slot;
+	uint32_t i;
+	
+	if (!(t = dupecheck_table_has(db, hash, db->tail, mangle, &i)))
+		return 0;
+	
+	if (to) {
+		slot = t->slots[i];
+		slot.pos = pos;
+		dupecheck_table_reserve(to);
+		dupecheck_table_put(&to->table, &slot);
+	}
+	
+	return 1;
+}
+
+static int dupecheck_reshard_slots(struct dupecheck_db_t *db, struct dupecheck_db_t *to, uint64_t pos)
+{
+	struct dupe_record_t *dp = dupecheck_record(db, db->tail);
+	int i, n;
+	
+	n = dupecheck_reshard_slot(db, dp->hash, 0, to, pos);
+	for (i = 0; i < dp->variant_count; i++)
+		n += dupecheck_reshard_slot(db, dp->variant[i].hash, dp->variant[i].dtype, to, pos);
+	
+	return n;
+}
+
+static int dupecheck_reshard_next(struct dupecheck_db_t *db)
+{
+	struct dupe_record_t *dp;
+	
+	/* skip the end markers and the records which have been replaced */
+	while (db->tail != db->head) {
+		dp = dupecheck_record(db, db->tail);
+		if (dp->len == 0) {
+			dupecheck_slab_free(db, db->tail >> DUPECHECK_SLAB_BITS);
+			db->tail = ((db->tail >> DUPECHECK_SLAB_BITS) + 1) << DUPECHECK_SLAB_BITS;
+			continue;
+		}
+		if (dupecheck_reshard_slots(db, NULL, 0))
+			return 1;
+		db->tail += DUPECHECK_RECORD_SIZE(dp->len, dp->variant_count);
+	}
+	
+	return 0;
+}
+
+static void dupecheck_reshard(int n)
+{
+	struct dupecheck_db_t old[DUPECHECK_SHARDS_MAX];
+	struct dupecheck_db_t *db, *to;
+	struct dupe_record_t *dp, *ndp;
+	const char *gt;
+	uint64_t pos;
+	int old_n = dupecheck_shards_running;
+	int i, oldest;
+	
+	for (i = 0; i < old_n; i++) {
+		old[i] = dupecheck_shards[i]->db;
+		dupecheck_db_init(&dupecheck_shards[i]->db);
+	}
+	for (i = old_n; i < n; i++)
+		if (!dupecheck_shards[i])
+			dupecheck_shards[i] = dupecheck_shard_alloc(i);
+	
+	dupecheck_shards_running = n;
+	
+	for (;;) {
+		oldest = -1;
+		for (i = 0; i < old_n; i++) {
+			if (!dupecheck_reshard_next(&old[i]))
+				continue;
+			if (oldest < 0 || dupecheck_record(&old[i], old[i].tail)->t < dupecheck_record(&old[oldest], old[oldest].tail)->t)
+				oldest = i;
+		}
+		if (oldest < 0)
+			break;
+		
+		db = &old[oldest];
+		dp = dupecheck_record(db, db->tail);
+		
+		/* the source callsign is before the '>', hashed like
+		 * filter_preprocess_dupefilter() does
+		 */
+		gt = memchr(dupe_record_packet(dp), '>', dp->len);
+		to = &dupecheck_shards[(gt) ? dupecheck_shard_of(keyhashuc(dupe_record_packet(dp), gt - dupe_record_packet(dp), 0)) : 0]->db;
+		
+		ndp = dupecheck_ring_append(to, dp->hash, dp->len, dp->variant_count, dp->t, &pos);
+		memcpy(ndp->variant, dp->variant, DUPECHECK_RECORD_SIZE(dp->len, dp->variant_count) - sizeof(*dp));
+		dupecheck_reshard_slots(db, to, pos);
+		
+		db->tail += DUPECHECK_RECORD_SIZE(dp->len, dp->variant_count);
+	}
+	
+	for (i = 0; i < old_n; i++)
+		dupecheck_db_free(&old[i]);
+	
+	hlog(LOG_INFO, "Dupecheck database split in %d shards (was %d)", n, old_n);
+}
+
+/*
+ *	Start / stop the shard threads, when there are more than one shard
+ */
+
+static void dupecheck_shards_start(void)
+{
+	struct dupecheck_shard_t *sh;
+	int i;
+	
+	if (dupecheck_shards_configured != dupecheck_shards_running)
+		dupecheck_reshard(dupecheck_shards_configured);
+	
+	if (dupecheck_shards_running == 1)
+		return;
+	
+	for (i = 0; i < dupecheck_shards_running; i++) {
+		sh = dupecheck_shards[i];
+		sh->shutting_down = 0;
+		if (pthread_create(&sh->th, &pthr_attrs, (void *)dupecheck_shard_thread, sh)) {
+			perror("pthread_create failed for dupecheck_shard_thread");
+			continue;
+		}
+		sh->running = 1;
+	}
+}
+
+static void dupecheck_shards_stop(void)
+{
+	struct dupecheck_shard_t *sh;
+	int e, i;
+	
+	for (i = 0; i < DUPECHECK_SHARDS_MAX && (sh = dupecheck_shards[i]); i++) {
+		if (!sh->running)
+			continue;
+		
+		pthread_mutex_lock(&sh->mutex);
+		sh->shutting_down = 1;
+		pthread_cond_broadcast(&sh->cond);
+		pthread_mutex_unlock(&sh->mutex);
+		
+		if ((e = pthread_join(sh->th, NULL)))
+			hlog(LOG_ERR, "Could not pthread_join dupecheck shard %d: %s", i, strerror(e));
+		sh->running = 0;
+	}
+}
+
 /*
  *	Start / stop dupecheck
  */
@@ -876,6 +1853,8 @@ void dupecheck_start(void)
 	if (dupecheck_running)
 		return;
 	
+	dupecheck_shards_start();
+	
 	dupecheck_shutting_down = 0;
 	
 	if (pthread_create(&dupecheck_th, &pthr_attrs, (void *)dupecheck_thread, NULL))
@@ -896,8 +1875,8 @@ void dupecheck_stop(void)
 #ifdef USE_EVENTFD
 	/* wake up dupecheck from sleep */
 	uint64_t u = 1;
-	int i = write(dupecheck_eventfd, &u, sizeof(uint64_t));
-	if (i != sizeof(uint64_t)) {
+	int n = write(dupecheck_eventfd, &u, sizeof(uint64_t));
+	if (n != sizeof(uint64_t)) {
 		hlog(LOG_ERR, "incoming_stop() failed to write to dupecheck_eventfd: %s", strerror(errno));
 	}
 #endif
@@ -906,45 +1885,85 @@ void dupecheck_stop(void)
 		hlog(LOG_ERR, "Could not pthread_join dupecheck_th: %s", strerror(e));
 	else
 		hlog(LOG_INFO, "Dupecheck thread has terminated.");
+	
+	/* the shards are idle now, with the dupecheck thread gone */
+	dupecheck_shards_stop();
+}
+
+/*
+ *	Wait for the dupecheck thread to start a new round of its loop, so
+ *	that it is no longer looking at a worker which has been taken off
+ *	the worker_threads list, and the worker can be freed.
+ */
+
+void dupecheck_sync(void)
+{
+	struct timespec ts = { 0, 1000000 };
+	uint32_t loops;
+	
+	if (!dupecheck_running)
+		return;
+	
+	loops = __atomic_load_n(&dupecheck_loops, __ATOMIC_SEQ_CST);
+	
+#ifdef USE_EVENTFD
+	/* wake up dupecheck from sleep */
+	uint64_t u = 1;
+	if (write(dupecheck_eventfd, &u, sizeof(uint64_t)) != sizeof(uint64_t))
+		hlog(LOG_ERR, "dupecheck_sync() failed to write to dupecheck_eventfd: %s", strerror(errno));
+#endif
+	
+	while (dupecheck_running && __atomic_load_n(&dupecheck_loops, __ATOMIC_SEQ_CST) == loops)
+		nanosleep(&ts, NULL);
 }
 
 /*	The  dupecheck_atend() is primarily for valgrind() to clean up dupecache.
  */
 void dupecheck_atend(void)
 {
+	struct dupecheck_shard_t *sh;
 	int i;
-	struct dupe_record_t *dp, *dp2;
-
-	for (i = 0; i < DUPECHECK_DB_SIZE; ++i) {
-		dp = dupecheck_db[i];
-		while (dp) {
-			dp2 = dp->next;
-			dupecheck_db_free(dp);
-			dp = dp2;
-		}
-		dupecheck_db[i] = NULL;
-	}
-#if 0 /* Well, not really...  valgrind did hfree() the dupecells,
-	 and without valgrind we really are not interested of freeup of
-	 the free chain... */
-	dp = dupecheck_free;
-	for ( ; dp ; dp = dp2 ) {
-		dp2 = dp->next;
-		cellfree(dupecheck_cells, dp);
+
+	for (i = 0; i < DUPECHECK_SHARDS_MAX && (sh = dupecheck_shards[i]); i++) {
+		dupecheck_db_free(&sh->db);
+		memset(&sh->db, 0, sizeof(sh->db));
 	}
-#endif
-	global_pbuf_purger(1, -1, -1); // purge everything..
+	global_pbuf_purger(1); // purge everything..
+	pbuf_ring_free(&pbuf_global);
+	pbuf_ring_free(&pbuf_global_dupe);
 }
 
 /*
- *	cellmalloc status
+ *	Memory status, summed up over the shards, in the terms of a
+ *	cellmalloc arena: the slabs are the blocks, and a record takes
+ *	the average record size in the rings
  */
 #ifndef _FOR_VALGRIND_
 void dupecheck_cell_stats(struct cellstatus_t *cellst)
 {
+	struct dupecheck_db_t *db;
+	long records = 0, bytes = 0;
+	int i;
+	
+	memset(cellst, 0, sizeof(*cellst));
+	
 	// TODO: this is not quite thread safe, but may be OK
-	cellstatus(dupecheck_cells, cellst);
+	for (i = 0; i < DUPECHECK_SHARDS_MAX && dupecheck_shards[i]; i++) {
+		db = &dupecheck_shards[i]->db;
+		records += dupecheck_table_records(db);
+		bytes += db->head - db->tail;
+		cellst->blocks += (db->head >> DUPECHECK_SLAB_BITS) - (db->tail >> DUPECHECK_SLAB_BITS) + 1;
+		cellst->blocks_max += db->slabs_max;
+		cellst->blocks_peak += db->slabs_max;
+	}
+	cellst->rss_bytes = (long)cellst->blocks * DUPECHECK_SLAB_SIZE;
+	
+	cellst->cellsize = sizeof(struct dupe_record_t);
+	cellst->alignment = 16;
+	cellst->cellsize_aligned = (records) ? bytes / records : DUPECHECK_RECORD_SIZE(0, 0);
+	cellst->cellcount = records;
+	cellst->block_size = DUPECHECK_SLAB_SIZE;
+	
+	dupecheck_cellgauge = records;
 }
 #endif
-
-
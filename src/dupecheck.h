@@ -14,17 +14,31 @@
 #include "worker.h"
 #include "cellmalloc.h"
 
+/*
+ *	A record in the ring of slabs of a dupecheck shard. The records are
+ *	aligned at 16 bytes, and a record with len 0 marks the end of a slab.
+ *	The mangled versions of the packet are not stored, just their hashes,
+ *	and the packet follows them.
+ */
+
 struct dupe_record_t {
-	struct dupe_record_t *next;
-	uint32_t hash;
 	time_t	 t;
-	int	 dtype; // dupecheck dupe type
-	int	 len;	// address + payload length
-	char	*packet;
-	char	 packetbuf[220]; /* 99.9+ % of time this is enough.. */
+	uint32_t hash;
+	uint16_t len;	// address + payload length
+	uint8_t  variant_count; // mangled versions of the packet
+	uint8_t  pad;
+	struct pbuf_dupe_variant_t variant[];
 };
 
-#define DUPECHECK_CELL_SIZE sizeof(struct dupe_record_t)
+#define DUPECHECK_RECORD_SIZE(len, variants) \
+	((sizeof(struct dupe_record_t) + (variants) * sizeof(struct pbuf_dupe_variant_t) + (len) + 15) & ~15)
+
+static inline char *dupe_record_packet(struct dupe_record_t *dp)
+{
+	return (char *)&dp->variant[dp->variant_count];
+}
+
+#define DUPECHECK_SHARDS_MAX	16	/* max. number of dupecheck shards */
 
 #define DTYPE_SPACE_TRIM	1
 #define DTYPE_STRIP_8BIT	2
@@ -40,14 +54,49 @@ extern long long dupecheck_outcount;  /* statistics counter */
 extern long long dupecheck_dupecount; /* statistics counter */
 extern long long dupecheck_dupetypes[DTYPE_MAX+1];
 extern long      dupecheck_cellgauge; /* statistics gauge   */
+extern int       dupecheck_shards_running;
+extern struct latency_hist_t dupecheck_publish_latency;
+
+/* the global packet queues, and the reclaiming of the packets in them */
+struct pbuf_reclaim_stats_t {
+	long long reclaimed;	/* packets the workers were done with */
+	long long returned;	/* ... of which went back to the pools of the workers */
+	int queue;		/* packets in pbuf_global, not reclaimed yet */
+	int dupe_queue;		/* and in pbuf_global_dupe */
+	int backlog;		/* packets waiting for room in pbuf_global */
+	int dupe_backlog;
+	uint32_t oldest_age_ms;	/* since the oldest packet in the queues was published */
+};
+
+extern struct pbuf_reclaim_stats_t pbuf_reclaim_stats;
 
 extern int dupecheck_eventfd;
 
 extern int  outgoing_lag_report(struct worker_t *self, int*lag, int*dupelag);
 
+/*
+ *	Kernels for finding the characters which the packets are mangled
+ *	by, and for mangling them, selected at startup by dupecheck_init()
+ */
+#define DUPECHECK_HAVE_8BIT	1
+#define DUPECHECK_HAVE_LOW	2
+#define DUPECHECK_HAVE_DEL	4
+
+struct dupecheck_kernel_t {
+	const char *name;
+	int (*scan)(const char *s, int len);	/* DUPECHECK_HAVE_* */
+	int (*mangle)(const char *s, int len, int dtype, char *out); /* not for DTYPE_SPACE_TRIM */
+};
+
+extern const struct dupecheck_kernel_t *dupecheck_kernel;
+extern const struct dupecheck_kernel_t *dupecheck_kernels(void);	/* available ones, NULL name terminates */
+
+extern void dupecheck_prepare(struct pbuf_t *pb);
+
 extern void dupecheck_init(void);
 extern void dupecheck_start(void);
 extern void dupecheck_stop(void);
+extern void dupecheck_sync(void);
 extern void dupecheck_atend(void);
 
 /* cellmalloc status */
@@ -31,6 +31,9 @@
 #include "client_heard.h"
 #include "version.h"
 #include "messaging.h"
+#include "geoindex.h"
+#include "callindex.h"
+#include "range.h"
 
 //#define FILTER_CLIENT_DEBUGGING
 
@@ -135,6 +138,24 @@ struct filter_refcallsign_t {
 	char	callsign[CALLSIGNLEN_MAX+1]; /* size: 10.. */
 	int8_t	reflen; /* length and flags */
 };
+
+/*
+ *	Large callsign sets (hundreds of callsigns in a b/ or g/ filter)
+ *	get an open-addressing hash of their exact callsigns, so that
+ *	matching does not need to scan through all of them. The wildcard
+ *	ones are still scanned, from a separate list. Both refer to the
+ *	refcallsigns by index, so that the first matching one can be found,
+ *	like the linear scan would.
+ */
+
+#define CALLSIGNSET_HASH_MIN 16 /* build a hash for sets having at least this many callsigns */
+
+struct filter_callhash_t {
+	int	mask;		/* number of slots - 1 */
+	int	nwild;		/* number of wildcard callsigns in wild[] */
+	int16_t	*wild;		/* refcallsigns indexes of the wildcards, ascending */
+	int16_t	slots[1];	/* refcallsigns index + 1, 0 for an empty slot */
+};
 struct filter_head_t {
 	struct filter_t *next;
 	const char *text; /* filter text as is		*/
@@ -148,6 +169,9 @@ struct filter_head_t {
 	  float   f_dist; /* for R filter */
 	}; /* ANONYMOUS UNION */
 	time_t  hist_age;
+	struct filter_callhash_t *callhash; /* for large callsign sets */
+	struct range_point_t f_pt; /* centre of r/ f/ m/ T, see range.c */
+	float   f_limit;           /* range_limit() of f_dist */
 
 	char	type;	  /* 1 char			*/
 	int16_t	negation; /* boolean flag		*/
@@ -174,6 +198,52 @@ struct filter_t {
 	char textbuf[FILT_TEXTBUFSIZE];
 };
 
+/*
+ *	The filter chains of a client are compiled into a filter program:
+ *	a flat array of operations, one for each filter, in the order
+ *	filter_process() needs to run them. Each operation has the match
+ *	function resolved up front, so there is no switch on the filter
+ *	type per packet, and the a/ and r/ filters carry their coordinates
+ *	in the operation itself, so walking the program does not touch the
+ *	512-byte filter cells at all for them.
+ */
+
+struct filter_op_t {
+	int (*fn)(struct client_t *c, struct pbuf_t *pb, const struct filter_op_t *op);
+	struct filter_t *f; /* the filter cell (text, callsign sets, history cache) */
+	int16_t negation;
+	int16_t need_pos;   /* can only match packets with F_HASPOS */
+	int16_t bitflags;   /* T_* packet type mask of t/ filters */
+	uint32_t kinds;     /* FILTER_KIND_* / T_* bits of the packets this may match */
+	int16_t range_slot; /* r/ f/ m/: index in prog->ranges, or -1 */
+	float   latN, lonE;
+	union {
+	  float   latS;     /* for A filter */
+	  float   limit;    /* for R filter, range_limit() of dist */
+	}; /* ANONYMOUS UNION */
+	union {
+	  float   lonW;     /* for A filter */
+	  float   dist;     /* for R filter */
+	}; /* ANONYMOUS UNION */
+	struct range_point_t pt; /* for R filter */
+	struct filter_centre_t *centre; /* for F and M filters, if subscribed */
+};
+
+struct filter_prog_t {
+	int negdefault_end; /* ops[0 .. negdefault_end-1] are negative default filters */
+	int posdefault_end; /* and so on, in the order of processing */
+	int neguser_end;
+	int posuser_end;    /* == number of ops */
+	int has_hist;       /* has f/ or m/ filters, which use cached historydb positions */
+	/* the centres of the range filters, checked all at once
+	 * with range_set_hits() if there are many of them
+	 */
+	struct range_set_t ranges;
+	uint32_t *range_bits;
+	int range_bits_valid; /* for the packet being processed */
+	struct filter_op_t ops[1];
+};
+
 #define QC_C	0x001 /* Q-filter flag bits */
 #define QC_X	0x002
 #define QC_U	0x004
@@ -241,6 +311,8 @@ cellarena_t *filter_wx_cells;
 
 int have_filtered_listeners;  /* do we have any filtered listeners, do we need to support them */
 
+#define FILTER_RANGE_BATCH_MIN 8 /* check the range filters of a program all at once, if it has this many */
+
 #define HIST_LOOKUP_INTERVAL 10 /* Cache historydb position lookups this much seconds on
 				  each filter entry referring to some
 				  fixed callsign (f,m,t) */
@@ -260,6 +332,7 @@ float filter_lon2rad(float lon)
 void filter_init(void)
 {
 	rwl_init(&filter_cellgauge_rwlock);
+	range_init();
 #ifndef _FOR_VALGRIND_
 	/* A few hundred... */
 
@@ -324,28 +397,23 @@ static int filter_entrycall_insert(struct pbuf_t *pb)
 	struct filter_entrycall_t *f, **fp, *f2;
 	/* OK, pre-parsing produced accepted result */
 	uint32_t hash;
-	int idx, keylen;
-	const char qcons = pb->qconst_start[2];
+	int i, idx;
 	const char *key = pb->qconst_start+4;
+	const int keylen = pb->entrycall_len; /* from incoming_parse_path() */
         char uckey[CALLSIGNLEN_MAX+1];
 
-	for (keylen = 0; keylen < CALLSIGNLEN_MAX; ++keylen) {
-		int c = key[keylen];
-		if (c == ',' || c == ':')
-			break;
-                if ('a' <= c && c <= 'z')
-                	c -= ('a' - 'A');
-                uckey[keylen] = c;
-                uckey[keylen+1] = 0;
-	}
-	if ((key[keylen] != ',' && key[keylen] != ':') ||
-	    (keylen < CALLSIGNLEN_MIN))
+	if (keylen < 1)
 		return 0; /* Bad entry-station callsign */
 	
-	pb->entrycall_len = keylen; // FIXME: should be in incoming parser...
-	
 	/* We insert only those that have Q-Constructs of qAR or qAr */
-	if (qcons != 'r' && qcons != 'R') return 0;
+	if (pb->qconst_type != 'r' && pb->qconst_type != 'R') return 0;
+
+	for (i = 0; i < keylen; ++i) {
+		int c = key[i];
+                if ('a' <= c && c <= 'z')
+                	c -= ('a' - 'A');
+                uckey[i] = c;
+	}
 
 	hash = keyhash(uckey, keylen, 0);
 	idx = (hash ^ (hash >> 11) ^ (hash >> 22) ) % FILTER_ENTRYCALL_HASHSIZE; /* Fold the hashbits.. */
@@ -775,18 +843,6 @@ const char *aprsc_strnstr(const char *s1, const char *s2, size_t len)
 }
 
 
-/*
- *	Check if there is a TCPIP* component in the path.
- *	OPTIMIZE: The flag could be set when TCPIP is inserted, or when the path
- *	is analyzed on input.
- */
-
-static void filter_check_tcpip(struct pbuf_t *pbuf)
-{
-	if (aprsc_strnstr(pbuf->dstcall_end, ",TCPIP*,", pbuf->qconst_start - pbuf->dstcall_end))
-		pbuf->flags |= F_HAS_TCPIP;
-}
-
 static void filter_keyhashes(struct pbuf_t *pb)
 {
 	pb->srccall_hash = keyhashuc(pb->data, pb->srccall_end - pb->data, 0);
@@ -802,8 +858,7 @@ static void filter_keyhashes(struct pbuf_t *pb)
 
 void filter_preprocess_dupefilter(struct pbuf_t *pbuf)
 {
-	// TODO: could probably skip filter_check_tcpip, and possibly filter_keyhashes too if no filtered listeners
-	filter_check_tcpip(pbuf);
+	// TODO: could possibly skip filter_keyhashes too if no filtered listeners
 	if (have_filtered_listeners) {
 		filter_entrycall_insert(pbuf);
 		filter_wx_insert(pbuf);
@@ -828,6 +883,7 @@ void filter_postprocess_dupefilter(struct pbuf_t *pbuf)
 			pbuf->lat     = hist->lat;
 			pbuf->lng     = hist->lon;
 			pbuf->cos_lat = hist->coslat;
+			range_point_set(&pbuf->range_pt, pbuf->lat, pbuf->lng, pbuf->cos_lat);
 
 			pbuf->flags  |= F_HASPOS;
 		}
@@ -844,12 +900,51 @@ void filter_postprocess_dupefilter(struct pbuf_t *pbuf)
  *
  */
 
+static int filter_match_on_callsignhash(struct filter_refcallsign_t *ref, int keylen, struct filter_t *f)
+{
+	struct filter_callhash_t *h = f->h.callhash;
+	struct filter_refcallsign_t *r = f->h.refcallsigns;
+	const char *r1 = (const void*)ref->callsign;
+	int i, j, len, best = -1;
+
+	/* exact callsigns */
+	if (keylen > 0 && keylen <= CALLSIGNLEN_MAX) {
+		for (j = keyhashuc(r1, keylen, 0) & h->mask; (i = h->slots[j]); j = (j + 1) & h->mask) {
+			i--;
+			if ((r[i].reflen & LengthMask) == keylen && strncasecmp(r1, r[i].callsign, keylen) == 0) {
+				best = i;
+				break;
+			}
+		}
+	}
+
+	/* wildcards, unless an exact one came before them */
+	for (j = 0; j < h->nwild; j++) {
+		i = h->wild[j];
+		if (best >= 0 && i > best)
+			break;
+		len = r[i].reflen & LengthMask;
+		if (len <= keylen && strncasecmp(r1, r[i].callsign, len) == 0) {
+			best = i;
+			break;
+		}
+	}
+
+	if (best < 0)
+		return 0; /* no match */
+
+	return ( r[best].reflen & NegationFlag ? 2 : 1 );
+}
+
 static int filter_match_on_callsignset(struct filter_refcallsign_t *ref, int keylen, struct filter_t *f, MatchEnum wildok)
 {
 	int i;
 	struct filter_refcallsign_t *r  = f->h.refcallsigns;
 	const char                  *r1 = (const void*)ref->callsign;
 
+	if (f->h.callhash && wildok == MatchWild)
+		return filter_match_on_callsignhash(ref, keylen, f);
+
 	for (i = 0; i < f->h.numnames; ++i) {
 		const int reflen = r[i].reflen;
 		const int len    = reflen & LengthMask;
@@ -899,6 +994,66 @@ static int filter_match_on_callsignset(struct filter_refcallsign_t *ref, int key
 
 }
 
+/*
+ *	Build the hash for a large callsign set, replacing the old one
+ *	if the set has been extended
+ */
+
+static void filter_callhash_build(struct filter_t *f)
+{
+	struct filter_callhash_t *h;
+	struct filter_refcallsign_t *r = f->h.refcallsigns;
+	int i, j, k, len, size, nexact = 0, nwild = 0;
+
+	if (f->h.callhash) {
+		hfree(f->h.callhash);
+		f->h.callhash = NULL;
+	}
+
+	if (f->h.numnames < CALLSIGNSET_HASH_MIN)
+		return;
+
+	for (i = 0; i < f->h.numnames; i++) {
+		if ((r[i].reflen & LengthMask) == 0)
+			continue; /* empty ones never match */
+		if (r[i].reflen & WildCard)
+			nwild++;
+		else
+			nexact++;
+	}
+
+	/* keep the load factor at 50% or below */
+	for (size = 32; size < nexact * 2; size *= 2)
+		;
+
+	h = hmalloc(sizeof(*h) + sizeof(int16_t) * (size - 1 + nwild));
+	memset(h, 0, sizeof(*h) + sizeof(int16_t) * (size - 1 + nwild));
+	h->mask = size - 1;
+	h->wild = &h->slots[size];
+
+	for (i = 0; i < f->h.numnames; i++) {
+		len = r[i].reflen & LengthMask;
+		if (len == 0)
+			continue;
+
+		if (r[i].reflen & WildCard) {
+			h->wild[h->nwild++] = i;
+			continue;
+		}
+
+		/* the first one of duplicate callsigns is the one which matches */
+		for (j = keyhashuc(r[i].callsign, len, 0) & h->mask; (k = h->slots[j]); j = (j + 1) & h->mask) {
+			k--;
+			if ((r[k].reflen & LengthMask) == len && strncasecmp(r[k].callsign, r[i].callsign, len) == 0)
+				break;
+		}
+		if (!h->slots[j])
+			h->slots[j] = i + 1;
+	}
+
+	f->h.callhash = h;
+}
+
 /*
  *	filter_parse_one_callsignset()  collects multiple callsigns
  *	on filters of types:  b, d, e, o, p, u
@@ -1017,6 +1172,9 @@ static int filter_parse_one_callsignset(struct client_t *c, const char *filt0, s
 	/* If not extending existing filter item,
 	   let main parser do the finalizations */
 
+	if (c && wildok == MatchWild)
+		filter_callhash_build(extend ? ff : f0);
+
 	return extend;
 }
 
@@ -1259,6 +1417,7 @@ int filter_parse(struct client_t *c, const char *filt, int is_user_filter)
 		f0.h.refcallsign.callsign[CALLSIGNLEN_MAX] = 0;
 		f0.h.refcallsign.reflen = strlen(f0.h.refcallsign.callsign);
 		f0.h.numnames = 0; /* reusing this as "position-cache valid" flag */
+		f0.h.f_limit = range_limit(f0.h.f_dist);
 
 		// hlog(LOG_DEBUG, "Filter: %s -> F xxx %.3f", filt0, f0.h.f_dist);
 
@@ -1291,6 +1450,7 @@ int filter_parse(struct client_t *c, const char *filt, int is_user_filter)
 			return -1;
 		}
 		f0.h.numnames = 0; /* reusing this as "position-cache valid" flag */
+		f0.h.f_limit = range_limit(f0.h.f_dist);
 
 		// hlog(LOG_DEBUG, "Filter: %s -> M %.3f", filt0, f0.h.f_dist);
 		break;
@@ -1408,6 +1568,8 @@ int filter_parse(struct client_t *c, const char *filt, int is_user_filter)
 		f0.h.f_lonE = filter_lon2rad(f0.h.f_lonE);
 
 		f0.h.f_coslat = cosf( f0.h.f_latN ); /* Store pre-calculated COS of LAT */
+		range_point_set(&f0.h.f_pt, f0.h.f_latN, f0.h.f_lonE, f0.h.f_coslat);
+		f0.h.f_limit = range_limit(f0.h.f_dist);
 		break;
 
 	case 's':
@@ -1489,6 +1651,7 @@ int filter_parse(struct client_t *c, const char *filt, int is_user_filter)
 			}
 			f0.h.refcallsign.callsign[CALLSIGNLEN_MAX] = 0;
 			f0.h.refcallsign.reflen = strlen(f0.h.refcallsign.callsign);
+			f0.h.f_limit = range_limit(f0.h.f_dist);
 			f0.h.type = 'T'; /* two variants... */
 		}
 
@@ -1547,6 +1710,8 @@ int filter_parse(struct client_t *c, const char *filt, int is_user_filter)
 
 	*fff = f;
 
+	filter_compile(c);
+
 	return 0;
 }
 
@@ -1558,6 +1723,8 @@ void filter_free(struct filter_t *f)
 
 	for ( ; f ; f = fnext ) {
 		fnext = f->h.next;
+		if (f->h.callhash)
+			hfree(f->h.callhash);
 		/* If not pointer to internal string, free it.. */
 #ifndef _FOR_VALGRIND_
 		if (f->h.text != f->textbuf)
@@ -1614,19 +1781,174 @@ function maidenhead_km_distance($This, $That) {
 
 */
 
-static float maidenhead_km_distance(float lat1, float coslat1, float lon1, float lat2, float coslat2, float lon2)
+/* The range filters do the same with range_within() in range.c, in a form
+ * which needs no trigonometric functions per packet.
+ */
+
+
+/*
+ *	A position of a f/ or m/ filter centre, shared by the filters of
+ *	a worker's clients referring to the same callsign. The worker
+ *	subscribes to the position in the historydb, and applies the
+ *	updates published by historydb_insert() in filter_centres_update(),
+ *	so the filters need no historydb lookups.
+ */
+
+#define FILTER_CENTRES_HASH 1024
+
+struct filter_centre_t {
+	struct filter_centre_t *next;	/* in the hash bucket */
+	struct filter_centres_t *fc;
+	uint32_t hash;
+	int refcount;			/* filters using this */
+	int valid;			/* position known */
+	time_t arrivaltime;		/* of the position */
+	float lat, coslat, lon;
+	struct range_point_t pt;
+	int keylen;
+	char key[CALLSIGNLEN_MAX+2];
+};
+
+/*
+ *	Refresh the cached historydb position of the f/ filter's friend,
+ *	or the m/ filter client's own position, if the cache has expired.
+ *	A subscribed centre is simply copied, it is always fresh.
+ */
+
+static void filter_centre_copy(struct filter_t *f, const struct filter_centre_t *ce)
+{
+	f->h.numnames = ce->valid;
+	if (!ce->valid)
+		return;
+	f->h.f_latN   = ce->lat;
+	f->h.f_lonE   = ce->lon;
+	f->h.f_coslat = ce->coslat;
+	f->h.f_pt     = ce->pt;
+}
+
+static void filter_hist_lookup_f(const struct filter_op_t *op)
+{
+	struct filter_t *f = op->f;
+	struct history_cell_t *history;
+	int i;
+
+	if (op->centre) {
+		filter_centre_copy(f, op->centre);
+		return;
+	}
+
+	if (f->h.hist_age < tick || f->h.hist_age > tick + HIST_LOOKUP_INTERVAL) {
+		i = historydb_lookup( f->h.refcallsign.callsign, f->h.refcallsign.reflen, &history );
+		f->h.numnames = i;
+		f->h.hist_age = tick + HIST_LOOKUP_INTERVAL;
+		if (!i) return; /* no lookup result.. */
+		f->h.f_latN   = history->lat;
+		f->h.f_lonE   = history->lon;
+		f->h.f_coslat = history->coslat;
+		range_point_set(&f->h.f_pt, f->h.f_latN, f->h.f_lonE, f->h.f_coslat);
+	}
+}
+
+static void filter_hist_lookup_m(struct client_t *c, const struct filter_op_t *op)
+{
+	struct filter_t *f = op->f;
+	struct history_cell_t *history;
+	int i;
+
+	if (op->centre) {
+		filter_centre_copy(f, op->centre);
+		return;
+	}
+
+	if (!*c->username) /* Should not happen... */
+		return;
+	
+	if (f->h.hist_age < tick || f->h.hist_age > tick + HIST_LOOKUP_INTERVAL) {
+		i = historydb_lookup( c->username, strlen(c->username), &history );
+		f->h.numnames = i;
+		if (!i) {
+			f->h.hist_age = tick + HIST_LOOKUP_INTERVAL/2;
+			return; /* no result */
+		}
+		f->h.hist_age = tick + HIST_LOOKUP_INTERVAL;
+		f->h.f_latN   = history->lat;
+		f->h.f_lonE   = history->lon;
+		f->h.f_coslat = history->coslat;
+		range_point_set(&f->h.f_pt, f->h.f_latN, f->h.f_lonE, f->h.f_coslat);
+	}
+}
+
+/*
+ *	The centre of a range filter (r/ f/ m/), or NULL if it is not known
+ */
+
+static const struct range_point_t *filter_range_centre(struct client_t *c, const struct filter_op_t *op)
 {
-	float sindlat2 = sinf((lat1 - lat2) * 0.5);
-	float sindlon2 = sinf((lon1 - lon2) * 0.5);
+	struct filter_t *f = op->f;
 
-	float a = (sindlat2 * sindlat2 +
-		   coslat1 * coslat2 * sindlon2 * sindlon2);
+	switch (f->h.type) {
+	case 'r':
+	case 'R':
+		return &op->pt;
+	case 'm':
+	case 'M':
+		/* If client has sent a location, use it. The client may be an unvalidated
+		 * client which does not exist in the historydb.
+		 */
+		if (c->loc_known)
+			return &c->loc_pt;
+		break;
+	}
 
-	float c = 2.0 * atan2f( sqrtf(a), sqrtf(1.0 - a));
+	/* Otherwise, the friend's or the client's own last position from
+	 * the historydb. For clients in the geoindex, the worker keeps the
+	 * cache up to date along with the index. A subscribed centre can
+	 * be used as is, others are looked up.
+	 */
+	if (!c->geo_indexed) {
+		if (op->centre)
+			return (op->centre->valid) ? &op->centre->pt : NULL;
+		if (f->h.type == 'm' || f->h.type == 'M')
+			filter_hist_lookup_m(c, op);
+		else
+			filter_hist_lookup_f(op);
+	}
 
-	return ((111.2 * 180.0 / M_PI) * c);
+	return (f->h.numnames) ? &f->h.f_pt : NULL;
 }
 
+/*
+ *	Programs having many range filters check all of them at once when
+ *	the first one is run for a packet, and the rest just pick their bit.
+ *	The r/ centres are filled in at compile time, the f/ and m/ ones
+ *	may move and are refreshed here.
+ */
+
+static int filter_range_bit(struct client_t *c, struct pbuf_t *pb, const struct filter_op_t *op)
+{
+	struct filter_prog_t *prog = c->filter_prog;
+	const struct filter_op_t *rop;
+	const struct range_point_t *centre;
+
+	if (!prog->range_bits_valid) {
+		for (rop = prog->ops; rop < prog->ops + prog->posuser_end; rop++) {
+			if (rop->range_slot < 0 || rop->f->h.type == 'r' || rop->f->h.type == 'R')
+				continue;
+			centre = filter_range_centre(c, rop);
+			if (centre)
+				range_set_put(&prog->ranges, rop->range_slot, centre, rop->f->h.f_limit);
+			else
+				prog->ranges.limit[rop->range_slot] = -1; /* can not match */
+		}
+		range_set_hits(&prog->ranges, &pb->range_pt, prog->range_bits);
+		prog->range_bits_valid = 1;
+	}
+
+	if (prog->range_bits[op->range_slot >> 5] & (1U << (op->range_slot & 31)))
+		return (op->negation) ? 2 : 1;
+
+	return 0;
+}
 
 /*
  *
@@ -1634,7 +1956,7 @@ static float maidenhead_km_distance(float lat1, float coslat1, float lon1, float
  *
  */
 
-static int filter_process_one_a(struct client_t *c, struct pbuf_t *pb, struct filter_t *f)
+static int filter_process_one_a(struct client_t *c, struct pbuf_t *pb, const struct filter_op_t *op)
 {
 	/* a/latN/lonW/latS/lonE  	Area filter
 
@@ -1650,22 +1972,21 @@ static int filter_process_one_a(struct client_t *c, struct pbuf_t *pb, struct fi
 
 	   50-70 instances in APRS-IS core at any given time.
 	   Up to 2500 invocations per second.
-	*/
-	;
-	if (!(pb->flags & F_HASPOS)) /* packet with a position.. (msgs with RECEIVER's position) */
-		return 0;
 
-	if ((pb->lat <= f->h.f_latN) &&
-	    (pb->lat >= f->h.f_latS) &&
-	    (pb->lng <= f->h.f_lonE) && /* East POSITIVE ! */
-	    (pb->lng >= f->h.f_lonW))
+	   The box is copied to the filter_op_t at compile time, and
+	   F_HASPOS has been checked by the caller (need_pos).
+	*/
+	if ((pb->lat <= op->latN) &&
+	    (pb->lat >= op->latS) &&
+	    (pb->lng <= op->lonE) && /* East POSITIVE ! */
+	    (pb->lng >= op->lonW))
 		/* Inside the box */
-		return f->h.negation ? 2 : 1;
+		return op->negation ? 2 : 1;
 
 	return 0;
 }
 
-static int filter_process_one_b(struct client_t *c, struct pbuf_t *pb, struct filter_t *f)
+static int filter_process_one_b(struct client_t *c, struct pbuf_t *pb, const struct filter_op_t *op)
 {
 	/* b/call1/call2...  	Budlist filter
 
@@ -1676,6 +1997,7 @@ static int filter_process_one_b(struct client_t *c, struct pbuf_t *pb, struct fi
 	   Up to 2500 invocations per second.
 	*/
 
+	struct filter_t *f = op->f;
 	struct filter_refcallsign_t ref;
 	int i = pb->srccall_end - pb->data;
 
@@ -1703,7 +2025,7 @@ static int filter_process_one_b(struct client_t *c, struct pbuf_t *pb, struct fi
 	return r;
 }
 
-static int filter_process_one_d(struct client_t *c, struct pbuf_t *pb, struct filter_t *f)
+static int filter_process_one_d(struct client_t *c, struct pbuf_t *pb, const struct filter_op_t *op)
 {
 	/* d/digi1/digi2...  	Digipeater filter
 
@@ -1716,91 +2038,33 @@ static int filter_process_one_d(struct client_t *c, struct pbuf_t *pb, struct fi
 	   25-35 filters in use at any given time.
 	   Up to 1300 invocations per second.
 	*/
+	struct filter_t *f = op->f;
 	struct filter_refcallsign_t ref;
-	const char *d = pb->srccall_end + 1 + pb->dstcall_len + 1; /* viacall start */
-	const char *q = pb->qconst_start-1;
-	int rc, i, cl, j = 0;
-	int found_call = 0;
-
-	/*hlog( LOG_INFO, "digifilter:  '%.*s' -> '%.*s'  q-d=%d",
-	 *      (int)(pb->packet_len < 50 ? pb->packet_len : 50),
-	 *      pb->data, (int)i, d, (int)(q-d) );
-	 */
-	
-	for (i = 0; d < q; ) {
-		++j;
-		if (j > 10) break; /* way too many callsigns... */
-
-		if (*d == ',') ++d; /* second round and onwards.. */
-		/* find end of callsign */
-		for (i = 0; i+d <= q && i <= CALLSIGNLEN_MAX; ++i) {
-			if (d[i] == ',')
-				break;
-		}
+	const struct pbuf_path_t *el;
+	int i, cl;
 
-		//hlog(LOG_INFO, "d:  -> (%d,%d) '%.*s'", (int)(d-pb->data), i, i, d);
+	/* the path has been split up by incoming_parse_path(), and an
+	 * element is flagged digipeated if it or a following one has a '*'
+	 */
+	for (i = 0; i < pb->path_count; i++) {
+		el = &pb->path[i];
 		
 		/* When matching callsign, ignore trailing '*' */
-		cl = i;
-		if (d[cl-1] == '*')
-			cl--;
-
+		cl = el->len;
 		if (cl > CALLSIGNLEN_MAX) cl = CALLSIGNLEN_MAX;
 		
 		/* digipeater address  ",addr," */
-		memcpy( ref.callsign, d, cl);
+		memcpy( ref.callsign, pb->data + el->off, cl);
 		memset( ref.callsign+cl, 0, sizeof(ref.callsign)-cl );
 
-		rc = filter_match_on_callsignset(&ref, cl, f, MatchWild);
-		if (rc) {
-			if (rc == 1) {
-				found_call = 1;
-				break;
-			}
-		}
-		d += i;
-	}
-	
-	if (!found_call)
-		return 0;
-	
-	/* Ok, we found the call. Check if it has a '*' in the end.
-	 * Or if one of the following calls does.
-	 *
-	 * d points to the start of this call, d[i-1] should be it's last character.
-	 */
-	
-	if (d[cl] == '*')
-		return 1;
-	
-	/* continue looking from next callsign */
-	d += i;
-	while (d < q) {
-		++j;
-		if (j > 10) break; /* way too many callsigns... */
-
-		if (*d == ',')
-			d++;
-		
-		/* find end of callsign */
-		for (i = 0; i+d <= q && i <= CALLSIGNLEN_MAX; ++i) {
-			if (d[i] == ',')
-				break;
-		}
-		
-		//hlog(LOG_INFO, "d:  -> (%d,%d) '%.*s'", (int)(d-pb->data), i, i, d);
-		
-		/* Is there a trailing '*' in the call? */
-		if (d[i-1] == '*')
-			return 1;;
-		
-		d += i;
+		if (filter_match_on_callsignset(&ref, cl, f, MatchWild) == 1)
+			return (el->flags & PBUF_PATH_DIGIPEATED) ? 1 : 0;
 	}
 	
 	return 0;
 }
 
-static int filter_process_one_e(struct client_t *c, struct pbuf_t *pb, struct filter_t *f)
+static int filter_process_one_e(struct client_t *c, struct pbuf_t *pb, const struct filter_op_t *op)
 {
 	/* e/call1/call1/...  	Entry station filter
 
@@ -1813,6 +2077,7 @@ static int filter_process_one_e(struct client_t *c, struct pbuf_t *pb, struct fi
 	   Up to 200 invocations per second.
 	*/
 
+	struct filter_t *f = op->f;
 	struct filter_refcallsign_t ref;
 	const char *e = pb->qconst_start+4;
 	int         i = pb->entrycall_len;
@@ -1827,7 +2092,7 @@ static int filter_process_one_e(struct client_t *c, struct pbuf_t *pb, struct fi
 	return filter_match_on_callsignset(&ref, i, f, MatchWild);
 }
 
-static int filter_process_one_f(struct client_t *c, struct pbuf_t *pb, struct filter_t *f)
+static int filter_process_one_f(struct client_t *c, struct pbuf_t *pb, const struct filter_op_t *op)
 {
 	/* f/call/dist  	Friend Range filter
 	   This is the same as the range filter except that the center is
@@ -1849,47 +2114,27 @@ static int filter_process_one_f(struct client_t *c, struct pbuf_t *pb, struct fi
 	   spent on the historydb.
 	*/
 
-	struct history_cell_t *history;
-
-	float r;
-	float lat1, lon1, coslat1;
-	float lat2, lon2, coslat2;
-
-	const char *callsign = f->h.refcallsign.callsign;
-	int i                = f->h.refcallsign.reflen;
+	struct filter_t *f = op->f;
+	const struct range_point_t *centre;
 
 	if (!(pb->flags & F_HASPOS)) /* packet with a position.. (msgs with RECEIVER's position) */
 		return 0; /* No position data... */
 
-	/* find friend's last location packet */
-	if (f->h.hist_age < tick || f->h.hist_age > tick + HIST_LOOKUP_INTERVAL) {
-		i = historydb_lookup( callsign, i, &history );
-		f->h.numnames = i;
-		f->h.hist_age = tick + HIST_LOOKUP_INTERVAL;
-		if (!i) return 0; /* no lookup result.. */
-		f->h.f_latN   = history->lat;
-		f->h.f_lonE   = history->lon;
-		f->h.f_coslat = history->coslat;
-	}
-	if (!f->h.numnames) return 0; /* histdb lookup cache invalid */
-
-	lat1    = f->h.f_latN;
-	lon1    = f->h.f_lonE;
-	coslat1 = f->h.f_coslat;
+	if (op->range_slot >= 0)
+		return filter_range_bit(c, pb, op);
 
-	lat2    = pb->lat;
-	lon2    = pb->lng;
-	coslat2 = pb->cos_lat;
+	/* find friend's last location packet, unless the worker
+	 * keeps the cache up to date for the geoindex */
+	centre = filter_range_centre(c, op);
+	if (!centre) return 0; /* histdb lookup cache invalid */
 
-	r = maidenhead_km_distance(lat1, coslat1, lon1, lat2, coslat2, lon2);
-
-	if (r < f->h.f_dist)  /* Range is less than given limit */
+	if (range_within(centre, f->h.f_limit, &pb->range_pt))  /* Range is less than given limit */
 		return (f->h.negation) ? 2 : 1;
 
 	return 0;
 }
 
-static int filter_process_one_g(struct client_t *c, struct pbuf_t *pb, struct filter_t *f)
+static int filter_process_one_g(struct client_t *c, struct pbuf_t *pb, const struct filter_op_t *op)
 {
 	/* g/call1/call1/...  	Test message recipient callsign filter
 
@@ -1900,6 +2145,8 @@ static int filter_process_one_g(struct client_t *c, struct pbuf_t *pb, struct fi
 	   Appeared in javAPRSSrvr 4.0, not widely used.
 	*/
 
+	struct filter_t *f = op->f;
+
 	if ( (pb->packettype & T_MESSAGE) == 0 ) /* not a message */
 		return 0;
 
@@ -1916,7 +2163,7 @@ static int filter_process_one_g(struct client_t *c, struct pbuf_t *pb, struct fi
 	return filter_match_on_callsignset(&ref, i, f, MatchWild);
 }
 
-static int filter_process_one_m(struct client_t *c, struct pbuf_t *pb, struct filter_t *f)
+static int filter_process_one_m(struct client_t *c, struct pbuf_t *pb, const struct filter_op_t *op)
 {
 	/* m/dist  	My Range filter
 	   This is the same as the range filter except that the center is
@@ -1940,63 +2187,27 @@ static int filter_process_one_m(struct client_t *c, struct pbuf_t *pb, struct fi
 	   spent on the historydb.
 	*/
 
-	float r;
-	float lat1, lon1, coslat1;
-	float lat2, lon2, coslat2;
-	int i;
-	struct history_cell_t *history;
+	struct filter_t *f = op->f;
+	const struct range_point_t *centre;
 
 	if (!(pb->flags & F_HASPOS)) /* packet with a position.. (msgs with RECEIVER's position) */
 		return 0;
 	
-	if (c->loc_known) {
-		/* If client has sent a location, use it. The client may be an unvalidated
-		 * client which does not exist in the historydb.
-		 */
-		r = maidenhead_km_distance(c->lat, c->cos_lat, c->lng, pb->lat, pb->cos_lat, pb->lng);
-		if (r < f->h.f_dist)  /* Range is less than given limit */
-			return f->h.negation ? 2 : 1;
-		
-		return 0;
-	}
-	
-	/* Otherwise, fall back to looking up from the historydb */
-	 
-	if (!*c->username) /* Should not happen... */
-		return 0;
-	
-	if (f->h.hist_age < tick || f->h.hist_age > tick + HIST_LOOKUP_INTERVAL) {
-		i = historydb_lookup( c->username, strlen(c->username), &history );
-		f->h.numnames = i;
-		if (!i) {
-			f->h.hist_age = tick + HIST_LOOKUP_INTERVAL/2;
-			return 0; /* no result */
-		}
-		f->h.hist_age = tick + HIST_LOOKUP_INTERVAL;
-		f->h.f_latN   = history->lat;
-		f->h.f_lonE   = history->lon;
-		f->h.f_coslat = history->coslat;
-	}
+	if (op->range_slot >= 0)
+		return filter_range_bit(c, pb, op);
 	
-	if (!f->h.numnames)
+	/* the client's own location, or its position in the historydb */
+	centre = filter_range_centre(c, op);
+	if (!centre)
 		return 0; /* cached lookup invalid.. */
 	
-	lat1    = f->h.f_latN;
-	lon1    = f->h.f_lonE;
-	coslat1 = f->h.f_coslat;
-	
-	lat2    = pb->lat;
-	lon2    = pb->lng;
-	coslat2 = pb->cos_lat;
-	
-	r = maidenhead_km_distance(lat1, coslat1, lon1, lat2, coslat2, lon2);
-	if (r < f->h.f_dist)  /* Range is less than given limit */
+	if (range_within(centre, f->h.f_limit, &pb->range_pt))  /* Range is less than given limit */
 		return f->h.negation ? 2 : 1;
 	
 	return 0;
 }
 
-static int filter_process_one_o(struct client_t *c, struct pbuf_t *pb, struct filter_t *f)
+static int filter_process_one_o(struct client_t *c, struct pbuf_t *pb, const struct filter_op_t *op)
 {
 	/* o/obj1/obj2...  	Object filter
 	   Pass all objects with the exact name of obj1, obj2, ...
@@ -2008,6 +2219,7 @@ static int filter_process_one_o(struct client_t *c, struct pbuf_t *pb, struct fi
 	   .. 2 cases in entire APRS-IS core at any time.
 	   About 50-70 invocations per second at peak.
 	*/
+	struct filter_t *f = op->f;
 	struct filter_refcallsign_t ref;
 	int i;
 
@@ -2025,7 +2237,7 @@ static int filter_process_one_o(struct client_t *c, struct pbuf_t *pb, struct fi
 	return filter_match_on_callsignset(&ref, i, f, MatchWild);
 }
 
-static int filter_process_one_p(struct client_t *c, struct pbuf_t *pb, struct filter_t *f)
+static int filter_process_one_p(struct client_t *c, struct pbuf_t *pb, const struct filter_op_t *op)
 {
 
 	/* p/aa/bb/cc...  	Prefix filter
@@ -2037,6 +2249,7 @@ static int filter_process_one_p(struct client_t *c, struct pbuf_t *pb, struct fi
 	   Up to 3500 invocations per second at peak.
 	*/
 
+	struct filter_t *f = op->f;
 	struct filter_refcallsign_t ref;
 	int i = pb->srccall_end - pb->data;
 
@@ -2065,7 +2278,7 @@ static int filter_process_one_p(struct client_t *c, struct pbuf_t *pb, struct fi
 	return r;
 }
 
-static int filter_process_one_q(struct client_t *c, struct pbuf_t *pb, struct filter_t *f)
+static int filter_process_one_q(struct client_t *c, struct pbuf_t *pb, const struct filter_op_t *op)
 {
 	/* q/con/ana  	q Contruct filter
 
@@ -2087,10 +2300,10 @@ static int filter_process_one_q(struct client_t *c, struct pbuf_t *pb, struct fi
 	   Up to 200 invocations per second at peak.
 	*/
 
-	const char *e = pb->qconst_start+2;
+	struct filter_t *f = op->f;
 	int mask;
 
-	switch (*e) {
+	switch (pb->qconst_type) {
 	case 'C':
 		mask = QC_C;
 		break;
@@ -2141,7 +2354,7 @@ static int filter_process_one_q(struct client_t *c, struct pbuf_t *pb, struct fi
 }
 
 
-static int filter_process_one_r(struct client_t *c, struct pbuf_t *pb, struct filter_t *f)
+static int filter_process_one_r(struct client_t *c, struct pbuf_t *pb, const struct filter_op_t *op)
 {
 	/* r/lat/lon/dist  	Range filter
 
@@ -2156,33 +2369,22 @@ static int filter_process_one_r(struct client_t *c, struct pbuf_t *pb, struct fi
 
 	   About 120-150 r-filters in entire APRS-IS core at any given time.
 	   Up to 5200 invocations per second at peak.
-	*/
-
-	float lat1    = f->h.f_latN;
-	float lon1    = f->h.f_lonE;
-	float coslat1 = f->h.f_coslat;
-	float r;
-
-	float lat2, lon2, coslat2;
-
-	if (!(pb->flags & F_HASPOS)) /* packet with a position.. (msgs with RECEIVER's position) */
-		return 0;
 
-	lat2    = pb->lat;
-	lon2    = pb->lng;
-	coslat2 = pb->cos_lat;
-
-	r = maidenhead_km_distance(lat1, coslat1, lon1, lat2, coslat2, lon2);
+	   The centre and range are copied to the filter_op_t at compile
+	   time, and F_HASPOS has been checked by the caller (need_pos).
+	   See range.c for the distance check.
+	*/
 
-	// hlog(LOG_DEBUG, "r: lalo: %.4f %.4f / reflalo: %.4f %.4f / dist: %.2f", rad2deg(lat2),rad2deg(lon2), rad2deg(lat1), rad2deg(lon1), r);
+	if (op->range_slot >= 0)
+		return filter_range_bit(c, pb, op);
 
-	if (r < f->h.f_dist)  /* Range is less than given limit */
-		return (f->h.negation) ? 2 : 1;
+	if (range_within(&op->pt, op->limit, &pb->range_pt))  /* Range is less than given limit */
+		return (op->negation) ? 2 : 1;
 
 	return 0;
 }
 
-static int filter_process_one_s(struct client_t *c, struct pbuf_t *pb, struct filter_t *f)
+static int filter_process_one_s(struct client_t *c, struct pbuf_t *pb, const struct filter_op_t *op)
 {
 	/* s/pri/alt/over  	Symbol filter
 
@@ -2198,6 +2400,7 @@ static int filter_process_one_s(struct client_t *c, struct pbuf_t *pb, struct fi
 	   About 10-15 s-filters in entire APRS-IS core at any given time.
 	   Up to 520 invocations per second at peak.
 	*/
+	struct filter_t *f = op->f;
 	const char symtable = (pb->symbol[0] == '/') ? '/' : '\\';
 	const char symcode  = pb->symbol[1];
 	const char symolay  = (pb->symbol[0] != symtable) ? pb->symbol[0] : 0;
@@ -2230,7 +2433,7 @@ static int filter_process_one_s(struct client_t *c, struct pbuf_t *pb, struct fi
 	return 0;
 }
 
-static int filter_process_one_t(struct client_t *c, struct pbuf_t *pb, struct filter_t *f)
+static int filter_process_one_t(struct client_t *c, struct pbuf_t *pb, const struct filter_op_t *op)
 {
 	/* [-]t/poimntqsu
 	   [-]t/poimntqsu/call/km
@@ -2272,11 +2475,12 @@ static int filter_process_one_t(struct client_t *c, struct pbuf_t *pb, struct fi
 	    t/.*./OH2RDY/50  Everything within 50 km of OH2RDY's last known position
 	                     ("." is dummy addition for C comments..)
 	*/
+	struct filter_t *f = op->f;
 	int rc = 0;
-	if (pb->packettype & f->h.bitflags) /* bitflags as comparison bitmask */
+	if (pb->packettype & op->bitflags) /* bitflags as comparison bitmask */
 		rc = 1;
 
-	if (!rc && (f->h.bitflags & T_WX) && (pb->flags & F_HASPOS)) {
+	if (!rc && (op->bitflags & T_WX) && (pb->flags & F_HASPOS)) {
 		/* "Note: The weather type filter also passes positions packets
 		//        for positionless weather packets."
 		//
@@ -2296,9 +2500,6 @@ static int filter_process_one_t(struct client_t *c, struct pbuf_t *pb, struct fi
 				       */
 		const char *callsign    = f->h.refcallsign.callsign;
 		const int   callsignlen = f->h.refcallsign.reflen;
-		float range, r;
-		float lat1, lon1, coslat1;
-		float lat2, lon2, coslat2;
 		struct history_cell_t *history;
 		int i;
 
@@ -2307,8 +2508,6 @@ static int filter_process_one_t(struct client_t *c, struct pbuf_t *pb, struct fi
 		if (!(pb->flags & F_HASPOS)) /* packet with a position.. (msgs with RECEIVER's position) */
 			return 0; /* No positional data.. */
 
-		range = f->h.f_dist;
-
 		/* So..  Now we have a callsign, and we have range.
 		   Lets find callsign's location, and range to that item..
 		   .. 60-100 lookups per second. */
@@ -2327,20 +2526,11 @@ static int filter_process_one_t(struct client_t *c, struct pbuf_t *pb, struct fi
 			f->h.f_latN   = history->lat;
 			f->h.f_lonE   = history->lon;
 			f->h.f_coslat = history->coslat;
+			range_point_set(&f->h.f_pt, f->h.f_latN, f->h.f_lonE, f->h.f_coslat);
 		}
 		if (!f->h.numnames) return 0; /* No valid data at range center position cache */
 
-		lat1    = f->h.f_latN;
-		lon1    = f->h.f_lonE;
-		coslat1 = f->h.f_coslat;
-
-		lat2    = pb->lat;
-		lon2    = pb->lng;
-		coslat2 = pb->cos_lat;
-
-		r = maidenhead_km_distance(lat1, coslat1, lon1, lat2, coslat2, lon2);
-
-		if (r < range)  /* Range is less than given limit */
+		if (range_within(&f->h.f_pt, f->h.f_limit, &pb->range_pt))  /* Range is less than given limit */
 			return (f->h.negation) ? 2 : 1;
 
 		return 0; /* unimplemented! */
@@ -2349,7 +2539,7 @@ static int filter_process_one_t(struct client_t *c, struct pbuf_t *pb, struct fi
 	return (f->h.negation ? (rc+rc) : rc);
 }
 
-static int filter_process_one_u(struct client_t *c, struct pbuf_t *pb, struct filter_t *f)
+static int filter_process_one_u(struct client_t *c, struct pbuf_t *pb, const struct filter_op_t *op)
 {
 	/* u/unproto1/unproto2/...  	Unproto filter
 
@@ -2360,6 +2550,7 @@ static int filter_process_one_u(struct client_t *c, struct pbuf_t *pb, struct fi
 	   Seen hardly ever in APRS-IS core, some rare instances in Tier-2.
 	*/
 
+	struct filter_t *f = op->f;
 	struct filter_refcallsign_t ref;
 	const char *d = pb->srccall_end+1;
 	int i;
@@ -2379,96 +2570,913 @@ static int filter_process_one_u(struct client_t *c, struct pbuf_t *pb, struct fi
 	return filter_match_on_callsignset(&ref, i, f, MatchWild);
 }
 
-static int filter_process_one(struct client_t *c, struct pbuf_t *pb, struct filter_t *f)
+static int filter_process_one_bad(struct client_t *c, struct pbuf_t *pb, const struct filter_op_t *op)
 {
-	int rc = 0;
+	/* filter_parse does not let these through, but be safe */
+	return -1;
+}
+
+/*
+ *	Fill in a filter program operation for a parsed filter:
+ *	pick the match function and copy the parameters the hot
+ *	filter types need from the filter cell.
+ */
+
+static void filter_compile_op(struct filter_op_t *op, struct filter_t *f)
+{
+	memset(op, 0, sizeof(*op));
+	op->f = f;
+	op->negation = f->h.negation;
+	op->range_slot = -1;
+
+	/* can match any packet, unless narrowed down below */
+	op->kinds = T_ALL;
 
 	switch (f->h.type) {
 
 	case 'a':
 	case 'A':
-		rc = filter_process_one_a(c, pb, f);
+		op->fn = filter_process_one_a;
+		op->need_pos = 1;
+		op->latN = f->h.f_latN;
+		op->latS = f->h.f_latS;
+		op->lonE = f->h.f_lonE;
+		op->lonW = f->h.f_lonW;
 		break;
 
 	case 'b':
 	case 'B':
-		rc = filter_process_one_b(c, pb, f);
+		op->fn = filter_process_one_b;
 		break;
 
 	case 'd':
 	case 'D':
-		rc = filter_process_one_d(c, pb, f);
+		op->fn = filter_process_one_d;
 		break;
 
 	case 'e':
 	case 'E':
-		rc = filter_process_one_e(c, pb, f);
+		op->fn = filter_process_one_e;
 		break;
 
 	case 'f':
 	case 'F':
-		rc = filter_process_one_f(c, pb, f);
+		op->fn = filter_process_one_f;
+		op->need_pos = 1;
 		break;
 
 	case 'g':
 	case 'G':
-		rc = filter_process_one_g(c, pb, f);
+		op->fn = filter_process_one_g;
+		op->kinds = T_MESSAGE;
 		break;
 
 	case 'm':
 	case 'M':
-		rc = filter_process_one_m(c, pb, f);
+		op->fn = filter_process_one_m;
+		op->need_pos = 1;
 		break;
 
 	case 'o':
 	case 'O':
-		rc = filter_process_one_o(c, pb, f);
+		op->fn = filter_process_one_o;
+		op->kinds = T_OBJECT | T_ITEM;
 		break;
 
 	case 'p':
 	case 'P':
-		rc = filter_process_one_p(c, pb, f);
+		op->fn = filter_process_one_p;
 		break;
 
 	case 'q':
 	case 'Q':
-		rc = filter_process_one_q(c, pb, f);
+		op->fn = filter_process_one_q;
 		break;
 
 	case 'r':
 	case 'R':
-		rc = filter_process_one_r(c, pb, f);
+		op->fn = filter_process_one_r;
+		op->need_pos = 1;
+		op->latN = f->h.f_latN;
+		op->lonE = f->h.f_lonE;
+		op->dist = f->h.f_dist;
+		op->pt = f->h.f_pt;
+		op->limit = f->h.f_limit;
 		break;
 
 	case 's':
 	case 'S':
-		rc = filter_process_one_s(c, pb, f);
+		op->fn = filter_process_one_s;
+		op->kinds = FILTER_KIND_SYMBOL;
 		break;
 
 	case 't':
 	case 'T':
-		rc = filter_process_one_t(c, pb, f);
+		op->fn = filter_process_one_t;
+		op->bitflags = f->h.bitflags;
+		/* t/w also passes positions of stations having sent positionless WX */
+		op->kinds = (uint16_t)f->h.bitflags | ((f->h.bitflags & T_WX) ? FILTER_KIND_HASPOS : 0);
 		break;
 
 	case 'u':
 	case 'U':
-		rc = filter_process_one_u(c, pb, f);
+		op->fn = filter_process_one_u;
 		break;
 
 	default:
-		rc = -1;
+		op->fn = filter_process_one_bad;
 		break;
 	}
-	//hlog(LOG_DEBUG, "filter '%s'  rc=%d", f->h.text, rc);
 
-	return rc;
+	if (op->need_pos)
+		op->kinds = FILTER_KIND_HASPOS;
 }
 
-int filter_process(struct worker_t *self, struct client_t *c, struct pbuf_t *pb)
+static int filter_chain_len(struct filter_t *f)
 {
-	struct filter_t *f;
+	int n = 0;
+
+	for ( ; f; f = f->h.next)
+		n++;
+
+	return n;
+}
+
+static struct filter_op_t *filter_compile_chain(struct filter_op_t *op, struct filter_t *f)
+{
+	for ( ; f; f = f->h.next)
+		filter_compile_op(op++, f);
+
+	return op;
+}
+
+/*
+ *	(Re)build the filter program of a client from its filter chains.
+ *	Must be called every time the chains are modified, since the
+ *	program points to the filter cells.
+ */
+
+void filter_compile(struct client_t *c)
+{
+	struct filter_prog_t *prog;
+	struct filter_op_t *op;
+	int n;
+
+	filter_prog_free(c);
+
+	n = filter_chain_len(c->negdefaultfilters) + filter_chain_len(c->posdefaultfilters)
+		+ filter_chain_len(c->neguserfilters) + filter_chain_len(c->posuserfilters);
+
+	if (n == 0)
+		return;
+
+	prog = hmalloc(sizeof(*prog) + (n - 1) * sizeof(struct filter_op_t));
+
+	op = filter_compile_chain(prog->ops, c->negdefaultfilters);
+	prog->negdefault_end = op - prog->ops;
+	op = filter_compile_chain(op, c->posdefaultfilters);
+	prog->posdefault_end = op - prog->ops;
+	op = filter_compile_chain(op, c->neguserfilters);
+	prog->neguser_end = op - prog->ops;
+	op = filter_compile_chain(op, c->posuserfilters);
+	prog->posuser_end = op - prog->ops;
+
+	prog->has_hist = 0;
+	n = 0;
+	for (op = prog->ops; op < prog->ops + prog->posuser_end; op++) {
+		if (op->fn == filter_process_one_f || op->fn == filter_process_one_m)
+			prog->has_hist = 1;
+		if (op->fn == filter_process_one_r || op->fn == filter_process_one_f || op->fn == filter_process_one_m)
+			n++;
+	}
 	
-	/* messaging support: if (1) this is a text message,
+	/* many range filters are checked all at once, see filter_range_bit() */
+	memset(&prog->ranges, 0, sizeof(prog->ranges));
+	prog->range_bits = NULL;
+	prog->range_bits_valid = 0;
+	if (n >= FILTER_RANGE_BATCH_MIN) {
+		range_set_init(&prog->ranges, n);
+		prog->range_bits = hmalloc(sizeof(uint32_t) * RANGE_BITS_WORDS(n));
+		n = 0;
+		for (op = prog->ops; op < prog->ops + prog->posuser_end; op++) {
+			if (op->fn == filter_process_one_r) {
+				range_set_put(&prog->ranges, n, &op->pt, op->limit);
+				op->range_slot = n++;
+			} else if (op->fn == filter_process_one_f || op->fn == filter_process_one_m) {
+				op->range_slot = n++;
+			}
+		}
+	}
+
+	/* Kinds of packets the positive filters may pass. Bad filters
+	 * are reported to the user when run, so they need to run always.
+	 */
+	c->filter_kinds = 0;
+	for (n = 0, op = prog->ops; n < prog->posuser_end; n++, op++) {
+		if ((n >= prog->negdefault_end && n < prog->posdefault_end) || n >= prog->neguser_end)
+			c->filter_kinds |= op->kinds;
+		if (op->fn == filter_process_one_bad)
+			c->filter_kinds |= T_ALL;
+	}
+
+	c->filter_prog = prog;
+}
+
+static void filter_unshare(struct client_t *c);
+static void filter_centres_unbind(struct filter_prog_t *prog);
+
+void filter_prog_free(struct client_t *c)
+{
+	filter_unshare(c);
+	
+	if (c->filter_prog) {
+		filter_centres_unbind(c->filter_prog);
+		if (c->filter_prog->range_bits) {
+			range_set_free(&c->filter_prog->ranges);
+			hfree(c->filter_prog->range_bits);
+		}
+		hfree(c->filter_prog);
+		c->filter_prog = NULL;
+	}
+	c->filter_kinds = 0;
+}
+
+/*
+ *	Shared filters.
+ *
+ *	Popular applications log in with the same default filter strings,
+ *	so many clients of a worker often have identical filters. They are
+ *	interned by a key made of the filter texts of the four chains, each
+ *	chain sorted. filter_process() runs the filters once per packet for
+ *	each distinct key, and reuses the verdict for the other clients.
+ *	The programs are not shared, each client still has its own filter
+ *	cells. Filters having m/ are not shared, since the verdict depends
+ *	on the position of the client itself.
+ *
+ *	The table is per worker, and only used by the worker thread.
+ */
+
+#define FILTER_INTERN_HASH_INITIAL	64
+
+struct filter_intern_t *filter_intern_alloc(void)
+{
+	struct filter_intern_t *fi;
+
+	fi = hmalloc(sizeof(*fi));
+	memset(fi, 0, sizeof(*fi));
+
+	fi->hash_size = FILTER_INTERN_HASH_INITIAL;
+	fi->hash = hmalloc(sizeof(*fi->hash) * fi->hash_size);
+	memset(fi->hash, 0, sizeof(*fi->hash) * fi->hash_size);
+
+	return fi;
+}
+
+void filter_intern_free(struct filter_intern_t *fi)
+{
+	struct filter_shared_t *sh, *next;
+	int i;
+
+	if (!fi)
+		return;
+
+	for (i = 0; i < fi->hash_size; i++) {
+		for (sh = fi->hash[i]; (sh); sh = next) {
+			next = sh->next;
+			hfree(sh);
+		}
+	}
+
+	hfree(fi->hash);
+	hfree(fi);
+}
+
+static void filter_intern_grow(struct filter_intern_t *fi)
+{
+	struct filter_shared_t **hash, *sh, *next;
+	int i, size = fi->hash_size * 2;
+
+	hash = hmalloc(sizeof(*hash) * size);
+	memset(hash, 0, sizeof(*hash) * size);
+
+	for (i = 0; i < fi->hash_size; i++) {
+		for (sh = fi->hash[i]; (sh); sh = next) {
+			next = sh->next;
+			sh->next = hash[sh->hash & (size - 1)];
+			hash[sh->hash & (size - 1)] = sh;
+		}
+	}
+
+	hfree(fi->hash);
+	fi->hash = hash;
+	fi->hash_size = size;
+}
+
+static int filter_cmp_text(const void *a, const void *b)
+{
+	return strcmp(*(const char **)a, *(const char **)b);
+}
+
+/*
+ *	Build the interning key of a client's filters, returns
+ *	the length of the key, or -1 if the filters can not be shared
+ */
+
+static int filter_intern_key(struct client_t *c, char **keyp)
+{
+	struct filter_prog_t *prog = c->filter_prog;
+	const char **texts;
+	int ends[4], i, j, start, len = 0;
+	char *key, *p;
+
+	texts = hmalloc(sizeof(*texts) * prog->posuser_end);
+	for (i = 0; i < prog->posuser_end; i++) {
+		/* bad filters are reported to each client on their own, and
+		 * m/ filters depend on the position of the client itself
+		 */
+		if (prog->ops[i].fn == filter_process_one_bad || prog->ops[i].fn == filter_process_one_m) {
+			hfree(texts);
+			return -1;
+		}
+		texts[i] = prog->ops[i].f->h.text;
+		len += strlen(texts[i]) + 1;
+	}
+
+	key = p = hmalloc(len + 4);
+
+	ends[0] = prog->negdefault_end;
+	ends[1] = prog->posdefault_end;
+	ends[2] = prog->neguser_end;
+	ends[3] = prog->posuser_end;
+
+	/* the order of the filters within a chain does not change whether
+	 * a packet passes, so sort them to find more identical sets
+	 */
+	for (i = 0, start = 0; i < 4; start = ends[i++]) {
+		qsort(texts + start, ends[i] - start, sizeof(*texts), filter_cmp_text);
+		for (j = start; j < ends[i]; j++) {
+			if (j > start && strcmp(texts[j], texts[j-1]) == 0)
+				continue;
+			p += sprintf(p, "%s ", texts[j]);
+		}
+		*p++ = '\n';
+	}
+
+	hfree(texts);
+	*keyp = key;
+
+	return p - key;
+}
+
+/*
+ *	Attach a client to the shared filter having the same key,
+ *	or add a new one. Called when the client is classified, after
+ *	its filters have been compiled.
+ */
+
+void filter_intern(struct filter_intern_t *fi, struct client_t *c)
+{
+	struct filter_shared_t *sh;
+	uint32_t hash;
+	char *key;
+	int keylen;
+
+	if (c->filter_shared || !c->filter_prog)
+		return;
+
+	keylen = filter_intern_key(c, &key);
+	if (keylen < 0)
+		return;
+
+	hash = keyhash(key, keylen, 0);
+	for (sh = fi->hash[hash & (fi->hash_size - 1)]; (sh); sh = sh->next)
+		if (sh->hash == hash && sh->keylen == keylen && memcmp(sh->key, key, keylen) == 0)
+			break;
+
+	if (!sh) {
+		if (fi->entries >= fi->hash_size)
+			filter_intern_grow(fi);
+
+		sh = hmalloc(sizeof(*sh) + keylen);
+		memset(sh, 0, sizeof(*sh));
+		sh->fi = fi;
+		sh->hash = hash;
+		sh->keylen = keylen;
+		memcpy(sh->key, key, keylen);
+		sh->key[keylen] = 0;
+
+		sh->next = fi->hash[hash & (fi->hash_size - 1)];
+		fi->hash[hash & (fi->hash_size - 1)] = sh;
+		fi->entries++;
+	}
+
+	hfree(key);
+
+	sh->refcount++;
+	fi->clients++;
+	c->filter_shared = sh;
+}
+
+/*
+ *	Detach a client from its shared filter, when its filter program
+ *	is freed
+ */
+
+static void filter_unshare(struct client_t *c)
+{
+	struct filter_shared_t *sh = c->filter_shared;
+	struct filter_shared_t **prevp;
+	struct filter_intern_t *fi;
+
+	if (!sh)
+		return;
+
+	c->filter_shared = NULL;
+	fi = sh->fi;
+	fi->clients--;
+
+	if (--sh->refcount > 0)
+		return;
+
+	for (prevp = &fi->hash[sh->hash & (fi->hash_size - 1)]; (*prevp); prevp = &(*prevp)->next) {
+		if (*prevp == sh) {
+			*prevp = sh->next;
+			break;
+		}
+	}
+
+	fi->entries--;
+	hfree(sh);
+}
+
+/*
+ *	Subscribed f/ and m/ filter centres, see filter_centre_t.
+ *	The table is per worker, and only used by the worker thread.
+ */
+
+struct filter_centres_t *filter_centres_alloc(void)
+{
+	struct filter_centres_t *fc;
+
+	fc = hmalloc(sizeof(*fc));
+	memset(fc, 0, sizeof(*fc));
+
+	fc->hash = hmalloc(sizeof(*fc->hash) * FILTER_CENTRES_HASH);
+	memset(fc->hash, 0, sizeof(*fc->hash) * FILTER_CENTRES_HASH);
+	historydb_queue_init(&fc->queue);
+
+	return fc;
+}
+
+void filter_centres_free(struct filter_centres_t *fc)
+{
+	struct filter_centre_t *ce, *next;
+	int i;
+
+	if (!fc)
+		return;
+
+	for (i = 0; i < FILTER_CENTRES_HASH; i++) {
+		for (ce = fc->hash[i]; (ce); ce = next) {
+			next = ce->next;
+			historydb_unsubscribe(ce->key, ce->keylen, &fc->queue, ce);
+			hfree(ce);
+		}
+	}
+
+	historydb_updates_free(historydb_queue_take(&fc->queue));
+	pthread_mutex_destroy(&fc->queue.mutex);
+	hfree(fc->hash);
+	hfree(fc);
+}
+
+/*
+ *	Apply the positions published by the historydb, returns the
+ *	number of updates
+ */
+
+int filter_centres_update(struct filter_centres_t *fc)
+{
+	struct historydb_update_t *updates, *u;
+	struct filter_centre_t *ce;
+	int n = 0;
+
+	updates = historydb_queue_take(&fc->queue);
+	for (u = updates; (u); u = u->next) {
+		ce = u->data;
+		n++;
+		if (!u->arrivaltime) {
+			ce->valid = 0;
+			continue;
+		}
+		ce->valid = 1;
+		ce->arrivaltime = u->arrivaltime;
+		ce->lat = u->lat;
+		ce->coslat = u->coslat;
+		ce->lon = u->lon;
+		range_point_set(&ce->pt, ce->lat, ce->lon, ce->coslat);
+	}
+
+	historydb_updates_free(updates);
+	fc->updates += n;
+
+	return n;
+}
+
+/*
+ *	Forget positions which historydb_lookup() would consider too old,
+ *	called once a second.
+ */
+
+void filter_centres_expire(struct filter_centres_t *fc)
+{
+	struct filter_centre_t *ce;
+	time_t validitytime = tick - lastposition_storetime + 5*60;
+	int i;
+
+	for (i = 0; i < FILTER_CENTRES_HASH; i++)
+		for (ce = fc->hash[i]; (ce); ce = ce->next)
+			if (ce->valid && ce->arrivaltime <= validitytime)
+				ce->valid = 0;
+}
+
+static struct filter_centre_t *filter_centre_get(struct filter_centres_t *fc, const char *key, int keylen)
+{
+	struct filter_centre_t *ce;
+	struct history_cell_t *history;
+	uint32_t hash;
+
+	if (keylen <= 0 || keylen > CALLSIGNLEN_MAX+1)
+		return NULL;
+
+	hash = keyhash(key, keylen, 0);
+	for (ce = fc->hash[hash % FILTER_CENTRES_HASH]; (ce); ce = ce->next)
+		if (ce->hash == hash && ce->keylen == keylen && memcmp(ce->key, key, keylen) == 0)
+			break;
+
+	if (!ce) {
+		ce = hmalloc(sizeof(*ce));
+		memset(ce, 0, sizeof(*ce));
+		ce->fc = fc;
+		ce->hash = hash;
+		ce->keylen = keylen;
+		memcpy(ce->key, key, keylen);
+
+		ce->next = fc->hash[hash % FILTER_CENTRES_HASH];
+		fc->hash[hash % FILTER_CENTRES_HASH] = ce;
+		fc->entries++;
+
+		/* subscribe first, so that no position in between is lost */
+		historydb_subscribe(key, keylen, &fc->queue, ce);
+		if (historydb_lookup(key, keylen, &history)) {
+			ce->valid = 1;
+			ce->arrivaltime = history->arrivaltime;
+			ce->lat = history->lat;
+			ce->coslat = history->coslat;
+			ce->lon = history->lon;
+			range_point_set(&ce->pt, ce->lat, ce->lon, ce->coslat);
+		}
+	}
+
+	ce->refcount++;
+
+	return ce;
+}
+
+static void filter_centre_put(struct filter_centre_t *ce)
+{
+	struct filter_centres_t *fc = ce->fc;
+	struct filter_centre_t **prevp;
+
+	if (--ce->refcount > 0)
+		return;
+
+	/* the queue may still have updates for it */
+	historydb_unsubscribe(ce->key, ce->keylen, &fc->queue, ce);
+	filter_centres_update(fc);
+
+	for (prevp = &fc->hash[ce->hash % FILTER_CENTRES_HASH]; (*prevp); prevp = &(*prevp)->next) {
+		if (*prevp == ce) {
+			*prevp = ce->next;
+			break;
+		}
+	}
+
+	fc->entries--;
+	hfree(ce);
+}
+
+/*
+ *	Subscribe the f/ and m/ filter centres of a client. Called when the
+ *	client is classified, after its filters have been compiled. The m/
+ *	filters of a client which has sent its own position do not need one.
+ */
+
+void filter_centres_bind(struct filter_centres_t *fc, struct client_t *c)
+{
+	struct filter_prog_t *prog = c->filter_prog;
+	struct filter_op_t *op;
+
+	if (!prog || !prog->has_hist)
+		return;
+
+	for (op = prog->ops; op < prog->ops + prog->posuser_end; op++) {
+		if (op->centre)
+			continue;
+		if (op->fn == filter_process_one_f)
+			op->centre = filter_centre_get(fc, op->f->h.refcallsign.callsign, op->f->h.refcallsign.reflen);
+		else if (op->fn == filter_process_one_m && !c->loc_known)
+			op->centre = filter_centre_get(fc, c->username, strlen(c->username));
+	}
+}
+
+static void filter_centres_unbind(struct filter_prog_t *prog)
+{
+	struct filter_op_t *op;
+
+	if (!prog->has_hist)
+		return;
+
+	for (op = prog->ops; op < prog->ops + prog->posuser_end; op++) {
+		if (op->centre) {
+			filter_centre_put(op->centre);
+			op->centre = NULL;
+		}
+	}
+}
+
+/*
+ *	Support for the geoindex and the callindex.
+ *
+ *	If all of the positive filters of a client are position filters
+ *	or callsign set filters, filter_process() can only pass packets which
+ *	have a position within one of the regions covered by the position
+ *	filters, or one of the callsigns of the callsign set filters in
+ *	the right place (negative filters can only drop more).
+ */
+
+static inline int filter_prog_op_positive(const struct filter_prog_t *prog, int i)
+{
+	return (i >= prog->negdefault_end && i < prog->posdefault_end) || i >= prog->neguser_end;
+}
+
+/* the packet field matched by a callsign set filter, or -1 */
+static int filter_call_class(const struct filter_op_t *op)
+{
+	if (op->fn == filter_process_one_p || op->fn == filter_process_one_b)
+		return CALLINDEX_SRC;
+	if (op->fn == filter_process_one_o)
+		return CALLINDEX_OBJ;
+	if (op->fn == filter_process_one_e)
+		return CALLINDEX_ENTRY;
+	if (op->fn == filter_process_one_u)
+		return CALLINDEX_DST;
+	if (op->fn == filter_process_one_d)
+		return CALLINDEX_DIGI;
+	if (op->fn == filter_process_one_g)
+		return CALLINDEX_MSG;
+
+	return -1;
+}
+
+/* Range of the position filters in radians of central angle, as
+ * checked by range_within(), with some slack for the
+ * single precision floating point
+ */
+static void filter_geo_circle(struct geoindex_box_t *b, float lat, float lon, float dist)
+{
+	double a = dist / (111.2 * 180.0 / M_PI) * 1.001 + 0.0002;
+	double dlon;
+
+	b->lat_s = lat - a;
+	b->lat_n = lat + a;
+
+	if (a >= M_PI / 2 || fabs(lat) + a >= M_PI / 2) {
+		/* reaches over a pole, or half around the world */
+		b->lon_w = -2 * M_PI;
+		b->lon_e = 2 * M_PI;
+		return;
+	}
+
+	dlon = asin(sin(a) / cos(lat)) * 1.001 + 0.0002;
+	b->lon_w = lon - dlon;
+	b->lon_e = lon + dlon;
+}
+
+static int filter_geo_op_region(struct client_t *c, const struct filter_op_t *op, struct geoindex_box_t *b)
+{
+	struct filter_t *f = op->f;
+
+	if (op->fn == filter_process_one_a) {
+		b->lat_s = op->latS;
+		b->lat_n = op->latN;
+		b->lon_w = op->lonW;
+		b->lon_e = op->lonE;
+		return 1;
+	}
+
+	if (op->fn == filter_process_one_r) {
+		filter_geo_circle(b, op->latN, op->lonE, op->dist);
+		return 1;
+	}
+
+	if (op->fn == filter_process_one_m && c->loc_known) {
+		filter_geo_circle(b, c->lat, c->lng, f->h.f_dist);
+		return 1;
+	}
+
+	if (op->fn == filter_process_one_f || op->fn == filter_process_one_m) {
+		if (op->fn == filter_process_one_f)
+			filter_hist_lookup_f(op);
+		else
+			filter_hist_lookup_m(c, op);
+		if (!f->h.numnames)
+			return 0; /* no position known for the centre, can not match */
+		filter_geo_circle(b, f->h.f_latN, f->h.f_lonE, f->h.f_dist);
+		return 1;
+	}
+
+	return -1;
+}
+
+/*
+ *	Fill in a bounding box of each region of the position filters, and
+ *	return the number of boxes. Callsign set filters are skipped, they
+ *	go in the callindex. Return -1 if the client might get packets
+ *	matching neither.
+ */
+
+int filter_geo_regions(struct client_t *c, struct geoindex_box_t *boxes, int max)
+{
+	struct filter_prog_t *prog = c->filter_prog;
+	int i, n = 0, rc;
+
+	/* igate ports get messages and courtesy positions without filters */
+	if (c->flags & CLFLAGS_IGATE)
+		return -1;
+
+	if (!prog)
+		return 0;
+
+	for (i = prog->negdefault_end; i < prog->posuser_end; i++) {
+		/* only the positive filters */
+		if (i == prog->posdefault_end)
+			i = prog->neguser_end;
+		if (i >= prog->posuser_end)
+			break;
+
+		if (filter_call_class(&prog->ops[i]) >= 0)
+			continue;
+
+		if (n == max)
+			return -1;
+
+		rc = filter_geo_op_region(c, &prog->ops[i], &boxes[n]);
+		if (rc < 0)
+			return -1;
+		n += rc;
+	}
+
+	return n;
+}
+
+/*
+ *	For clients in the geoindex, the worker refreshes the historydb
+ *	position caches of the f/ and m/ filters once per second, and when
+ *	subscribed positions arrive, instead of them being refreshed when
+ *	processing packets. Returns 1 if a
+ *	region of a positive filter moved and the client needs to be
+ *	indexed again.
+ */
+
+int filter_geo_refresh(struct client_t *c)
+{
+	struct filter_prog_t *prog = c->filter_prog;
+	struct filter_op_t *op;
+	struct filter_t *f;
+	int i, valid, moved = 0;
+	float lat, lon;
+
+	if (!prog || !prog->has_hist)
+		return 0;
+
+	for (i = 0; i < prog->posuser_end; i++) {
+		op = &prog->ops[i];
+		f = op->f;
+
+		if (op->fn == filter_process_one_m) {
+			if (c->loc_known)
+				continue;
+		} else if (op->fn != filter_process_one_f) {
+			continue;
+		}
+
+		valid = f->h.numnames;
+		lat = f->h.f_latN;
+		lon = f->h.f_lonE;
+
+		if (op->fn == filter_process_one_f)
+			filter_hist_lookup_f(op);
+		else
+			filter_hist_lookup_m(c, op);
+
+		if (valid != f->h.numnames || lat != f->h.f_latN || lon != f->h.f_lonE) {
+			if (filter_prog_op_positive(prog, i))
+				moved = 1;
+		}
+	}
+
+	return moved;
+}
+
+/*
+ *	Collect the callsigns and prefixes of the positive callsign set
+ *	filters of a client, for the callindex. Returns the number of keys,
+ *	the hmalloc()ed keys array needs to be freed by the caller.
+ */
+
+int filter_call_keys(struct client_t *c, struct callindex_key_t **keysp)
+{
+	struct filter_prog_t *prog = c->filter_prog;
+	struct callindex_key_t *keys, *k;
+	struct filter_refcallsign_t *r;
+	int i, j, cls, n = 0;
+
+	*keysp = NULL;
+	if (!prog)
+		return 0;
+
+	for (i = 0; i < prog->posuser_end; i++)
+		if (filter_prog_op_positive(prog, i) && filter_call_class(&prog->ops[i]) >= 0)
+			n += prog->ops[i].f->h.numnames;
+
+	if (n == 0)
+		return 0;
+
+	k = keys = hmalloc(sizeof(*keys) * n);
+	for (i = 0; i < prog->posuser_end; i++) {
+		if (!filter_prog_op_positive(prog, i) || (cls = filter_call_class(&prog->ops[i])) < 0)
+			continue;
+
+		r = prog->ops[i].f->h.refcallsigns;
+		for (j = 0; j < prog->ops[i].f->h.numnames; j++) {
+			/* empty ones never match */
+			if ((r[j].reflen & LengthMask) == 0)
+				continue;
+			k->cls = cls;
+			k->prefix = (prog->ops[i].fn == filter_process_one_p || (r[j].reflen & WildCard)) ? 1 : 0;
+			k->len = r[j].reflen & LengthMask;
+			memcpy(k->call, r[j].callsign, k->len);
+			k++;
+		}
+	}
+
+	*keysp = keys;
+
+	return k - keys;
+}
+
+/*
+ *	Check if the client has an m/ filter using the client's own
+ *	position, which would need to be re-indexed when it moves.
+ */
+
+int filter_geo_uses_loc(struct client_t *c)
+{
+	struct filter_prog_t *prog = c->filter_prog;
+	int i;
+
+	if (!prog)
+		return 0;
+
+	for (i = 0; i < prog->posuser_end; i++)
+		if (prog->ops[i].fn == filter_process_one_m)
+			return 1;
+
+	return 0;
+}
+
+/*
+ *	Run a single filter program operation
+ */
+
+static inline int filter_op_run(struct client_t *c, struct pbuf_t *pb, const struct filter_op_t *op)
+{
+	if (op->need_pos && !(pb->flags & F_HASPOS)) /* packet with a position.. (msgs with RECEIVER's position) */
+		return 0;
+
+	return op->fn(c, pb, op);
+}
+
+static int filter_prog_run(struct worker_t *self, struct client_t *c, struct pbuf_t *pb, struct filter_prog_t *prog, int *bad);
+
+int filter_process(struct worker_t *self, struct client_t *c, struct pbuf_t *pb)
+{
+	struct filter_prog_t *prog;
+	struct filter_shared_t *sh;
+	int rc, bad;
+	
+	/* messaging support: if (1) this is a text message,
 	 * (2) the client is an igate port,
 	 * and (3) the message's recipient has been heard
 	 * recently on the port, gate the message.
@@ -2504,48 +3512,85 @@ int filter_process(struct worker_t *self, struct client_t *c, struct pbuf_t *pb)
 		}
 	}
 	
-	f = c->negdefaultfilters;
-	for ( ; f; f = f->h.next ) {
-		int rc = filter_process_one(c, pb, f);
+	prog = c->filter_prog;
+	if (!prog)
+		return 0;
+	
+	/* another client having the same filters already ran them for this packet */
+	sh = (self) ? c->filter_shared : NULL;
+	if (sh) {
+		if (sh->stamp == self->packet_stamp) {
+			self->filter_shared_hits++;
+			return sh->rc;
+		}
+	}
+	
+	rc = filter_prog_run(self, c, pb, prog, &bad);
+	
+	/* verdicts involving bad filters are not shared, the other
+	 * clients need to be notified as well
+	 */
+	if (sh && !bad) {
+		sh->stamp = self->packet_stamp;
+		sh->rc = rc;
+	}
+	
+	return rc;
+}
+
+/*
+ *	Run the filter program of a client, *bad is set if any of the
+ *	filters failed
+ */
+
+static int filter_prog_run(struct worker_t *self, struct client_t *c, struct pbuf_t *pb, struct filter_prog_t *prog, int *bad)
+{
+	const struct filter_op_t *op;
+	int i;
+	
+	*bad = 0;
+	prog->range_bits_valid = 0;
+	op = prog->ops;
+	for (i = 0; i < prog->negdefault_end; i++, op++) {
+		int rc = filter_op_run(c, pb, op);
 		/* no reports to user about bad filters.. */
 		if (rc > 0)
 			return 0; // match on filter - no output on client
 	}
 
-	f = c->posdefaultfilters;
-	for ( ; f; f = f->h.next ) {
-		int rc = filter_process_one(c, pb, f);
+	for ( ; i < prog->posdefault_end; i++, op++) {
+		int rc = filter_op_run(c, pb, op);
 		/* no reports to user about bad filters.. */
 		if (rc > 0) {
-			FILTER_CLIENT_DEBUG(self, c, "# matched server default filter %s\r\n", f->h.text);
+			FILTER_CLIENT_DEBUG(self, c, "# matched server default filter %s\r\n", op->f->h.text);
 			return rc;
 		}
 	}
 
-	f = c->neguserfilters;
-	for ( ; f; f = f->h.next ) {
-		int rc = filter_process_one(c, pb, f);
+	for ( ; i < prog->neguser_end; i++, op++) {
+		int rc = filter_op_run(c, pb, op);
 		if (rc < 0) {
-			rc = client_bad_filter_notify(self, c, f->h.text);
+			*bad = 1;
+			rc = client_bad_filter_notify(self, c, op->f->h.text);
 			if (rc < 0) /* possibly the client got destroyed here! */
 				return rc;
 		}
 		if (rc > 0) {
-			FILTER_CLIENT_DEBUG(self, c, "# matched negative filter %s\r\n", f->h.text);
+			FILTER_CLIENT_DEBUG(self, c, "# matched negative filter %s\r\n", op->f->h.text);
 			return 0; // match on filter - no output on client
 		}
 	}
 
-	f = c->posuserfilters;
-	for ( ; f; f = f->h.next ) {
-		int rc = filter_process_one(c, pb, f);
+	for ( ; i < prog->posuser_end; i++, op++) {
+		int rc = filter_op_run(c, pb, op);
 		if (rc < 0) {
-			rc = client_bad_filter_notify(self, c, f->h.text);
+			*bad = 1;
+			rc = client_bad_filter_notify(self, c, op->f->h.text);
 			if (rc < 0) /* possibly the client got destroyed here! */
 				return rc;
 		}
 		if (rc > 0) {
-			FILTER_CLIENT_DEBUG(self, c, "# matched filter %s\r\n", f->h.text);
+			FILTER_CLIENT_DEBUG(self, c, "# matched filter %s\r\n", op->f->h.text);
 			return rc;
 		}
 	}
@@ -2629,6 +3674,8 @@ int filter_commands(struct worker_t *self, struct client_t *c, int in_message, c
 		f = c->posuserfilters;
 		filter_free(f);
 		c->posuserfilters = NULL;
+		filter_compile(c);
+		worker_reclassify_client(self, c);
 		// FIXME: Sleep a bit ? ... no, that would be a way to create a denial of service attack
 		// FIXME: there is a danger of SEGV-blowing filter processing...
 		return filter_command_reply(self, c, in_message, "User filters reset to default");
@@ -2644,6 +3691,7 @@ int filter_commands(struct worker_t *self, struct client_t *c, int in_message, c
 	f = c->posuserfilters;
 	c->posuserfilters = NULL;
 	filter_free(f);
+	filter_compile(c);
 	// FIXME: Sleep a bit ? ... no, that would be a way to create a denial of service attack
 	// FIXME: there is a danger of SEGV-blowing filter processing...
 
@@ -2662,6 +3710,9 @@ int filter_commands(struct worker_t *self, struct client_t *c, int in_message, c
 	}
 	hfree(b);
 	
+	/* the client might go in or out of the geoindex */
+	worker_reclassify_client(self, c);
+	
 	return filter_command_reply(self, c, in_message, "filter %s active", c->filter_s);
 }
 
@@ -13,11 +13,91 @@
 
 #include "worker.h"
 #include "cellmalloc.h"
+#include "historydb.h"
 
 extern void filter_init(void);
 extern int  filter_parse(struct client_t *c, const char *filt, int is_user_filter);
 extern void filter_free(struct filter_t *c);
+extern void filter_compile(struct client_t *c);
+extern void filter_prog_free(struct client_t *c);
+
+struct geoindex_box_t;
+extern int  filter_geo_regions(struct client_t *c, struct geoindex_box_t *boxes, int max);
+extern int  filter_geo_refresh(struct client_t *c);
+extern int  filter_geo_uses_loc(struct client_t *c);
+
+struct callindex_key_t;
+extern int  filter_call_keys(struct client_t *c, struct callindex_key_t **keysp);
 extern int  filter_process(struct worker_t *self, struct client_t *c, struct pbuf_t *pb);
+
+/*
+ *	Clients having identical filters share a filter_shared_t, interned
+ *	in a per-worker table, and the verdict of filter_process() for the
+ *	current packet is cached in it.
+ */
+struct filter_shared_t {
+	struct filter_shared_t *next;	/* in the hash bucket */
+	struct filter_intern_t *fi;
+	uint32_t hash;
+	int refcount;			/* clients having these filters */
+	uint32_t stamp;			/* self->packet_stamp of the verdict, 0 if none */
+	int rc;				/* cached verdict of filter_process() */
+	int keylen;
+	char key[1];
+};
+
+/* another client having the same filters has already rejected the current packet */
+static inline int filter_shared_rejected(struct worker_t *self, struct filter_shared_t *sh)
+{
+	return sh && sh->stamp == self->packet_stamp && sh->rc < 1;
+}
+
+struct filter_intern_t {
+	struct filter_shared_t **hash;
+	int hash_size;
+	int entries;		/* distinct filter sets */
+	int clients;		/* clients having one of them */
+};
+
+extern struct filter_intern_t *filter_intern_alloc(void);
+extern void filter_intern_free(struct filter_intern_t *fi);
+extern void filter_intern(struct filter_intern_t *fi, struct client_t *c);
+
+/*
+ *	The historydb positions of the f/ and m/ filter centres of the
+ *	clients of a worker, one for each callsign, kept up to date by
+ *	historydb subscriptions which feed the queue.
+ */
+struct filter_centre_t;
+
+struct filter_centres_t {
+	struct filter_centre_t **hash;
+	int entries;		/* callsigns subscribed */
+	long updates;		/* positions received */
+	struct historydb_queue_t queue;
+};
+
+extern struct filter_centres_t *filter_centres_alloc(void);
+extern void filter_centres_free(struct filter_centres_t *fc);
+extern void filter_centres_bind(struct filter_centres_t *fc, struct client_t *c);
+extern int  filter_centres_update(struct filter_centres_t *fc);
+extern void filter_centres_expire(struct filter_centres_t *fc);
+
+/*
+ *	Kinds of a packet, for a quick check of whether the filters of
+ *	a client (c->filter_kinds) could pass it at all: the T_* packet
+ *	type bits (T_ALL is set on every packet) and a couple more.
+ */
+#define FILTER_KIND_HASPOS	(1 << 16)	/* F_HASPOS is set */
+#define FILTER_KIND_SYMBOL	(1 << 17)	/* has a symbol */
+
+static inline uint32_t filter_packet_kinds(struct pbuf_t *pb)
+{
+	return pb->packettype
+		| ((pb->flags & F_HASPOS) ? FILTER_KIND_HASPOS : 0)
+		| ((pb->symbol[1]) ? FILTER_KIND_SYMBOL : 0);
+}
+
 extern int  filter_commands(struct worker_t *self, struct client_t *c, int in_message, const char *s, const int len);
 
 extern void filter_preprocess_dupefilter(struct pbuf_t *pb);
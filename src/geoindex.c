@@ -0,0 +1,231 @@
+/*
+ *	aprsc
+ *
+ *	(c) Heikki Hannikainen, OH7LZB <hessu@hes.iki.fi>
+ *
+ *     This program is licensed under the BSD license, which can be found
+ *     in the file LICENSE.
+ *
+ */
+
+/*
+ *	geoindex.c: a per-worker lat/lon grid of the regions covered by the
+ *	position filters (a/ r/ f/ m/) of the worker's clients.
+ *
+ *	A client is indexed if it has nothing but position filters and
+ *	callsign set filters in its positive filter set: it can then only
+ *	get packets which have a position within one of its regions, or
+ *	match one of the callsigns in the callindex. For a packet with a
+ *	position, process_outgoing_single() only looks at the clients
+ *	registered in the grid cell of the packet's position (and the ones
+ *	found in the callindex), and clients which could not be indexed are
+ *	kept in self->clients_other and run through the filters for every
+ *	packet, as before.
+ *
+ *	The regions are provided by filter_geo_regions(), and the index is
+ *	only modified by the worker thread which owns it, outside of the
+ *	outgoing packet loop. The only exception is client_close(), which
+ *	may remove the client currently being processed from its cells.
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "geoindex.h"
+#include "filter.h"
+#include "hmalloc.h"
+#include "hlog.h"
+
+struct geoindex_t *geoindex_alloc(void)
+{
+	struct geoindex_t *gi;
+
+	gi = hmalloc(sizeof(*gi));
+	memset(gi, 0, sizeof(*gi));
+
+	return gi;
+}
+
+void geoindex_free(struct geoindex_t *gi)
+{
+	int i;
+
+	if (!gi)
+		return;
+
+	for (i = 0; i < GEOINDEX_ROWS * GEOINDEX_COLS; i++)
+		if (gi->cells[i].clients)
+			hfree(gi->cells[i].clients);
+
+	hfree(gi);
+}
+
+/*
+ *	Grid coordinates. Rows are clamped at the poles, columns are not
+ *	wrapped here so that boxes crossing the date line can be walked
+ *	from west to east.
+ */
+
+static inline int geoindex_row(float lat)
+{
+	int r = (int)floor((lat * (180.0 / M_PI) + 90.0) / GEOINDEX_CELL_DEG);
+
+	if (r < 0)
+		return 0;
+	if (r >= GEOINDEX_ROWS)
+		return GEOINDEX_ROWS - 1;
+
+	return r;
+}
+
+static inline int geoindex_col(float lng)
+{
+	return (int)floor((lng * (180.0 / M_PI) + 180.0) / GEOINDEX_CELL_DEG);
+}
+
+static inline int geoindex_col_wrap(int col)
+{
+	col %= GEOINDEX_COLS;
+
+	return (col < 0) ? col + GEOINDEX_COLS : col;
+}
+
+static int geoindex_cmp_int(const void *a, const void *b)
+{
+	return *(const int *)a - *(const int *)b;
+}
+
+/*
+ *	Collect the cells covered by a box in the cells array,
+ *	return the new number of cells, or -1 if there are too many
+ */
+
+static int geoindex_box_cells(struct geoindex_box_t *b, int *cells, int n)
+{
+	int r, c, r0, r1, c0, c1;
+
+	if (b->lat_s > b->lat_n || b->lon_w > b->lon_e)
+		return n; /* empty, can not match anything */
+
+	r0 = geoindex_row(b->lat_s);
+	r1 = geoindex_row(b->lat_n);
+	c0 = geoindex_col(b->lon_w);
+	c1 = geoindex_col(b->lon_e);
+
+	if (c1 - c0 + 1 >= GEOINDEX_COLS) {
+		c0 = 0;
+		c1 = GEOINDEX_COLS - 1;
+	}
+
+	if (n + (r1 - r0 + 1) * (c1 - c0 + 1) > GEOINDEX_MAX_CELLS)
+		return -1;
+
+	for (r = r0; r <= r1; r++)
+		for (c = c0; c <= c1; c++)
+			cells[n++] = r * GEOINDEX_COLS + geoindex_col_wrap(c);
+
+	return n;
+}
+
+static void geoindex_cell_add(struct geoindex_cell_t *cell, struct client_t *c)
+{
+	if (cell->count == cell->size) {
+		cell->size = (cell->size) ? cell->size * 2 : 8;
+		cell->clients = hrealloc(cell->clients, sizeof(*cell->clients) * cell->size);
+	}
+
+	cell->clients[cell->count++] = c;
+}
+
+/*
+ *	Remove a client from a cell by moving the last client in its place.
+ *	The outgoing loop walks the cells backwards, so that the client
+ *	being processed can go away without any other client being skipped.
+ */
+
+static void geoindex_cell_remove(struct geoindex_cell_t *cell, struct client_t *c)
+{
+	int i;
+
+	for (i = 0; i < cell->count; i++) {
+		if (cell->clients[i] == c) {
+			cell->clients[i] = cell->clients[--cell->count];
+			return;
+		}
+	}
+
+	hlog(LOG_ERR, "geoindex_cell_remove: client %p not found in cell", c);
+}
+
+/*
+ *	Add a client in the index. Returns -1 if the client can not be
+ *	indexed (it has filters other than position and callsign set
+ *	filters, or its regions are too large), and should get all
+ *	packets through the filters instead.
+ */
+
+int geoindex_add(struct geoindex_t *gi, struct client_t *c)
+{
+	struct geoindex_box_t boxes[GEOINDEX_MAX_BOXES];
+	int cells[GEOINDEX_MAX_CELLS];
+	int i, n, nboxes, ncells = 0;
+
+	nboxes = filter_geo_regions(c, boxes, GEOINDEX_MAX_BOXES);
+	if (nboxes < 0)
+		return -1;
+
+	for (i = 0; i < nboxes; i++) {
+		ncells = geoindex_box_cells(&boxes[i], cells, ncells);
+		if (ncells < 0)
+			return -1;
+	}
+
+	/* a client is registered in a cell only once, even if its regions overlap */
+	qsort(cells, ncells, sizeof(int), geoindex_cmp_int);
+	for (i = 0, n = 0; i < ncells; i++)
+		if (n == 0 || cells[i] != cells[n-1])
+			cells[n++] = cells[i];
+
+	c->geo_cells = (n) ? hmalloc(sizeof(int) * n) : NULL;
+	c->geo_cell_count = n;
+	for (i = 0; i < n; i++) {
+		c->geo_cells[i] = cells[i];
+		geoindex_cell_add(&gi->cells[cells[i]], c);
+	}
+
+	c->geo_indexed = 1;
+	gi->clients++;
+	gi->cells_used += n;
+
+	return 0;
+}
+
+void geoindex_remove(struct geoindex_t *gi, struct client_t *c)
+{
+	int i;
+
+	if (!c->geo_indexed)
+		return;
+
+	for (i = 0; i < c->geo_cell_count; i++)
+		geoindex_cell_remove(&gi->cells[c->geo_cells[i]], c);
+
+	gi->clients--;
+	gi->cells_used -= c->geo_cell_count;
+
+	if (c->geo_cells)
+		hfree(c->geo_cells);
+	c->geo_cells = NULL;
+	c->geo_cell_count = 0;
+	c->geo_indexed = 0;
+}
+
+/*
+ *	Find the cell of a position
+ */
+
+struct geoindex_cell_t *geoindex_lookup(struct geoindex_t *gi, float lat, float lng)
+{
+	return &gi->cells[geoindex_row(lat) * GEOINDEX_COLS + geoindex_col_wrap(geoindex_col(lng))];
+}
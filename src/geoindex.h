@@ -0,0 +1,51 @@
+/*
+ *	aprsc
+ *
+ *	(c) Heikki Hannikainen, OH7LZB <hessu@hes.iki.fi>
+ *
+ *     This program is licensed under the BSD license, which can be found
+ *     in the file LICENSE.
+ *
+ */
+
+#ifndef GEOINDEX_H
+#define GEOINDEX_H
+
+#include "worker.h"
+
+/*
+ *	A box on the map, in radians like pbuf_t lat/lng.
+ *	lat_s <= lat_n and lon_w <= lon_e, but the longitudes may
+ *	extend past +-PI when the box crosses the date line.
+ */
+struct geoindex_box_t {
+	float lat_s, lat_n;
+	float lon_w, lon_e;
+};
+
+#define GEOINDEX_CELL_DEG	2	/* grid cell size, in degrees */
+#define GEOINDEX_ROWS		(180 / GEOINDEX_CELL_DEG)
+#define GEOINDEX_COLS		(360 / GEOINDEX_CELL_DEG)
+#define GEOINDEX_MAX_CELLS	1024	/* clients covering more cells are not indexed */
+#define GEOINDEX_MAX_BOXES	32	/* clients having more regions are not indexed */
+
+struct geoindex_cell_t {
+	struct client_t **clients;
+	int count;
+	int size;
+};
+
+struct geoindex_t {
+	struct geoindex_cell_t cells[GEOINDEX_ROWS * GEOINDEX_COLS];
+	int clients;		/* number of clients in the index */
+	int cells_used;		/* number of client-cell registrations */
+};
+
+extern struct geoindex_t *geoindex_alloc(void);
+extern void geoindex_free(struct geoindex_t *gi);
+
+extern int geoindex_add(struct geoindex_t *gi, struct client_t *c);
+extern void geoindex_remove(struct geoindex_t *gi, struct client_t *c);
+extern struct geoindex_cell_t *geoindex_lookup(struct geoindex_t *gi, float lat, float lng);
+
+#endif
@@ -47,6 +47,8 @@ long historydb_cellgauge;
 long historydb_noposcount;
 
 long historydb_cleanup_cleaned;
+long historydb_subscriptions;
+long historydb_published;
 
 void historydb_nopos(void) {}         /* profiler call counter items */
 void historydb_nointerest(void) {}
@@ -66,7 +68,7 @@ void historydb_init(void)
 	historydb_cells = cellinit( "historydb",
 				    sizeof(struct history_cell_t),
 				    __alignof__(struct history_cell_t), 
-				    CELLMALLOC_POLICY_FIFO,
+				    CELLMALLOC_POLICY_FIFO | CELLMALLOC_POLICY_HUGEPAGES,
 				    2048 /* 2 MB */,
 				    0 /* minfree */ );
 #endif
@@ -276,6 +278,131 @@ int historydb_load(FILE *fp)
 	return 0;
 }
 
+/*
+ *	Subscriptions, in a hash of their own. historydb_insert() runs in
+ *	the dupecheck thread, and only takes the subscription lock if there
+ *	are any subscriptions at all.
+ */
+
+#define HISTORYDB_SUBS_HASH 1024
+
+struct historydb_sub_t {
+	struct historydb_sub_t *next;
+	struct historydb_queue_t *q;
+	void    *data;
+	uint32_t hash1;
+	int	 keylen;
+	char     key[CALLSIGNLEN_MAX+2];
+};
+
+static struct historydb_sub_t *historydb_subs[HISTORYDB_SUBS_HASH];
+static pthread_mutex_t historydb_subs_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+void historydb_queue_init(struct historydb_queue_t *q)
+{
+	pthread_mutex_init(&q->mutex, NULL);
+	q->head = NULL;
+	q->tailp = &q->head;
+}
+
+/* grab all of the updates in the queue, oldest first */
+struct historydb_update_t *historydb_queue_take(struct historydb_queue_t *q)
+{
+	struct historydb_update_t *u;
+
+	pthread_mutex_lock(&q->mutex);
+	u = q->head;
+	q->head = NULL;
+	q->tailp = &q->head;
+	pthread_mutex_unlock(&q->mutex);
+
+	return u;
+}
+
+void historydb_updates_free(struct historydb_update_t *u)
+{
+	struct historydb_update_t *next;
+
+	for ( ; (u); u = next) {
+		next = u->next;
+		hfree(u);
+	}
+}
+
+void historydb_subscribe(const char *keybuf, const int keylen, struct historydb_queue_t *q, void *data)
+{
+	struct historydb_sub_t *sub;
+
+	if (keylen > CALLSIGNLEN_MAX+1)
+		return; /* can not be in the db either */
+
+	sub = hmalloc(sizeof(*sub));
+	sub->q = q;
+	sub->data = data;
+	sub->hash1 = keyhash(keybuf, keylen, 0);
+	sub->keylen = keylen;
+	memcpy(sub->key, keybuf, keylen);
+
+	pthread_mutex_lock(&historydb_subs_mutex);
+	sub->next = historydb_subs[sub->hash1 % HISTORYDB_SUBS_HASH];
+	historydb_subs[sub->hash1 % HISTORYDB_SUBS_HASH] = sub;
+	++historydb_subscriptions;
+	pthread_mutex_unlock(&historydb_subs_mutex);
+}
+
+/*
+ *	Remove a subscription. Updates already queued for it are left in
+ *	the queue, the subscriber needs to take them before freeing the data.
+ */
+
+void historydb_unsubscribe(const char *keybuf, const int keylen, struct historydb_queue_t *q, void *data)
+{
+	struct historydb_sub_t **subp, *sub;
+	uint32_t h1 = keyhash(keybuf, keylen, 0);
+
+	pthread_mutex_lock(&historydb_subs_mutex);
+	for (subp = &historydb_subs[h1 % HISTORYDB_SUBS_HASH]; (sub = *subp); subp = &sub->next) {
+		if (sub->q == q && sub->data == data) {
+			*subp = sub->next;
+			--historydb_subscriptions;
+			hfree(sub);
+			break;
+		}
+	}
+	pthread_mutex_unlock(&historydb_subs_mutex);
+}
+
+static void historydb_publish(const char *keybuf, const int keylen, uint32_t h1, struct pbuf_t *pb)
+{
+	struct historydb_sub_t *sub;
+	struct historydb_update_t *u;
+
+	pthread_mutex_lock(&historydb_subs_mutex);
+	for (sub = historydb_subs[h1 % HISTORYDB_SUBS_HASH]; (sub); sub = sub->next) {
+		if (sub->hash1 != h1 || sub->keylen != keylen || memcmp(sub->key, keybuf, keylen) != 0)
+			continue;
+
+		u = hmalloc(sizeof(*u));
+		u->next = NULL;
+		u->data = sub->data;
+		if (pb) {
+			u->arrivaltime = pb->t;
+			u->lat = pb->lat;
+			u->coslat = pb->cos_lat;
+			u->lon = pb->lng;
+		} else {
+			u->arrivaltime = 0;
+		}
+
+		pthread_mutex_lock(&sub->q->mutex);
+		*sub->q->tailp = u;
+		sub->q->tailp = &u->next;
+		pthread_mutex_unlock(&sub->q->mutex);
+		++historydb_published;
+	}
+	pthread_mutex_unlock(&historydb_subs_mutex);
+}
+
 /* insert... */
 
 int historydb_insert(struct pbuf_t *pb)
@@ -430,6 +557,10 @@ int historydb_insert(struct pbuf_t *pb)
 	// Free the lock
 	rwl_wrunlock(&historydb_rwlock);
 
+	// Tell the subscribers, if there are any
+	if (historydb_subscriptions)
+		historydb_publish(keybuf, keylen, h1, (isdead) ? NULL : pb);
+
 	return 1;
 }
 
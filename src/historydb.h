@@ -32,6 +32,8 @@
 #ifndef __HISTORYDB_H__
 #define __HISTORYDB_H__
 
+#include <pthread.h>
+
 #include "cellmalloc.h"
 
 struct history_cell_t {
@@ -70,6 +72,36 @@ extern void historydb_atend(void);
 extern int historydb_insert(struct pbuf_t*);
 extern int historydb_lookup(const char *keybuf, const int keylen, struct history_cell_t **result);
 
+/*
+ *	Subscriptions: a subscriber interested in the position of a key gets
+ *	an update in its queue whenever historydb_insert() stores or removes
+ *	the position of the key. The data pointer of the subscription is
+ *	passed back in the updates.
+ */
+
+struct historydb_update_t {
+	struct historydb_update_t *next;
+	void    *data;		/* of the subscription */
+	time_t   arrivaltime;	/* 0 if the position was removed */
+	float	 lat, coslat, lon;
+};
+
+struct historydb_queue_t {
+	pthread_mutex_t mutex;
+	struct historydb_update_t *head;
+	struct historydb_update_t **tailp;
+};
+
+extern long historydb_subscriptions;
+extern long historydb_published;
+
+extern void historydb_queue_init(struct historydb_queue_t *q);
+extern struct historydb_update_t *historydb_queue_take(struct historydb_queue_t *q);
+extern void historydb_updates_free(struct historydb_update_t *u);
+
+extern void historydb_subscribe(const char *keybuf, const int keylen, struct historydb_queue_t *q, void *data);
+extern void historydb_unsubscribe(const char *keybuf, const int keylen, struct historydb_queue_t *q, void *data);
+
 /* cellmalloc status */
 #ifndef _FOR_VALGRIND_
 extern void historydb_cell_stats(struct cellstatus_t *cellst);
@@ -37,6 +37,24 @@ void *hmalloc(size_t size)
 	return p;
 }
 
+/* zeroed, large ones come as fresh pages from the system and are
+ * not written to here
+ */
+void *hcalloc(size_t nmemb, size_t size)
+{
+	void *p;
+	
+	if (!(p = calloc(nmemb, size))) {
+		if (mem_panic)
+			exit(1);
+		mem_panic = 1;
+		fprintf(stderr, "hcalloc: Out of memory! Could not allocate %d bytes.", (int)(nmemb * size));
+		exit(1);
+	}
+	
+	return p;
+}
+
 void *hrealloc(void *ptr, size_t size)
 {
 	void *p;
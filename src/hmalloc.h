@@ -20,6 +20,7 @@
  */
 
 extern void *hmalloc(size_t size);
+extern void *hcalloc(size_t nmemb, size_t size);
 extern void *hrealloc(void *ptr, size_t size);
 extern void hfree(void *ptr);
 
@@ -101,95 +101,178 @@ typedef struct cellarena_t {
   int dummy;
 } cellarena_t;
 #endif
-/* global packet buffer freelists */
+/*
+ *	Packet buffer size classes
+ *
+ *	A buffer is PBUF_SLOT_LEN * (slot + 1) bytes long, and each slot
+ *	has an arena of its own, made when the slot is first used. The
+ *	workers allocate from PBUF_CLASSES of the slots, packed in
+ *	pbuf_class_set. They start from the sizes in worker.h, and once
+ *	PBUF_CLASS_SAMPLE packets have been received after startup, and on
+ *	each reconfiguration after that, pbuf_classes_adapt() picks the
+ *	classes taking the least memory for the packet lengths seen since
+ *	the previous time. A buffer records its slot, so that it goes back
+ *	to its own arena after the classes have changed.
+ */
+
+#define PBUF_CLASS_SAMPLE	100000	/* packets to see before picking the classes */
+#define PBUF_CLASS_KB_MIN	256	/* smallest block size for the arena of a class */
+
+#define PBUF_SLOT_OF(len)	(((len) - 1) / PBUF_SLOT_LEN)
+#define PBUF_SLOT_BUF_LEN(s)	(((s) + 1) * PBUF_SLOT_LEN)
+#define PBUF_CLASS_SET(s, m, l)	((s) | ((m) << PBUF_SLOT_BITS) | ((l) << (2 * PBUF_SLOT_BITS)))
+
+struct pbuf_slot_t {
+	cellarena_t *ca;
+	char name[16];
+};
+
+static struct pbuf_slot_t pbuf_slots[PBUF_SLOTS];
 
-cellarena_t *pbuf_cells_small;
-cellarena_t *pbuf_cells_medium;
-cellarena_t *pbuf_cells_large;
+static const uint32_t pbuf_class_set_default = PBUF_CLASS_SET(PBUF_SLOT_OF(PACKETLEN_MAX_SMALL),
+	PBUF_SLOT_OF(PACKETLEN_MAX_MEDIUM), PBUF_SLOT_OF(PACKETLEN_MAX_LARGE));
+static uint32_t pbuf_class_set = PBUF_CLASS_SET(PBUF_SLOT_OF(PACKETLEN_MAX_SMALL),
+	PBUF_SLOT_OF(PACKETLEN_MAX_MEDIUM), PBUF_SLOT_OF(PACKETLEN_MAX_LARGE));
+
+/* packet lengths seen by the workers, by slot, indexed like pbuf_homes[] */
+static uint64_t pbuf_len_hist[PBUF_HOMES][PBUF_SLOTS];
+static uint64_t pbuf_len_base[PBUF_SLOTS];	/* the totals when the classes were picked */
+static int pbuf_classes_adapted;
+static pthread_mutex_t pbuf_classes_mt = PTHREAD_MUTEX_INITIALIZER;
 
 int pbuf_cells_kb = 2048; /* 2M bunches is faster for system than 16M ! */
 
+/* the buffers on their way back to the workers which allocated them */
+struct pbuf_home_t pbuf_homes[PBUF_HOMES];
+
+/*
+ *	Make the arena of a slot, if it does not have one yet
+ */
+
+static void pbuf_slot_init(int s, int kb)
+{
+#ifndef _FOR_VALGRIND_
+	if (pbuf_slots[s].ca)
+		return;
+
+	snprintf(pbuf_slots[s].name, sizeof(pbuf_slots[s].name), "pbuf %d", PBUF_SLOT_BUF_LEN(s));
+	pbuf_slots[s].ca = cellinit( pbuf_slots[s].name,
+				     sizeof(struct pbuf_t) + PBUF_SLOT_BUF_LEN(s),
+				     __alignof__(struct pbuf_t), CELLMALLOC_POLICY_FIFO | CELLMALLOC_POLICY_HUGEPAGES,
+				     kb /* n kB at the time */, 0 /* minfree */ );
+#endif
+}
+
 /*
  *	Get a buffer for a packet
  *
- *	pbuf_t buffers are accumulated into each worker local buffer in small sets,
- *	and then used from there.  The buffers are returned into global pools.
+ *	pbuf_t buffers are taken from, and given back to, a cache of each
+ *	worker, which trades magazines of them with the global arenas.
  */
 
 void pbuf_init(void)
 {
+	int c;
+
+	for (c = 0; c < PBUF_CLASSES; c++)
+		pbuf_slot_init(PBUF_CLASS_SLOT(pbuf_class_set, c), pbuf_cells_kb);
+}
+
+/*
+ *	Set up the packet buffer cache of a worker for a class
+ */
+
+static void pbuf_cache_load(struct worker_t *self, int c)
+{
+	int s = PBUF_CLASS_SLOT(self->pbuf_class_set, c);
+
 #ifndef _FOR_VALGRIND_
-	pbuf_cells_small  = cellinit( "pbuf small",
-				      sizeof(struct pbuf_t) + PACKETLEN_MAX_SMALL,
-				      __alignof__(struct pbuf_t), CELLMALLOC_POLICY_FIFO,
-				      pbuf_cells_kb /* n kB at the time */, 0 /* minfree */ );
-	pbuf_cells_medium = cellinit( "pbuf medium",
-				      sizeof(struct pbuf_t) + PACKETLEN_MAX_MEDIUM,
-				      __alignof__(struct pbuf_t), CELLMALLOC_POLICY_FIFO,
-				      pbuf_cells_kb /* n kB at the time */, 0 /* minfree */ );
-	pbuf_cells_large  = cellinit( "pbuf large",
-				      sizeof(struct pbuf_t) + PACKETLEN_MAX_LARGE,
-				      __alignof__(struct pbuf_t), CELLMALLOC_POLICY_FIFO,
-				      pbuf_cells_kb /* n kB at the time */, 0 /* minfree */ );
+	cellcache_init(&self->pbuf_cache[c], pbuf_slots[s].ca);
+#else
+	self->pbuf_cache[c].cellsize = sizeof(struct pbuf_t) + PBUF_SLOT_BUF_LEN(s);
 #endif
 }
 
+void pbuf_cache_init(struct worker_t *self)
+{
+	int c;
+
+	self->pbuf_class_set = __atomic_load_n(&pbuf_class_set, __ATOMIC_ACQUIRE);
+	for (c = 0; c < PBUF_CLASSES; c++)
+		pbuf_cache_load(self, c);
+}
+
+/*
+ *	The classes have changed: the caches of the classes which are
+ *	gone are flushed to their arenas, and loaded from the new ones
+ */
+
+static void pbuf_cache_switch(struct worker_t *self, uint32_t set)
+{
+	uint32_t old = self->pbuf_class_set;
+	int c;
+
+	self->pbuf_class_set = set;
+	for (c = 0; c < PBUF_CLASSES; c++) {
+		if (PBUF_CLASS_SLOT(old, c) == PBUF_CLASS_SLOT(set, c))
+			continue;
+		cellcache_flush(&self->pbuf_cache[c]);
+		pbuf_cache_load(self, c);
+	}
+}
+
+/*
+ *	The size class of the worker for a buffer of len bytes, -1 if
+ *	there is none
+ */
+
+static int pbuf_class_of(struct worker_t *self, int len)
+{
+	int c;
+
+	for (c = 0; c < PBUF_CLASSES; c++)
+		if (len <= PBUF_SLOT_BUF_LEN(PBUF_CLASS_SLOT(self->pbuf_class_set, c)))
+			return c;
+
+	return -1;
+}
+
+/* the slot recorded in the buffer is good */
+static int pbuf_slot_valid(struct pbuf_t *p)
+{
+	return p->size_class < PBUF_SLOTS && p->buf_len == PBUF_SLOT_BUF_LEN(p->size_class);
+}
+
 /*
- *	pbuf_free  sends buffer back to worker local pool, or when invoked
+ *	pbuf_free  sends buffer back to worker local cache, or when invoked
  *	without 'self' pointer, like in final history buffer cleanup,
- *	to the global pool.
+ *	to the global pool. A buffer of a class the worker no longer
+ *	uses goes to the global pool, too.
  */
 
 void pbuf_free(struct worker_t *self, struct pbuf_t *p)
 {
-	if (self) { /* Return to worker local pool */
+	int c;
 
-		// hlog(LOG_DEBUG, "pbuf_free(%p) for worker %p - packet length: %d", p, self, p->buf_len);
+	if (!pbuf_slot_valid(p)) {
+		hlog(LOG_ERR, "pbuf_free(%p) for worker %p - packet length not known: %d", p, self, p->buf_len);
+		return;
+	}
 
-		switch (p->buf_len) {
-		case PACKETLEN_MAX_SMALL:
-			p->next = self->pbuf_free_small;
-			self->pbuf_free_small = p;
-			break;
-		case PACKETLEN_MAX_MEDIUM:
-			p->next = self->pbuf_free_medium;
-			self->pbuf_free_medium = p;
-			break;
-		case PACKETLEN_MAX_LARGE:
-			p->next = self->pbuf_free_large;
-			self->pbuf_free_large = p;
-			break;
-		default:
-			hlog(LOG_ERR, "pbuf_free(%p) for worker %p - packet length not known: %d", p, self, p->buf_len);
-			break;
+	if (self) { /* Return to worker local cache */
+		for (c = 0; c < PBUF_CLASSES; c++) {
+			if (PBUF_CLASS_SLOT(self->pbuf_class_set, c) == p->size_class) {
+				cellcache_free(&self->pbuf_cache[c], p);
+				return;
+			}
 		}
-		return;
 	}
 
 #ifndef _FOR_VALGRIND_
-
 	/* Not worker local processing then, return to global pools. */
-
-	// hlog(LOG_DEBUG, "pbuf_free(%p) for global pool - packet length: %d", p, p->buf_len);
-
-	switch (p->buf_len) {
-	case PACKETLEN_MAX_SMALL:
-		cellfree(pbuf_cells_small, p);
-		break;
-	case PACKETLEN_MAX_MEDIUM:
-		cellfree(pbuf_cells_medium, p);
-		break;
-	case PACKETLEN_MAX_LARGE:
-		cellfree(pbuf_cells_large, p);
-		break;
-	default:
-		hlog(LOG_ERR, "pbuf_free(%p) - packet length not known: %d", p, p->buf_len);
-		break;
-	}
-	return;
+	cellfree(pbuf_slots[p->size_class].ca, p);
 #else
 	hfree(p);
-	return;
 #endif
 }
 
@@ -201,47 +284,296 @@ void pbuf_free(struct worker_t *self, struct pbuf_t *p)
 
 void pbuf_free_many(struct pbuf_t **array, int numbufs)
 {
-	int i;
-	void **arraysmall   = alloca(sizeof(void*)*numbufs);
-	void **arraymedium  = alloca(sizeof(void*)*numbufs);
-	void **arraylarge   = alloca(sizeof(void*)*numbufs);
-	int smallcnt = 0, mediumcnt = 0, largecnt = 0;
+	int i, left = 0;
+	struct pbuf_t **rest = alloca(sizeof(*rest)*numbufs);
+#ifndef _FOR_VALGRIND_
+	void **batch = alloca(sizeof(void*)*numbufs);
+	int s, n, k;
+#endif
 
 	for (i = 0; i < numbufs; ++i) {
 		array[i]->is_free = 1;
 		//__sync_synchronize();
-		switch (array[i]->buf_len) {
-		case PACKETLEN_MAX_SMALL:
-			arraysmall [smallcnt++]  = array[i];
-			break;
-		case PACKETLEN_MAX_MEDIUM:
-			arraymedium[mediumcnt++] = array[i];
-			break;
-		case PACKETLEN_MAX_LARGE:
-			arraylarge [largecnt++]  = array[i];
-			break;
-		default:
+		if (!pbuf_slot_valid(array[i])) {
 		  hlog( LOG_ERR, "pbuf_free_many(%p) - packet length not known: %d :%d",
 			array[i], array[i]->buf_len, array[i]->packet_len );
+			continue;
+		}
+		rest[left++] = array[i];
+	}
+
+#ifndef _FOR_VALGRIND_
+	/* a batch for each slot, there are only a few of them */
+	while (left > 0) {
+		s = rest[0]->size_class;
+		for (i = n = k = 0; i < left; i++) {
+			if (rest[i]->size_class == s)
+				batch[n++] = rest[i];
+			else
+				rest[k++] = rest[i];
+		}
+		left = k;
+		cellfreemany(pbuf_slots[s].ca, batch, n);
+	}
+#else
+	for (i = 0; i < left; ++i) {
+		hfree(rest[i]);
+	}
+#endif
+}
+
+/*
+ *	The packet lengths seen since the classes were picked, and
+ *	their totals, returns the number of packets
+ */
+
+static uint64_t pbuf_len_window(uint64_t *window, uint64_t *totals)
+{
+	uint64_t n = 0;
+	int h, s;
+
+	memset(totals, 0, sizeof(*totals) * PBUF_SLOTS);
+	for (h = 0; h < PBUF_HOMES; h++)
+		for (s = 0; s < PBUF_SLOTS; s++)
+			totals[s] += __atomic_load_n(&pbuf_len_hist[h][s], __ATOMIC_RELAXED);
+
+	for (s = 0; s < PBUF_SLOTS; s++) {
+		window[s] = totals[s] - pbuf_len_base[s];
+		n += window[s];
+	}
+
+	return n;
+}
+
+/* the class set would take for each slot */
+static int pbuf_class_slot_for(uint32_t set, int s)
+{
+	int c;
+
+	for (c = 0; c < PBUF_CLASSES - 1; c++)
+		if (s <= PBUF_CLASS_SLOT(set, c))
 			break;
+
+	return PBUF_CLASS_SLOT(set, c);
+}
+
+/* bytes of buffer space the packets of hist[] take with a class set */
+static uint64_t pbuf_classes_cost(const uint64_t *hist, uint32_t set)
+{
+	uint64_t cost = 0;
+	int s;
+
+	for (s = 0; s < PBUF_SLOTS; s++)
+		cost += hist[s] * PBUF_SLOT_BUF_LEN(pbuf_class_slot_for(set, s));
+
+	return cost;
+}
+
+/*
+ *	Pick the classes taking the least buffer space for the packets of
+ *	hist[]. The largest class is always PACKETLEN_MAX long, and the
+ *	others end at the slots where the cost of the packets they take,
+ *	each counted at the length of its class, is the least. The block
+ *	size of the arena of each class goes by its share of the packets.
+ */
+
+static uint32_t pbuf_classes_pick(const uint64_t *hist, uint64_t total, int *kb)
+{
+	uint64_t cum[PBUF_SLOTS], cost[PBUF_CLASSES][PBUF_SLOTS], x;
+	int from[PBUF_CLASSES][PBUF_SLOTS];
+	int slot[PBUF_CLASSES];
+	int c, i, j;
+
+	for (j = 0; j < PBUF_SLOTS; j++) {
+		cum[j] = ((j) ? cum[j-1] : 0) + hist[j];
+		cost[0][j] = cum[j] * PBUF_SLOT_BUF_LEN(j);
+		from[0][j] = -1;
+	}
+
+	for (c = 1; c < PBUF_CLASSES; c++) {
+		for (j = 0; j < PBUF_SLOTS; j++) {
+			cost[c][j] = UINT64_MAX;
+			from[c][j] = -1;
+			for (i = c - 1; i < j; i++) {
+				if (cost[c-1][i] == UINT64_MAX)
+					continue;
+				x = cost[c-1][i] + (cum[j] - cum[i]) * PBUF_SLOT_BUF_LEN(j);
+				if (x < cost[c][j]) {
+					cost[c][j] = x;
+					from[c][j] = i;
+				}
+			}
 		}
 	}
 
-	// hlog( LOG_DEBUG, "pbuf_free_many(); counts: small %d large %d huge %d", smallcnt, mediumcnt, largecnt );
+	/* walk back from the largest one */
+	for (c = PBUF_CLASSES - 1, j = PBUF_SLOTS - 1; c >= 0; c--) {
+		slot[c] = j;
+		j = from[c][j];
+	}
 
-#ifndef _FOR_VALGRIND_
-	if (smallcnt > 0)
-		cellfreemany(pbuf_cells_small,  arraysmall,  smallcnt);
-	if (mediumcnt > 0)
-		cellfreemany(pbuf_cells_medium, arraymedium, mediumcnt);
-	if (largecnt > 0)
-		cellfreemany(pbuf_cells_large,  arraylarge,  largecnt);
+	for (c = 0; c < PBUF_CLASSES; c++) {
+		x = cum[slot[c]] - ((c) ? cum[slot[c-1]] : 0);
+		for (kb[c] = PBUF_CLASS_KB_MIN; kb[c] < pbuf_cells_kb && (uint64_t)kb[c] * total < x * pbuf_cells_kb; kb[c] *= 2)
+			;
+	}
+
+	return PBUF_CLASS_SET(slot[0], slot[1], slot[2]);
+}
+
+/*
+ *	Pick the size classes from the packet lengths seen, once after
+ *	startup, and on reconfiguration - runs in the main thread
+ */
+
+void pbuf_classes_adapt(int reconfiguring)
+{
+	uint64_t window[PBUF_SLOTS], totals[PBUF_SLOTS], n;
+	uint32_t set, old;
+	int kb[PBUF_CLASSES];
+	int c;
+
+	pthread_mutex_lock(&pbuf_classes_mt);
+
+	if (pbuf_classes_adapted && !reconfiguring)
+		goto done;
+
+	n = pbuf_len_window(window, totals);
+	if (n < PBUF_CLASS_SAMPLE) {
+		if (reconfiguring)
+			hlog(LOG_INFO, "pbuf size classes: %llu packets seen, keeping the classes until %d",
+				(unsigned long long)n, PBUF_CLASS_SAMPLE);
+		goto done;
+	}
+
+	old = pbuf_class_set;
+	set = pbuf_classes_pick(window, n, kb);
+	for (c = 0; c < PBUF_CLASSES; c++)
+		pbuf_slot_init(PBUF_CLASS_SLOT(set, c), kb[c]);
+
+	hlog(LOG_INFO, "pbuf size classes: %d %d %d bytes, %.1f bytes per packet (was %d %d %d, %.1f) for %llu packets",
+		PBUF_SLOT_BUF_LEN(PBUF_CLASS_SLOT(set, 0)), PBUF_SLOT_BUF_LEN(PBUF_CLASS_SLOT(set, 1)),
+		PBUF_SLOT_BUF_LEN(PBUF_CLASS_SLOT(set, 2)), (double)pbuf_classes_cost(window, set) / n,
+		PBUF_SLOT_BUF_LEN(PBUF_CLASS_SLOT(old, 0)), PBUF_SLOT_BUF_LEN(PBUF_CLASS_SLOT(old, 1)),
+		PBUF_SLOT_BUF_LEN(PBUF_CLASS_SLOT(old, 2)), (double)pbuf_classes_cost(window, old) / n,
+		(unsigned long long)n);
+
+	/* the workers switch over on their next buffer */
+	__atomic_store_n(&pbuf_class_set, set, __ATOMIC_RELEASE);
+
+	memcpy(pbuf_len_base, totals, sizeof(pbuf_len_base));
+	pbuf_classes_adapted = 1;
+
+done:
+	pthread_mutex_unlock(&pbuf_classes_mt);
+}
+
+/*
+ *	The home of the buffers a worker allocates, 0 if it has none
+ */
+
+static int pbuf_home_of(struct worker_t *self)
+{
+	return (self->id >= 0 && self->id < PBUF_HOMES - 1) ? self->id + 1 : 0;
+}
+
+/*
+ *	pbuf_return_many  sends buffers back to the pools of the workers
+ *			which allocated them, with a single inbox put for
+ *			each worker. The ones whose worker has stopped go
+ *			to the global pool. Returns the number of buffers
+ *			given back to the workers.
+ */
+
+int pbuf_return_many(struct pbuf_t **array, int numbufs)
+{
+	struct pbuf_t *newest[PBUF_HOMES], *oldest[PBUF_HOMES];
+	int count[PBUF_HOMES];
+	uint8_t homes[PBUF_HOMES];
+	struct pbuf_t **orphans = alloca(sizeof(*orphans) * numbufs);
+	struct pbuf_t *pb;
+	int i, h, homecnt = 0, orphancnt = 0, returned = 0;
+
+	memset(newest, 0, sizeof(newest));
 
-#else
 	for (i = 0; i < numbufs; ++i) {
-		hfree(array[i]);
+		pb = array[i];
+		pb->is_free = 1;
+		h = pb->home;
+		if (!h || !__atomic_load_n(&pbuf_homes[h].live, __ATOMIC_ACQUIRE)) {
+			orphans[orphancnt++] = pb;
+			continue;
+		}
+		if (!newest[h]) {
+			homes[homecnt++] = h;
+			oldest[h] = pb;
+			count[h] = 0;
+		}
+		pb->next = newest[h];
+		newest[h] = pb;
+		count[h]++;
+	}
+
+	for (i = 0; i < homecnt; i++) {
+		h = homes[i];
+		pbuf_inbox_put(&pbuf_homes[h].returned, newest[h], oldest[h], count[h]);
+		returned += count[h];
+	}
+
+	if (orphancnt)
+		pbuf_free_many(orphans, orphancnt);
+
+	return returned;
+}
+
+/*
+ *	Move the buffers given back to a worker to its thread-local caches
+ */
+
+static void pbuf_home_collect(struct worker_t *self, int h)
+{
+	struct pbuf_t *pb, *next;
+	int count;
+
+	for (pb = pbuf_inbox_take(&pbuf_homes[h].returned, &count); (pb); pb = next) {
+		next = pb->next;
+		pbuf_free(self, pb);
+	}
+}
+
+/*
+ *	A worker is stopping: take back what is on the way, and stop
+ *	getting more. pbuf_return_many() may have seen the home live just
+ *	before, and the few buffers it then puts in wait there for the next
+ *	worker having the same id, or pbuf_homes_free().
+ */
+
+void pbuf_home_close(struct worker_t *self)
+{
+	int h = pbuf_home_of(self);
+
+	if (!h)
+		return;
+
+	__atomic_store_n(&pbuf_homes[h].live, 0, __ATOMIC_SEQ_CST);
+	pbuf_home_collect(self, h);
+}
+
+/*
+ *	Free the buffers still on their way back, at shutdown
+ */
+
+void pbuf_homes_free(void)
+{
+	struct pbuf_t *pb, *next;
+	int h, count;
+
+	for (h = 1; h < PBUF_HOMES; h++) {
+		for (pb = pbuf_inbox_take(&pbuf_homes[h].returned, &count); (pb); pb = next) {
+			next = pb->next;
+			pbuf_free(NULL, pb);
+		}
 	}
-#endif
 }
 
 /*
@@ -263,162 +595,103 @@ static void pbuf_dump_entry(FILE *fp, struct pbuf_t *pb)
 void pbuf_dump(FILE *fp)
 {
 	/* Dump the pbuf queue out on text format */
-	struct pbuf_t *pb = pbuf_global;
+	uint32_t seq;
 	
-	for ( ; pb ; pb = pb->next ) {
-		pbuf_dump_entry(fp, pb);
+	for (seq = pbuf_global.tail; seq != pbuf_ring_head(&pbuf_global); seq++) {
+		pbuf_dump_entry(fp, pbuf_ring_get(&pbuf_global, seq));
 	}
 }
 
 void pbuf_dupe_dump(FILE *fp)
 {
 	/* Dump the pbuf queue out on text format */
-	struct pbuf_t *pb = pbuf_global_dupe;
+	uint32_t seq;
 	
-	for ( ; pb ; pb = pb->next ) {
-		pbuf_dump_entry(fp, pb);
+	for (seq = pbuf_global_dupe.tail; seq != pbuf_ring_head(&pbuf_global_dupe); seq++) {
+		pbuf_dump_entry(fp, pbuf_ring_get(&pbuf_global_dupe, seq));
 	}
 }
 
 /*
- *	get a buffer for an incoming packet, from either a thread-local
- *	freelist of preallocated buffers, or from the global cellmalloc
- *	area.
+ *	get a buffer for an incoming packet, from the thread-local cache,
+ *	which gets magazines of them from the global cellmalloc arena
+ *	when it runs out.
  */
 
 static struct pbuf_t *pbuf_get(struct worker_t *self, int len)
 {
 	struct pbuf_t *pb;
-	int i;
-	struct pbuf_t **allocarray;
-	struct pbuf_t **pool;
-	cellarena_t *global_pool;
-	int bunchlen;
-
-	/* select which thread-local freelist to use */
-	if (len <= PACKETLEN_MAX_SMALL) {
-		//hlog(LOG_DEBUG, "pbuf_get: Allocating small buffer for a packet of %d bytes", len);
-		pool        = &self->pbuf_free_small;
-		global_pool = pbuf_cells_small;
-		len         = PACKETLEN_MAX_SMALL;
-		bunchlen    = PBUF_ALLOCATE_BUNCH_SMALL;
-	} else if (len <= PACKETLEN_MAX_MEDIUM) {
-		//hlog(LOG_DEBUG, "pbuf_get: Allocating large buffer for a packet of %d bytes", len);
-		pool        = &self->pbuf_free_medium;
-		global_pool = pbuf_cells_medium;
-		len         = PACKETLEN_MAX_MEDIUM;
-		bunchlen    = PBUF_ALLOCATE_BUNCH_MEDIUM;
-	} else if (len <= PACKETLEN_MAX_LARGE) {
-		//hlog(LOG_DEBUG, "pbuf_get: Allocating huge buffer for a packet of %d bytes", len);
-		pool        = &self->pbuf_free_large;
-		global_pool = pbuf_cells_large;
-		len         = PACKETLEN_MAX_LARGE;
-		bunchlen    = PBUF_ALLOCATE_BUNCH_LARGE;
-	} else { /* too large! */
+	struct cellcache_t *cache;
+	uint32_t set;
+	int c, s, home;
+
+	/* the classes have been picked again */
+	set = __atomic_load_n(&pbuf_class_set, __ATOMIC_ACQUIRE);
+	if (self->pbuf_class_set != set)
+		pbuf_cache_switch(self, set);
+
+	/* select which thread-local cache to use */
+	if (len < 1 || (c = pbuf_class_of(self, len)) < 0) { /* too large! */
 		hlog(LOG_ERR, "pbuf_get: Not allocating a buffer for a packet of %d bytes!", len);
 		return NULL;
 	}
+	cache = &self->pbuf_cache[c];
+	s = PBUF_CLASS_SLOT(self->pbuf_class_set, c);
 
-	allocarray = alloca(bunchlen * sizeof(void*));
-
-	if (*pool) {
-		/* fine, just get the first buffer from the freelist pool...
-		 * the pool is not doubly linked (not necessary)
-		 */
-		pb = *pool;
-		*pool = pb->next;
-
-		/* zero all header fields */
-		memset(pb, 0, sizeof(*pb));
-
-		/* we know the length in this sub-pool, set it */
-		pb->buf_len = len;
-
-		// hlog(LOG_DEBUG, "pbuf_get(%d): got one buf from local pool: %p", len, pb);
-
-		return pb;
-	}
+	/* the buffers given back by the dupecheck thread come first */
+	home = pbuf_home_of(self);
+	if (home && cellcache_empty(cache) && pbuf_inbox_pending(&pbuf_homes[home].returned))
+		pbuf_home_collect(self, home);
 	
-#ifndef _FOR_VALGRIND_
-	/* The local list is empty... get buffers from the global list. */
+	/* and they are to come back, after this one */
+	if (home && !pbuf_homes[home].live)
+		__atomic_store_n(&pbuf_homes[home].live, 1, __ATOMIC_RELEASE);
 
-	bunchlen = cellmallocmany( global_pool, (void**)allocarray, bunchlen );
-	if (bunchlen < 1) {
+	/* the length goes in the histogram the classes are picked from */
+	__atomic_store_n(&pbuf_len_hist[home][PBUF_SLOT_OF(len)],
+		pbuf_len_hist[home][PBUF_SLOT_OF(len)] + 1, __ATOMIC_RELAXED);
+
+	if (!(pb = cellcache_alloc(cache))) {
 		hlog(LOG_CRIT, "aprsc: Out of memory: Could not allocate packet buffers!");
 		return NULL;
 	}
 
-	for ( i = 1;  i < bunchlen; ++i ) {
-		pb = allocarray[i];
-		pb->is_free = 0;
-		pb->next    = *pool;
-		pb->buf_len = len; // this is necessary for worker local pool discard at worker shutdown
-		*pool = pb;
-	}
-
-	pb = allocarray[0];
-
-	// hlog(LOG_DEBUG, "pbuf_get(%d): got %d bufs from global pool %p", len, bunchlen, pool);
-
-	/* ok, return the first buffer from the pool */
-
 	/* zero all header fields */
 	memset(pb, 0, sizeof(*pb));
 
-	/* we know the length in this sub-pool, set it */
-	pb->buf_len = len;
-	
-	return pb;
-
-#else /* Valgrind -version of things */
-
-
-	/* The local list is empty... get buffers from the global list. */
-
-	int sz = sizeof(struct pbuf_t) + len;
-
-	for ( i = 1;  i < bunchlen; ++i ) {
-		pb = hmalloc(sz);
-		pb->next = *pool;
-		pb->buf_len = len; // for valgrind this is not necessary.. but exists for symmetry's sake
-		*pool = pb;
-	}
-
-	pb = hmalloc(sz);
-	
-	memset(pb, 0, sz);
-	pb->buf_len = len;
-
-	// hlog(LOG_DEBUG, "pbuf_get_real(%d): got %d bufs to local pool, returning %p", len, bunchlen, pb);
+	/* we know the length in this size class, set it */
+	pb->buf_len = PBUF_SLOT_BUF_LEN(s);
+	pb->size_class = s;
+	pb->home = home;
 
 	return pb;
-#endif
 }
 
 
 
 /*
  *	Move incoming packets from the thread-local incoming buffer
- *	(self->pbuf_incoming_local) to self->incoming local for the
- *	dupecheck thread to catch them
+ *	(self->pbuf_incoming_local) to the inbox of the dupecheck thread.
+ *	This does not take a lock, so it always gets them there.
  */
 
 void incoming_flush(struct worker_t *self)
 {
-	int me;
+	struct pbuf_t *pb;
+	uint64_t now;
+	
+	if (self->pbuf_incoming_local_sampled) {
+		now = latency_now();
+		for (pb = self->pbuf_incoming_local; (pb); pb = pb->next) {
+			if (pb->received) {
+				pb->flushed = now;
+				latency_add(&self->flush_latency, now - pb->queued);
+			}
+		}
+	}
 	
-	/* try grab the lock.. if it fails, we'll try again, either
-	 * in 200 milliseconds or after next input
-	 */
-	if (pthread_mutex_trylock(&self->pbuf_incoming_mutex) != 0)
-		return;
-		
-	*self->pbuf_incoming_last = self->pbuf_incoming_local;
-	self->pbuf_incoming_last  = self->pbuf_incoming_local_last;
-	self->pbuf_incoming_count += self->pbuf_incoming_local_count;
-        if ((me = pthread_mutex_unlock(&self->pbuf_incoming_mutex))) {
-                hlog(LOG_ERR, "incoming: could not unlock pbuf_incoming_mutex: %s", strerror(me));
-        }
+	pbuf_inbox_put(&self->pbuf_incoming, self->pbuf_incoming_local,
+		self->pbuf_incoming_local_last, self->pbuf_incoming_local_count);
 
 	//hlog( LOG_DEBUG, "incoming_flush() sent out %d packets", self->pbuf_incoming_local_count );
 
@@ -433,8 +706,9 @@ void incoming_flush(struct worker_t *self)
 	
 	/* clean the local lockfree queue */
 	self->pbuf_incoming_local = NULL;
-	self->pbuf_incoming_local_last = &self->pbuf_incoming_local;
+	self->pbuf_incoming_local_last = NULL;
 	self->pbuf_incoming_local_count = 0;
+	self->pbuf_incoming_local_sampled = 0;
 }
 
 /*
@@ -646,6 +920,66 @@ static int check_invalid_path_callsign(const char *call, int len, int after_q)
 	return 0;
 }
 
+/*
+ *	Split up the digipeater path of a packet before the Q construct,
+ *	and pick the Q construct type and the entry station callsign,
+ *	once for all of the filters. Also flags a TCPIP* in the path.
+ *	Needs to run on the final packet, after the Q construct processing.
+ */
+
+void incoming_parse_path(struct pbuf_t *pb)
+{
+	const char *p = pb->dstcall_end + 1;
+	const char *q = pb->qconst_start - 1; /* the ',' before the Q construct */
+	const char *e;
+	struct pbuf_path_t *el;
+	int n = 0, len, star, digipeated;
+	
+	while (p < q) {
+		/* find end of path callsign */
+		for (e = p; e < q && *e != ','; e++)
+			;
+		
+		len = e - p;
+		star = (len > 0 && e[-1] == '*');
+		if (star) {
+			len--;
+			if (len == 5 && memcmp(p, "TCPIP", 5) == 0)
+				pb->flags |= F_HAS_TCPIP;
+		}
+		
+		if (n < PBUF_PATH_MAX) {
+			el = &pb->path[n++];
+			el->off = p - pb->data;
+			el->len = (len > 255) ? 255 : len;
+			el->flags = (star) ? PBUF_PATH_STAR : 0;
+		}
+		
+		p = e + 1;
+	}
+	pb->path_count = n;
+	
+	/* an element has been digipeated, if it or one of the following ones has a '*' */
+	for (digipeated = 0; n > 0; n--) {
+		el = &pb->path[n-1];
+		if (el->flags & PBUF_PATH_STAR)
+			digipeated = 1;
+		if (digipeated)
+			el->flags |= PBUF_PATH_DIGIPEATED;
+	}
+	
+	/* "qAR,entrycall," */
+	pb->qconst_type = pb->qconst_start[2];
+	
+	p = pb->qconst_start + 4;
+	for (len = 0; len < CALLSIGNLEN_MAX; len++)
+		if (p[len] == ',' || p[len] == ':')
+			break;
+	if ((p[len] != ',' && p[len] != ':') || len < CALLSIGNLEN_MIN)
+		len = 0; /* bad entry station callsign */
+	pb->entrycall_len = len;
+}
+
 /*
  *	Check for invalid callsigns in path
  */
@@ -760,12 +1094,19 @@ static int incoming_server_message(struct worker_t *self, struct client_t *c, st
  *	m/ filter.
  */
 
-static void client_loc_update(struct client_t *c, struct pbuf_t *pb)
+static void client_loc_update(struct worker_t *self, struct client_t *c, struct pbuf_t *pb)
 {
+	int moved = (!c->loc_known || c->lat != pb->lat || c->lng != pb->lng);
+	
 	c->lat = pb->lat;
 	c->lng = pb->lng;
 	c->cos_lat = pb->cos_lat;
+	c->loc_pt = pb->range_pt;
 	c->loc_known = 1;
+	
+	/* the m/ filter region moves with the client */
+	if (moved && c->geo_indexed && filter_geo_uses_loc(c))
+		worker_reclassify_client(self, c);
 }
 
 /*
@@ -1010,7 +1351,7 @@ int incoming_parse(struct worker_t *self, struct client_t *c, char *s, int len)
 	}
 	
 	/* store the source reference */
-	pb->origin = c;
+	pb->origin = c->handle;
 	
 	/* when it was received ? */
 	pb->t = tick;
@@ -1097,6 +1438,7 @@ int incoming_parse(struct worker_t *self, struct client_t *c, char *s, int len)
 	pb->dstcall_end = pb->data + (dstcall_end - s);
 	pb->dstcall_len = via_start - src_end - 1;
 	pb->info_start  = info_start;
+	incoming_parse_path(pb);
 	
 	//hlog_packet(LOG_DEBUG, pb->data, pb->packet_len-2, "After parsing and Qc algorithm: ");
 	
@@ -1135,7 +1477,7 @@ int incoming_parse(struct worker_t *self, struct client_t *c, char *s, int len)
 	 * read-only clients.
 	 */
 	if (originated_by_client && (pb->packettype & T_POSITION))
-		client_loc_update(c, pb);
+		client_loc_update(self, c, pb);
 	
 	/* If disallow_unverified is enabled, don't allow unverified clients
 	 * to send any packets. Do this after any potential client_loc_update
@@ -1156,15 +1498,35 @@ int incoming_parse(struct worker_t *self, struct client_t *c, char *s, int len)
 	/* Filter preprocessing before sending this to dupefilter.. */
 	filter_preprocess_dupefilter(pb);
 	
+	/* ..and the hashing for the dupefilter itself, here in the
+	 * worker, so that the single dupecheck thread has less to do
+	 */
+	dupecheck_prepare(pb);
+	
 	/* If the packet came in on a filtered port, mark the station as
 	 * heard on this port, so that messages can be routed to it.
 	 */
 	if (c->flags & CLFLAGS_IGATE)
 		client_heard_update(c, pb);
 	
-	/* put the buffer in the thread's incoming queue */
-	*self->pbuf_incoming_local_last = pb;
-	self->pbuf_incoming_local_last = &pb->next;
+	/* every latency_sampling'th packet is sampled for the latency
+	 * histograms, from the read() it came in
+	 */
+	if (self->read_time && --self->latency_countdown <= 0) {
+		self->latency_countdown = latency_sampling;
+		pb->received = self->read_time;
+		pb->queued = latency_now();
+		latency_add(&self->parse_latency, pb->queued - pb->received);
+		self->pbuf_incoming_local_sampled++;
+	}
+	
+	/* put the buffer in the thread's incoming queue, in front, the
+	 * way the inbox of the dupecheck thread wants it
+	 */
+	pb->next = self->pbuf_incoming_local;
+	if (!pb->next)
+		self->pbuf_incoming_local_last = pb;
+	self->pbuf_incoming_local = pb;
 	self->pbuf_incoming_local_count++;
 	
 	return rc;
@@ -1230,12 +1592,34 @@ in_drop:
 }
 
 #ifndef _FOR_VALGRIND_
-void incoming_cell_stats(struct cellstatus_t *cellst_pbuf_small,
-	struct cellstatus_t *cellst_pbuf_medium,
-	struct cellstatus_t *cellst_pbuf_large)
+void incoming_cell_stats(struct cellstatus_t *cellst, struct pbuf_class_stats_t *classst)
 {
-	cellstatus(pbuf_cells_small, cellst_pbuf_small);
-	cellstatus(pbuf_cells_medium, cellst_pbuf_medium);
-	cellstatus(pbuf_cells_large, cellst_pbuf_large);
+	uint64_t window[PBUF_SLOTS], totals[PBUF_SLOTS];
+	uint32_t set;
+	int64_t saved;
+	long used;
+	int c, s, first;
+
+	pthread_mutex_lock(&pbuf_classes_mt);
+	set = pbuf_class_set;
+	pbuf_len_window(window, totals);
+	pthread_mutex_unlock(&pbuf_classes_mt);
+
+	for (c = first = 0; c < PBUF_CLASSES; c++) {
+		cellstatus(pbuf_slots[PBUF_CLASS_SLOT(set, c)].ca, &cellst[c]);
+
+		/* the packets of the class, and the space they save compared to the classes of worker.h */
+		classst[c].buf_len = PBUF_SLOT_BUF_LEN(PBUF_CLASS_SLOT(set, c));
+		classst[c].packets = 0;
+		saved = 0;
+		for (s = first; s <= PBUF_CLASS_SLOT(set, c); s++) {
+			classst[c].packets += window[s];
+			saved += (int64_t)window[s] * (PBUF_SLOT_BUF_LEN(pbuf_class_slot_for(pbuf_class_set_default, s)) - classst[c].buf_len);
+		}
+		first = s;
+
+		used = cellst[c].cellcount - cellst[c].freecount;
+		classst[c].saved_bytes = (classst[c].packets) ? (double)saved / classst[c].packets * used : 0;
+	}
 }
 #endif
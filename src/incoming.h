@@ -20,15 +20,22 @@ extern int check_invalid_src_dst(const char *call, int len);
 extern int check_call_match(const char **set, const char *call, int len);
 extern int check_call_glob_match(char **set, const char *call, int len);
 extern int check_path_calls(const char *via_start, const char *path_end);
+extern void incoming_parse_path(struct pbuf_t *pb);
 
 extern void incoming_flush(struct worker_t *self);
 extern int incoming_handler(struct worker_t *self, struct client_t *c, int l4proto, char *s, int len);
 extern int incoming_parse(struct worker_t *self, struct client_t *c, char *s, int len);
 
 #ifndef _FOR_VALGRIND_
-extern void incoming_cell_stats(struct cellstatus_t *cellst_pbuf_small,
-	struct cellstatus_t *cellst_pbuf_medium,
-	struct cellstatus_t *cellst_pbuf_large);
+/* a packet buffer size class, for the status */
+struct pbuf_class_stats_t {
+	int buf_len;		/* length of the buffers */
+	long packets;		/* packets since the classes were picked */
+	long saved_bytes;	/* bytes the buffers in use take less than with the fixed classes */
+};
+
+/* both of PBUF_CLASSES */
+extern void incoming_cell_stats(struct cellstatus_t *cellst, struct pbuf_class_stats_t *classst);
 #endif
 
 #endif
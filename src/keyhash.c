@@ -21,7 +21,8 @@
  *   http://www.concentric.net/~Ttwang/tech/inthash.htm
  *   http://isthe.com/chongo/tech/comp/fnv/
  *
- * Currently using FNV-1a
+ * Currently using a multiply-and-fold hash of 8 bytes at a time, and
+ * FNV-1a where a hash is needed one byte at a time
  *
  */
 
@@ -48,9 +49,14 @@
  */
 
 #include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
 #include <sys/types.h>
 
 #include "keyhash.h"
+#include "random.h"
 
 #ifdef __GNUC__ // compiling with GCC ?
 
@@ -66,14 +72,135 @@
 
 #endif
 
-void keyhash_init(void) { }
+#define FNV_32_PRIME     16777619U
+#define FVN_32_OFFSET  2166136261U
 
-uint32_t __attribute__((pure)) keyhash(const void *p, int len, uint32_t hash)
+/*
+ * keyhash() and keyhashuc() hash 8 bytes at a time. Each word is
+ * mixed in with a 64x64 -> 128 bit multiplication, folding the high
+ * half of the product on the low one, and the length is mixed in at
+ * the end. The state and the constants mixed in come from a random
+ * seed, picked at startup by keyhash_init(), so that remote peers can
+ * not predict the hashes, and send packets and filters colliding in
+ * the hash tables. keyhashuc() folds lower case letters to upper case
+ * a word at a time, and gives the same hash as keyhash() gives for the
+ * key in upper case.
+ *
+ * A nonzero hash0 continues a hash, but unlike with the FNV, hashing
+ * a key in parts does not give the same hash as hashing it at once.
+ *
+ * The FNV-1a versions are still there as keyhash_fnv() and
+ * keyhashuc_fnv(), for the hashes which must stay the same from one
+ * process to another, or which are calculated a byte at a time.
+ * Building with -DKEYHASH_FNV makes keyhash() and keyhashuc() use the
+ * FNV-1a, too.
+ */
+
+static uint64_t keyhash_secret[3] = {
+	0x243f6a8885a308d3ULL, 0xa0761d6478bd642fULL, 0xe7037ed1a0b428dbULL
+};
+
+void keyhash_init(void)
+{
+	uint64_t seed[3];
+	int fd, i;
+	
+	fd = urandom_open();
+	if (fd < 0 || read(fd, seed, sizeof(seed)) != sizeof(seed)) {
+		/* urandom failed for us, use something inferior */
+		for (i = 0; i < 3; i++)
+			seed[i] = ((uint64_t)time(NULL) << 32) ^ ((uint64_t)getpid() << (i * 8)) ^ (uint64_t)random();
+	}
+	if (fd >= 0)
+		close(fd);
+	
+	/* an odd multiplier, and the high bits set for the others, so
+	 * that none of them is 0
+	 */
+	keyhash_secret[0] = seed[0] | (1ULL << 63);
+	keyhash_secret[1] = seed[1] | 1;
+	keyhash_secret[2] = seed[2] | (1ULL << 62);
+}
+
+static inline uint64_t keyhash_mum(uint64_t a, uint64_t b)
+{
+#ifdef __SIZEOF_INT128__
+	__uint128_t r = (__uint128_t)a * b;
+	
+	return (uint64_t)r ^ (uint64_t)(r >> 64);
+#else
+	uint64_t ha = a >> 32, la = (uint32_t)a, hb = b >> 32, lb = (uint32_t)b;
+	uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+	uint64_t t = rl + (rm0 << 32), lo = t + (rm1 << 32);
+	uint64_t c = (t < rl) + (lo < t);
+	
+	return lo ^ (rh + (rm0 >> 32) + (rm1 >> 32) + c);
+#endif
+}
+
+static inline uint64_t keyhash_load8(const uint8_t *p)
+{
+	uint64_t v;
+	
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+static inline uint64_t keyhash_load4(const uint8_t *p)
+{
+	uint32_t v;
+	
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+/* lower case ASCII letters in a word to upper case */
+static inline uint64_t keyhash_upcase(uint64_t w)
+{
+	const uint64_t ones = 0x0101010101010101ULL;
+	uint64_t h = w & (0x7f * ones);
+	uint64_t ge_a = h + (0x80 - 'a') * ones;	/* bit 7 set if >= 'a' */
+	uint64_t gt_z = h + (0x80 - 'z' - 1) * ones;	/* bit 7 set if > 'z' */
+	
+	return w ^ (((ge_a & ~gt_z & ~w) & (0x80 * ones)) >> 2);
+}
+
+static inline __attribute__((always_inline)) uint32_t keyhash_words(const void *s, int len, uint32_t hash0, int uc)
+{
+	const uint8_t *p = s;
+	uint64_t h = keyhash_secret[0] ^ hash0;
+	uint64_t w;
+	int i;
+	
+	/* the last word is done separately, even if it is a whole one */
+	for (i = 0; i + 8 < len; i += 8) {
+		w = keyhash_load8(p + i);
+		if (uc)
+			w = keyhash_upcase(w);
+		h = keyhash_mum(w ^ keyhash_secret[1], h ^ keyhash_secret[2]);
+	}
+	
+	/* the rest, up to 8 bytes, possibly overlapping the ones done */
+	if (len >= 8)
+		w = keyhash_load8(p + len - 8);
+	else if (len >= 4)
+		w = (keyhash_load4(p) << 32) | keyhash_load4(p + len - 4);
+	else if (len > 0)
+		w = ((uint64_t)p[0] << 16) | ((uint64_t)p[len >> 1] << 8) | p[len - 1];
+	else
+		w = 0;
+	if (uc)
+		w = keyhash_upcase(w);
+	h = keyhash_mum(w ^ keyhash_secret[1], h ^ keyhash_secret[2]);
+	h = keyhash_mum(h ^ keyhash_secret[1], (uint64_t)len ^ keyhash_secret[0]);
+	
+	return (uint32_t)(h ^ (h >> 32));
+}
+
+uint32_t __attribute__((pure)) keyhash_fnv(const void *p, int len, uint32_t hash)
 {
 	const uint8_t *u = p;
 	int i;
-#define FNV_32_PRIME     16777619U
-#define FVN_32_OFFSET  2166136261U
 
 	if (hash == 0)
         	hash = (uint32_t)FVN_32_OFFSET;
@@ -93,7 +220,7 @@ uint32_t __attribute__((pure)) keyhash(const void *p, int len, uint32_t hash)
 /* The data material is known to contain ASCII, and if any value in there
  * is a lower case letter, it is first converted to upper case one.
 */
-uint32_t __attribute__((pure)) keyhashuc(const void *p, int len, uint32_t hash)
+uint32_t __attribute__((pure)) keyhashuc_fnv(const void *p, int len, uint32_t hash)
 {
 	const uint8_t *u = p;
 	int i;
@@ -118,3 +245,21 @@ uint32_t __attribute__((pure)) keyhashuc(const void *p, int len, uint32_t hash)
 	}
 	return hash;
 }
+
+uint32_t __attribute__((pure)) keyhash(const void *p, int len, uint32_t hash)
+{
+#ifdef KEYHASH_FNV
+	return keyhash_fnv(p, len, hash);
+#else
+	return keyhash_words(p, len, hash, 0);
+#endif
+}
+
+uint32_t __attribute__((pure)) keyhashuc(const void *p, int len, uint32_t hash)
+{
+#ifdef KEYHASH_FNV
+	return keyhashuc_fnv(p, len, hash);
+#else
+	return keyhash_words(p, len, hash, 1);
+#endif
+}
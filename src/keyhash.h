@@ -11,8 +11,14 @@
 #ifndef KEYHASH_H
 #define KEYHASH_H
 
+#include <stdint.h>
+
 extern void     keyhash_init(void);
 extern uint32_t keyhash(const void *s, int slen, uint32_t hash0);
 extern uint32_t keyhashuc(const void *s, int slen, uint32_t hash0);
 
+/* FNV-1a, the same in every process, and a byte at a time */
+extern uint32_t keyhash_fnv(const void *s, int slen, uint32_t hash0);
+extern uint32_t keyhashuc_fnv(const void *s, int slen, uint32_t hash0);
+
 #endif
@@ -0,0 +1,110 @@
+/*
+ *	aprsc
+ *
+ *	(c) Heikki Hannikainen, OH7LZB <hessu@hes.iki.fi>
+ *
+ *     This program is licensed under the BSD license, which can be found
+ *     in the file LICENSE.
+ *
+ */
+
+/*
+ *	latency.c: latency histograms and their percentiles, see latency.h
+ */
+
+#include <sys/time.h>
+
+#include "latency.h"
+#include "config.h"
+
+/*
+ *	A monotonic timestamp in microseconds, for measuring latencies
+ *	between threads
+ */
+
+uint64_t latency_now(void)
+{
+#ifdef USE_CLOCK_GETTIME
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+#else
+	struct timeval tv;
+
+	gettimeofday(&tv, NULL);
+
+	return (uint64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+#endif
+}
+
+void latency_merge(struct latency_hist_t *dst, const struct latency_hist_t *src)
+{
+	int i;
+
+	for (i = 0; i < LATENCY_BUCKETS; i++)
+		dst->buckets[i] += src->buckets[i];
+
+	dst->count += src->count;
+	dst->sum += src->sum;
+	if (src->max > dst->max)
+		dst->max = src->max;
+}
+
+/* the largest value which goes in a bucket */
+static uint32_t latency_bucket_top(int b)
+{
+	int e;
+
+	if (b < LATENCY_SUB)
+		return b;
+
+	e = (b >> LATENCY_SUB_BITS) + LATENCY_SUB_BITS - 1;
+
+	return (((uint64_t)(LATENCY_SUB + (b & (LATENCY_SUB - 1))) + 1) << (e - LATENCY_SUB_BITS)) - 1;
+}
+
+/*
+ *	The latency which pct percent of the samples are at or below,
+ *	rounded up to the top of its bucket
+ */
+
+uint32_t latency_percentile(const struct latency_hist_t *h, double pct)
+{
+	uint64_t rank, n = 0;
+	uint32_t top;
+	int i;
+
+	if (!h->count)
+		return 0;
+
+	rank = h->count * pct / 100.0;
+	if (rank < 1)
+		rank = 1;
+
+	for (i = 0; i < LATENCY_BUCKETS; i++) {
+		n += h->buckets[i];
+		if (n >= rank) {
+			top = latency_bucket_top(i);
+			return (top < h->max) ? top : h->max;
+		}
+	}
+
+	return h->max;
+}
+
+cJSON *latency_json(const struct latency_hist_t *h)
+{
+	cJSON *j = cJSON_CreateObject();
+
+	cJSON_AddNumberToObject(j, "count", h->count);
+	cJSON_AddNumberToObject(j, "avg_us", (h->count) ? h->sum / h->count : 0);
+	cJSON_AddNumberToObject(j, "p50_us", latency_percentile(h, 50));
+	cJSON_AddNumberToObject(j, "p90_us", latency_percentile(h, 90));
+	cJSON_AddNumberToObject(j, "p99_us", latency_percentile(h, 99));
+	cJSON_AddNumberToObject(j, "p999_us", latency_percentile(h, 99.9));
+	cJSON_AddNumberToObject(j, "max_us", h->max);
+
+	return j;
+}
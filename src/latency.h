@@ -0,0 +1,66 @@
+/*
+ *	aprsc
+ *
+ *	(c) Heikki Hannikainen, OH7LZB <hessu@hes.iki.fi>
+ *
+ *     This program is licensed under the BSD license, which can be found
+ *     in the file LICENSE.
+ *
+ */
+
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <stdint.h>
+
+#include "cJSON.h"
+
+/*
+ *	Latency histograms, in microseconds. The buckets are logarithmic,
+ *	with 8 buckets for every power of two, so a percentile is within
+ *	12.5% of the real value. A histogram is updated by a single thread
+ *	and read by the status thread without locking - the counters may
+ *	be a packet or two off from each other, which does not matter.
+ */
+
+#define LATENCY_SUB_BITS	3
+#define LATENCY_SUB		(1 << LATENCY_SUB_BITS)
+#define LATENCY_BUCKETS		((32 - LATENCY_SUB_BITS + 1) * LATENCY_SUB)
+
+struct latency_hist_t {
+	uint64_t count;
+	uint64_t sum;
+	uint32_t max;
+	uint64_t buckets[LATENCY_BUCKETS];
+};
+
+extern uint64_t latency_now(void);
+extern void latency_merge(struct latency_hist_t *dst, const struct latency_hist_t *src);
+extern uint32_t latency_percentile(const struct latency_hist_t *h, double pct);
+extern cJSON *latency_json(const struct latency_hist_t *h);
+
+static inline int latency_bucket(uint32_t usec)
+{
+	int e;
+
+	if (usec < LATENCY_SUB)
+		return usec;
+
+	e = 31 - __builtin_clz(usec);
+
+	return ((e - LATENCY_SUB_BITS + 1) << LATENCY_SUB_BITS)
+		+ ((usec >> (e - LATENCY_SUB_BITS)) & (LATENCY_SUB - 1));
+}
+
+static inline void latency_add(struct latency_hist_t *h, uint64_t usec)
+{
+	uint32_t v = (usec > UINT32_MAX) ? UINT32_MAX : usec;
+
+	h->buckets[latency_bucket(v)]++;
+	h->count++;
+	h->sum += v;
+	if (v > h->max)
+		h->max = v;
+}
+
+#endif
@@ -19,6 +19,8 @@
 #include "hlog.h"
 #include "filter.h"
 #include "status.h"
+#include "geoindex.h"
+#include "callindex.h"
 
 /*
  *	send a single packet to all clients (and peers and uplinks) which
@@ -35,13 +37,104 @@ static inline void send_single(struct worker_t *self, struct client_t *c, char *
 	else
 		clientaccount_add_tx( c, c->ai_protocol, 0, 1);
 	
+	/* the write latency of a sampled packet is recorded when the
+	 * output buffer it is in has been written, see client_obuf_written()
+	 */
+	if (self->outgoing_sample_received && !c->obuf_sample_received) {
+		c->obuf_sample_received = self->outgoing_sample_received;
+		c->obuf_sample_taken = self->outgoing_sample_taken;
+	}
+	
 	c->write(self, c, data, len);
 }
 
+/*
+ *	Run the filters of a single downstream client, and send the packet
+ *	if it matches. The client may be destroyed while sending.
+ */
+
+static inline void process_outgoing_client(struct worker_t *self, struct client_t *c, uint32_t origin, struct pbuf_t *pb, uint32_t kinds)
+{
+	/* If not full feed, process filters to see if the packet should be sent. */
+	if ((c->flags & CLFLAGS_FULLFEED) != CLFLAGS_FULLFEED) {
+		/* Skip the filters if they can not pass this kind of
+		 * packets at all. Igate ports may get messages and
+		 * courtesy positions without filters, though.
+		 */
+		if (!(c->filter_kinds & kinds) && !(c->flags & CLFLAGS_IGATE)) {
+			self->filter_prefiltered++;
+			return;
+		}
+		
+		self->filter_calls++;
+		if (filter_process(self, c, pb) < 1) {
+			//hlog(LOG_DEBUG, "fd %d: Not fullfeed or not matching filter, not sending.", c->fd);
+			return;
+		}
+	}
+	
+	/* Do not send packet back to the source client.
+	   The handle is not reused for a new client, even if the
+	   client_t of the source is.
+	   Very unlikely check, so check for this last.
+	 */
+	if (c->handle == origin) {
+		//hlog(LOG_DEBUG, "%d: not sending to client: originated from this socketsocket", c->fd);
+		return;
+	}
+
+	/* Do not send packets to clients which we've blacklisted as broken. */
+	if (c->no_tx)
+		return;
+	
+	send_single(self, c, pb->data, pb->packet_len);
+}
+
+/*
+ *	Look at the hot record of a classified client: returns 0 if the
+ *	client can not want the packet, without touching the client_t.
+ *	The filters of igate ports are always run, for the messaging.
+ */
+
+static inline int process_outgoing_hot(struct worker_t *self, struct client_hot_t *h, uint32_t origin, uint32_t kinds)
+{
+	/* not back to the source client, nor to a blacklisted igate */
+	if (h->handle == origin || h->no_tx)
+		return 0;
+	
+	if ((h->flags & CLFLAGS_FULLFEED) == CLFLAGS_FULLFEED || (h->flags & CLFLAGS_IGATE))
+		return 1;
+	
+	if (!(h->filter_kinds & kinds)) {
+		self->filter_prefiltered++;
+		return 0;
+	}
+	
+	if (filter_shared_rejected(self, h->filter_shared)) {
+		self->filter_calls++;
+		self->filter_shared_hits++;
+		return 0;
+	}
+	
+	return 1;
+}
+
+/*
+ *	The classes are walked backwards: a client destroyed while sending
+ *	is replaced by the last one of the class, which has been visited
+ *	already.
+ */
+
 static void process_outgoing_single(struct worker_t *self, struct pbuf_t *pb)
 {
-	struct client_t *c, *cnext;
-	struct client_t *origin = pb->origin; /* reduce pointer deferencing in tight loops */
+	struct client_t *c;
+	struct client_class_t *cl;
+	struct client_hot_t *h;
+	uint32_t origin = pb->origin; /* reduce pointer deferencing in tight loops */
+	struct geoindex_cell_t *cell;
+	struct callindex_entry_t *entries[CALLINDEX_MAX_MATCHES];
+	uint32_t stamp, kinds;
+	int i, j, n;
 	
 	/*
 	// debug dump
@@ -58,7 +151,8 @@ static void process_outgoing_single(struct worker_t *self, struct pbuf_t *pb)
 	
 	if (pb->flags & F_DUPE) {
 		/* Duplicate packet. Don't send, unless client especially wants! */
-		if (self->clients_dupe) {
+		cl = &self->clients_dupe;
+		if (cl->count) {
 			/* if we have any dupe clients at all, generate a version with "dup\t"
 			 * prefix to avoid regular clients processing dupes
 			 */
@@ -67,65 +161,85 @@ static void process_outgoing_single(struct worker_t *self, struct pbuf_t *pb)
 			memcpy(dupe_sendbuf + 4, pb->data, pb->packet_len);
 			int dupe_len = pb->packet_len + 4;
 			
-			for (c = self->clients_dupe; (c); c = cnext) {
-				cnext = c->class_next; // client_write() MAY destroy the client object!
-				send_single(self, c, dupe_sendbuf, dupe_len);
+			for (i = cl->count - 1; i >= 0; i--) {
+				if (i >= cl->count) // client_write() MAY destroy the client object!
+					continue;
+				send_single(self, cl->hot[i].c, dupe_sendbuf, dupe_len);
 			}
 		}
 		
 		/* Check if I have the client which sent this dupe, and
 		 * increment it's dupe counter
 		 */
-		/* OPTIMIZE: we walk through all clients for each dupe - how to find it quickly? */
-		for (c = self->clients; (c); c = c->next) {
-			if (c == origin) {
-				clientaccount_add_rx(c, -1, 0, 0, 0, 1);
-				break;
-			}
-		}
+		c = client_handle_get(self, origin);
+		if (c)
+			clientaccount_add_rx(c, -1, 0, 0, 0, 1);
 		
 		return;
 	}
 
 	if (pb->flags & F_FROM_DOWNSTR) {
 		/* client is from downstream, send to upstreams and peers */
-		for (c = self->clients_ups; (c); c = cnext) {
-			cnext = c->class_next; // client_write() MAY destroy the client object!
-			if (c != origin)
-				send_single(self, c, pb->data, pb->packet_len);
+		cl = &self->clients_ups;
+		for (i = cl->count - 1; i >= 0; i--) {
+			if (i >= cl->count) // client_write() MAY destroy the client object!
+				continue;
+			h = &cl->hot[i];
+			if (h->handle != origin)
+				send_single(self, h->c, pb->data, pb->packet_len);
 		}
 	}
 	
 	/* packet came from anywhere and is not a dupe - let's go through the
-	 * clients who connected us
+	 * clients who connected us. The stamp identifies the packet for
+	 * the verdicts cached in shared filters, and for the index walk.
 	 */
-	for (c = self->clients_other; (c); c = cnext) {
-		cnext = c->class_next; // client_write() MAY destroy the client object!
-		
-		/* If not full feed, process filters to see if the packet should be sent. */
-		if (( (c->flags & CLFLAGS_FULLFEED) != CLFLAGS_FULLFEED) && filter_process(self, c, pb) < 1) {
-			//hlog(LOG_DEBUG, "fd %d: Not fullfeed or not matching filter, not sending.", c->fd);
+	stamp = ++self->packet_stamp;
+	if (stamp == 0) /* wrapped around, 0 is the initial stamp of clients */
+		stamp = ++self->packet_stamp;
+	
+	kinds = filter_packet_kinds(pb);
+	cl = &self->clients_other;
+	for (i = cl->count - 1; i >= 0; i--) {
+		if (i >= cl->count) // client_write() MAY destroy the client object!
 			continue;
+		h = &cl->hot[i];
+		if (process_outgoing_hot(self, h, origin, kinds))
+			process_outgoing_client(self, h->c, origin, pb, kinds);
+	}
+	
+	if (!self->geoindex || !self->geoindex->clients)
+		return;
+	
+	/* Clients having only position and callsign set filters can only
+	 * get packets having a position within their regions, or one of
+	 * their callsigns: look at the ones registered in the packet's
+	 * grid cell and callsign entries. A client can be in many of them,
+	 * so they're stamped when visited. The lists are walked backwards,
+	 * since a client being destroyed is replaced by the last one.
+	 */
+	if (pb->flags & F_HASPOS) {
+		cell = geoindex_lookup(self->geoindex, pb->lat, pb->lng);
+		for (i = cell->count - 1; i >= 0; i--) {
+			if (i >= cell->count)
+				continue;
+			c = cell->clients[i];
+			c->index_stamp = stamp;
+			process_outgoing_client(self, c, origin, pb, kinds);
 		}
-		
-		/* Do not send packet back to the source client.
-		   This may reject a packet that came from a socket that got
-		   closed a few milliseconds ago and its client_t got
-		   recycled on a newly connected client, but if the new client
-		   is a long living one, all further packets will be accepted
-		   just fine.
-		   Very unlikely check, so check for this last.
-		 */
-		if (c == origin) {
-			//hlog(LOG_DEBUG, "%d: not sending to client: originated from this socketsocket", c->fd);
-			continue;
+	}
+	
+	n = callindex_lookup(self->callindex, pb, entries);
+	for (j = 0; j < n; j++) {
+		for (i = entries[j]->count - 1; i >= 0; i--) {
+			if (i >= entries[j]->count)
+				continue;
+			c = entries[j]->clients[i];
+			if (c->index_stamp == stamp)
+				continue;
+			c->index_stamp = stamp;
+			process_outgoing_client(self, c, origin, pb, kinds);
 		}
-
-		/* Do not send packets to clients which we've blacklisted as broken. */
-		if (c->no_tx)
-			continue;
-		
-		send_single(self, c, pb->data, pb->packet_len);
 	}
 }
 
@@ -137,19 +251,15 @@ static void process_outgoing_single(struct worker_t *self, struct pbuf_t *pb)
 void process_outgoing(struct worker_t *self)
 {
 	struct pbuf_t *pb;
-	int e;
+	uint32_t seq, head;
 	
-	if ((e = rwl_rdlock(&pbuf_global_rwlock))) {
-		hlog(LOG_CRIT, "worker: Failed to rdlock pbuf_global_rwlock!");
-		exit(1);
-	}
-	
-	while ((pb = *self->pbuf_global_prevp)) {
-		//__sync_synchronize();
+	head = pbuf_ring_head(&pbuf_global);
+	for (seq = self->pbuf_cursor.seq; seq != head; seq++) {
+		pb = pbuf_ring_get(&pbuf_global, seq);
 		/* Some safety checks against bugs and overload conditions */
-		if (pb->is_free) {
-			hlog(LOG_ERR, "worker %d: process_outgoing got pbuf %d marked free, age %ld (now %ld t %ld)\n%.*s",
-				self->id, pb->seqnum, tick - pb->t, tick, pb->t, pb->packet_len-2, pb->data);
+		if (pb->is_free || (uint32_t)pb->seqnum != seq) {
+			hlog(LOG_ERR, "worker %d: process_outgoing got pbuf %d marked free or not %u, age %ld (now %ld t %ld)\n%.*s",
+				self->id, pb->seqnum, seq, tick - pb->t, tick, pb->t, pb->packet_len-2, pb->data);
 			abort(); /* this would be pretty bad, so we crash immediately */
 		} else if (pb->t > tick + 2) {
 			/* 2-second offset is normal in case of one thread updating tick earlier than another
@@ -167,17 +277,26 @@ void process_outgoing(struct worker_t *self)
 			self->internal_packet_drops++;
 			if (self->internal_packet_drops > 10)
 				status_error(86400, "packet_drop_hang");
+		} else if (pb->received) {
+			/* sampled for the latency histograms, see send_single() */
+			self->outgoing_sample_received = pb->received;
+			self->outgoing_sample_taken = latency_now();
+			process_outgoing_single(self, pb);
+			self->outgoing_sample_received = 0;
+			latency_add(&self->outgoing_latency, latency_now() - pb->published);
 		} else {
 			process_outgoing_single(self, pb);
 		}
-		self->last_pbuf_seqnum = pb->seqnum;
-		self->pbuf_global_prevp = &pb->next;
+		/* done with it, the dupecheck thread may reclaim it */
+		pbuf_ring_advance(&self->pbuf_cursor, seq + 1);
 	}
 	
-	while ((pb = *self->pbuf_global_dupe_prevp)) {
-		if (pb->is_free) {
-			hlog(LOG_ERR, "worker %d: process_outgoing got dupe %d marked free, age %ld (now %ld t %ld)\n%.*s",
-				self->id, pb->seqnum, tick - pb->t, tick, pb->t, pb->packet_len-2, pb->data);
+	head = pbuf_ring_head(&pbuf_global_dupe);
+	for (seq = self->pbuf_dupe_cursor.seq; seq != head; seq++) {
+		pb = pbuf_ring_get(&pbuf_global_dupe, seq);
+		if (pb->is_free || (uint32_t)pb->seqnum != seq) {
+			hlog(LOG_ERR, "worker %d: process_outgoing got dupe %d marked free or not %u, age %ld (now %ld t %ld)\n%.*s",
+				self->id, pb->seqnum, seq, tick - pb->t, tick, pb->t, pb->packet_len-2, pb->data);
 			abort();
 		} else if (pb->t > tick + 2) {
 			hlog(LOG_ERR, "worker: process_outgoing got dupe from future %d with t %ld > tick %ld!\n%.*s",
@@ -188,13 +307,6 @@ void process_outgoing(struct worker_t *self)
 		} else {
 			process_outgoing_single(self, pb);
 		}
-		self->last_pbuf_dupe_seqnum = pb->seqnum;
-		self->pbuf_global_dupe_prevp = &pb->next;
-	}
-	
-	if ((e = rwl_rdunlock(&pbuf_global_rwlock))) {
-		hlog(LOG_CRIT, "worker: Failed to rdunlock pbuf_global_rwlock!");
-		exit(1);
+		pbuf_ring_advance(&self->pbuf_dupe_cursor, seq + 1);
 	}
 }
-
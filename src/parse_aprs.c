@@ -97,6 +97,7 @@ static int pbuf_fill_pos(struct pbuf_t *pb, const float lat, const float lng, co
 	pb->lat     = filter_lat2rad(lat);  /* deg-to-radians */
 	pb->cos_lat = cosf(pb->lat);        /* used in range filters */
 	pb->lng     = filter_lon2rad(lng);  /* deg-to-radians */
+	range_point_set(&pb->range_pt, pb->lat, pb->lng, pb->cos_lat);
 	
 	pb->flags |= F_HASPOS;	/* the packet has positional data */
 
@@ -0,0 +1,172 @@
+/*
+ *	aprsc
+ *
+ *	(c) Heikki Hannikainen, OH7LZB <hessu@hes.iki.fi>
+ *
+ *     This program is licensed under the BSD license, which can be found
+ *     in the file LICENSE.
+ *
+ */
+
+/*
+ *	pbufring.c: the global packet queue, a broadcast ring of packet
+ *	buffers from the dupecheck thread to the workers. See pbufring.h.
+ *
+ *	The producer stores a packet in its slot and then moves the head
+ *	with a release store, so a consumer seeing the new head with an
+ *	acquire load sees the packet too. A consumer moves its cursor
+ *	with a release store after it is done with a packet, and the
+ *	producer only reuses a slot after all of the cursors have passed
+ *	the packet in it.
+ *
+ *	The inbox of the dupecheck thread is here too, since it is the
+ *	other half of the trip of a packet between the threads.
+ */
+
+#include <string.h>
+
+#include "pbufring.h"
+#include "worker.h"
+#include "hmalloc.h"
+#include "hlog.h"
+
+void pbuf_ring_init(struct pbuf_ring_t *r, uint32_t size, uint32_t seq)
+{
+	memset(r, 0, sizeof(*r));
+
+	r->size = size;
+	r->slots = hmalloc(sizeof(*r->slots) * size);
+	memset(r->slots, 0, sizeof(*r->slots) * size);
+	r->head = r->tail = seq;
+	r->backlog_prevp = &r->backlog;
+}
+
+void pbuf_ring_free(struct pbuf_ring_t *r)
+{
+	if (r->slots)
+		hfree(r->slots);
+	r->slots = NULL;
+}
+
+/*
+ *	Publish a list of packets having consecutive seqnums, starting
+ *	from the head of the ring (or the end of the backlog). Returns the
+ *	number of packets left in the backlog.
+ */
+
+int pbuf_ring_publish(struct pbuf_ring_t *r, struct pbuf_t *pb_list)
+{
+	struct pbuf_t *pb;
+	uint32_t head = r->head;
+
+	/* append to the backlog */
+	for (pb = pb_list; (pb); pb = pb->next) {
+		*r->backlog_prevp = pb;
+		r->backlog_prevp = &pb->next;
+		r->backlog_count++;
+	}
+
+	/* move as many as fit in the ring */
+	while (r->backlog && head - r->tail < r->size) {
+		pb = r->backlog;
+		r->backlog = pb->next;
+		r->backlog_count--;
+
+		if (pb->seqnum != head)
+			hlog(LOG_ERR, "pbuf_ring_publish: packet seqnum %u does not match head %u", pb->seqnum, head);
+
+		pb->next = NULL;
+		r->slots[head & (r->size - 1)] = pb;
+		head++;
+	}
+
+	if (!r->backlog)
+		r->backlog_prevp = &r->backlog;
+
+	__atomic_store_n(&r->head, head, __ATOMIC_RELEASE);
+
+	if (pb_list && r->backlog_count)
+		hlog(LOG_DEBUG, "pbuf_ring_publish: ring of %u full, %d packets in backlog", r->size, r->backlog_count);
+
+	return r->backlog_count;
+}
+
+/*
+ *	Take out the packets before seqnum upto, which all of the consumers
+ *	have passed, to be freed by the caller. Returns the number of
+ *	packets put in freeset, call again if it is max.
+ */
+
+int pbuf_ring_reclaim(struct pbuf_ring_t *r, uint32_t upto, struct pbuf_t **freeset, int max)
+{
+	int n = 0;
+
+	/* never past the head, even if a cursor would be */
+	if ((int32_t)(upto - r->head) > 0)
+		upto = r->head;
+
+	while (r->tail != upto && n < max) {
+		freeset[n++] = r->slots[r->tail & (r->size - 1)];
+		r->slots[r->tail & (r->size - 1)] = NULL;
+		r->tail++;
+	}
+
+	return n;
+}
+
+/*
+ *	A consumer starts from the packets published after it joins.
+ *	It must be on the producer's list of consumers before this,
+ *	with joined cleared.
+ */
+
+void pbuf_ring_join(struct pbuf_ring_t *r, struct pbuf_ring_cursor_t *cur)
+{
+	__atomic_store_n(&cur->seq, pbuf_ring_head(r), __ATOMIC_RELEASE);
+	__atomic_store_n(&cur->joined, 1, __ATOMIC_RELEASE);
+}
+
+/*
+ *	Put a list of packets in the inbox. The list is linked from the
+ *	newest packet to the oldest one, and the next of the oldest one is
+ *	overwritten. The release of the compare and swap makes the packets
+ *	visible to the consumer, with their contents.
+ */
+
+void pbuf_inbox_put(struct pbuf_inbox_t *q, struct pbuf_t *newest, struct pbuf_t *oldest, int count)
+{
+	/* counted first, so that the consumer does not take the count below zero */
+	__atomic_add_fetch(&q->count, count, __ATOMIC_RELAXED);
+
+	oldest->next = __atomic_load_n(&q->head, __ATOMIC_RELAXED);
+	while (!__atomic_compare_exchange_n(&q->head, &oldest->next, newest, 1, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+		;
+}
+
+/*
+ *	Take all of the packets out of the inbox, oldest first. Returns
+ *	the list and its length in *count, or NULL if the inbox is empty.
+ */
+
+struct pbuf_t *pbuf_inbox_take(struct pbuf_inbox_t *q, int *count)
+{
+	struct pbuf_t *pb, *next, *list = NULL;
+	int n = 0;
+
+	if (!pbuf_inbox_pending(q)) {
+		*count = 0;
+		return NULL;
+	}
+
+	for (pb = __atomic_exchange_n(&q->head, NULL, __ATOMIC_ACQUIRE); (pb); pb = next) {
+		next = pb->next;
+		pb->next = list;
+		list = pb;
+		n++;
+	}
+
+	__atomic_sub_fetch(&q->count, n, __ATOMIC_RELAXED);
+	*count = n;
+
+	return list;
+}
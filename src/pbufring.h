@@ -0,0 +1,130 @@
+/*
+ *	aprsc
+ *
+ *	(c) Heikki Hannikainen, OH7LZB <hessu@hes.iki.fi>
+ *
+ *     This program is licensed under the BSD license, which can be found
+ *     in the file LICENSE.
+ *
+ */
+
+#ifndef PBUFRING_H
+#define PBUFRING_H
+
+#include <stdint.h>
+
+struct pbuf_t;
+
+/*
+ *	A broadcast ring of packet buffers, indexed by the seqnum of the
+ *	packets. There is a single producer (the dupecheck thread), which
+ *	publishes packets in seqnum order, and many consumers (the workers),
+ *	each having a cursor of its own. The producer reclaims the packets
+ *	all of the consumers have passed. No locks are taken, the consumers
+ *	never block the producer, and the producer only needs to look at
+ *	the cursors.
+ *
+ *	If the ring is full because a consumer is lagging behind, the
+ *	producer keeps the new packets in a backlog, and publishes them
+ *	when there is room again.
+ */
+
+struct pbuf_ring_t {
+	struct pbuf_t **slots;
+	uint32_t size;		/* number of slots, a power of two */
+	uint32_t head;		/* seqnum of the next packet to publish */
+	uint32_t tail;		/* seqnum of the oldest packet not reclaimed, producer only */
+
+	struct pbuf_t *backlog;	/* packets waiting for room in the ring, producer only */
+	struct pbuf_t **backlog_prevp;
+	int backlog_count;
+};
+
+/*
+ *	A consumer's position in the ring. A consumer joins the ring by
+ *	setting its cursor to the head, and the producer does not reclaim
+ *	anything while there is a consumer which has not joined yet.
+ */
+
+struct pbuf_ring_cursor_t {
+	uint32_t seq;		/* seqnum of the next packet to process */
+	int joined;
+};
+
+extern void pbuf_ring_init(struct pbuf_ring_t *r, uint32_t size, uint32_t seq);
+extern void pbuf_ring_free(struct pbuf_ring_t *r);
+extern int  pbuf_ring_publish(struct pbuf_ring_t *r, struct pbuf_t *pb_list);
+extern int  pbuf_ring_reclaim(struct pbuf_ring_t *r, uint32_t upto, struct pbuf_t **freeset, int max);
+extern void pbuf_ring_join(struct pbuf_ring_t *r, struct pbuf_ring_cursor_t *cur);
+
+/* seqnum of the next packet to be published, and everything before it is readable */
+static inline uint32_t pbuf_ring_head(const struct pbuf_ring_t *r)
+{
+	return __atomic_load_n(&r->head, __ATOMIC_ACQUIRE);
+}
+
+static inline struct pbuf_t *pbuf_ring_get(const struct pbuf_ring_t *r, uint32_t seq)
+{
+	return r->slots[seq & (r->size - 1)];
+}
+
+/* the consumer is done with everything before seq */
+static inline void pbuf_ring_advance(struct pbuf_ring_cursor_t *cur, uint32_t seq)
+{
+	__atomic_store_n(&cur->seq, seq, __ATOMIC_RELEASE);
+}
+
+static inline int pbuf_ring_pending(const struct pbuf_ring_t *r, const struct pbuf_ring_cursor_t *cur)
+{
+	return pbuf_ring_head(r) != cur->seq;
+}
+
+/*
+ *	Find the oldest cursor of the consumers, for pbuf_ring_reclaim().
+ *	Call with the head of the ring as *min to begin with. Returns 0 if
+ *	the consumer has not joined, and nothing may be reclaimed.
+ */
+
+static inline int pbuf_ring_cursor_min(const struct pbuf_ring_cursor_t *cur, uint32_t *min)
+{
+	uint32_t seq;
+
+	if (!__atomic_load_n(&cur->joined, __ATOMIC_ACQUIRE))
+		return 0;
+
+	seq = __atomic_load_n(&cur->seq, __ATOMIC_ACQUIRE);
+	if ((int32_t)(seq - *min) < 0)
+		*min = seq;
+
+	return 1;
+}
+
+/*
+ *	An inbox of packets, from the workers to the dupecheck thread.
+ *	Any number of producers put lists of packets in, and a single
+ *	consumer takes all of them out at once. Neither side takes a lock,
+ *	so a worker never has to wait or skip a flush because the dupecheck
+ *	thread is draining the inbox.
+ *
+ *	The inbox is a stack: a producer links its list, newest packet
+ *	first, in front of the packets already in it with a compare and
+ *	swap, and the consumer swaps the whole stack out with an exchange
+ *	and reverses it to the order the packets were put in. The consumer
+ *	never takes out single packets, so a packet being reused in between
+ *	(the ABA problem of lock-free stacks) does not matter.
+ */
+
+struct pbuf_inbox_t {
+	struct pbuf_t *head;	/* the newest packet */
+	int count;		/* packets in the inbox, for the statistics */
+};
+
+extern void pbuf_inbox_put(struct pbuf_inbox_t *q, struct pbuf_t *newest, struct pbuf_t *oldest, int count);
+extern struct pbuf_t *pbuf_inbox_take(struct pbuf_inbox_t *q, int *count);
+
+static inline int pbuf_inbox_pending(const struct pbuf_inbox_t *q)
+{
+	return __atomic_load_n(&q->head, __ATOMIC_RELAXED) != NULL;
+}
+
+#endif
@@ -0,0 +1,250 @@
+/*
+ *	aprsc
+ *
+ *	(c) Heikki Hannikainen, OH7LZB <hessu@hes.iki.fi>
+ *
+ *     This program is licensed under the BSD license, which can be found
+ *     in the file LICENSE.
+ *
+ */
+
+/*
+ *	range.c: distance checks for the range filters
+ *
+ *	The filters used to calculate the distance in kilometres with the
+ *	haversine formula for every packet, which takes two sines, two
+ *	square roots and an arc tangent. Instead, a point is stored with
+ *	the sines and cosines of half of its latitude and longitude
+ *	(range_point_set()), and the half-angle sines of the differences
+ *	are found with
+ *
+ *	  sin((b - a) / 2) = sin(b/2) cos(a/2) - cos(b/2) sin(a/2)
+ *
+ *	The haversine of the distance is then
+ *
+ *	  h = sin^2(dlat/2) + cos(lat1) cos(lat2) sin^2(dlon/2)
+ *
+ *	and the distance is within the limit of the filter if h is smaller
+ *	than the haversine of the limit, calculated once by range_limit().
+ *	This is the same test as before, but rounding may move a packet
+ *	a few metres at the edge of the range.
+ *
+ *	range_set_hits() checks a point against a set of centres at once,
+ *	using SSE or AVX on x86-64, as selected at startup by range_init().
+ *	All kernels do exactly the same single precision operations in the
+ *	same order as range_within(), so they give exactly the same
+ *	results. To keep it that way, the compiler must not fuse the
+ *	multiplications and additions in this file.
+ */
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC optimize ("fp-contract=off")
+#endif
+#ifdef __clang__
+#pragma STDC FP_CONTRACT OFF
+#endif
+
+#include <string.h>
+#include <math.h>
+
+#include "range.h"
+#include "hmalloc.h"
+#include "hlog.h"
+
+#if defined(__GNUC__) && defined(__x86_64__) && defined(__SSE_MATH__)
+#define RANGE_X86
+#include <immintrin.h>
+#endif
+
+/* kilometres per radian of central angle, as in the filter documentation */
+#define RANGE_KM_PER_RAD	(111.2 * 180.0 / M_PI)
+
+void range_point_set(struct range_point_t *p, float lat, float lng, float coslat)
+{
+	p->slat = sinf(lat * 0.5f);
+	p->clat = cosf(lat * 0.5f);
+	p->slng = sinf(lng * 0.5f);
+	p->clng = cosf(lng * 0.5f);
+	p->coslat = coslat;
+}
+
+/*
+ *	Convert a range in kilometres to the haversine of the central
+ *	angle, for comparing with range_hav()
+ */
+
+float range_limit(float dist)
+{
+	double h = dist / RANGE_KM_PER_RAD * 0.5;
+	double s;
+
+	if (dist <= 0)
+		return 0; /* nothing is closer than 0 */
+
+	if (h >= M_PI / 2)
+		return 2; /* more than half around the world covers everything */
+
+	s = sin(h);
+
+	return s * s;
+}
+
+static inline float range_hav(float slat, float clat, float slng, float clng, float coslat, const struct range_point_t *p)
+{
+	float sdlat = p->slat * clat - p->clat * slat;
+	float sdlng = p->slng * clng - p->clng * slng;
+
+	return sdlat * sdlat + p->coslat * coslat * sdlng * sdlng;
+}
+
+int range_within(const struct range_point_t *centre, float limit, const struct range_point_t *p)
+{
+	return range_hav(centre->slat, centre->clat, centre->slng, centre->clng, centre->coslat, p) < limit;
+}
+
+/*
+ *	Range sets
+ */
+
+void range_set_init(struct range_set_t *rs, int count)
+{
+	float *a;
+	int i, size = (count + RANGE_SET_PAD - 1) / RANGE_SET_PAD * RANGE_SET_PAD;
+
+	a = hmalloc(sizeof(float) * 6 * (size ? size : 1));
+	memset(a, 0, sizeof(float) * 6 * size);
+
+	rs->count = count;
+	rs->size = size;
+	rs->slat = a;
+	rs->clat = a + size;
+	rs->slng = a + size * 2;
+	rs->clng = a + size * 3;
+	rs->coslat = a + size * 4;
+	rs->limit = a + size * 5;
+
+	/* nothing is within a negative limit */
+	for (i = 0; i < size; i++)
+		rs->limit[i] = -1;
+}
+
+void range_set_free(struct range_set_t *rs)
+{
+	if (rs->slat)
+		hfree(rs->slat);
+	memset(rs, 0, sizeof(*rs));
+}
+
+void range_set_put(struct range_set_t *rs, int i, const struct range_point_t *centre, float limit)
+{
+	rs->slat[i] = centre->slat;
+	rs->clat[i] = centre->clat;
+	rs->slng[i] = centre->slng;
+	rs->clng[i] = centre->clng;
+	rs->coslat[i] = centre->coslat;
+	rs->limit[i] = limit;
+}
+
+/*
+ *	Batch kernels
+ */
+
+static void range_hits_scalar(const struct range_set_t *rs, const struct range_point_t *p, uint32_t *bits)
+{
+	int i;
+
+	memset(bits, 0, sizeof(*bits) * RANGE_BITS_WORDS(rs->count));
+
+	for (i = 0; i < rs->count; i++)
+		if (range_hav(rs->slat[i], rs->clat[i], rs->slng[i], rs->clng[i], rs->coslat[i], p) < rs->limit[i])
+			bits[i >> 5] |= 1U << (i & 31);
+}
+
+#ifdef RANGE_X86
+
+static void range_hits_sse(const struct range_set_t *rs, const struct range_point_t *p, uint32_t *bits)
+{
+	__m128 pslat = _mm_set1_ps(p->slat);
+	__m128 pclat = _mm_set1_ps(p->clat);
+	__m128 pslng = _mm_set1_ps(p->slng);
+	__m128 pclng = _mm_set1_ps(p->clng);
+	__m128 pcoslat = _mm_set1_ps(p->coslat);
+	__m128 sdlat, sdlng, h;
+	int i;
+
+	memset(bits, 0, sizeof(*bits) * RANGE_BITS_WORDS(rs->count));
+
+	for (i = 0; i < rs->size; i += 4) {
+		sdlat = _mm_sub_ps(_mm_mul_ps(pslat, _mm_loadu_ps(rs->clat + i)),
+			_mm_mul_ps(pclat, _mm_loadu_ps(rs->slat + i)));
+		sdlng = _mm_sub_ps(_mm_mul_ps(pslng, _mm_loadu_ps(rs->clng + i)),
+			_mm_mul_ps(pclng, _mm_loadu_ps(rs->slng + i)));
+		h = _mm_add_ps(_mm_mul_ps(sdlat, sdlat),
+			_mm_mul_ps(_mm_mul_ps(_mm_mul_ps(pcoslat, _mm_loadu_ps(rs->coslat + i)), sdlng), sdlng));
+		bits[i >> 5] |= (uint32_t)_mm_movemask_ps(_mm_cmplt_ps(h, _mm_loadu_ps(rs->limit + i))) << (i & 31);
+	}
+}
+
+__attribute__((target("avx")))
+static void range_hits_avx(const struct range_set_t *rs, const struct range_point_t *p, uint32_t *bits)
+{
+	__m256 pslat = _mm256_set1_ps(p->slat);
+	__m256 pclat = _mm256_set1_ps(p->clat);
+	__m256 pslng = _mm256_set1_ps(p->slng);
+	__m256 pclng = _mm256_set1_ps(p->clng);
+	__m256 pcoslat = _mm256_set1_ps(p->coslat);
+	__m256 sdlat, sdlng, h;
+	int i;
+
+	memset(bits, 0, sizeof(*bits) * RANGE_BITS_WORDS(rs->count));
+
+	for (i = 0; i < rs->size; i += 8) {
+		sdlat = _mm256_sub_ps(_mm256_mul_ps(pslat, _mm256_loadu_ps(rs->clat + i)),
+			_mm256_mul_ps(pclat, _mm256_loadu_ps(rs->slat + i)));
+		sdlng = _mm256_sub_ps(_mm256_mul_ps(pslng, _mm256_loadu_ps(rs->clng + i)),
+			_mm256_mul_ps(pclng, _mm256_loadu_ps(rs->slng + i)));
+		h = _mm256_add_ps(_mm256_mul_ps(sdlat, sdlat),
+			_mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(pcoslat, _mm256_loadu_ps(rs->coslat + i)), sdlng), sdlng));
+		bits[i >> 5] |= (uint32_t)_mm256_movemask_ps(_mm256_cmp_ps(h, _mm256_loadu_ps(rs->limit + i), _CMP_LT_OQ)) << (i & 31);
+	}
+}
+
+#endif
+
+static struct range_kernel_t range_kernel_list[4] = {
+	{ "scalar", range_hits_scalar }
+};
+const struct range_kernel_t *range_kernel = &range_kernel_list[0];
+
+const struct range_kernel_t *range_kernels(void)
+{
+	return range_kernel_list;
+}
+
+/*
+ *	Find the kernels supported by the CPU, and pick the widest one
+ */
+
+void range_init(void)
+{
+	int n = 0;
+
+	range_kernel_list[n].name = "scalar";
+	range_kernel_list[n++].hits = range_hits_scalar;
+
+#ifdef RANGE_X86
+	range_kernel_list[n].name = "sse";
+	range_kernel_list[n++].hits = range_hits_sse;
+
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx")) {
+		range_kernel_list[n].name = "avx";
+		range_kernel_list[n++].hits = range_hits_avx;
+	}
+#endif
+
+	range_kernel_list[n].name = NULL;
+	range_kernel = &range_kernel_list[n - 1];
+
+	hlog(LOG_DEBUG, "range filters: using %s kernel", range_kernel->name);
+}
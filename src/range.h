@@ -0,0 +1,68 @@
+/*
+ *	aprsc
+ *
+ *	(c) Heikki Hannikainen, OH7LZB <hessu@hes.iki.fi>
+ *
+ *     This program is licensed under the BSD license, which can be found
+ *     in the file LICENSE.
+ *
+ */
+
+#ifndef RANGE_H
+#define RANGE_H
+
+#include <stdint.h>
+
+/*
+ *	A point for the range filters (r/ f/ m/ and t/ with a distance).
+ *	The sines and cosines of half of the latitude and longitude are
+ *	calculated once, when the point is known, so that checking the
+ *	distance between two points only needs multiplications.
+ */
+struct range_point_t {
+	float slat, clat;	/* sin and cos of lat / 2 */
+	float slng, clng;	/* sin and cos of lng / 2 */
+	float coslat;		/* cos of lat */
+};
+
+/*
+ *	A set of range filter centres and their limits, as a structure of
+ *	arrays for range_set_hits(). The arrays are padded up to a multiple
+ *	of RANGE_SET_PAD with centres which can not be hit.
+ */
+#define RANGE_SET_PAD	8
+
+struct range_set_t {
+	int count;
+	int size;
+	float *slat, *clat, *slng, *clng, *coslat, *limit;
+};
+
+/* a batch kernel: set a bit in bits[] for each centre within range of p */
+typedef void (*range_hits_fn)(const struct range_set_t *rs, const struct range_point_t *p, uint32_t *bits);
+
+struct range_kernel_t {
+	const char *name;
+	range_hits_fn hits;
+};
+
+extern void range_init(void);
+extern const struct range_kernel_t *range_kernel;	/* selected by range_init() */
+extern const struct range_kernel_t *range_kernels(void);	/* available ones, NULL name terminates */
+
+extern void  range_point_set(struct range_point_t *p, float lat, float lng, float coslat);
+extern float range_limit(float dist);
+extern int   range_within(const struct range_point_t *centre, float limit, const struct range_point_t *p);
+
+extern void range_set_init(struct range_set_t *rs, int count);
+extern void range_set_free(struct range_set_t *rs);
+extern void range_set_put(struct range_set_t *rs, int i, const struct range_point_t *centre, float limit);
+
+static inline void range_set_hits(const struct range_set_t *rs, const struct range_point_t *p, uint32_t *bits)
+{
+	range_kernel->hits(rs, p, bits);
+}
+
+#define RANGE_BITS_WORDS(count)	(((count) + 31) / 32)
+
+#endif
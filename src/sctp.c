@@ -323,6 +323,7 @@ int sctp_client_write(struct worker_t *self, struct client_t *c, char *p, int le
 		//hlog(LOG_DEBUG, "%s/%s: client_write obuf empty", c->addr_rem, c->username, c->addr_rem);
 		c->obuf_start = 0;
 		c->obuf_end   = 0;
+		client_obuf_written(self, c);
 	}
 	return len;
 }
@@ -43,8 +43,8 @@ char *status_json_cached = NULL;
 time_t status_json_cache_t = 0;
 
 struct cdata_list_t {
-	const char *tree;
-	const char *name;
+	char *tree;
+	char *name;
 	struct cdata_list_t *next;
 	struct cdata_t *cd;
 	int gauge;
@@ -197,6 +197,122 @@ static void status_check_motd(cJSON *node)
 	cJSON_AddStringToObject(node, "motd", "/motd.html");
 }
 
+/*
+ *	Find an item of a counterdata tree, going down in the objects
+ *	when the name has dots in it: "total_latency.p99_us". The items
+ *	of an array are found by their "id": "1.total_latency.p99_us"
+ */
+
+static cJSON *status_json_child(cJSON *node, const char *key)
+{
+	cJSON *item, *id;
+	
+	if (!(node->type & cJSON_Array))
+		return cJSON_GetObjectItem(node, key);
+	
+	cJSON_ArrayForEach(item, node) {
+		id = cJSON_GetObjectItem(item, "id");
+		if (id && id->valueint == atoi(key))
+			return item;
+	}
+	
+	return NULL;
+}
+
+static cJSON *status_json_item(cJSON *node, const char *name)
+{
+	char key[64];
+	const char *dot;
+
+	while (node && (dot = strchr(name, '.'))) {
+		if (dot - name >= (int)sizeof(key))
+			return NULL;
+		memcpy(key, name, dot - name);
+		key[dot - name] = 0;
+		node = status_json_child(node, key);
+		name = dot + 1;
+	}
+
+	return (node) ? status_json_child(node, name) : NULL;
+}
+
+static void status_cdata_add(const char *tree, const char *name, int gauge)
+{
+	struct cdata_list_t *cl = hmalloc(sizeof(*cl));
+	char *n;
+	
+	n = hmalloc(strlen(tree) + 1 + strlen(name) + 1);
+	sprintf(n, "%s.%s", tree, name);
+	cl->tree = hstrdup(tree);
+	cl->name = hstrdup(name);
+	cl->next = cdata_list;
+	cl->cd = cdata_alloc(n);
+	hfree(n);
+	cl->gauge = gauge;
+	cdata_list = cl;
+}
+
+/*
+ *	The latency percentiles of each worker go in the counterdata too,
+ *	as "workers.<id>.total_latency.p99_us". The workers come and go on
+ *	reconfiguration, so the entries of a worker are added when its id
+ *	is first seen, and those of a worker which has been stopped get
+ *	samples of -1, like any other missing value.
+ */
+
+static void status_cdata_workers(cJSON *workers)
+{
+	static const char *stages[] = {
+		"parse_latency", "flush_latency", "outgoing_latency", "write_latency", "total_latency"
+	};
+	struct cdata_list_t *cl;
+	cJSON *jw, *id;
+	char name[64];
+	int i;
+	
+	cJSON_ArrayForEach(jw, workers) {
+		if (!(id = cJSON_GetObjectItem(jw, "id")))
+			continue;
+		
+		for (i = 0; i < (int)(sizeof(stages) / sizeof(stages[0])); i++) {
+			snprintf(name, sizeof(name), "%d.%s.p99_us", id->valueint, stages[i]);
+			for (cl = cdata_list; (cl); cl = cl->next)
+				if (strcmp(cl->tree, "workers") == 0 && strcmp(cl->name, name) == 0)
+					break;
+			if (!cl)
+				status_cdata_add("workers", name, 1);
+		}
+	}
+}
+
+#ifndef _FOR_VALGRIND_
+/*
+ *	The memory status of a cellmalloc arena, or something like it,
+ *	with the keys prefixed by the name of the arena
+ */
+
+void status_cell_json(cJSON *memory, const char *name, struct cellstatus_t *st, long used)
+{
+	static const char *keys[] = {
+		"cells_used", "cells_free", "cells_alloc", "cells_cached", "used_bytes", "allocated_bytes",
+		"rss_bytes", "block_size", "blocks", "blocks_max", "blocks_peak",
+		"blocks_released", "releases", "cell_size", "cell_size_aligned", "cell_align"
+	};
+	double values[] = {
+		used, st->freecount, st->cellcount, st->cached, (double)used * st->cellsize_aligned, (double)st->blocks * st->block_size,
+		st->rss_bytes, st->block_size, st->blocks, st->blocks_max, st->blocks_peak,
+		st->blocks_released, st->releases, st->cellsize, st->cellsize_aligned, st->alignment
+	};
+	char key[64];
+	int i;
+	
+	for (i = 0; i < (int)(sizeof(keys) / sizeof(keys[0])); i++) {
+		snprintf(key, sizeof(key), "%s_%s", name, keys[i]);
+		cJSON_AddNumberToObject(memory, key, values[i]);
+	}
+}
+#endif
+
 /*
  *	Generate a JSON status string
  */
@@ -257,116 +373,38 @@ char *status_json_string(int no_cache, int periodical)
 	cJSON *memory = cJSON_CreateObject();
 #ifndef _FOR_VALGRIND_
 	struct cellstatus_t cellst;
-	historydb_cell_stats(&cellst), 
-	cJSON_AddNumberToObject(memory, "historydb_cells_used", historydb_cellgauge);
-	cJSON_AddNumberToObject(memory, "historydb_cells_free", cellst.freecount);
-	cJSON_AddNumberToObject(memory, "historydb_used_bytes", historydb_cellgauge*cellst.cellsize_aligned);
-	cJSON_AddNumberToObject(memory, "historydb_allocated_bytes", (long)cellst.blocks * (long)cellst.block_size);
-	cJSON_AddNumberToObject(memory, "historydb_block_size", (long)cellst.block_size);
-	cJSON_AddNumberToObject(memory, "historydb_blocks", (long)cellst.blocks);
-	cJSON_AddNumberToObject(memory, "historydb_blocks_max", (long)cellst.blocks_max);
-	cJSON_AddNumberToObject(memory, "historydb_cell_size", cellst.cellsize);
-	cJSON_AddNumberToObject(memory, "historydb_cell_size_aligned", cellst.cellsize_aligned);
-	cJSON_AddNumberToObject(memory, "historydb_cell_align", cellst.alignment);
-	
-	dupecheck_cell_stats(&cellst), 
-	cJSON_AddNumberToObject(memory, "dupecheck_cells_used", dupecheck_cellgauge);
-	cJSON_AddNumberToObject(memory, "dupecheck_cells_free", cellst.freecount);
-	cJSON_AddNumberToObject(memory, "dupecheck_used_bytes", dupecheck_cellgauge*cellst.cellsize_aligned);
-	cJSON_AddNumberToObject(memory, "dupecheck_allocated_bytes", (long)cellst.blocks * (long)cellst.block_size);
-	cJSON_AddNumberToObject(memory, "dupecheck_block_size", (long)cellst.block_size);
-	cJSON_AddNumberToObject(memory, "dupecheck_blocks", (long)cellst.blocks);
-	cJSON_AddNumberToObject(memory, "dupecheck_blocks_max", (long)cellst.blocks_max);
-	cJSON_AddNumberToObject(memory, "dupecheck_cell_size", cellst.cellsize);
-	cJSON_AddNumberToObject(memory, "dupecheck_cell_size_aligned", cellst.cellsize_aligned);
-	cJSON_AddNumberToObject(memory, "dupecheck_cell_align", cellst.alignment);
+	historydb_cell_stats(&cellst);
+	status_cell_json(memory, "historydb", &cellst, historydb_cellgauge);
+	
+	dupecheck_cell_stats(&cellst);
+	status_cell_json(memory, "dupecheck", &cellst, dupecheck_cellgauge);
 	
 	struct cellstatus_t cellst_filter, cellst_filter_wx, cellst_filter_entrycall;
-	filter_cell_stats(&cellst_filter, &cellst_filter_entrycall, &cellst_filter_wx),
-	cJSON_AddNumberToObject(memory, "filter_cells_used", filter_cellgauge);
-	cJSON_AddNumberToObject(memory, "filter_cells_free", cellst_filter.freecount);
-	cJSON_AddNumberToObject(memory, "filter_used_bytes", filter_cellgauge*cellst_filter.cellsize_aligned);
-	cJSON_AddNumberToObject(memory, "filter_allocated_bytes", (long)cellst_filter.blocks * (long)cellst_filter.block_size);
-	cJSON_AddNumberToObject(memory, "filter_block_size", (long)cellst_filter.block_size);
-	cJSON_AddNumberToObject(memory, "filter_blocks", (long)cellst_filter.blocks);
-	cJSON_AddNumberToObject(memory, "filter_blocks_max", (long)cellst_filter.blocks_max);
-	cJSON_AddNumberToObject(memory, "filter_cell_size", cellst_filter.cellsize);
-	cJSON_AddNumberToObject(memory, "filter_cell_size_aligned", cellst_filter.cellsize_aligned);
-	cJSON_AddNumberToObject(memory, "filter_cell_align", cellst_filter.alignment);
-	
-	cJSON_AddNumberToObject(memory, "filter_wx_cells_used", filter_wx_cellgauge);
-	cJSON_AddNumberToObject(memory, "filter_wx_cells_free", cellst_filter_wx.freecount);
-	cJSON_AddNumberToObject(memory, "filter_wx_used_bytes", filter_wx_cellgauge*cellst_filter_wx.cellsize_aligned);
-	cJSON_AddNumberToObject(memory, "filter_wx_allocated_bytes", (long)cellst_filter_wx.blocks * (long)cellst_filter_wx.block_size);
-	cJSON_AddNumberToObject(memory, "filter_wx_block_size", (long)cellst_filter_wx.block_size);
-	cJSON_AddNumberToObject(memory, "filter_wx_blocks", (long)cellst_filter_wx.blocks);
-	cJSON_AddNumberToObject(memory, "filter_wx_blocks_max", (long)cellst_filter_wx.blocks_max);
-	cJSON_AddNumberToObject(memory, "filter_wx_cell_size", cellst_filter_wx.cellsize);
-	cJSON_AddNumberToObject(memory, "filter_wx_cell_size_aligned", cellst_filter_wx.cellsize_aligned);
-	cJSON_AddNumberToObject(memory, "filter_wx_cell_align", cellst_filter_wx.alignment);
-	
-	cJSON_AddNumberToObject(memory, "filter_entrycall_cells_used", filter_entrycall_cellgauge);
-	cJSON_AddNumberToObject(memory, "filter_entrycall_cells_free", cellst_filter_entrycall.freecount);
-	cJSON_AddNumberToObject(memory, "filter_entrycall_used_bytes", filter_entrycall_cellgauge*cellst_filter_entrycall.cellsize_aligned);
-	cJSON_AddNumberToObject(memory, "filter_entrycall_allocated_bytes", (long)cellst_filter_entrycall.blocks * (long)cellst_filter_entrycall.block_size);
-	cJSON_AddNumberToObject(memory, "filter_entrycall_block_size", (long)cellst_filter_entrycall.block_size);
-	cJSON_AddNumberToObject(memory, "filter_entrycall_blocks", (long)cellst_filter_entrycall.blocks);
-	cJSON_AddNumberToObject(memory, "filter_entrycall_blocks_max", (long)cellst_filter_entrycall.blocks_max);
-	cJSON_AddNumberToObject(memory, "filter_entrycall_cell_size", cellst_filter_entrycall.cellsize);
-	cJSON_AddNumberToObject(memory, "filter_entrycall_cell_size_aligned", cellst_filter_entrycall.cellsize_aligned);
-	cJSON_AddNumberToObject(memory, "filter_entrycall_cell_align", cellst_filter_entrycall.alignment);
-	
-	struct cellstatus_t cellst_pbuf_small, cellst_pbuf_medium, cellst_pbuf_large;
-	incoming_cell_stats(&cellst_pbuf_small, &cellst_pbuf_medium, &cellst_pbuf_large);
-	cJSON_AddNumberToObject(memory, "pbuf_small_cells_used", cellst_pbuf_small.cellcount - cellst_pbuf_small.freecount);
-	cJSON_AddNumberToObject(memory, "pbuf_small_cells_free", cellst_pbuf_small.freecount);
-	cJSON_AddNumberToObject(memory, "pbuf_small_cells_alloc", cellst_pbuf_small.cellcount);
-	cJSON_AddNumberToObject(memory, "pbuf_small_used_bytes", (cellst_pbuf_small.cellcount - cellst_pbuf_small.freecount)*cellst_pbuf_small.cellsize_aligned);
-	cJSON_AddNumberToObject(memory, "pbuf_small_allocated_bytes", (long)cellst_pbuf_small.blocks * (long)cellst_pbuf_small.block_size);
-	cJSON_AddNumberToObject(memory, "pbuf_small_block_size", (long)cellst_pbuf_small.block_size);
-	cJSON_AddNumberToObject(memory, "pbuf_small_blocks", (long)cellst_pbuf_small.blocks);
-	cJSON_AddNumberToObject(memory, "pbuf_small_blocks_max", (long)cellst_pbuf_small.blocks_max);
-	cJSON_AddNumberToObject(memory, "pbuf_small_cell_size", cellst_pbuf_small.cellsize);
-	cJSON_AddNumberToObject(memory, "pbuf_small_cell_size_aligned", cellst_pbuf_small.cellsize_aligned);
-	cJSON_AddNumberToObject(memory, "pbuf_small_cell_align", cellst_pbuf_small.alignment);
-	
-	cJSON_AddNumberToObject(memory, "pbuf_medium_cells_used", cellst_pbuf_medium.cellcount - cellst_pbuf_medium.freecount);
-	cJSON_AddNumberToObject(memory, "pbuf_medium_cells_free", cellst_pbuf_medium.freecount);
-	cJSON_AddNumberToObject(memory, "pbuf_medium_cells_alloc", cellst_pbuf_medium.cellcount);
-	cJSON_AddNumberToObject(memory, "pbuf_medium_used_bytes", (cellst_pbuf_medium.cellcount - cellst_pbuf_medium.freecount)*cellst_pbuf_medium.cellsize_aligned);
-	cJSON_AddNumberToObject(memory, "pbuf_medium_allocated_bytes", (long)cellst_pbuf_medium.blocks * (long)cellst_pbuf_medium.block_size);
-	cJSON_AddNumberToObject(memory, "pbuf_medium_block_size", (long)cellst_pbuf_medium.block_size);
-	cJSON_AddNumberToObject(memory, "pbuf_medium_blocks", (long)cellst_pbuf_medium.blocks);
-	cJSON_AddNumberToObject(memory, "pbuf_medium_blocks_max", (long)cellst_pbuf_medium.blocks_max);
-	cJSON_AddNumberToObject(memory, "pbuf_medium_cell_size", cellst_pbuf_medium.cellsize);
-	cJSON_AddNumberToObject(memory, "pbuf_medium_cell_size_aligned", cellst_pbuf_medium.cellsize_aligned);
-	cJSON_AddNumberToObject(memory, "pbuf_medium_cell_align", cellst_pbuf_medium.alignment);
-	
-	cJSON_AddNumberToObject(memory, "pbuf_large_cells_used", cellst_pbuf_large.cellcount - cellst_pbuf_large.freecount);
-	cJSON_AddNumberToObject(memory, "pbuf_large_cells_free", cellst_pbuf_large.freecount);
-	cJSON_AddNumberToObject(memory, "pbuf_large_cells_alloc", cellst_pbuf_large.cellcount);
-	cJSON_AddNumberToObject(memory, "pbuf_large_used_bytes", (cellst_pbuf_large.cellcount - cellst_pbuf_large.freecount)*cellst_pbuf_large.cellsize_aligned);
-	cJSON_AddNumberToObject(memory, "pbuf_large_allocated_bytes", (long)cellst_pbuf_large.blocks * (long)cellst_pbuf_large.block_size);
-	cJSON_AddNumberToObject(memory, "pbuf_large_block_size", (long)cellst_pbuf_large.block_size);
-	cJSON_AddNumberToObject(memory, "pbuf_large_blocks", (long)cellst_pbuf_large.blocks);
-	cJSON_AddNumberToObject(memory, "pbuf_large_blocks_max", (long)cellst_pbuf_large.blocks_max);
-	cJSON_AddNumberToObject(memory, "pbuf_large_cell_size", cellst_pbuf_large.cellsize);
-	cJSON_AddNumberToObject(memory, "pbuf_large_cell_size_aligned", cellst_pbuf_large.cellsize_aligned);
-	cJSON_AddNumberToObject(memory, "pbuf_large_cell_align", cellst_pbuf_large.alignment);
+	filter_cell_stats(&cellst_filter, &cellst_filter_entrycall, &cellst_filter_wx);
+	status_cell_json(memory, "filter", &cellst_filter, filter_cellgauge);
+	status_cell_json(memory, "filter_wx", &cellst_filter_wx, filter_wx_cellgauge);
+	status_cell_json(memory, "filter_entrycall", &cellst_filter_entrycall, filter_entrycall_cellgauge);
+	
+	static const char *pbuf_class_names[PBUF_CLASSES] = { "pbuf_small", "pbuf_medium", "pbuf_large" };
+	struct cellstatus_t cellst_pbuf[PBUF_CLASSES];
+	struct pbuf_class_stats_t classst_pbuf[PBUF_CLASSES];
+	char key[64];
+	int i;
+	
+	incoming_cell_stats(cellst_pbuf, classst_pbuf);
+	for (i = 0; i < PBUF_CLASSES; i++) {
+		status_cell_json(memory, pbuf_class_names[i], &cellst_pbuf[i], cellst_pbuf[i].cellcount - cellst_pbuf[i].freecount);
+		snprintf(key, sizeof(key), "%s_buf_len", pbuf_class_names[i]);
+		cJSON_AddNumberToObject(memory, key, classst_pbuf[i].buf_len);
+		snprintf(key, sizeof(key), "%s_packets", pbuf_class_names[i]);
+		cJSON_AddNumberToObject(memory, key, classst_pbuf[i].packets);
+		snprintf(key, sizeof(key), "%s_saved_bytes", pbuf_class_names[i]);
+		cJSON_AddNumberToObject(memory, key, classst_pbuf[i].saved_bytes);
+	}
 	
 	struct cellstatus_t cellst_client_heard;
 	client_heard_cell_stats(&cellst_client_heard);
-	cJSON_AddNumberToObject(memory, "client_heard_cells_used", cellst_client_heard.cellcount - cellst_client_heard.freecount);
-	cJSON_AddNumberToObject(memory, "client_heard_cells_free", cellst_client_heard.freecount);
-	cJSON_AddNumberToObject(memory, "client_heard_cells_alloc", cellst_client_heard.cellcount);
-	cJSON_AddNumberToObject(memory, "client_heard_used_bytes", (cellst_client_heard.cellcount - cellst_client_heard.freecount)*cellst_client_heard.cellsize_aligned);
-	cJSON_AddNumberToObject(memory, "client_heard_allocated_bytes", (long)cellst_client_heard.blocks * (long)cellst_client_heard.block_size);
-	cJSON_AddNumberToObject(memory, "client_heard_block_size", (long)cellst_client_heard.block_size);
-	cJSON_AddNumberToObject(memory, "client_heard_blocks", (long)cellst_client_heard.blocks);
-	cJSON_AddNumberToObject(memory, "client_heard_blocks_max", (long)cellst_client_heard.blocks_max);
-	cJSON_AddNumberToObject(memory, "client_heard_cell_size", cellst_client_heard.cellsize);
-	cJSON_AddNumberToObject(memory, "client_heard_cell_size_aligned", cellst_client_heard.cellsize_aligned);
-	cJSON_AddNumberToObject(memory, "client_heard_cell_align", cellst_client_heard.alignment);
+	status_cell_json(memory, "client_heard", &cellst_client_heard, cellst_client_heard.cellcount - cellst_client_heard.freecount);
 #endif
 	
 	cJSON_AddItemToObject(root, "memory", memory);
@@ -378,13 +416,27 @@ char *status_json_string(int no_cache, int periodical)
 	cJSON_AddNumberToObject(historydb, "keymatches", historydb_keymatches);
 	cJSON_AddNumberToObject(historydb, "noposcount", historydb_noposcount);
 	cJSON_AddNumberToObject(historydb, "cleaned", historydb_cleanup_cleaned);
+	cJSON_AddNumberToObject(historydb, "subscriptions", historydb_subscriptions);
+	cJSON_AddNumberToObject(historydb, "published", historydb_published);
 	cJSON_AddItemToObject(root, "historydb", historydb);
 	
 	cJSON *dupecheck = cJSON_CreateObject();
 	cJSON_AddNumberToObject(dupecheck, "dupes_dropped", dupecheck_dupecount);
 	cJSON_AddNumberToObject(dupecheck, "uniques_out", dupecheck_outcount);
+	cJSON_AddNumberToObject(dupecheck, "shards", dupecheck_shards_running);
+	cJSON_AddItemToObject(dupecheck, "publish_latency", latency_json(&dupecheck_publish_latency));
 	cJSON_AddItemToObject(root, "dupecheck", dupecheck);
 	
+	cJSON *pbuf = cJSON_CreateObject();
+	cJSON_AddNumberToObject(pbuf, "queue", pbuf_reclaim_stats.queue);
+	cJSON_AddNumberToObject(pbuf, "dupe_queue", pbuf_reclaim_stats.dupe_queue);
+	cJSON_AddNumberToObject(pbuf, "backlog", pbuf_reclaim_stats.backlog);
+	cJSON_AddNumberToObject(pbuf, "dupe_backlog", pbuf_reclaim_stats.dupe_backlog);
+	cJSON_AddNumberToObject(pbuf, "oldest_age_ms", pbuf_reclaim_stats.oldest_age_ms);
+	cJSON_AddNumberToObject(pbuf, "reclaimed", pbuf_reclaim_stats.reclaimed);
+	cJSON_AddNumberToObject(pbuf, "returned", pbuf_reclaim_stats.returned);
+	cJSON_AddItemToObject(root, "pbuf", pbuf);
+	
 	cJSON *dupe_vars = cJSON_CreateObject();
 	cJSON_AddNumberToObject(dupe_vars, "exact", dupecheck_dupetypes[0]);
 	cJSON_AddNumberToObject(dupe_vars, "space_trim", dupecheck_dupetypes[DTYPE_SPACE_TRIM]);
@@ -417,12 +469,13 @@ char *status_json_string(int no_cache, int periodical)
 	if (periodical) {
 		cJSON *ct, *cv;
 		struct cdata_list_t *cl;
+		status_cdata_workers(json_workers);
 		for (cl = cdata_list; (cl); cl = cl->next) {
 			ct = cJSON_GetObjectItem(root, cl->tree);
 			if (!ct)
 				continue;
 				
-			cv = cJSON_GetObjectItem(ct, cl->name);
+			cv = status_json_item(ct, cl->name);
 			
 			/* cJSON's cv->valueint is just an integer, which will overflow
 			 * too quickly. So, let's take the more expensive valuedouble.
@@ -688,7 +741,6 @@ int status_read_liveupgrade(void)
 void status_init(void)
 {
 	int i;
-	char *n;
 	
 	static const char *cdata_start[][3] = {
 		{ "totals", "clients", "g" },
@@ -709,21 +761,21 @@ void status_init(void)
 #endif
 		{ "dupecheck", "dupes_dropped", "c" },
 		{ "dupecheck", "uniques_out", "c" },
+		{ "pbuf", "queue", "g" },
+		{ "pbuf", "oldest_age_ms", "g" },
+		{ "pbuf", "reclaimed", "c" },
+		{ "totals", "parse_latency.p99_us", "g" },
+		{ "totals", "flush_latency.p99_us", "g" },
+		{ "totals", "outgoing_latency.p99_us", "g" },
+		{ "totals", "write_latency.p99_us", "g" },
+		{ "totals", "total_latency.p99_us", "g" },
+		{ "dupecheck", "publish_latency.p99_us", "g" },
 		{ NULL, NULL }
 	};
 	
 	i = 0;
 	while (cdata_start[i][0] != NULL) {
-		n = hmalloc(strlen(cdata_start[i][0]) + 1 + strlen(cdata_start[i][1]) + 1);
-		sprintf(n, "%s.%s", cdata_start[i][0], cdata_start[i][1]);
-		struct cdata_list_t *cl = hmalloc(sizeof(*cl));
-		cl->tree = cdata_start[i][0];
-		cl->name = cdata_start[i][1];
-		cl->next = cdata_list;
-		cl->cd = cdata_alloc(n);
-		hfree(n);
-		cl->gauge = cdata_start[i][2][0] == 'g' ? 1 : 0;
-		cdata_list = cl;
+		status_cdata_add(cdata_start[i][0], cdata_start[i][1], cdata_start[i][2][0] == 'g' ? 1 : 0);
 		i++;
 	}
 }
@@ -736,6 +788,8 @@ void status_atend(void)
 	for (cl = cdata_list; (cl); cl = cl_next) {
 		cl_next = cl->next;
 		cdata_free(cl->cd);
+		hfree(cl->tree);
+		hfree(cl->name);
 		hfree(cl);
 	}
 	
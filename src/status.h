@@ -26,6 +26,11 @@ extern int status_read_liveupgrade(void);
 extern void status_init(void);
 extern void status_atend(void);
 
+#ifndef _FOR_VALGRIND_
+struct cellstatus_t;
+extern void status_cell_json(cJSON *memory, const char *name, struct cellstatus_t *st, long used);
+#endif
+
 extern char *hex_encode(const char *buf, int len);
 extern int hex_decode(char *obuf, int olen, const char *hex);
 
@@ -776,6 +776,7 @@ int ssl_write(struct worker_t *self, struct client_t *c)
 			//hlog(LOG_DEBUG, "ssl_write fd %d (%s) obuf empty", c->fd, c->addr_rem);
 			c->obuf_start = 0;
 			c->obuf_end   = 0;
+			client_obuf_written(self, c);
 			
 			/* tell the poller that we have no outgoing data */
 			xpoll_outgoing(&self->xp, c->xfd, 0);
@@ -0,0 +1,586 @@
+/*
+ *	aprsc-bench
+ *
+ *	(c) Heikki Hannikainen, OH7LZB <hessu@hes.iki.fi>
+ *
+ *	This program is licensed under the BSD license, which can be found
+ *	in the file LICENSE.
+ *
+ */
+
+/*
+ *	aprsc-bench: microbenchmarks for the packet processing hot paths.
+ *	Links against the aprsc objects (except aprsc.o, which has main()),
+ *	so the benchmarks run the real code. Each benchmark first checks
+ *	that the optimized code gives the same results as a reference
+ *	implementation, and fails loudly if it does not.
+ */
+
+#define HELPS	"Usage: aprsc-bench [-f <feedfile>] [-n <packets>] [-r <rounds>] [-c <clients>] [-s <seed>] [-H off|transparent|hugetlb] <benchmark|all> ...\n"
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#ifdef __linux__
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+#include "bench.h"
+#include "hmalloc.h"
+#include "hlog.h"
+#include "parse_aprs.h"
+#include "filter.h"
+#include "incoming.h"
+#include "historydb.h"
+#include "dupecheck.h"
+#include "cellmalloc.h"
+
+/* aprsc.o is not linked in, provide what the other objects need from it */
+pthread_attr_t pthr_attrs;
+
+void pthreads_profiling_reset(const char *name)
+{
+}
+
+struct bench_opts_t bench_opts = {
+	NULL,	/* feed_file */
+	50000,	/* packets */
+	3,	/* rounds */
+	500,	/* clients */
+	1,	/* seed */
+	CELLMALLOC_HUGEPAGES_OFF	/* hugepages */
+};
+
+/* the packet buffers, on huge pages with -H */
+static cellarena_t *bench_pbuf_cells;
+
+struct bench_t {
+	const char *name;
+	int (*run)(void);
+	const char *help;
+};
+
+static struct bench_t benches[] = {
+	{ "filter", bench_filter, "filter_process: compiled filter program vs. walking the filter chains" },
+	{ "index", bench_index, "outgoing filtering: all clients vs. the geoindex and callindex" },
+	{ "budlist", bench_budlist, "large b/ filters: scanning the callsigns vs. the callsign set hash" },
+	{ "shared", bench_shared, "identical filters: running them for each client vs. sharing the verdict" },
+	{ "range", bench_range, "range filter distance: the haversine distance vs. range_within() and the batch kernels" },
+	{ "ring", bench_ring, "global packet queue: a stress test of the broadcast ring, and the rwlock list vs. the ring" },
+	{ "dupecheck", bench_dupecheck, "dupecheck: the verdicts of a sharded dupecheck vs. a single shard, and their throughput" },
+	{ "keyhash", bench_keyhash, "hash tables: the word-at-a-time keyhash vs. the FNV-1a, on callsigns and packets" },
+	{ "inbox", bench_inbox, "dupecheck inbox: a stress test of the lock-free inbox, and the mutex vs. the inbox" },
+	{ "cellmalloc", bench_cellmalloc, "cell arenas: a stress test, giving memory back after a spike, and cellmallocmany vs. malloc" },
+	{ "cellcache", bench_cellcache, "packet buffers: many workers on the arena lock vs. the cell caches and returning to the worker" },
+	{ "fanout", bench_fanout, "outgoing packets to many clients: walking the client_t structs vs. the hot records of the classes" },
+	{ "hugepages", bench_hugepages, "cell arenas: fan-out walk and dupecheck probes on normal pages vs. transparent and hugetlb huge pages" },
+	{ NULL, NULL, NULL }
+};
+
+/*
+ *	Timing and reporting
+ */
+
+double bench_time(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec + ts.tv_nsec / 1000000000.0;
+}
+
+void bench_report(const char *bench, const char *variant, long ops, double secs)
+{
+	printf("%-12s %-24s %12ld ops %9.3f s %10.1f ns/op %12.0f ops/s\n",
+		bench, variant, ops, secs,
+		(ops > 0) ? secs * 1000000000.0 / ops : 0.0,
+		(secs > 0) ? ops / secs : 0.0);
+	fflush(stdout);
+}
+
+/*
+ *	The hardware cache counters of this thread over a timed run, like
+ *	perf stat -e cache-references,cache-misses would count them. Most
+ *	virtual machines do not have them, and then they are left out.
+ */
+
+void bench_counters_start(struct bench_counters_t *bc)
+{
+#ifdef __linux__
+	static const uint64_t events[BENCH_COUNTERS] = { PERF_COUNT_HW_CACHE_REFERENCES, PERF_COUNT_HW_CACHE_MISSES };
+	struct perf_event_attr attr;
+	int i;
+
+	for (i = 0; i < BENCH_COUNTERS; i++) {
+		memset(&attr, 0, sizeof(attr));
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.size = sizeof(attr);
+		attr.config = events[i];
+		attr.disabled = 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		bc->fd[i] = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+		if (bc->fd[i] >= 0)
+			ioctl(bc->fd[i], PERF_EVENT_IOC_ENABLE, 0);
+	}
+#else
+	bc->fd[0] = bc->fd[1] = -1;
+#endif
+}
+
+void bench_counters_report(struct bench_counters_t *bc, const char *bench, const char *variant, long ops)
+{
+	static int warned;
+	long long v[BENCH_COUNTERS];
+	int i, ok = 1;
+
+	for (i = 0; i < BENCH_COUNTERS; i++) {
+		v[i] = 0;
+		if (bc->fd[i] < 0) {
+			ok = 0;
+			continue;
+		}
+#ifdef __linux__
+		ioctl(bc->fd[i], PERF_EVENT_IOC_DISABLE, 0);
+#endif
+		if (read(bc->fd[i], &v[i], sizeof(v[i])) != sizeof(v[i]))
+			ok = 0;
+		close(bc->fd[i]);
+	}
+
+	if (!ok) {
+		if (!warned)
+			printf("hardware cache counters not available, no cache miss counts\n");
+		warned = 1;
+		return;
+	}
+
+	printf("%-12s %-24s %12.1f cache refs/op %9.2f cache misses/op\n",
+		bench, variant, (double)v[0] / ops, (double)v[1] / ops);
+	fflush(stdout);
+}
+
+void bench_fail(const char *fmt, ...)
+{
+	va_list args;
+
+	va_start(args, fmt);
+	fprintf(stderr, "aprsc-bench: FAIL: ");
+	vfprintf(stderr, fmt, args);
+	fprintf(stderr, "\n");
+	va_end(args);
+
+	exit(1);
+}
+
+/*
+ *	A small deterministic PRNG, so that runs are repeatable
+ *	across systems (xorshift32).
+ */
+
+static unsigned int bench_rand_state = 1;
+
+void bench_srand(unsigned int seed)
+{
+	bench_rand_state = (seed) ? seed : 1;
+}
+
+unsigned int bench_rand(void)
+{
+	unsigned int x = bench_rand_state;
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+
+	return bench_rand_state = x;
+}
+
+double bench_rand_range(double min, double max)
+{
+	return min + (max - min) * (bench_rand() / 4294967296.0);
+}
+
+/*
+ *	Feed loading and generation
+ */
+
+static void bench_feed_add(struct bench_feed_t *feed, const char *s, int len)
+{
+	if ((feed->count & 1023) == 0) {
+		feed->lines = hrealloc(feed->lines, sizeof(char *) * (feed->count + 1024));
+		feed->lens = hrealloc(feed->lens, sizeof(int) * (feed->count + 1024));
+	}
+
+	feed->lines[feed->count] = hmalloc(len + 1);
+	memcpy(feed->lines[feed->count], s, len);
+	feed->lines[feed->count][len] = 0;
+	feed->lens[feed->count] = len;
+	feed->count++;
+}
+
+static struct bench_feed_t *bench_feed_load(const char *path)
+{
+	struct bench_feed_t *feed;
+	char s[PACKETLEN_MAX+2];
+	FILE *fp;
+	int len;
+
+	fp = fopen(path, "r");
+	if (!fp)
+		bench_fail("could not open feed file %s", path);
+
+	feed = hmalloc(sizeof(*feed));
+	memset(feed, 0, sizeof(*feed));
+
+	while (fgets(s, sizeof(s), fp)) {
+		len = strlen(s);
+		while (len > 0 && (s[len-1] == '\r' || s[len-1] == '\n'))
+			len--;
+		if (len == 0 || s[0] == '#')
+			continue;
+		bench_feed_add(feed, s, len);
+	}
+
+	fclose(fp);
+
+	if (feed->count == 0)
+		bench_fail("no packets in feed file %s", path);
+
+	return feed;
+}
+
+/* regions where most of the synthetic stations are */
+static const struct {
+	double lat, lng, spread;
+} bench_regions[] = {
+	{  61.0,   25.0, 3.0 },	/* Finland */
+	{  51.0,   10.0, 4.0 },	/* Germany */
+	{  52.0,    0.0, 3.0 },	/* UK */
+	{  40.0,  -75.0, 5.0 },	/* US east coast */
+	{  37.0, -122.0, 4.0 },	/* US west coast */
+	{  35.0,  139.0, 3.0 },	/* Japan */
+	{ -33.0,  151.0, 3.0 },	/* Australia */
+};
+#define BENCH_REGIONS (sizeof(bench_regions) / sizeof(bench_regions[0]))
+
+static const char *bench_prefixes[] = {
+	"OH", "OH7", "SM", "LA", "OZ", "DL", "DK", "PA", "G", "M0",
+	"F", "I", "EA", "N", "K", "W", "KB", "WA", "JA", "VK"
+};
+#define BENCH_PREFIXES (sizeof(bench_prefixes) / sizeof(bench_prefixes[0]))
+
+#define BENCH_CALLS 5000
+static char bench_calls[BENCH_CALLS][CALLSIGNLEN_MAX+1];
+static int bench_call_region[BENCH_CALLS];
+
+/* Generate a callsign pool where the prefix matches the region
+ * roughly, so that p/ and b/ filters see realistic clustering.
+ */
+static void bench_calls_generate(void)
+{
+	int i, sfx;
+
+	for (i = 0; i < BENCH_CALLS; i++) {
+		sfx = bench_rand() % 4;
+		snprintf(bench_calls[i], sizeof(bench_calls[i]), "%s%d%c%c%c%s%.*d",
+			bench_prefixes[bench_rand() % BENCH_PREFIXES],
+			bench_rand() % 10,
+			'A' + bench_rand() % 26, 'A' + bench_rand() % 26, 'A' + bench_rand() % 26,
+			(sfx) ? "-" : "", (sfx) ? 1 : 0, (sfx) ? sfx * 3 : 0);
+		bench_call_region[i] = bench_rand() % (BENCH_REGIONS + 1);
+	}
+}
+
+static int bench_fmt_pos(char *p, int len, double lat, double lng, char symtable, char symcode)
+{
+	char ns = (lat < 0) ? 'S' : 'N';
+	char ew = (lng < 0) ? 'W' : 'E';
+
+	if (lat < 0) lat = -lat;
+	if (lng < 0) lng = -lng;
+
+	return snprintf(p, len, "%02d%05.2f%c%c%03d%05.2f%c%c",
+		(int)lat, (lat - (int)lat) * 60.0, ns, symtable,
+		(int)lng, (lng - (int)lng) * 60.0, ew, symcode);
+}
+
+static struct bench_feed_t *bench_feed_synthetic(int count)
+{
+	struct bench_feed_t *feed;
+	char s[PACKETLEN_MAX];
+	char pos[32];
+	double lat, lng;
+	int i, n, ci, r, kind;
+	const char *src, *igate;
+
+	bench_calls_generate();
+
+	feed = hmalloc(sizeof(*feed));
+	memset(feed, 0, sizeof(*feed));
+
+	for (i = 0; i < count; i++) {
+		ci = bench_rand() % BENCH_CALLS;
+		src = bench_calls[ci];
+		igate = bench_calls[(ci * 7 + 13) % BENCH_CALLS];
+		r = bench_call_region[ci];
+
+		if (r < BENCH_REGIONS) {
+			lat = bench_regions[r].lat + bench_rand_range(-1, 1) * bench_regions[r].spread;
+			lng = bench_regions[r].lng + bench_rand_range(-1, 1) * bench_regions[r].spread;
+		} else {
+			lat = bench_rand_range(-80, 80);
+			lng = bench_rand_range(-179, 179);
+		}
+
+		kind = bench_rand() % 100;
+		if (kind < 55) {
+			/* position */
+			bench_fmt_pos(pos, sizeof(pos), lat, lng, '/', (kind & 1) ? '>' : '-');
+			n = snprintf(s, sizeof(s), "%s>APRS,WIDE2-1,qAR,%s:!%s comment %d", src, igate, pos, i);
+		} else if (kind < 62) {
+			/* weather */
+			bench_fmt_pos(pos, sizeof(pos), lat, lng, '/', '_');
+			n = snprintf(s, sizeof(s), "%s>APRS,TCPIP*,qAC,T2TEST:!%s%03d/%03dg%03dt%03d",
+				src, pos, bench_rand() % 360, bench_rand() % 20, bench_rand() % 30, bench_rand() % 100);
+		} else if (kind < 70) {
+			/* object */
+			bench_fmt_pos(pos, sizeof(pos), lat, lng, '/', 'E');
+			n = snprintf(s, sizeof(s), "%s>APRS,TCPIP*,qAC,T2TEST:;OBJ%-6d*111111z%sobject",
+				src, bench_rand() % 1000, pos);
+		} else if (kind < 80) {
+			/* message */
+			n = snprintf(s, sizeof(s), "%s>APRS,TCPIP*,qAC,T2TEST::%-9s:hello %d{%d",
+				src, bench_calls[bench_rand() % BENCH_CALLS], i, i % 1000);
+		} else if (kind < 90) {
+			/* status */
+			n = snprintf(s, sizeof(s), "%s>APRS,WIDE1-1,WIDE2-1,qAR,%s:>status %d", src, igate, i);
+		} else {
+			/* telemetry */
+			n = snprintf(s, sizeof(s), "%s>APRS,%s*,WIDE2-1,qAR,%s:T#%03d,%03d,%03d,%03d,%03d,%03d,00000000",
+				src, igate, igate, i % 1000, bench_rand() % 256, bench_rand() % 256,
+				bench_rand() % 256, bench_rand() % 256, bench_rand() % 256);
+		}
+
+		bench_feed_add(feed, s, n);
+	}
+
+	return feed;
+}
+
+/*
+ *	Get the feed to run the benchmark with, as selected on the command line
+ */
+
+struct bench_feed_t *bench_feed_get(void)
+{
+	static struct bench_feed_t *feed = NULL;
+
+	if (feed)
+		return feed;
+
+	bench_srand(bench_opts.seed);
+
+	if (bench_opts.feed_file)
+		feed = bench_feed_load(bench_opts.feed_file);
+	else
+		feed = bench_feed_synthetic(bench_opts.packets);
+
+	return feed;
+}
+
+/*
+ *	Fill in a packet buffer from an APRS-IS line, like incoming_parse
+ *	does, without the Q construct processing (the line must already
+ *	have a Q construct) or any of the drop rules. Returns NULL if the
+ *	line is not usable.
+ */
+
+struct pbuf_t *bench_pbuf_parse(const char *s, int len)
+{
+	struct pbuf_t *pb;
+	char *path_end, *src_end, *dstcall_end, *q;
+
+	if (len > PACKETLEN_MAX_LARGE - 3)
+		return NULL;
+
+	if (!bench_pbuf_cells)
+		bench_pbuf_cells = cellinit("bench pbuf", sizeof(*pb) + PACKETLEN_MAX_LARGE, __alignof__(struct pbuf_t),
+			CELLMALLOC_POLICY_FIFO | CELLMALLOC_POLICY_HUGEPAGES, 2048, 0);
+	if (!(pb = cellmalloc(bench_pbuf_cells)))
+		bench_fail("out of packet buffers");
+	memset(pb, 0, sizeof(*pb));
+	pb->buf_len = PACKETLEN_MAX_LARGE;
+
+	memcpy(pb->data, s, len);
+	memcpy(pb->data + len, "\r\n", 3);
+	pb->packet_len = len + 2;
+
+	path_end = memchr(pb->data, ':', len);
+	if (!path_end)
+		goto fail;
+
+	src_end = memchr(pb->data, '>', path_end - pb->data);
+	if (!src_end || src_end - pb->data > CALLSIGNLEN_MAX)
+		goto fail;
+
+	q = memmem(src_end, path_end - src_end, ",q", 2);
+	if (!q)
+		goto fail;
+
+	dstcall_end = src_end + 1;
+	while (dstcall_end < path_end && *dstcall_end != '-' && *dstcall_end != ',')
+		dstcall_end++;
+	pb->dstcall_end_or_ssid = dstcall_end;
+	while (dstcall_end < path_end && *dstcall_end != ',')
+		dstcall_end++;
+
+	pb->srcname = pb->data;
+	pb->srcname_len = src_end - pb->data;
+	pb->srccall_end = src_end;
+	pb->dstcall_end = dstcall_end;
+	pb->dstcall_len = dstcall_end - src_end - 1;
+	pb->qconst_start = q + 1;
+	pb->info_start = path_end + 1;
+	pb->t = tick;
+	pb->flags = F_FROM_DOWNSTR;
+	incoming_parse_path(pb);
+
+	if (parse_aprs(pb) < 0)
+		goto fail;
+
+	filter_preprocess_dupefilter(pb);
+	dupecheck_prepare(pb);
+
+	return pb;
+
+fail:
+	cellfree(bench_pbuf_cells, pb);
+	return NULL;
+}
+
+void bench_pbuf_free(struct pbuf_t *pb)
+{
+	cellfree(bench_pbuf_cells, pb);
+}
+
+/*
+ *	The filters and the historydb are initialized once for all of the
+ *	benchmarks using them, and the historydb is enabled, like it is
+ *	with filtered listeners
+ */
+
+void bench_filter_init(void)
+{
+	static int done = 0;
+
+	if (done)
+		return;
+
+	have_filtered_listeners = 1;
+	filter_init();
+	historydb_init();
+	done = 1;
+}
+
+static void bench_usage(void)
+{
+	struct bench_t *b;
+
+	fprintf(stderr, HELPS);
+	fprintf(stderr, "Benchmarks:\n");
+	for (b = benches; b->name; b++)
+		fprintf(stderr, "  %-12s %s\n", b->name, b->help);
+
+	exit(1);
+}
+
+static int bench_run(struct bench_t *b)
+{
+	int rc;
+
+	printf("--- %s: %s\n", b->name, b->help);
+	rc = b->run();
+	if (rc)
+		fprintf(stderr, "aprsc-bench: %s failed: %d\n", b->name, rc);
+
+	return rc;
+}
+
+int main(int argc, char **argv)
+{
+	struct bench_t *b;
+	int i, c, rc = 0;
+
+	while ((c = getopt(argc, argv, "f:n:r:c:s:H:h?")) != -1) {
+		switch (c) {
+		case 'f':
+			bench_opts.feed_file = optarg;
+			break;
+		case 'n':
+			bench_opts.packets = atoi(optarg);
+			break;
+		case 'r':
+			bench_opts.rounds = atoi(optarg);
+			break;
+		case 'c':
+			bench_opts.clients = atoi(optarg);
+			break;
+		case 's':
+			bench_opts.seed = atoi(optarg);
+			break;
+		case 'H':
+			if (strcmp(optarg, "off") == 0)
+				bench_opts.hugepages = CELLMALLOC_HUGEPAGES_OFF;
+			else if (strcmp(optarg, "transparent") == 0)
+				bench_opts.hugepages = CELLMALLOC_HUGEPAGES_THP;
+			else if (strcmp(optarg, "hugetlb") == 0)
+				bench_opts.hugepages = CELLMALLOC_HUGEPAGES_HUGETLB;
+			else
+				bench_usage();
+			break;
+		default:
+			bench_usage();
+		}
+	}
+
+	if (optind >= argc || bench_opts.packets < 1 || bench_opts.rounds < 1 || bench_opts.clients < 1)
+		bench_usage();
+
+	/* only warnings and worse from the aprsc code, please */
+	log_level = LOG_WARNING;
+	time(&now);
+	tick = now;
+
+	/* before any of the arenas are made */
+	bench_opts.hugepages = cellhugepages(bench_opts.hugepages);
+	printf("huge pages: %s\n", cellhugepages_name(bench_opts.hugepages));
+
+	for (i = optind; i < argc; i++) {
+		if (strcmp(argv[i], "all") == 0) {
+			for (b = benches; b->name; b++)
+				rc |= bench_run(b);
+			continue;
+		}
+
+		for (b = benches; b->name; b++)
+			if (strcmp(argv[i], b->name) == 0)
+				break;
+
+		if (!b->name) {
+			fprintf(stderr, "aprsc-bench: unknown benchmark '%s'\n", argv[i]);
+			bench_usage();
+		}
+
+		rc |= bench_run(b);
+	}
+
+	return (rc) ? 1 : 0;
+}
@@ -0,0 +1,77 @@
+/*
+ *	aprsc-bench
+ *
+ *	(c) Heikki Hannikainen, OH7LZB <hessu@hes.iki.fi>
+ *
+ *	This program is licensed under the BSD license, which can be found
+ *	in the file LICENSE.
+ *
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include "worker.h"
+
+/*
+ *	A feed of APRS-IS lines, either loaded from a file recorded from
+ *	an APRS-IS full feed (one packet per line, # comments ignored)
+ *	or generated synthetically.
+ */
+
+struct bench_feed_t {
+	int count;
+	char **lines;
+	int *lens;
+};
+
+/* command line options common to all benchmarks */
+struct bench_opts_t {
+	const char *feed_file;	/* -f: recorded feed, or NULL for synthetic */
+	int packets;		/* -n: number of synthetic packets */
+	int rounds;		/* -r: how many times to run the timed loop */
+	int clients;		/* -c: number of clients, for benchmarks having them */
+	unsigned int seed;	/* -s: PRNG seed */
+	int hugepages;		/* -H: huge pages of the arenas, CELLMALLOC_HUGEPAGES_* */
+};
+
+extern struct bench_opts_t bench_opts;
+
+extern double bench_time(void);
+extern void bench_report(const char *bench, const char *variant, long ops, double secs);
+extern void bench_fail(const char *fmt, ...);
+
+#define BENCH_COUNTERS	2	/* cache references and misses */
+
+struct bench_counters_t {
+	int fd[BENCH_COUNTERS];
+};
+
+extern void bench_counters_start(struct bench_counters_t *bc);
+extern void bench_counters_report(struct bench_counters_t *bc, const char *bench, const char *variant, long ops);
+
+extern void bench_srand(unsigned int seed);
+extern unsigned int bench_rand(void);
+extern double bench_rand_range(double min, double max);
+
+extern struct bench_feed_t *bench_feed_get(void);
+extern struct pbuf_t *bench_pbuf_parse(const char *s, int len);
+extern void bench_pbuf_free(struct pbuf_t *pb);
+extern void bench_filter_init(void);
+
+/* the benchmarks */
+extern int bench_filter(void);
+extern int bench_index(void);
+extern int bench_budlist(void);
+extern int bench_shared(void);
+extern int bench_range(void);
+extern int bench_ring(void);
+extern int bench_dupecheck(void);
+extern int bench_keyhash(void);
+extern int bench_inbox(void);
+extern int bench_cellmalloc(void);
+extern int bench_cellcache(void);
+extern int bench_hugepages(void);
+extern int bench_fanout(void);
+
+#endif
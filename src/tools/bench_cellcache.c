@@ -0,0 +1,284 @@
+/*
+ *	aprsc-bench
+ *
+ *	(c) Heikki Hannikainen, OH7LZB <hessu@hes.iki.fi>
+ *
+ *	This program is licensed under the BSD license, which can be found
+ *	in the file LICENSE.
+ *
+ */
+
+/*
+ *	bench_cellcache: packet buffers allocated by many workers and
+ *	freed by the dupecheck thread
+ *
+ *	Worker threads allocate packet buffer sized cells and hand them to
+ *	a consumer thread, like the workers hand packets to the dupecheck
+ *	thread, and the consumer frees them. In the arena run the workers
+ *	take bunches of cells from the arena with cellmallocmany() to a
+ *	freelist of their own, and the consumer frees them to the arena
+ *	with cellfreemany(), both under the lock of the arena, like the
+ *	buffers used to go. In the cache run the workers allocate from a
+ *	cell cache of their own, and the consumer gives the cells back
+ *	through an inbox of the worker which allocated them, to its cache.
+ *
+ *	The consumer checks that it gets the cells of each worker in
+ *	order, and a cell being in flight when it is allocated again
+ *	fails the run. At the end all of the cells must be back in the
+ *	arena, once the caches are flushed and the depot is trimmed.
+ */
+
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include "cellmalloc.h"
+#include "pbufring.h"
+#include "hmalloc.h"
+#include "bench.h"
+
+#define BENCH_CACHE_WORKERS_MAX	16
+#define BENCH_CACHE_BATCH	16
+#define BENCH_CACHE_INFLIGHT	4096	/* cells of a worker on the way to the consumer, at most */
+#define BENCH_CACHE_BUNCH	2000	/* cells taken from the arena at a time, in the arena run */
+#define BENCH_CACHE_CELL	(sizeof(struct pbuf_t) + PACKETLEN_MAX_SMALL)
+
+#define BENCH_CACHE_FREE	1
+#define BENCH_CACHE_INUSE	2
+
+struct bench_cache_worker_t {
+	pthread_t th;
+	struct bench_cache_run_t *run;
+	int id;
+
+	struct cellcache_t cache;
+	struct pbuf_t *pool;		/* the freelist of the arena run */
+	struct pbuf_inbox_t inbox;	/* to the consumer */
+	struct pbuf_inbox_t returned;	/* from the consumer, in the cache run */
+
+	long freed;			/* by the consumer */
+	uint32_t expect;		/* consumer: seqnum of the next cell */
+} __attribute__((aligned(64)));
+
+struct bench_cache_run_t {
+	cellarena_t *ca;
+	int cache;		/* 1: cell caches, 0: the arena */
+	int workers;
+	long packets;		/* per worker */
+
+	struct bench_cache_worker_t w[BENCH_CACHE_WORKERS_MAX];
+};
+
+/* move the cells given back by the consumer to the cache */
+static void bench_cache_collect(struct bench_cache_worker_t *w)
+{
+	struct pbuf_t *pb, *next;
+	int count;
+
+	for (pb = pbuf_inbox_take(&w->returned, &count); (pb); pb = next) {
+		next = pb->next;
+		cellcache_free(&w->cache, pb);
+	}
+}
+
+static struct pbuf_t *bench_cache_get(struct bench_cache_worker_t *w)
+{
+	struct bench_cache_run_t *run = w->run;
+	void *bunch[BENCH_CACHE_BUNCH];
+	struct pbuf_t *pb;
+	int i, n;
+
+	if (run->cache) {
+		if (cellcache_empty(&w->cache) && pbuf_inbox_pending(&w->returned))
+			bench_cache_collect(w);
+		return cellcache_alloc(&w->cache);
+	}
+
+	if (!w->pool) {
+		n = cellmallocmany(run->ca, bunch, BENCH_CACHE_BUNCH);
+		for (i = 0; i < n; i++) {
+			pb = bunch[i];
+			pb->next = w->pool;
+			w->pool = pb;
+		}
+	}
+
+	if ((pb = w->pool))
+		w->pool = pb->next;
+
+	return pb;
+}
+
+static void *bench_cache_worker(void *arg)
+{
+	struct bench_cache_worker_t *w = arg;
+	struct bench_cache_run_t *run = w->run;
+	struct pbuf_t *pb, *newest, *oldest;
+	uint32_t seq = 0;
+	long made = 0;
+	int count;
+
+	while (made < run->packets) {
+		while (made - __atomic_load_n(&w->freed, __ATOMIC_ACQUIRE) > BENCH_CACHE_INFLIGHT)
+			sched_yield();
+
+		newest = oldest = NULL;
+		for (count = 0; count < BENCH_CACHE_BATCH && made < run->packets; count++, made++) {
+			if (!(pb = bench_cache_get(w)))
+				bench_fail("worker %d: out of cells", w->id);
+			if (pb->is_free == BENCH_CACHE_INUSE)
+				bench_fail("worker %d: cell %p allocated while in flight", w->id, pb);
+			pb->is_free = BENCH_CACHE_INUSE;
+			pb->origin = w->id;
+			pb->seqnum = seq++;
+			pb->data[0] = 'x';
+
+			pb->next = newest;
+			if (!newest)
+				oldest = pb;
+			newest = pb;
+		}
+
+		pbuf_inbox_put(&w->inbox, newest, oldest, count);
+	}
+
+	/* wait for all of them to come back, and give the cells to the arena */
+	while (__atomic_load_n(&w->freed, __ATOMIC_ACQUIRE) < made)
+		sched_yield();
+
+	if (run->cache) {
+		bench_cache_collect(w);
+		cellcache_flush(&w->cache);
+	} else {
+		for (pb = w->pool; (pb); pb = w->pool) {
+			w->pool = pb->next;
+			cellfree(run->ca, pb);
+		}
+	}
+
+	return NULL;
+}
+
+/* check the cells of a worker, and free them */
+static long bench_cache_consume(struct bench_cache_run_t *run, struct bench_cache_worker_t *w,
+	struct pbuf_t *list, void **array)
+{
+	struct pbuf_t *pb, *next;
+	long n = 0;
+
+	for (pb = list; (pb); pb = next) {
+		next = pb->next;
+		if (pb->is_free != BENCH_CACHE_INUSE || pb->origin != (uint32_t)w->id)
+			bench_fail("worker %d: cell %p is not in flight from it", w->id, pb);
+		if ((uint32_t)pb->seqnum != w->expect)
+			bench_fail("worker %d: expected cell %u, got %u", w->id, w->expect, (uint32_t)pb->seqnum);
+		w->expect++;
+		pb->is_free = BENCH_CACHE_FREE;
+		array[n++] = pb;
+	}
+
+	if (run->cache)
+		pbuf_inbox_put(&w->returned, list, array[n - 1], n);
+	else
+		cellfreemany(run->ca, array, n);
+
+	__atomic_add_fetch(&w->freed, n, __ATOMIC_RELEASE);
+
+	return n;
+}
+
+static double bench_cache_run(struct bench_cache_run_t *run)
+{
+	struct bench_cache_worker_t *w;
+	struct pbuf_t *list;
+	void **array = hmalloc(sizeof(*array) * BENCH_CACHE_INFLIGHT * 2);
+	long total = run->packets * run->workers, got = 0;
+	double start;
+	int i, j, count;
+
+	for (i = 0; i < run->workers; i++) {
+		w = &run->w[i];
+		memset(w, 0, sizeof(*w));
+		w->run = run;
+		w->id = i;
+		cellcache_init(&w->cache, run->ca);
+	}
+
+	start = bench_time();
+
+	for (i = 0; i < run->workers; i++)
+		if (pthread_create(&run->w[i].th, NULL, bench_cache_worker, &run->w[i]))
+			bench_fail("pthread_create failed");
+
+	while (got < total) {
+		for (i = j = 0; i < run->workers; i++) {
+			if ((list = pbuf_inbox_take(&run->w[i].inbox, &count))) {
+				got += bench_cache_consume(run, &run->w[i], list, array);
+				j++;
+			}
+		}
+		if (!j)
+			sched_yield();
+	}
+
+	for (i = 0; i < run->workers; i++)
+		pthread_join(run->w[i].th, NULL);
+
+	start = bench_time() - start;
+
+	hfree(array);
+
+	return start;
+}
+
+/* all of the cells must be back in the blocks, once the depot is trimmed */
+static void bench_cache_check(struct bench_cache_run_t *run, const char *name, time_t *t)
+{
+	struct cellstatus_t st;
+
+	cellstatus(run->ca, &st);
+	printf("%-40s %d blocks, %ld cells in the depot\n", name, st.blocks, st.cached);
+
+	*t += 100;
+	celltrim(run->ca, *t, 0);
+	*t += 100;
+	celltrim(run->ca, *t, 0);
+
+	cellstatus(run->ca, &st);
+	if (st.cellcount - st.freecount != 0 || st.cached)
+		bench_fail("%s: %d cells still in use, %ld in the depot", name, st.cellcount - st.freecount, st.cached);
+}
+
+int bench_cellcache(void)
+{
+	struct bench_cache_run_t *run;
+	static const int workers[] = { 1, 8, 16 };
+	char name[64];
+	time_t t = 0;
+	int r, i;
+
+	run = hmalloc(sizeof(*run));
+	memset(run, 0, sizeof(*run));
+	run->ca = cellinit("pbuf bench", BENCH_CACHE_CELL, __alignof__(struct pbuf_t), CELLMALLOC_POLICY_FIFO, 2048, 0);
+
+	for (r = 0; r < bench_opts.rounds; r++) {
+		for (i = 0; i < (int)(sizeof(workers) / sizeof(workers[0])); i++) {
+			run->workers = workers[i];
+			run->packets = bench_opts.packets * 20L / run->workers;
+
+			run->cache = 0;
+			snprintf(name, sizeof(name), "arena, %d workers", run->workers);
+			bench_report("cellcache", name, run->packets * run->workers, bench_cache_run(run));
+			bench_cache_check(run, name, &t);
+
+			run->cache = 1;
+			snprintf(name, sizeof(name), "cache, %d workers", run->workers);
+			bench_report("cellcache", name, run->packets * run->workers, bench_cache_run(run));
+			bench_cache_check(run, name, &t);
+		}
+	}
+
+	hfree(run);
+
+	return 0;
+}
@@ -0,0 +1,253 @@
+/*
+ *	aprsc-bench
+ *
+ *	(c) Heikki Hannikainen, OH7LZB <hessu@hes.iki.fi>
+ *
+ *	This program is licensed under the BSD license, which can be found
+ *	in the file LICENSE.
+ *
+ */
+
+/*
+ *	bench_cellmalloc: the cell arenas
+ *
+ *	The stress test allocates and frees cells at random, each cell
+ *	stamped with its own number, and checks that no cell is handed
+ *	out twice and that the counts of the arena add up. The spike test
+ *	grows an arena past the 200 blocks the arenas used to be limited
+ *	to, frees all of the cells, and checks that celltrim() leaves the
+ *	empty blocks alone until the delay has passed, and then gives
+ *	their pages back to the system. The
+ *	throughput is measured on packet buffer sized cells, allocated
+ *	and freed in batches like the workers and the dupecheck thread
+ *	do, compared to malloc().
+ */
+
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "cellmalloc.h"
+#include "hmalloc.h"
+#include "bench.h"
+
+#define BENCH_CELL_SIZE		300
+#define BENCH_CELL_LIVE		20000	/* cells in use in the stress test, at most */
+#define BENCH_CELL_STRESS	2000000
+#define BENCH_CELL_SPIKE_KB	64	/* block size of the spike test */
+#define BENCH_CELL_SPIKE_BLOCKS	300
+#define BENCH_CELL_BATCH	64
+#define BENCH_CELL_RING		65536	/* cells in flight in the throughput test */
+
+struct bench_cell_t {
+	long id;
+	struct bench_cell_t *self;
+	char pad[BENCH_CELL_SIZE - sizeof(long) - sizeof(void *)];
+};
+
+static void bench_cell_check_counts(cellarena_t *ca, const char *name, long live)
+{
+	struct cellstatus_t st;
+
+	cellstatus(ca, &st);
+	if (st.cellcount - st.freecount != live)
+		bench_fail("%s: %d cells, %d free, expected %ld in use", name, st.cellcount, st.freecount, live);
+	if (st.blocks > st.blocks_peak)
+		bench_fail("%s: %d blocks, peak %d", name, st.blocks, st.blocks_peak);
+}
+
+static void bench_cell_stress(int policy, const char *name)
+{
+	cellarena_t *ca = cellinit(name, sizeof(struct bench_cell_t), __alignof__(struct bench_cell_t), policy, 64, 0);
+	struct bench_cell_t **live = hmalloc(sizeof(*live) * BENCH_CELL_LIVE);
+	struct bench_cell_t *c;
+	long id = 0, i, n = 0;
+	int j;
+
+	for (i = 0; i < BENCH_CELL_STRESS; i++) {
+		/* grow and shrink in waves, so that blocks go empty and get reused */
+		int grow = ((i / (BENCH_CELL_LIVE * 2)) & 1) ? bench_rand() % 4 == 0 : bench_rand() % 4 != 0;
+		if (n < BENCH_CELL_LIVE && (grow || !n)) {
+			c = cellmalloc(ca);
+			if (!c)
+				bench_fail("%s: cellmalloc failed", name);
+			if ((uintptr_t)c % __alignof__(struct bench_cell_t))
+				bench_fail("%s: cell %p is not aligned", name, c);
+			c->id = id++;
+			c->self = c;
+			live[n++] = c;
+		} else {
+			j = bench_rand() % n;
+			c = live[j];
+			if (c->self != c)
+				bench_fail("%s: cell %ld at %p was overwritten", name, c->id, c);
+			c->self = NULL;
+			cellfree(ca, c);
+			live[j] = live[--n];
+		}
+	}
+
+	bench_cell_check_counts(ca, name, n);
+
+	/* every live cell must still be intact, and different from each other */
+	for (i = 0; i < n; i++) {
+		if (live[i]->self != live[i])
+			bench_fail("%s: cell %ld at %p was overwritten", name, live[i]->id, live[i]);
+		live[i]->self = NULL;
+	}
+	cellfreemany(ca, (void **)live, n);
+	bench_cell_check_counts(ca, name, 0);
+
+	printf("%s stress test passed: %d allocations and frees\n", name, BENCH_CELL_STRESS);
+
+	hfree(live);
+}
+
+/* pages of the range which are in memory */
+static long bench_cell_resident(void *p, size_t len)
+{
+#ifdef __linux__
+	long pagesize = sysconf(_SC_PAGESIZE);
+	unsigned char vec[4096];
+	long pages, i, n = 0;
+	char *start = (char *)((uintptr_t)p & ~(uintptr_t)(pagesize - 1));
+
+	pages = ((char *)p + len - start + pagesize - 1) / pagesize;
+	if (pages > (long)sizeof(vec))
+		pages = sizeof(vec);
+	if (mincore(start, pages * pagesize, vec))
+		return -1;
+	for (i = 0; i < pages; i++)
+		n += vec[i] & 1;
+
+	return n;
+#else
+	return -1;
+#endif
+}
+
+static void bench_cell_spike(void)
+{
+	cellarena_t *ca = cellinit("spike", sizeof(struct bench_cell_t), __alignof__(struct bench_cell_t),
+		CELLMALLOC_POLICY_FIFO | CELLMALLOC_POLICY_NOMUTEX, BENCH_CELL_SPIKE_KB, 0);
+	int count = BENCH_CELL_SPIKE_BLOCKS * (BENCH_CELL_SPIKE_KB * 1024 / sizeof(struct bench_cell_t) - 1);
+	struct bench_cell_t **cells = hmalloc(sizeof(*cells) * count);
+	struct cellstatus_t st, peak;
+	long resident;
+	int i;
+
+	celltrim(ca, 1, 60);
+
+	if (cellmallocmany(ca, (void **)cells, count) != count)
+		bench_fail("spike: could not allocate %d cells", count);
+	for (i = 0; i < count; i++)
+		memset(cells[i], 0x55, sizeof(*cells[i]));
+	cellstatus(ca, &peak);
+	if (peak.blocks < 200)
+		bench_fail("spike: %d cells fit in %d blocks, the test needs more", count, peak.blocks);
+
+	/* free them, the blocks stay around until the delay has passed */
+	cellfreemany(ca, (void **)cells, count);
+	celltrim(ca, 30, 60);
+	cellstatus(ca, &st);
+	if (st.releases || st.rss_bytes != peak.rss_bytes)
+		bench_fail("spike: blocks were released before the delay");
+
+	celltrim(ca, 61, 60);
+	cellstatus(ca, &st);
+	if (st.releases < peak.blocks - 1 || st.blocks_released != st.blocks)
+		bench_fail("spike: %ld of %d blocks released", st.releases, st.blocks);
+	if (st.rss_bytes > peak.rss_bytes / 10)
+		bench_fail("spike: %ld bytes still resident of %ld", st.rss_bytes, peak.rss_bytes);
+
+	/* the cells after the first page of a block are not in memory */
+	for (i = 0; i < count; i++)
+		if ((uintptr_t)cells[i] % (BENCH_CELL_SPIKE_KB * 1024) >= (uintptr_t)sysconf(_SC_PAGESIZE)) {
+			resident = bench_cell_resident(cells[i], sizeof(*cells[i]));
+			if (resident > 0)
+				bench_fail("spike: a released cell is still in memory");
+		}
+
+	printf("spike: %d blocks (peak %d), %ld kB resident -> %d released, %ld kB resident\n",
+		peak.blocks, st.blocks_peak, peak.rss_bytes / 1024, st.blocks_released, st.rss_bytes / 1024);
+
+	/* and they are good for use again, with zeroed pages */
+	if (cellmallocmany(ca, (void **)cells, count) != count)
+		bench_fail("spike: could not allocate the cells again");
+	cellstatus(ca, &st);
+	if (st.blocks != peak.blocks)
+		bench_fail("spike: %d blocks after reuse, expected %d", st.blocks, peak.blocks);
+	cellfreemany(ca, (void **)cells, count);
+	bench_cell_check_counts(ca, "spike", 0);
+
+	hfree(cells);
+}
+
+/*
+ *	Packets through a ring: allocate a batch, free the oldest batch
+ */
+
+static double bench_cell_run(cellarena_t *ca, void **ring, long ops)
+{
+	double start = bench_time();
+	long i, head = 0;
+	int j;
+
+	for (i = 0; i < ops; i += BENCH_CELL_BATCH) {
+		void **slot = &ring[head & (BENCH_CELL_RING - 1)];
+		if (i >= BENCH_CELL_RING) {
+			if (ca) {
+				cellfreemany(ca, slot, BENCH_CELL_BATCH);
+			} else {
+				for (j = 0; j < BENCH_CELL_BATCH; j++)
+					free(slot[j]);
+			}
+		}
+		if (ca) {
+			if (cellmallocmany(ca, slot, BENCH_CELL_BATCH) != BENCH_CELL_BATCH)
+				bench_fail("cellmallocmany failed");
+		} else {
+			for (j = 0; j < BENCH_CELL_BATCH; j++)
+				slot[j] = malloc(BENCH_CELL_SIZE);
+		}
+		for (j = 0; j < BENCH_CELL_BATCH; j++)
+			*(long *)slot[j] = i + j;
+		head += BENCH_CELL_BATCH;
+	}
+
+	/* the ones in the ring are left in, the next round frees them */
+	return bench_time() - start;
+}
+
+int bench_cellmalloc(void)
+{
+	cellarena_t *ca;
+	void **ring;
+	long ops = bench_opts.packets * 40L;
+	int r, j;
+
+	bench_cell_stress(CELLMALLOC_POLICY_FIFO, "fifo");
+	bench_cell_stress(CELLMALLOC_POLICY_LIFO, "lifo");
+	bench_cell_spike();
+
+	ca = cellinit("bench", BENCH_CELL_SIZE, __alignof__(struct bench_cell_t), CELLMALLOC_POLICY_FIFO, 2048, 0);
+	ring = hmalloc(sizeof(*ring) * BENCH_CELL_RING);
+
+	ops -= ops % BENCH_CELL_BATCH;
+	if (ops < BENCH_CELL_RING * 2)
+		ops = BENCH_CELL_RING * 2;
+
+	for (r = 0; r < bench_opts.rounds; r++) {
+		bench_report("cellmalloc", "cellmallocmany", ops, bench_cell_run(ca, ring, ops));
+		cellfreemany(ca, ring, BENCH_CELL_RING);
+		celltrim(ca, r + 1, 0);
+
+		bench_report("cellmalloc", "malloc", ops, bench_cell_run(NULL, ring, ops));
+		for (j = 0; j < BENCH_CELL_RING; j++)
+			free(ring[j]);
+	}
+
+	hfree(ring);
+
+	return 0;
+}
@@ -0,0 +1,705 @@
+/*
+ *	aprsc-bench
+ *
+ *	(c) Heikki Hannikainen, OH7LZB <hessu@hes.iki.fi>
+ *
+ *	This program is licensed under the BSD license, which can be found
+ *	in the file LICENSE.
+ *
+ */
+
+/*
+ *	bench_dupecheck: the dupecheck thread's packet processing, with a
+ *	single shard and with the database split in shards checked by
+ *	threads of their own
+ *
+ *	A stream of packets is made from the feed, with exact duplicates
+ *	of earlier packets, and packets which are mangled versions of each
+ *	other in all of the ways the dupecheck knows about. The stream is
+ *	run through the dupecheck with different numbers of shards, and
+ *	every packet must get the same verdict and seqnum as with a single
+ *	shard. The database is also split in shards halfway through the
+ *	stream, and must give the same verdicts after that. The hashing
+ *	done by the workers for the dupecheck is measured separately.
+ *
+ *	The scan and mangle kernels are checked against the scalar ones on
+ *	fuzzed packets of all lengths, with the characters which get mangled
+ *	sprinkled in, and timed on the feed.
+ *
+ *	The table test fills a database with a million records, and
+ *	measures the lookups, the inserts and the expiry, compared with
+ *	the chained hash of 8192 buckets, and the cleanup scanning all of
+ *	it every 10 seconds, which the dupecheck used to have.
+ *
+ *	dupecheck.c is included here, instead of linking dupecheck.o, so
+ *	that the packets can be run through dupecheck_drain_worker() from
+ *	a worker made up here.
+ */
+
+#include <limits.h>
+
+#include "../dupecheck.c"
+
+#include "cellmalloc.h"
+#include "bench.h"
+
+#define BENCH_DUPECHECK_BATCH	500	/* packets drained from the worker at a time */
+#define BENCH_DUPECHECK_PENDING	64	/* mangled packets waiting for the other version */
+#define BENCH_DUPECHECK_RECORDS	1000000	/* records in the table test */
+#define BENCH_DUPECHECK_FUZZ	200000	/* fuzzed packets for the kernels */
+#define BENCH_DUPECHECK_STEP	1000	/* inserts timed at a time, for the longest step */
+
+struct bench_dupecheck_res_t {
+	char *dupe;
+	uint32_t *seqnum;
+	long long dupetypes[DTYPE_MAX+1];
+};
+
+static struct pbuf_t **bench_stream;
+static int bench_stream_count;
+
+/*
+ *	Make a pair of packets from a line: one with a character inserted
+ *	in the info field or changed, and one which matches a mangled
+ *	version of the first. Returns 0 if the line can not be used.
+ */
+
+static int bench_dupecheck_mangle(const char *line, int len, char *a, int *alen, char *b, int *blen)
+{
+	const char *info = memchr(line, ':', len);
+	int p, ilen;
+	char c;
+
+	if (!info || len + 4 > PACKETLEN_MAX - 3)
+		return 0;
+
+	info++;
+	ilen = len - (info - line);
+	if (ilen < 2)
+		return 0;
+
+	/* somewhere in the latter half of the info field, where the
+	 * parser does not care much
+	 */
+	p = (info - line) + ilen / 2 + bench_rand() % (ilen - ilen / 2);
+
+	switch (bench_rand() % 8) {
+	case 0: /* trailing spaces, the other one has them trimmed */
+		*alen = len + 1 + bench_rand() % 3;
+		memcpy(a, line, len);
+		memset(a + len, ' ', *alen - len);
+		memcpy(b, line, len);
+		*blen = len;
+		return 1;
+	case 1: /* the 8th bit set on a character, the other one has it cleared */
+		if (line[p] == ' ')
+			return 0;
+		memcpy(a, line, len);
+		a[p] |= 0x80;
+		*alen = len;
+		memcpy(b, line, len);
+		*blen = len;
+		return 1;
+	case 2: /* an 8-bit character, stripped or replaced with a space */
+	case 3:
+		c = 0xB0;
+		break;
+	case 4: /* low data, stripped or replaced with a space */
+	case 5:
+		c = 0x01;
+		break;
+	default: /* DEL, stripped or replaced with a space */
+		c = 0x7f;
+		break;
+	}
+
+	memcpy(a, line, p);
+	a[p] = c;
+	memcpy(a + p + 1, line + p, len - p);
+	*alen = len + 1;
+
+	if (bench_rand() & 1) {
+		memcpy(b, line, len);
+		*blen = len;
+	} else {
+		memcpy(b, a, *alen);
+		b[p] = ' ';
+		*blen = *alen;
+	}
+
+	return 1;
+}
+
+static void bench_dupecheck_add(struct pbuf_t *pb)
+{
+	if (pb)
+		bench_stream[bench_stream_count++] = pb;
+}
+
+static void bench_dupecheck_setup(void)
+{
+	struct bench_feed_t *feed;
+	struct pbuf_t *pending[BENCH_DUPECHECK_PENDING];
+	struct pbuf_t *pb;
+	char a[PACKETLEN_MAX], b[PACKETLEN_MAX];
+	int alen, blen;
+	int max, next = 0, pending_count = 0;
+	int i, k;
+
+	if (bench_stream)
+		return;
+
+	bench_filter_init();
+	feed = bench_feed_get();
+	dupecheck_init();
+
+	max = feed->count * 3 / 2 + BENCH_DUPECHECK_PENDING;
+	bench_stream = hmalloc(sizeof(*bench_stream) * max);
+	bench_stream_count = 0;
+
+	while (bench_stream_count < max - BENCH_DUPECHECK_PENDING) {
+		k = bench_rand() % 100;
+		if (k < 15 && pending_count) {
+			/* the other version of a mangled packet, a bit later */
+			i = bench_rand() % pending_count;
+			bench_dupecheck_add(pending[i]);
+			pending[i] = pending[--pending_count];
+		} else if (k < 40 && bench_stream_count) {
+			/* an exact duplicate of a recent packet */
+			i = bench_stream_count - 1 - bench_rand() % ((bench_stream_count < 1000) ? bench_stream_count : 1000);
+			pb = bench_stream[i];
+			bench_dupecheck_add(bench_pbuf_parse(pb->data, pb->packet_len - 2));
+		} else if (k < 55 && pending_count < BENCH_DUPECHECK_PENDING) {
+			i = next++ % feed->count;
+			if (!bench_dupecheck_mangle(feed->lines[i], feed->lens[i], a, &alen, b, &blen))
+				continue;
+			pb = bench_pbuf_parse(b, blen);
+			if (!pb)
+				continue;
+			bench_dupecheck_add(bench_pbuf_parse(a, alen));
+			pending[pending_count++] = pb;
+		} else {
+			i = next++ % feed->count;
+			bench_dupecheck_add(bench_pbuf_parse(feed->lines[i], feed->lens[i]));
+		}
+	}
+
+	for (i = 0; i < pending_count; i++)
+		bench_dupecheck_add(pending[i]);
+}
+
+/*
+ *	Run a part of the stream through the dupecheck, and store the
+ *	verdicts. Returns the time it took.
+ */
+
+static double bench_dupecheck_run(int from, int to, struct bench_dupecheck_res_t *res)
+{
+	struct worker_t *w;
+	struct pbuf_t *pb_out, **pb_out_prevp, *pb_out_last;
+	struct pbuf_t *pb_out_dupe, **pb_out_dupe_prevp, *pb_out_dupe_last;
+	int pb_out_count, pb_out_dupe_count;
+	int i, j, n;
+	double start;
+
+	w = hmalloc(sizeof(*w));
+	memset(w, 0, sizeof(*w));
+
+	for (i = from; i < to; i++)
+		bench_stream[i]->flags &= ~F_DUPE;
+
+	dupecheck_shards_start();
+
+	start = bench_time();
+
+	for (i = from; i < to; i += n) {
+		n = (to - i < BENCH_DUPECHECK_BATCH) ? to - i : BENCH_DUPECHECK_BATCH;
+		/* newest first, like a worker puts them in the inbox */
+		for (j = i + n - 1; j > i; j--)
+			bench_stream[j]->next = bench_stream[j - 1];
+		pbuf_inbox_put(&w->pbuf_incoming, bench_stream[i + n - 1], bench_stream[i], n);
+
+		pb_out = pb_out_dupe = NULL;
+		pb_out_prevp = &pb_out;
+		pb_out_dupe_prevp = &pb_out_dupe;
+		pb_out_count = pb_out_dupe_count = 0;
+		dupecheck_drain_worker(w, &pb_out_prevp, &pb_out_last,
+			&pb_out_dupe_prevp, &pb_out_dupe_last,
+			&pb_out_count, &pb_out_dupe_count);
+	}
+
+	start = bench_time() - start;
+
+	dupecheck_shards_stop();
+
+	for (i = from; i < to; i++) {
+		res->dupe[i] = (bench_stream[i]->flags & F_DUPE) ? 1 : 0;
+		res->seqnum[i] = bench_stream[i]->seqnum;
+	}
+	memcpy(res->dupetypes, dupecheck_dupetypes, sizeof(res->dupetypes));
+
+	hfree(w);
+
+	return start;
+}
+
+/* expire everything in the database, and start the seqnums over */
+static void bench_dupecheck_reset(void)
+{
+	time_t now = tick;
+	int i;
+
+	tick += dupefilter_storetime * 3;
+	for (i = 0; i < DUPECHECK_SHARDS_MAX && dupecheck_shards[i]; i++)
+		dupecheck_expire(&dupecheck_shards[i]->db, INT_MAX);
+	tick = now;
+
+	dupecheck_seqnum = dupecheck_dupe_seqnum = -2000;
+	memset(dupecheck_dupetypes, 0, sizeof(dupecheck_dupetypes));
+}
+
+static void bench_dupecheck_compare(const char *what, struct bench_dupecheck_res_t *ref, struct bench_dupecheck_res_t *res)
+{
+	struct pbuf_t *pb;
+	int i;
+
+	for (i = 0; i < bench_stream_count; i++) {
+		pb = bench_stream[i];
+		if (ref->dupe[i] != res->dupe[i])
+			bench_fail("%s: packet %d is %s, with one shard %s: %.*s", what, i,
+				(res->dupe[i]) ? "a dupe" : "unique", (ref->dupe[i]) ? "a dupe" : "unique",
+				pb->packet_len - 2, pb->data);
+		if (ref->seqnum[i] != res->seqnum[i])
+			bench_fail("%s: packet %d got seqnum %u, with one shard %u", what, i, res->seqnum[i], ref->seqnum[i]);
+	}
+
+	for (i = 0; i <= DTYPE_MAX; i++)
+		if (ref->dupetypes[i] != res->dupetypes[i])
+			bench_fail("%s: %lld dupes of type %d, with one shard %lld", what,
+				res->dupetypes[i], i, ref->dupetypes[i]);
+}
+
+static void bench_dupecheck_res_init(struct bench_dupecheck_res_t *res)
+{
+	memset(res, 0, sizeof(*res));
+	res->dupe = hmalloc(bench_stream_count);
+	res->seqnum = hmalloc(sizeof(*res->seqnum) * bench_stream_count);
+}
+
+static void bench_dupecheck_res_free(struct bench_dupecheck_res_t *res)
+{
+	hfree(res->dupe);
+	hfree(res->seqnum);
+}
+
+/*
+ *	A fuzzed packet: a feed line, or random bytes, cut or repeated to a
+ *	random length, with some of the characters which get mangled in it
+ */
+
+static int bench_dupecheck_fuzz(struct bench_feed_t *feed, char *buf)
+{
+	static const unsigned char specials[] = { 0x80, 0xB0, 0xFF, 0x01, 0x1F, 0x09, 0x7F, 0x20, 0x00 };
+	const char *line = feed->lines[bench_rand() % feed->count];
+	int llen = feed->lens[bench_rand() % feed->count];
+	int len = bench_rand() % (PACKETLEN_MAX + 1);
+	int i, n, k = bench_rand() % 8;
+
+	if (llen > (int)strlen(line))
+		llen = strlen(line);
+
+	for (i = 0; i < len; i++)
+		buf[i] = (k == 0 || !llen) ? (char)bench_rand() : line[i % llen];
+
+	/* most of them clean, some with a few, some with many */
+	n = (k < 4) ? 0 : (k < 7) ? 1 + bench_rand() % 3 : bench_rand() % (len + 1);
+	for (i = 0; i < n && len; i++)
+		buf[bench_rand() % len] = specials[bench_rand() % sizeof(specials)];
+
+	return len;
+}
+
+static void bench_dupecheck_kernels(void)
+{
+	const struct dupecheck_kernel_t *kernels = dupecheck_kernels();
+	const struct dupecheck_kernel_t *scalar = &kernels[0];
+	const struct dupecheck_kernel_t *k;
+	struct bench_feed_t *feed = bench_feed_get();
+	char buf[PACKETLEN_MAX], ref[PACKETLEN_MAX], out[PACKETLEN_MAX];
+	char **dirty;
+	char name[64];
+	double start;
+	long sum;
+	int i, j, len, rlen, olen, dtype, r;
+
+	for (i = 0; i < BENCH_DUPECHECK_FUZZ; i++) {
+		len = bench_dupecheck_fuzz(feed, buf);
+		for (k = &kernels[1]; k->name; k++) {
+			if (k->scan(buf, len) != scalar->scan(buf, len))
+				bench_fail("%s scan: %d, scalar %d, on fuzzed packet %d of %d bytes",
+					k->name, k->scan(buf, len), scalar->scan(buf, len), i, len);
+			for (dtype = DTYPE_STRIP_8BIT; dtype <= DTYPE_MAX; dtype++) {
+				rlen = scalar->mangle(buf, len, dtype, ref);
+				olen = k->mangle(buf, len, dtype, out);
+				if (olen != rlen || memcmp(out, ref, rlen) != 0)
+					bench_fail("%s mangle %d: %d bytes, scalar %d, differs on fuzzed packet %d of %d bytes",
+						k->name, dtype, olen, rlen, i, len);
+			}
+		}
+	}
+	printf("scan and mangle kernels match the scalar ones on %d fuzzed packets:", BENCH_DUPECHECK_FUZZ);
+	for (k = &kernels[1]; k->name; k++)
+		printf(" %s", k->name);
+	printf("\n");
+
+	/* the feed with an 8-bit character in each line, for the mangling */
+	dirty = hmalloc(sizeof(*dirty) * feed->count);
+	for (i = 0; i < feed->count; i++) {
+		dirty[i] = hmalloc(feed->lens[i] + 1);
+		memcpy(dirty[i], feed->lines[i], feed->lens[i]);
+		dirty[i][feed->lens[i] / 2] = 0xB0;
+	}
+
+	for (r = 0; r < bench_opts.rounds; r++) {
+		for (k = kernels; k->name; k++) {
+			start = bench_time();
+			for (j = sum = 0; j < 10; j++)
+				for (i = 0; i < feed->count; i++)
+					sum += k->scan(feed->lines[i], feed->lens[i]);
+			snprintf(name, sizeof(name), "scan, %s", k->name);
+			bench_report("dupecheck", name, feed->count * 10L, bench_time() - start);
+			if (sum != 0)
+				bench_fail("%s scan found something to mangle in the feed", k->name);
+
+			for (dtype = DTYPE_STRIP_8BIT; dtype <= DTYPE_SPACED_8BIT; dtype += 2) {
+				start = bench_time();
+				for (j = sum = 0; j < 10; j++)
+					for (i = 0; i < feed->count; i++)
+						sum += k->mangle(dirty[i], (feed->lens[i] > PACKETLEN_MAX) ? PACKETLEN_MAX : feed->lens[i], dtype, out);
+				snprintf(name, sizeof(name), "mangle %s, %s", (dtype == DTYPE_STRIP_8BIT) ? "strip" : "spaced", k->name);
+				bench_report("dupecheck", name, feed->count * 10L, bench_time() - start);
+			}
+		}
+	}
+
+	for (i = 0; i < feed->count; i++)
+		hfree(dirty[i]);
+	hfree(dirty);
+}
+
+/*
+ *	The chained hash table the dupecheck used to have, for comparison
+ */
+
+#define BENCH_CHAINED_SIZE 8192
+
+struct bench_chained_t {
+	struct bench_chained_t *next;
+	uint32_t hash;
+	time_t	 t;
+	int	 dtype;
+	int	 len;
+	char	*packet;
+	char	 packetbuf[220];
+};
+
+static struct bench_chained_t *bench_chained_db[BENCH_CHAINED_SIZE];
+static cellarena_t *bench_chained_cells;
+
+static struct bench_chained_t **bench_chained_find(uint32_t hash, const char *s, int len)
+{
+	struct bench_chained_t **dpp, *dp;
+	uint32_t idx = hash;
+
+	idx ^= (idx >> 13); /* fold the hash bits.. */
+	idx ^= (idx >> 26); /* fold the hash bits.. */
+	for (dpp = &bench_chained_db[idx % BENCH_CHAINED_SIZE]; (dp = *dpp); dpp = &dp->next)
+		if (dp->hash == hash && dp->t >= tick - dupefilter_storetime
+		    && dp->len == len && memcmp(s, dp->packet, len) == 0)
+			break;
+
+	return dpp;
+}
+
+static void bench_chained_insert(uint32_t hash, const char *s, int len)
+{
+	struct bench_chained_t **dpp = bench_chained_find(hash, s, len);
+	struct bench_chained_t *dp;
+
+	if (*dpp)
+		return;
+
+	dp = cellmalloc(bench_chained_cells);
+	memset(dp, 0, sizeof(*dp));
+	dp->len = len;
+	dp->packet = dp->packetbuf;
+	if (len > sizeof(dp->packetbuf))
+		dp->packet = hmalloc(len + 1);
+	memcpy(dp->packet, s, len);
+	dp->hash = hash;
+	dp->t = tick;
+	*dpp = dp;
+}
+
+static long bench_chained_cleanup(void)
+{
+	struct bench_chained_t *dp, **dpp;
+	time_t expiretime = tick - dupefilter_storetime;
+	long n = 0;
+	int i;
+
+	for (i = 0; i < BENCH_CHAINED_SIZE; i++) {
+		dpp = &bench_chained_db[i];
+		while ((dp = *dpp)) {
+			if (dp->t < expiretime) {
+				*dpp = dp->next;
+				if (dp->packet != dp->packetbuf)
+					hfree(dp->packet);
+				cellfree(bench_chained_cells, dp);
+				n++;
+				continue;
+			}
+			dpp = &dp->next;
+		}
+	}
+
+	return n;
+}
+
+/*
+ *	A million different records, made of the feed lines with a number
+ *	at the end, and looked up in a random order
+ */
+
+struct bench_dupecheck_keys_t {
+	char *buf;
+	int *offs;
+	int *lens;
+	uint32_t *hashes;
+	int *order;
+};
+
+static void bench_dupecheck_keys(struct bench_dupecheck_keys_t *k, struct bench_feed_t *feed)
+{
+	int i, j, t, len, size = 0, used = 0;
+
+	for (i = 0; i < feed->count; i++)
+		size += feed->lens[i] + 12;
+	size = size * (BENCH_DUPECHECK_RECORDS / feed->count + 1);
+
+	k->buf = hmalloc(size);
+	k->offs = hmalloc(sizeof(*k->offs) * BENCH_DUPECHECK_RECORDS);
+	k->lens = hmalloc(sizeof(*k->lens) * BENCH_DUPECHECK_RECORDS);
+	k->hashes = hmalloc(sizeof(*k->hashes) * BENCH_DUPECHECK_RECORDS);
+	k->order = hmalloc(sizeof(*k->order) * BENCH_DUPECHECK_RECORDS);
+
+	for (i = 0; i < BENCH_DUPECHECK_RECORDS; i++) {
+		j = i % feed->count;
+		len = feed->lens[j];
+		memcpy(k->buf + used, feed->lines[j], len);
+		len += sprintf(k->buf + used + len, " %d", i);
+		k->offs[i] = used;
+		k->lens[i] = len;
+		k->hashes[i] = keyhash(k->buf + used, len, 0);
+		k->order[i] = i;
+		used += len;
+	}
+
+	/* shuffle */
+	for (i = BENCH_DUPECHECK_RECORDS - 1; i > 0; i--) {
+		j = bench_rand() % (i + 1);
+		t = k->order[i];
+		k->order[i] = k->order[j];
+		k->order[j] = t;
+	}
+}
+
+static void bench_dupecheck_keys_free(struct bench_dupecheck_keys_t *k)
+{
+	hfree(k->buf);
+	hfree(k->offs);
+	hfree(k->lens);
+	hfree(k->hashes);
+	hfree(k->order);
+}
+
+static void bench_dupecheck_table(void)
+{
+	struct bench_dupecheck_keys_t k;
+	struct dupecheck_db_t db;
+	struct dupecheck_slot_t *slot;
+	time_t now = tick;
+	double start, step, step_max;
+	uint64_t pos;
+	long found, n;
+	int i, j;
+
+	bench_dupecheck_keys(&k, bench_feed_get());
+
+	/* open addressing and the ring of slabs */
+	dupecheck_db_init(&db);
+
+	start = step = bench_time();
+	step_max = 0;
+	for (i = 0; i < BENCH_DUPECHECK_RECORDS; i++) {
+		dupecheck_table_reserve(&db);
+		slot = dupecheck_table_find(&db, k.hashes[i], k.buf + k.offs[i], k.lens[i], "", 0);
+		if (!slot->pos)
+			dupecheck_store(&db, slot, k.hashes[i], k.buf + k.offs[i], k.lens[i], "", 0, NULL, 0, &pos);
+		if (i % BENCH_DUPECHECK_STEP == BENCH_DUPECHECK_STEP - 1) {
+			if (bench_time() - step > step_max)
+				step_max = bench_time() - step;
+			step = bench_time();
+		}
+	}
+	bench_report("dupecheck", "table: insert", BENCH_DUPECHECK_RECORDS, bench_time() - start);
+	printf("longest insert step of %d records: %.3f ms\n", BENCH_DUPECHECK_STEP, step_max * 1000.0);
+	if (dupecheck_table_records(&db) != BENCH_DUPECHECK_RECORDS)
+		bench_fail("table has %u records, expected %d", dupecheck_table_records(&db), BENCH_DUPECHECK_RECORDS);
+
+	start = bench_time();
+	for (i = found = 0; i < BENCH_DUPECHECK_RECORDS; i++) {
+		j = k.order[i];
+		found += (dupecheck_table_find(&db, k.hashes[j], k.buf + k.offs[j], k.lens[j], "", 0)->pos != 0);
+	}
+	bench_report("dupecheck", "table: lookup, found", BENCH_DUPECHECK_RECORDS, bench_time() - start);
+	if (found != BENCH_DUPECHECK_RECORDS)
+		bench_fail("table lookup found %ld records, expected %d", found, BENCH_DUPECHECK_RECORDS);
+
+	start = bench_time();
+	for (i = found = 0; i < BENCH_DUPECHECK_RECORDS; i++) {
+		j = k.order[i];
+		found += (dupecheck_table_find(&db, k.hashes[j] ^ 1, k.buf + k.offs[j], k.lens[j], "", 0)->pos != 0);
+	}
+	bench_report("dupecheck", "table: lookup, not found", BENCH_DUPECHECK_RECORDS, bench_time() - start);
+
+	/* all of it expires at once, which is the worst case */
+	tick += dupefilter_storetime * 2;
+	start = bench_time();
+	step_max = 0;
+	while (dupecheck_table_records(&db)) {
+		step = bench_time();
+		dupecheck_expire(&db, DUPECHECK_EXPIRE_MAX);
+		step = bench_time() - step;
+		if (step > step_max)
+			step_max = step;
+	}
+	bench_report("dupecheck", "table: expire", BENCH_DUPECHECK_RECORDS, bench_time() - start);
+	printf("longest expiry step of %d records: %.3f ms\n", DUPECHECK_EXPIRE_MAX, step_max * 1000.0);
+	tick = now;
+
+	dupecheck_db_free(&db);
+
+	/* the chained hash */
+	if (!bench_chained_cells)
+		bench_chained_cells = cellinit("bench_chained", sizeof(struct bench_chained_t),
+			__alignof__(struct bench_chained_t), CELLMALLOC_POLICY_LIFO | CELLMALLOC_POLICY_NOMUTEX,
+			2048, 0);
+
+	start = bench_time();
+	for (i = 0; i < BENCH_DUPECHECK_RECORDS; i++)
+		bench_chained_insert(k.hashes[i], k.buf + k.offs[i], k.lens[i]);
+	bench_report("dupecheck", "chained: insert", BENCH_DUPECHECK_RECORDS, bench_time() - start);
+
+	/* the chains are long, a sample of the lookups is enough */
+	start = bench_time();
+	for (i = found = 0; i < BENCH_DUPECHECK_RECORDS / 10; i++) {
+		j = k.order[i];
+		found += (*bench_chained_find(k.hashes[j], k.buf + k.offs[j], k.lens[j]) != NULL);
+	}
+	bench_report("dupecheck", "chained: lookup, found", BENCH_DUPECHECK_RECORDS / 10, bench_time() - start);
+	if (found != BENCH_DUPECHECK_RECORDS / 10)
+		bench_fail("chained lookup found %ld records, expected %d", found, BENCH_DUPECHECK_RECORDS / 10);
+
+	start = bench_time();
+	for (i = 0; i < BENCH_DUPECHECK_RECORDS / 10; i++) {
+		j = k.order[i];
+		bench_chained_find(k.hashes[j] ^ 1, k.buf + k.offs[j], k.lens[j]);
+	}
+	bench_report("dupecheck", "chained: lookup, not found", BENCH_DUPECHECK_RECORDS / 10, bench_time() - start);
+
+	/* the cleanup scanned everything, even if nothing expired */
+	start = bench_time();
+	bench_chained_cleanup();
+	printf("chained cleanup scan, nothing expiring: %.3f ms\n", (bench_time() - start) * 1000.0);
+
+	tick += dupefilter_storetime * 2;
+	start = bench_time();
+	n = bench_chained_cleanup();
+	bench_report("dupecheck", "chained: cleanup", n, bench_time() - start);
+	tick = now;
+
+	bench_dupecheck_keys_free(&k);
+}
+
+int bench_dupecheck(void)
+{
+	struct bench_dupecheck_res_t ref, res;
+	char name[64];
+	double secs;
+	long dupes = 0;
+	int r, n, i;
+
+	bench_dupecheck_setup();
+	bench_dupecheck_res_init(&ref);
+	bench_dupecheck_res_init(&res);
+
+	/* the verdicts of a single shard, to compare with */
+	dupecheck_shards_configured = 1;
+	bench_dupecheck_reset();
+	bench_dupecheck_run(0, bench_stream_count, &ref);
+
+	for (i = 0; i < bench_stream_count; i++)
+		dupes += ref.dupe[i];
+	printf("%d packets, %ld dupes: exact %lld, space_trim %lld, 8bit strip/clear/spaced %lld/%lld/%lld, "
+		"low strip/spaced %lld/%lld, del strip %lld\n",
+		bench_stream_count, dupes, ref.dupetypes[0], ref.dupetypes[DTYPE_SPACE_TRIM],
+		ref.dupetypes[DTYPE_STRIP_8BIT], ref.dupetypes[DTYPE_CLEAR_8BIT], ref.dupetypes[DTYPE_SPACED_8BIT],
+		ref.dupetypes[DTYPE_LOWDATA_STRIP], ref.dupetypes[DTYPE_LOWDATA_SPACED], ref.dupetypes[DTYPE_DEL_STRIP]);
+
+	for (i = 0; i < DTYPE_MAX; i++)
+		if (!ref.dupetypes[i])
+			bench_fail("no dupes of type %d in the stream", i);
+
+	/* the part done by the workers, before the dupecheck thread */
+	for (r = 0; r < bench_opts.rounds; r++) {
+		secs = bench_time();
+		for (i = 0; i < bench_stream_count; i++)
+			dupecheck_prepare(bench_stream[i]);
+		bench_report("dupecheck", "prepare, in the workers", bench_stream_count, bench_time() - secs);
+	}
+
+	/* split in shards halfway through the stream */
+	for (n = 2; n <= DUPECHECK_SHARDS_MAX; n *= 2) {
+		bench_dupecheck_reset();
+		dupecheck_shards_configured = 1;
+		bench_dupecheck_run(0, bench_stream_count / 2, &res);
+		dupecheck_shards_configured = n;
+		bench_dupecheck_run(bench_stream_count / 2, bench_stream_count, &res);
+		snprintf(name, sizeof(name), "split in %d shards halfway", n);
+		bench_dupecheck_compare(name, &ref, &res);
+	}
+	printf("verdicts match after splitting the database in 2..%d shards\n", DUPECHECK_SHARDS_MAX);
+
+	for (r = 0; r < bench_opts.rounds; r++) {
+		for (n = 1; n <= DUPECHECK_SHARDS_MAX; n *= 2) {
+			dupecheck_shards_configured = n;
+			bench_dupecheck_reset();
+			secs = bench_dupecheck_run(0, bench_stream_count, &res);
+			snprintf(name, sizeof(name), "%d shards", n);
+			bench_dupecheck_compare(name, &ref, &res);
+			bench_report("dupecheck", name, bench_stream_count, secs);
+		}
+	}
+
+	dupecheck_shards_configured = 1;
+	dupecheck_shards_start();
+
+	bench_dupecheck_kernels();
+	bench_dupecheck_table();
+
+	bench_dupecheck_res_free(&ref);
+	bench_dupecheck_res_free(&res);
+
+	return 0;
+}
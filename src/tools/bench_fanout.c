@@ -0,0 +1,234 @@
+/*
+ *	aprsc-bench
+ *
+ *	(c) Heikki Hannikainen, OH7LZB <hessu@hes.iki.fi>
+ *
+ *	This program is licensed under the BSD license, which can be found
+ *	in the file LICENSE.
+ *
+ */
+
+/*
+ *	bench_fanout: sending the outgoing packets to many clients
+ *
+ *	outgoing.c is included here, so that the static functions of the
+ *	outgoing path can be run on a worker of the benchmark's own. The
+ *	clients are real ones, allocated with client_alloc() and classified
+ *	when they log in, having filters which can not be indexed, so that
+ *	they all go in the "other" class, and their writes are counted
+ *	instead of buffered.
+ *
+ *	The client_t walk goes through the clients and looks at the
+ *	client_t of each one for every packet, like the class lists used
+ *	to be walked. The hot record walk is process_outgoing_single(),
+ *	which only goes to the client_t of the clients which may want the
+ *	packet. Both must send the same packets. If the system has the
+ *	hardware counters, the cache misses are counted too.
+ */
+
+#include "../outgoing.c"
+
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+
+#include "hmalloc.h"
+#include "filter.h"
+#include "geoindex.h"
+#include "callindex.h"
+#include "bench.h"
+
+#define BENCH_FANOUT_VISITS	20000000L	/* client visits in a run, about */
+
+/* filter strings used by a lot of clients, shared in the worker */
+static const char *bench_fanout_popular[] = {
+	"t/m", "t/n", "t/w", "p/OH/OG/OF t/m", "p/DL/DB/DO t/s", "p/K/W/N t/w", "s//#", "q/I"
+};
+
+static struct pbuf_t **bench_fanout_pbufs;
+static int bench_fanout_pbuf_count;
+static long bench_fanout_sent;
+static int bench_fanout_fd = -1;
+
+static int bench_fanout_write(struct worker_t *self, struct client_t *c, char *p, int len)
+{
+	bench_fanout_sent += len;
+
+	return len;
+}
+
+static void bench_fanout_setup(void)
+{
+	struct bench_feed_t *feed;
+	struct pbuf_t *pb;
+	int i;
+
+	if (bench_fanout_pbufs)
+		return;
+
+	bench_filter_init();
+	client_init();
+
+	feed = bench_feed_get();
+	bench_fanout_pbufs = hmalloc(sizeof(*bench_fanout_pbufs) * feed->count);
+	for (i = 0; i < feed->count; i++)
+		if ((pb = bench_pbuf_parse(feed->lines[i], feed->lens[i])))
+			bench_fanout_pbufs[bench_fanout_pbuf_count++] = pb;
+
+	/* the clients get TCP_NODELAY set when they log in */
+	if ((bench_fanout_fd = socket(AF_INET, SOCK_STREAM, 0)) < 0)
+		bench_fail("socket failed");
+}
+
+/* half of the clients have popular filters, the rest prefixes of their
+ * own, each along with a type filter so that they can not be indexed
+ */
+static void bench_fanout_filter(char *s, int len)
+{
+	struct pbuf_t *pb;
+	int r = bench_rand() % 10;
+
+	if (r < 5) {
+		snprintf(s, len, "%s", bench_fanout_popular[bench_rand() % (sizeof(bench_fanout_popular) / sizeof(bench_fanout_popular[0]))]);
+		return;
+	}
+
+	pb = bench_fanout_pbufs[bench_rand() % bench_fanout_pbuf_count];
+	if (r < 8)
+		snprintf(s, len, "p/%.*s t/m", (pb->srcname_len > 4) ? 4 : pb->srcname_len, pb->srcname);
+	else if (r < 9)
+		snprintf(s, len, "e/%.*s t/w", pb->entrycall_len, pb->qconst_start + 4);
+	else
+		snprintf(s, len, "s/->_/%c", 'A' + bench_rand() % 26);
+}
+
+static struct client_t *bench_fanout_client(struct worker_t *self)
+{
+	struct client_t *c;
+	char s[64], *f, *save;
+
+	if (!(c = client_alloc()))
+		bench_fail("client_alloc failed");
+
+	c->fd = bench_fanout_fd;
+	c->flags = CLFLAGS_INPORT | CLFLAGS_USERFILTEROK;
+	c->ai_protocol = IPPROTO_TCP;
+	c->write = bench_fanout_write;
+	/* a few blacklisted igates, skipped by the hot records too */
+	c->no_tx = (bench_rand() % 50 == 0);
+
+	bench_fanout_filter(s, sizeof(s));
+	for (f = strtok_r(s, " ", &save); f; f = strtok_r(NULL, " ", &save))
+		if (filter_parse(c, f, 1) < 0)
+			bench_fail("filter_parse failed for '%s'", f);
+
+	worker_mark_client_connected(self, c);
+	c->fd = -1;
+
+	return c;
+}
+
+/* every client, looking at the client_t */
+static double bench_fanout_walk(struct worker_t *self, struct client_t **clients, int nclients, int npackets)
+{
+	struct pbuf_t *pb;
+	double start = bench_time();
+	uint32_t kinds;
+	int i, j;
+
+	for (i = 0; i < npackets; i++) {
+		pb = bench_fanout_pbufs[i];
+		if (++self->packet_stamp == 0)
+			++self->packet_stamp;
+		kinds = filter_packet_kinds(pb);
+		for (j = nclients - 1; j >= 0; j--)
+			process_outgoing_client(self, clients[j], pb->origin, pb, kinds);
+	}
+
+	return bench_time() - start;
+}
+
+static double bench_fanout_hot(struct worker_t *self, int npackets)
+{
+	double start = bench_time();
+	int i;
+
+	for (i = 0; i < npackets; i++)
+		process_outgoing_single(self, bench_fanout_pbufs[i]);
+
+	return bench_time() - start;
+}
+
+static void bench_fanout_run(int nclients)
+{
+	struct worker_t *self;
+	struct client_t **clients;
+	struct bench_counters_t bc;
+	char name[64];
+	long sent_walk, sent_hot = 0;
+	int i, r, npackets;
+
+	self = hmalloc(sizeof(*self));
+	memset(self, 0, sizeof(*self));
+
+	clients = hmalloc(sizeof(*clients) * nclients);
+	for (i = 0; i < nclients; i++)
+		clients[i] = bench_fanout_client(self);
+
+	if (self->clients_other.count != nclients)
+		bench_fail("%d of %d clients in the other class", self->clients_other.count, nclients);
+
+	npackets = BENCH_FANOUT_VISITS / nclients;
+	if (npackets > bench_fanout_pbuf_count)
+		npackets = bench_fanout_pbuf_count;
+
+	printf("%d clients of %d bytes, %d hot records of %d bytes, %d filter sets, %d packets\n",
+		nclients, (int)sizeof(struct client_t), self->clients_other.count, (int)sizeof(struct client_hot_t),
+		self->filter_intern->entries, npackets);
+
+	for (r = 0; r < bench_opts.rounds; r++) {
+		snprintf(name, sizeof(name), "client_t walk, %d", nclients);
+		bench_fanout_sent = 0;
+		bench_counters_start(&bc);
+		bench_report("fanout", name, npackets, bench_fanout_walk(self, clients, nclients, npackets));
+		bench_counters_report(&bc, "fanout", name, npackets);
+		sent_walk = bench_fanout_sent;
+
+		snprintf(name, sizeof(name), "hot records, %d", nclients);
+		bench_fanout_sent = 0;
+		bench_counters_start(&bc);
+		bench_report("fanout", name, npackets, bench_fanout_hot(self, npackets));
+		bench_counters_report(&bc, "fanout", name, npackets);
+		sent_hot = bench_fanout_sent;
+
+		if (sent_walk != sent_hot || !sent_hot)
+			bench_fail("%d clients: %ld bytes sent by the client_t walk, %ld by the hot records",
+				nclients, sent_walk, sent_hot);
+	}
+
+	printf("%.1f kB sent per packet\n", (double)sent_hot / npackets / 1024.0);
+
+	/* the shared filters go with the clients, then the worker */
+	for (i = 0; i < nclients; i++)
+		client_free(clients[i]);
+	geoindex_free(self->geoindex);
+	callindex_free(self->callindex);
+	filter_intern_free(self->filter_intern);
+	filter_centres_free(self->filter_centres);
+	hfree(self->clients_other.hot);
+	hfree(self);
+	hfree(clients);
+}
+
+int bench_fanout(void)
+{
+	static const int sizes[] = { 1000, 5000, 20000 };
+	int i;
+
+	bench_fanout_setup();
+
+	for (i = 0; i < (int)(sizeof(sizes) / sizeof(sizes[0])); i++)
+		bench_fanout_run(sizes[i]);
+
+	return 0;
+}
@@ -0,0 +1,714 @@
+/*
+ *	aprsc-bench
+ *
+ *	(c) Heikki Hannikainen, OH7LZB <hessu@hes.iki.fi>
+ *
+ *	This program is licensed under the BSD license, which can be found
+ *	in the file LICENSE.
+ *
+ */
+
+/*
+ *	bench_filter: filter_process() and outgoing filter index benchmarks
+ *
+ *	filter.c is included here, instead of linking filter.o, so that
+ *	the reference implementation can use the static filter match
+ *	functions.
+ */
+
+#include "../filter.c"
+
+#include "geoindex.h"
+#include "callindex.h"
+#include "bench.h"
+
+/* filter type mix, roughly as in the usage table in filter.c */
+static const struct {
+	char type;
+	int weight;
+} bench_filter_mix[] = {
+	{ 'a', 237 },
+	{ 'b',  92 },
+	{ 'd',  14 },
+	{ 'e',   2 },
+	{ 'f',  22 },
+	{ 'm', 209 },
+	{ 'o',   2 },
+	{ 'p', 144 },
+	{ 'q',   4 },
+	{ 'r', 190 },
+	{ 's',  17 },
+	{ 't',  66 },
+	{ 'u',   1 },
+};
+#define BENCH_FILTER_TYPES (sizeof(bench_filter_mix) / sizeof(bench_filter_mix[0]))
+
+static struct pbuf_t **bench_pbufs;
+static int bench_pbuf_count;
+static struct pbuf_t **bench_pos_pbufs;
+static int bench_pos_count;
+
+static double bench_deg(float rad)
+{
+	return rad * (180.0 / M_PI);
+}
+
+static double bench_clamp(double v, double limit)
+{
+	if (v > limit)
+		return limit;
+	if (v < -limit)
+		return -limit;
+	return v;
+}
+
+static struct pbuf_t *bench_random_pbuf(void)
+{
+	return bench_pbufs[bench_rand() % bench_pbuf_count];
+}
+
+static struct pbuf_t *bench_random_pos_pbuf(void)
+{
+	return bench_pos_pbufs[bench_rand() % bench_pos_count];
+}
+
+static char bench_filter_type(void)
+{
+	int i, total = 0, r;
+
+	for (i = 0; i < BENCH_FILTER_TYPES; i++)
+		total += bench_filter_mix[i].weight;
+
+	r = bench_rand() % total;
+	for (i = 0; i < BENCH_FILTER_TYPES; i++) {
+		if (r < bench_filter_mix[i].weight)
+			return bench_filter_mix[i].type;
+		r -= bench_filter_mix[i].weight;
+	}
+
+	return 'r';
+}
+
+/*
+ *	Generate a filter of the given type, using stations in the feed
+ *	for the callsigns and the locations.
+ */
+
+static void bench_filter_generate(char type, char *s, int len)
+{
+	struct pbuf_t *pb;
+	char *p = s;
+	int i, n;
+	double w;
+
+	switch (type) {
+	case 'a':
+		pb = bench_random_pos_pbuf();
+		w = bench_rand_range(0.2, 3.0);
+		snprintf(s, len, "a/%.3f/%.3f/%.3f/%.3f",
+			bench_clamp(bench_deg(pb->lat) + w, 90), bench_clamp(bench_deg(pb->lng) - w * 2, 180),
+			bench_clamp(bench_deg(pb->lat) - w, 90), bench_clamp(bench_deg(pb->lng) + w * 2, 180));
+		break;
+	case 'r':
+		pb = bench_random_pos_pbuf();
+		snprintf(s, len, "r/%.3f/%.3f/%d",
+			bench_deg(pb->lat), bench_deg(pb->lng), 20 + bench_rand() % 480);
+		break;
+	case 'm':
+		snprintf(s, len, "m/%d", 20 + bench_rand() % 280);
+		break;
+	case 'f':
+		pb = bench_random_pos_pbuf();
+		snprintf(s, len, "f/%.*s/%d", pb->srcname_len, pb->srcname, 10 + bench_rand() % 190);
+		break;
+	case 'b':
+	case 'o':
+	case 'u':
+	case 'd':
+	case 'e':
+		n = (type == 'b') ? 1 + bench_rand() % 8 : 1 + bench_rand() % 2;
+		p += snprintf(p, len, "%c", type);
+		for (i = 0; i < n; i++) {
+			pb = bench_random_pbuf();
+			if (type == 'e' || type == 'd')
+				p += snprintf(p, len - (p - s), "/%.*s", pb->entrycall_len, pb->qconst_start + 4);
+			else if (type == 'o')
+				p += snprintf(p, len - (p - s), "/OBJ%d*", bench_rand() % 100);
+			else if (type == 'u')
+				p += snprintf(p, len - (p - s), "/AP%c*", 'A' + bench_rand() % 26);
+			else if (bench_rand() % 10 == 0)
+				p += snprintf(p, len - (p - s), "/%.*s*", pb->srcname_len - 1, pb->srcname);
+			else
+				p += snprintf(p, len - (p - s), "/%.*s", pb->srcname_len, pb->srcname);
+		}
+		break;
+	case 'p':
+		n = 1 + bench_rand() % 4;
+		p += snprintf(p, len, "p");
+		for (i = 0; i < n; i++) {
+			pb = bench_random_pbuf();
+			p += snprintf(p, len - (p - s), "/%.*s", 2 + bench_rand() % 2, pb->srcname);
+		}
+		break;
+	case 's':
+		snprintf(s, len, "s/->_");
+		break;
+	case 'q':
+		snprintf(s, len, "q/C");
+		break;
+	case 't':
+	default:
+		snprintf(s, len, "t/%s", (bench_rand() & 1) ? "poimqstunw" + bench_rand() % 8 : "m");
+		break;
+	}
+}
+
+/*
+ *	Reference implementation: walk the four filter chains, dispatching
+ *	on the filter type for every filter, like filter_process did before
+ *	the filter chains were compiled. Not igate ports.
+ */
+
+static int bench_filter_process_one(struct client_t *c, struct pbuf_t *pb, struct filter_t *f)
+{
+	struct filter_op_t op;
+
+	filter_compile_op(&op, f);
+
+	return filter_op_run(c, pb, &op);
+}
+
+static int bench_filter_process_chains(struct client_t *c, struct pbuf_t *pb)
+{
+	struct filter_t *f;
+	int rc;
+
+	for (f = c->negdefaultfilters; f; f = f->h.next)
+		if (bench_filter_process_one(c, pb, f) > 0)
+			return 0;
+
+	for (f = c->posdefaultfilters; f; f = f->h.next)
+		if ((rc = bench_filter_process_one(c, pb, f)) > 0)
+			return rc;
+
+	for (f = c->neguserfilters; f; f = f->h.next)
+		if (bench_filter_process_one(c, pb, f) > 0)
+			return 0;
+
+	for (f = c->posuserfilters; f; f = f->h.next)
+		if ((rc = bench_filter_process_one(c, pb, f)) > 0)
+			return rc;
+
+	return 0;
+}
+
+/* a client which is a station in the feed, and might have a known position */
+static struct client_t *bench_client_alloc(void)
+{
+	struct client_t *c;
+	struct pbuf_t *pb;
+	int n;
+
+	c = hmalloc(sizeof(*c));
+	memset(c, 0, sizeof(*c));
+	c->flags = CLFLAGS_INPORT | CLFLAGS_USERFILTEROK;
+
+	pb = bench_random_pos_pbuf();
+	n = (pb->srcname_len < sizeof(c->username)) ? pb->srcname_len : sizeof(c->username) - 1;
+	memcpy(c->username, pb->srcname, n);
+	c->username_len = n;
+	if (bench_rand() % 10 < 7) {
+		c->lat = pb->lat;
+		c->lng = pb->lng;
+		c->cos_lat = pb->cos_lat;
+		c->loc_pt = pb->range_pt;
+		c->loc_known = 1;
+	}
+
+	return c;
+}
+
+/* a random filter string of a few filters, separated by spaces */
+static void bench_client_filters(char *s, int len)
+{
+	char *p = s;
+	int i, n;
+
+	/* a few clients have a lot of range filters, which are
+	 * checked all at once
+	 */
+	if (bench_rand() % 50 == 0) {
+		n = FILTER_RANGE_BATCH_MIN + bench_rand() % 8;
+		for (i = 0; i < n; i++) {
+			bench_filter_generate("rrrfm"[bench_rand() % 5], p, len - (p - s));
+			p += strlen(p);
+			*p++ = ' ';
+		}
+	}
+
+	n = 1 + bench_rand() % 3;
+	for (i = 0; i < n; i++) {
+		bench_filter_generate(bench_filter_type(), p, len - (p - s));
+		p += strlen(p);
+		*p++ = ' ';
+	}
+
+	/* some clients exclude something */
+	if (bench_rand() % 10 == 0) {
+		if (bench_rand() & 1) {
+			strcpy(p, "-t/c");
+		} else {
+			*p = '-';
+			bench_filter_generate('p', p + 1, len - (p - s) - 1);
+		}
+	} else {
+		*--p = 0;
+	}
+}
+
+static void bench_client_parse(struct client_t *c, const char *filters)
+{
+	char s[FILTER_S_SIZE * 5], *p, *t;
+
+	snprintf(s, sizeof(s), "%s", filters);
+	for (t = strtok_r(s, " ", &p); (t); t = strtok_r(NULL, " ", &p))
+		if (filter_parse(c, t, 1) < 0)
+			bench_fail("filter_parse failed for generated filter '%s'", t);
+}
+
+static struct client_t *bench_client_create(void)
+{
+	struct client_t *c;
+	char s[FILTER_S_SIZE * 5];
+
+	c = bench_client_alloc();
+	bench_client_filters(s, sizeof(s));
+	bench_client_parse(c, s);
+
+	return c;
+}
+
+/*
+ *	Parse the feed, and run the packets through the history db
+ *	like the dupecheck thread does, so that f/ and m/ filters
+ *	find their centres
+ */
+
+static void bench_filter_setup(void)
+{
+	struct bench_feed_t *feed;
+	struct pbuf_t *pb;
+	int i;
+
+	if (bench_pbufs)
+		return;
+
+	feed = bench_feed_get();
+	bench_filter_init();
+
+	bench_pbufs = hmalloc(sizeof(*bench_pbufs) * feed->count);
+	bench_pos_pbufs = hmalloc(sizeof(*bench_pos_pbufs) * feed->count);
+	bench_pbuf_count = bench_pos_count = 0;
+
+	for (i = 0; i < feed->count; i++) {
+		pb = bench_pbuf_parse(feed->lines[i], feed->lens[i]);
+		if (!pb)
+			continue;
+		filter_postprocess_dupefilter(pb);
+		historydb_insert(pb);
+		bench_pbufs[bench_pbuf_count++] = pb;
+		if (pb->flags & F_HASPOS)
+			bench_pos_pbufs[bench_pos_count++] = pb;
+	}
+
+	if (bench_pos_count == 0)
+		bench_fail("no packets with a position in the feed");
+}
+
+int bench_filter(void)
+{
+	struct client_t **clients;
+	int i, j, r, rc1, rc2, nclients = bench_opts.clients;
+	long matches = 0, prefiltered = 0;
+	double start;
+	uint32_t kinds;
+
+	bench_filter_setup();
+
+	clients = hmalloc(sizeof(*clients) * nclients);
+	for (i = 0; i < nclients; i++)
+		clients[i] = bench_client_create();
+
+	printf("%d packets (%d with position), %d clients\n", bench_pbuf_count, bench_pos_count, nclients);
+
+	/* check that the compiled program and the chains agree */
+	for (i = 0; i < bench_pbuf_count; i++) {
+		for (j = 0; j < nclients; j++) {
+			rc1 = bench_filter_process_chains(clients[j], bench_pbufs[i]);
+			rc2 = filter_process(NULL, clients[j], bench_pbufs[i]);
+			if (rc1 != rc2)
+				bench_fail("filter result mismatch: chains %d program %d, filter '%s' packet '%.*s'",
+					rc1, rc2, clients[j]->posuserfilters ? clients[j]->posuserfilters->h.text : "",
+					bench_pbufs[i]->packet_len - 2, bench_pbufs[i]->data);
+			if (rc2 > 0)
+				matches++;
+			if (!(clients[j]->filter_kinds & filter_packet_kinds(bench_pbufs[i]))) {
+				if (rc2 > 0)
+					bench_fail("prefilter dropped a match: filter '%s' packet '%.*s'",
+						clients[j]->posuserfilters ? clients[j]->posuserfilters->h.text : "",
+						bench_pbufs[i]->packet_len - 2, bench_pbufs[i]->data);
+				prefiltered++;
+			}
+		}
+	}
+
+	printf("results verified, %ld matches (%.2f%%), %.2f%% prefiltered\n", matches,
+		100.0 * matches / ((double)bench_pbuf_count * nclients),
+		100.0 * prefiltered / ((double)bench_pbuf_count * nclients));
+
+	for (r = 0; r < bench_opts.rounds; r++) {
+		start = bench_time();
+		for (i = 0; i < bench_pbuf_count; i++)
+			for (j = 0; j < nclients; j++)
+				bench_filter_process_chains(clients[j], bench_pbufs[i]);
+		bench_report("filter", "chains", (long)bench_pbuf_count * nclients, bench_time() - start);
+
+		start = bench_time();
+		for (i = 0; i < bench_pbuf_count; i++)
+			for (j = 0; j < nclients; j++)
+				filter_process(NULL, clients[j], bench_pbufs[i]);
+		bench_report("filter", "program", (long)bench_pbuf_count * nclients, bench_time() - start);
+
+		start = bench_time();
+		for (i = 0; i < bench_pbuf_count; i++) {
+			kinds = filter_packet_kinds(bench_pbufs[i]);
+			for (j = 0; j < nclients; j++)
+				if (clients[j]->filter_kinds & kinds)
+					filter_process(NULL, clients[j], bench_pbufs[i]);
+		}
+		bench_report("filter", "prefiltered", (long)bench_pbuf_count * nclients, bench_time() - start);
+	}
+
+	return 0;
+}
+
+/*
+ *	index: run the filters of all clients for every packet, like
+ *	process_outgoing_single() did before, vs. only the clients which
+ *	could not be indexed, and the ones in the packet's geoindex cell
+ *	and callindex entries.
+ */
+
+static struct geoindex_t *bench_gi;
+static struct callindex_t *bench_ci;
+static uint32_t bench_stamp;
+
+static long bench_index_scan_all(struct client_t **clients, int nclients)
+{
+	long matches = 0;
+	int i, j;
+
+	for (i = 0; i < bench_pbuf_count; i++)
+		for (j = 0; j < nclients; j++)
+			if (filter_process(NULL, clients[j], bench_pbufs[i]) > 0)
+				matches++;
+
+	return matches;
+}
+
+/* run the filters of the indexed clients which may match a packet,
+ * like process_outgoing_single() does
+ */
+static long bench_index_visit(struct pbuf_t *pb, struct client_t *want, long *visits)
+{
+	struct geoindex_cell_t *cell;
+	struct callindex_entry_t *entries[CALLINDEX_MAX_MATCHES];
+	struct client_t *c;
+	long matches = 0;
+	int i, j, n;
+
+	bench_stamp++;
+
+	if (pb->flags & F_HASPOS) {
+		cell = geoindex_lookup(bench_gi, pb->lat, pb->lng);
+		for (i = cell->count - 1; i >= 0; i--) {
+			c = cell->clients[i];
+			c->index_stamp = bench_stamp;
+			if (want) {
+				if (c == want)
+					return 1;
+				continue;
+			}
+			(*visits)++;
+			if (filter_process(NULL, c, pb) > 0)
+				matches++;
+		}
+	}
+
+	n = callindex_lookup(bench_ci, pb, entries);
+	for (j = 0; j < n; j++) {
+		for (i = entries[j]->count - 1; i >= 0; i--) {
+			c = entries[j]->clients[i];
+			if (c->index_stamp == bench_stamp)
+				continue;
+			c->index_stamp = bench_stamp;
+			if (want) {
+				if (c == want)
+					return 1;
+				continue;
+			}
+			(*visits)++;
+			if (filter_process(NULL, c, pb) > 0)
+				matches++;
+		}
+	}
+
+	return matches;
+}
+
+static long bench_index_scan_indexed(struct client_t **others, int nothers, long *visits)
+{
+	struct pbuf_t *pb;
+	long matches = 0;
+	int i, j;
+
+	for (i = 0; i < bench_pbuf_count; i++) {
+		pb = bench_pbufs[i];
+		for (j = 0; j < nothers; j++)
+			if (filter_process(NULL, others[j], pb) > 0)
+				matches++;
+		*visits += nothers;
+
+		matches += bench_index_visit(pb, NULL, visits);
+	}
+
+	return matches;
+}
+
+int bench_index(void)
+{
+	struct client_t **clients, **others;
+	struct pbuf_t *pb;
+	int i, j, r, nothers = 0, nclients = bench_opts.clients;
+	long m1, m2, visits = 0;
+	double start;
+
+	bench_filter_setup();
+
+	bench_gi = geoindex_alloc();
+	bench_ci = callindex_alloc();
+	clients = hmalloc(sizeof(*clients) * nclients);
+	others = hmalloc(sizeof(*others) * nclients);
+
+	for (i = 0; i < nclients; i++) {
+		clients[i] = bench_client_create();
+		if (geoindex_add(bench_gi, clients[i]) < 0)
+			others[nothers++] = clients[i];
+		else
+			callindex_add(bench_ci, clients[i]);
+	}
+
+	printf("%d packets (%d with position), %d clients, %d indexed: %d geo cells, %d with %d callsign entries\n",
+		bench_pbuf_count, bench_pos_count, nclients, bench_gi->clients, bench_gi->cells_used,
+		bench_ci->clients, bench_ci->entries);
+
+	/* every packet passed to an indexed client must find it through the indexes */
+	for (i = 0; i < bench_pbuf_count; i++) {
+		pb = bench_pbufs[i];
+		for (j = 0; j < nclients; j++) {
+			if (!clients[j]->geo_indexed || filter_process(NULL, clients[j], pb) < 1)
+				continue;
+			if (!bench_index_visit(pb, clients[j], NULL))
+				bench_fail("indexed client not found for a matching packet: filter '%s' packet '%.*s'",
+					clients[j]->posuserfilters ? clients[j]->posuserfilters->h.text : "",
+					pb->packet_len - 2, pb->data);
+		}
+	}
+
+	for (r = 0; r < bench_opts.rounds; r++) {
+		start = bench_time();
+		m1 = bench_index_scan_all(clients, nclients);
+		bench_report("index", "all", (long)bench_pbuf_count, bench_time() - start);
+
+		visits = 0;
+		start = bench_time();
+		m2 = bench_index_scan_indexed(others, nothers, &visits);
+		bench_report("index", "indexed", (long)bench_pbuf_count, bench_time() - start);
+
+		if (m1 != m2)
+			bench_fail("index match count mismatch: all %ld indexed %ld", m1, m2);
+	}
+
+	printf("filter runs per packet: %d all, %.1f indexed\n", nclients, (double)visits / bench_pbuf_count);
+
+	return 0;
+}
+
+/*
+ *	budlist: b/ filters of growing size, matched by scanning the
+ *	callsigns vs. using the hash of large callsign sets
+ */
+
+int bench_budlist(void)
+{
+	static const int sizes[] = { 4, 16, 64, 256, 1024, 4096 };
+	struct client_t *c;
+	struct filter_t *f;
+	struct filter_callhash_t *callhash;
+	char *s, *p, name[32];
+	int i, j, k, r, n, rc1, rc2;
+	long matches;
+	double start;
+
+	bench_filter_setup();
+
+	for (k = 0; k < sizeof(sizes) / sizeof(sizes[0]); k++) {
+		n = sizes[k];
+
+		/* mostly callsigns heard in the feed, some wildcards */
+		p = s = hmalloc(n * (CALLSIGNLEN_MAX + 2) + 3);
+		p += sprintf(p, "b");
+		for (i = 0; i < n; i++) {
+			struct pbuf_t *pb = bench_random_pbuf();
+			if (i % 64 == 63)
+				snprintf(name, sizeof(name), "%.*s*", (pb->srcname_len > 3) ? 3 : pb->srcname_len, pb->srcname);
+			else
+				snprintf(name, sizeof(name), "%.*s", pb->srcname_len, pb->srcname);
+			p += sprintf(p, "/%.*s", CALLSIGNLEN_MAX + 1, name);
+		}
+
+		c = hmalloc(sizeof(*c));
+		memset(c, 0, sizeof(*c));
+		c->flags = CLFLAGS_INPORT | CLFLAGS_USERFILTEROK;
+		if (filter_parse(c, s, 1) < 0)
+			bench_fail("filter_parse failed for budlist of %d", n);
+		hfree(s);
+
+		f = c->posuserfilters;
+		callhash = f->h.callhash;
+
+		/* check that the scan and the hash agree */
+		matches = 0;
+		for (i = 0; i < bench_pbuf_count; i++) {
+			f->h.callhash = NULL;
+			rc1 = filter_process(NULL, c, bench_pbufs[i]);
+			f->h.callhash = callhash;
+			rc2 = filter_process(NULL, c, bench_pbufs[i]);
+			if (rc1 != rc2)
+				bench_fail("budlist of %d: scan %d hash %d for packet '%.*s'",
+					n, rc1, rc2, bench_pbufs[i]->packet_len - 2, bench_pbufs[i]->data);
+			if (rc2 > 0)
+				matches++;
+		}
+
+		printf("budlist of %d: %s, %ld matches\n", f->h.numnames,
+			(callhash) ? "hashed" : "not hashed", matches);
+
+		for (r = 0; r < bench_opts.rounds; r++) {
+			snprintf(name, sizeof(name), "scan %d", n);
+			f->h.callhash = NULL;
+			start = bench_time();
+			for (j = 0; j < bench_pbuf_count; j++)
+				filter_process(NULL, c, bench_pbufs[j]);
+			bench_report("budlist", name, bench_pbuf_count, bench_time() - start);
+			f->h.callhash = callhash;
+
+			if (!callhash)
+				continue;
+
+			snprintf(name, sizeof(name), "hash %d", n);
+			start = bench_time();
+			for (j = 0; j < bench_pbuf_count; j++)
+				filter_process(NULL, c, bench_pbufs[j]);
+			bench_report("budlist", name, bench_pbuf_count, bench_time() - start);
+		}
+
+		filter_free(c->posuserfilters);
+		filter_prog_free(c);
+		hfree(c);
+	}
+
+	return 0;
+}
+
+/*
+ *	shared: most clients use one of a few popular filter strings,
+ *	run the filters of every client vs. sharing the verdict of
+ *	identical filters, like process_outgoing_single() does
+ */
+
+int bench_shared(void)
+{
+	struct client_t **clients;
+	struct worker_t *w;
+	char (*popular)[FILTER_S_SIZE * 5];
+	int i, j, r, rc1, rc2, npopular, nclients = bench_opts.clients;
+	double start;
+
+	bench_filter_setup();
+
+	/* every 20th client has filters of its own, the others
+	 * pick one of the popular ones
+	 */
+	npopular = (nclients / 20) ? nclients / 20 : 1;
+	popular = hmalloc(sizeof(*popular) * npopular);
+	for (i = 0; i < npopular; i++)
+		bench_client_filters(popular[i], sizeof(popular[i]));
+
+	w = hmalloc(sizeof(*w));
+	memset(w, 0, sizeof(*w));
+	w->filter_intern = filter_intern_alloc();
+
+	clients = hmalloc(sizeof(*clients) * nclients);
+	for (i = 0; i < nclients; i++) {
+		clients[i] = bench_client_alloc();
+		if (bench_rand() % 20 == 0) {
+			char s[FILTER_S_SIZE * 5];
+			bench_client_filters(s, sizeof(s));
+			bench_client_parse(clients[i], s);
+		} else {
+			bench_client_parse(clients[i], popular[bench_rand() % npopular]);
+		}
+		filter_intern(w->filter_intern, clients[i]);
+	}
+
+	printf("%d packets, %d clients, %d distinct filter sets (%.1f clients per set)\n",
+		bench_pbuf_count, nclients, w->filter_intern->entries,
+		(double)w->filter_intern->clients / w->filter_intern->entries);
+
+	/* check that the shared verdicts are right */
+	for (i = 0; i < bench_pbuf_count; i++) {
+		if (++w->packet_stamp == 0)
+			++w->packet_stamp;
+		for (j = 0; j < nclients; j++) {
+			rc1 = filter_process(NULL, clients[j], bench_pbufs[i]);
+			rc2 = filter_process(w, clients[j], bench_pbufs[i]);
+			if ((rc1 > 0) != (rc2 > 0))
+				bench_fail("shared filter result mismatch: own %d shared %d, filters '%s' packet '%.*s'",
+					rc1, rc2, clients[j]->filter_shared ? clients[j]->filter_shared->key : "(not shared)",
+					bench_pbufs[i]->packet_len - 2, bench_pbufs[i]->data);
+		}
+	}
+
+	printf("results verified, %lld of %ld verdicts shared\n", w->filter_shared_hits,
+		(long)bench_pbuf_count * nclients);
+
+	for (r = 0; r < bench_opts.rounds; r++) {
+		start = bench_time();
+		for (i = 0; i < bench_pbuf_count; i++)
+			for (j = 0; j < nclients; j++)
+				filter_process(NULL, clients[j], bench_pbufs[i]);
+		bench_report("shared", "each client", (long)bench_pbuf_count * nclients, bench_time() - start);
+
+		start = bench_time();
+		for (i = 0; i < bench_pbuf_count; i++) {
+			if (++w->packet_stamp == 0)
+				++w->packet_stamp;
+			for (j = 0; j < nclients; j++)
+				filter_process(w, clients[j], bench_pbufs[i]);
+		}
+		bench_report("shared", "shared verdicts", (long)bench_pbuf_count * nclients, bench_time() - start);
+	}
+
+	return 0;
+}
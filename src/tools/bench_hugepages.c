@@ -0,0 +1,201 @@
+/*
+ *	aprsc-bench
+ *
+ *	(c) Heikki Hannikainen, OH7LZB <hessu@hes.iki.fi>
+ *
+ *	This program is licensed under the BSD license, which can be found
+ *	in the file LICENSE.
+ *
+ */
+
+/*
+ *	bench_hugepages: the cell arenas on normal pages vs. huge pages
+ *
+ *	Each huge page mode is run in turn, on arenas made for it, and a
+ *	mode which is not available on this system (cellhugepages() falls
+ *	back from it) is skipped: hugetlb needs pages reserved with
+ *	vm.nr_hugepages, and transparent ones must not be turned off.
+ *
+ *	The fan-out walk goes through a large set of packet buffer cells
+ *	in the order a busy server would have them in the global queue,
+ *	after the arena has been churned for a while - all over the
+ *	arena - and reads the fields the outgoing filters look at for
+ *	each packet, like the workers do for each client. The dupecheck
+ *	probes read records at random in a large set of dupecheck slabs,
+ *	like the hash table lookups of the dupecheck thread do. Both are
+ *	mostly TLB misses on normal pages, once the set is larger than
+ *	the TLB reaches.
+ */
+
+#include <string.h>
+
+#include "cellmalloc.h"
+#include "hmalloc.h"
+#include "bench.h"
+
+#define BENCH_HUGE_MB		256	/* of cells in each test */
+#define BENCH_HUGE_PBUF		(sizeof(struct pbuf_t) + PACKETLEN_MAX_SMALL)
+#define BENCH_HUGE_SLAB		65536	/* the dupecheck slab size */
+#define BENCH_HUGE_RECORD	64	/* bytes read in a dupecheck probe */
+
+static const int bench_huge_modes[] = {
+	CELLMALLOC_HUGEPAGES_OFF,
+	CELLMALLOC_HUGEPAGES_THP,
+	CELLMALLOC_HUGEPAGES_HUGETLB
+};
+
+/* kB of anonymous memory on transparent huge pages */
+static long bench_huge_anon(void)
+{
+	FILE *fp;
+	char line[128];
+	long kb, total = 0;
+
+	if (!(fp = fopen("/proc/self/smaps_rollup", "r")))
+		return -1;
+
+	while (fgets(line, sizeof(line), fp))
+		if (sscanf(line, "AnonHugePages: %ld kB", &kb) == 1)
+			total += kb;
+	fclose(fp);
+
+	return total;
+}
+
+static void bench_huge_shuffle(void **cells, long n)
+{
+	void *t;
+	long i, j;
+
+	for (i = n - 1; i > 0; i--) {
+		j = ((long)bench_rand() << 16 ^ bench_rand()) % (i + 1);
+		t = cells[i];
+		cells[i] = cells[j];
+		cells[j] = t;
+	}
+}
+
+static double bench_huge_fanout(struct pbuf_t **pbs, long n, long ops, long *sum)
+{
+	struct pbuf_t *pb;
+	double start = bench_time();
+	long i, j = 0;
+
+	for (i = 0; i < ops; i++) {
+		pb = pbs[j];
+		if (++j == n)
+			j = 0;
+		*sum += pb->flags + pb->packet_len + pb->srcname_len + pb->data[0];
+		if (pb->t > 0 && pb->lat > 0.0)
+			*sum += (long)(pb->lat * pb->lng);
+	}
+
+	return bench_time() - start;
+}
+
+static double bench_huge_probe(char **slabs, long n, long ops, long *sum)
+{
+	double start = bench_time();
+	unsigned int x = bench_opts.seed | 1;
+	const char *rec;
+	long i;
+
+	for (i = 0; i < ops; i++) {
+		/* xorshift, the probes are random like the hashes are */
+		x ^= x << 13;
+		x ^= x >> 17;
+		x ^= x << 5;
+		rec = slabs[x % n] + (x >> 8) % (BENCH_HUGE_SLAB / BENCH_HUGE_RECORD) * BENCH_HUGE_RECORD;
+		*sum += *(const long *)rec + rec[BENCH_HUGE_RECORD - 1];
+	}
+
+	return bench_time() - start;
+}
+
+static void bench_huge_run(int mode, time_t *t)
+{
+	const char *name = cellhugepages_name(mode);
+	cellarena_t *pbuf_cells, *slab_cells;
+	struct pbuf_t **pbs, *pb;
+	char **slabs;
+	long pbuf_count = BENCH_HUGE_MB * 1024L * 1024L / BENCH_HUGE_PBUF;
+	long slab_count = BENCH_HUGE_MB * 1024L * 1024L / BENCH_HUGE_SLAB;
+	long ops = bench_opts.packets * 40L, sum = 0, anon;
+	char variant[64];
+	int r;
+	long i;
+
+	if (cellhugepages(mode) != mode) {
+		printf("huge pages: %s not available, skipped\n", name);
+		return;
+	}
+
+	anon = bench_huge_anon();
+
+	pbuf_cells = cellinit("pbuf huge", BENCH_HUGE_PBUF, __alignof__(struct pbuf_t),
+		CELLMALLOC_POLICY_FIFO | CELLMALLOC_POLICY_HUGEPAGES, 2048, 0);
+	slab_cells = cellinit("slab huge", BENCH_HUGE_SLAB, 16,
+		CELLMALLOC_POLICY_FIFO | CELLMALLOC_POLICY_HUGEPAGES, 2048, 0);
+
+	pbs = hmalloc(sizeof(*pbs) * pbuf_count);
+	slabs = hmalloc(sizeof(*slabs) * slab_count);
+
+	if (cellmallocmany(pbuf_cells, (void **)pbs, pbuf_count) != pbuf_count)
+		bench_fail("%s: could not allocate %ld packet buffers", name, pbuf_count);
+	for (i = 0; i < pbuf_count; i++) {
+		pb = pbs[i];
+		memset(pb, 0, sizeof(*pb));
+		pb->t = tick;
+		pb->flags = F_FROM_DOWNSTR;
+		pb->packet_len = i % PACKETLEN_MAX_SMALL;
+		pb->srcname_len = i % CALLSIGNLEN_MAX;
+		pb->lat = pb->lng = 0.5;
+		pb->data[0] = 'O';
+	}
+	bench_huge_shuffle((void **)pbs, pbuf_count);
+
+	if (cellmallocmany(slab_cells, (void **)slabs, slab_count) != slab_count)
+		bench_fail("%s: could not allocate %ld slabs", name, slab_count);
+	for (i = 0; i < slab_count; i++)
+		memset(slabs[i], i, BENCH_HUGE_SLAB);
+
+	if (anon >= 0)
+		printf("huge pages: %s, %ld MB of transparent huge pages in the arenas\n", name,
+			(bench_huge_anon() - anon) / 1024);
+
+	for (r = 0; r < bench_opts.rounds; r++) {
+		snprintf(variant, sizeof(variant), "fan-out walk, %s", name);
+		bench_report("hugepages", variant, ops, bench_huge_fanout(pbs, pbuf_count, ops, &sum));
+		snprintf(variant, sizeof(variant), "dupecheck probes, %s", name);
+		bench_report("hugepages", variant, ops, bench_huge_probe(slabs, slab_count, ops, &sum));
+	}
+
+	if (!sum)
+		bench_fail("%s: nothing was read", name);
+
+	/* the arenas stay around, but give their memory back */
+	cellfreemany(pbuf_cells, (void **)pbs, pbuf_count);
+	cellfreemany(slab_cells, (void **)slabs, slab_count);
+	for (r = 0; r < 2; r++) {
+		*t += 100;
+		celltrim(pbuf_cells, *t, 0);
+		celltrim(slab_cells, *t, 0);
+	}
+
+	hfree(pbs);
+	hfree(slabs);
+}
+
+int bench_hugepages(void)
+{
+	time_t t = 0;
+	int i;
+
+	for (i = 0; i < (int)(sizeof(bench_huge_modes) / sizeof(bench_huge_modes[0])); i++)
+		bench_huge_run(bench_huge_modes[i], &t);
+
+	/* back to what the command line asked for */
+	cellhugepages(bench_opts.hugepages);
+
+	return 0;
+}
@@ -0,0 +1,362 @@
+/*
+ *	aprsc-bench
+ *
+ *	(c) Heikki Hannikainen, OH7LZB <hessu@hes.iki.fi>
+ *
+ *	This program is licensed under the BSD license, which can be found
+ *	in the file LICENSE.
+ *
+ */
+
+/*
+ *	bench_inbox: the handoff of packets from the workers to the
+ *	dupecheck thread
+ *
+ *	Producer threads put batches of packets in, like the workers do
+ *	in incoming_flush(), and a consumer thread drains them, like the
+ *	dupecheck thread. The consumer gives the packets back to their
+ *	producers through an inbox of their own, so the packets are
+ *	reused all the time. The consumer checks that it gets all of the
+ *	packets of every producer, in order.
+ *
+ *	The stress test puts all of the producers in a single inbox,
+ *	and stalls them randomly. The throughput test compares the mutex
+ *	and pthread_mutex_trylock() the handoff used to be with the inbox,
+ *	and counts the flushes which had to be deferred to the next batch
+ *	because the lock was taken, and the latency from queueing a packet
+ *	to the consumer taking it.
+ */
+
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+#include "pbufring.h"
+#include "latency.h"
+#include "hmalloc.h"
+#include "bench.h"
+
+#define BENCH_INBOX_PRODUCERS_MAX	16
+#define BENCH_INBOX_BATCH		16
+#define BENCH_INBOX_POOL		1024	/* packets of a producer */
+
+struct bench_inbox_producer_t {
+	pthread_t th;
+	struct bench_inbox_run_t *run;
+	int id;
+	unsigned int rand_state;
+	struct pbuf_t *mem;
+
+	struct pbuf_t *pool;		/* free packets, producer only */
+	struct pbuf_inbox_t returned;	/* packets given back by the consumer */
+
+	/* the old handoff */
+	pthread_mutex_t mutex;
+	struct pbuf_t *incoming;
+	struct pbuf_t **incoming_last;
+	long deferred;
+
+	/* the new one */
+	struct pbuf_inbox_t inbox;
+
+	uint32_t expect;		/* consumer: seqnum of the next packet */
+	long got;
+} __attribute__((aligned(64)));
+
+struct bench_inbox_run_t {
+	int mutex;		/* 1: mutex and trylock, 0: inbox */
+	int shared;		/* all producers put in the inbox of the first one */
+	int stall;		/* producers stall every now and then */
+	int producers;
+	long packets;		/* per producer */
+
+	struct latency_hist_t latency;
+	struct bench_inbox_producer_t prod[BENCH_INBOX_PRODUCERS_MAX];
+};
+
+static unsigned int bench_inbox_rand(unsigned int *state)
+{
+	unsigned int x = *state;
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+
+	return *state = x;
+}
+
+/* the mutex is held by the consumer for as long as it takes to grab the list */
+static int bench_inbox_flush_mutex(struct bench_inbox_producer_t *p, struct pbuf_t *oldest, struct pbuf_t **lastp)
+{
+	if (pthread_mutex_trylock(&p->mutex) != 0)
+		return 0;
+
+	*p->incoming_last = oldest;
+	p->incoming_last = lastp;
+	pthread_mutex_unlock(&p->mutex);
+
+	return 1;
+}
+
+static void *bench_inbox_producer(void *arg)
+{
+	struct bench_inbox_producer_t *p = arg;
+	struct bench_inbox_run_t *run = p->run;
+	struct pbuf_inbox_t *inbox = (run->shared) ? &run->prod[0].inbox : &p->inbox;
+	struct pbuf_t *pb, *newest = NULL, *oldest = NULL, **lastp = &oldest;
+	uint32_t seq = -1000; /* wraps around */
+	long made = 0;
+	int i, n, returned, count = 0;
+
+	while (made < run->packets) {
+		n = (run->stall) ? 1 + bench_inbox_rand(&p->rand_state) % (BENCH_INBOX_BATCH * 2) : BENCH_INBOX_BATCH;
+		for (i = 0; i < n && made < run->packets; i++) {
+			/* out of packets: flush what there is, and wait for the consumer */
+			if (!p->pool && !(p->pool = pbuf_inbox_take(&p->returned, &returned)))
+				break;
+			pb = p->pool;
+			p->pool = pb->next;
+
+			pb->origin = p->id;
+			pb->seqnum = seq++;
+			pb->queued = latency_now();
+			made++;
+
+			/* the old handoff appends, the inbox wants the newest first */
+			if (run->mutex) {
+				pb->next = NULL;
+				*lastp = pb;
+				lastp = &pb->next;
+			} else {
+				pb->next = newest;
+				if (!newest)
+					oldest = pb;
+				newest = pb;
+			}
+			count++;
+		}
+
+		if (!i)
+			sched_yield();
+
+		if (run->mutex) {
+			if (!oldest) {
+				/* nothing to flush */
+			} else if (bench_inbox_flush_mutex(p, oldest, lastp)) {
+				oldest = NULL;
+				lastp = &oldest;
+			} else {
+				p->deferred++;
+			}
+		} else if (newest) {
+			pbuf_inbox_put(inbox, newest, oldest, count);
+			newest = oldest = NULL;
+		}
+		count = 0;
+
+		if (run->stall && bench_inbox_rand(&p->rand_state) % 64 == 0) {
+			if (p->rand_state & 1)
+				sched_yield();
+			else
+				usleep(p->rand_state % 200);
+		}
+	}
+
+	/* the last ones must get there, the worker would retry on the next round */
+	while (run->mutex && oldest) {
+		if (bench_inbox_flush_mutex(p, oldest, lastp))
+			break;
+		p->deferred++;
+		sched_yield();
+	}
+
+	return NULL;
+}
+
+static struct pbuf_t *bench_inbox_take(struct bench_inbox_run_t *run, struct bench_inbox_producer_t *p)
+{
+	struct pbuf_t *list;
+	int count;
+
+	if (!run->mutex)
+		return pbuf_inbox_take(&p->inbox, &count);
+
+	if (!__atomic_load_n(&p->incoming, __ATOMIC_RELAXED))
+		return NULL;
+
+	pthread_mutex_lock(&p->mutex);
+	list = p->incoming;
+	p->incoming = NULL;
+	p->incoming_last = &p->incoming;
+	pthread_mutex_unlock(&p->mutex);
+
+	return list;
+}
+
+/* check the packets, and give them back to their producers */
+static long bench_inbox_consume(struct bench_inbox_run_t *run, struct pbuf_t *list)
+{
+	struct pbuf_t *pb, *next;
+	struct pbuf_t *back[BENCH_INBOX_PRODUCERS_MAX], *back_oldest[BENCH_INBOX_PRODUCERS_MAX];
+	int back_count[BENCH_INBOX_PRODUCERS_MAX];
+	struct bench_inbox_producer_t *p;
+	uint64_t now = latency_now();
+	long n = 0;
+	int i;
+
+	memset(back, 0, sizeof(back));
+	memset(back_count, 0, sizeof(back_count));
+
+	for (pb = list; (pb); pb = next) {
+		next = pb->next;
+		if (pb->origin >= (uint32_t)run->producers)
+			bench_fail("packet from an unknown producer %u", pb->origin);
+		p = &run->prod[pb->origin];
+		if ((uint32_t)pb->seqnum != p->expect)
+			bench_fail("producer %d: expected packet %u, got %u", p->id, p->expect, (uint32_t)pb->seqnum);
+		p->expect++;
+		p->got++;
+		latency_add(&run->latency, now - pb->queued);
+
+		pb->next = back[pb->origin];
+		if (!back[pb->origin])
+			back_oldest[pb->origin] = pb;
+		back[pb->origin] = pb;
+		back_count[pb->origin]++;
+		n++;
+	}
+
+	for (i = 0; i < run->producers; i++)
+		if (back[i])
+			pbuf_inbox_put(&run->prod[i].returned, back[i], back_oldest[i], back_count[i]);
+
+	return n;
+}
+
+/*
+ *	Run the producers in threads of their own, and the consumer in
+ *	this thread. Returns the time it took for the consumer to get all
+ *	of the packets.
+ */
+
+static double bench_inbox_run(struct bench_inbox_run_t *run, unsigned int seed)
+{
+	struct bench_inbox_producer_t *p;
+	long total = run->packets * run->producers, got = 0;
+	double start;
+	int i, j;
+
+	memset(&run->latency, 0, sizeof(run->latency));
+
+	for (i = 0; i < run->producers; i++) {
+		p = &run->prod[i];
+		memset(p, 0, sizeof(*p));
+		p->run = run;
+		p->id = i;
+		p->rand_state = seed + i * 7919 + 1;
+		p->expect = -1000;
+		pthread_mutex_init(&p->mutex, NULL);
+		p->incoming_last = &p->incoming;
+
+		p->mem = hmalloc(sizeof(*p->mem) * BENCH_INBOX_POOL);
+		memset(p->mem, 0, sizeof(*p->mem) * BENCH_INBOX_POOL);
+		for (j = 0; j < BENCH_INBOX_POOL; j++) {
+			p->mem[j].next = p->pool;
+			p->pool = &p->mem[j];
+		}
+	}
+
+	start = bench_time();
+
+	for (i = 0; i < run->producers; i++)
+		if (pthread_create(&run->prod[i].th, NULL, bench_inbox_producer, &run->prod[i]))
+			bench_fail("pthread_create failed");
+
+	while (got < total) {
+		for (i = j = 0; i < run->producers; i++) {
+			struct pbuf_t *list = bench_inbox_take(run, &run->prod[i]);
+			if (list) {
+				got += bench_inbox_consume(run, list);
+				j++;
+			}
+		}
+		if (!j)
+			sched_yield();
+	}
+
+	start = bench_time() - start;
+
+	for (i = 0; i < run->producers; i++)
+		pthread_join(run->prod[i].th, NULL);
+
+	for (i = 0; i < run->producers; i++) {
+		p = &run->prod[i];
+		if (p->got != run->packets)
+			bench_fail("producer %d: got %ld packets, expected %ld", i, p->got, run->packets);
+		if (p->inbox.count || p->inbox.head)
+			bench_fail("producer %d: %d packets left in the inbox", i, p->inbox.count);
+		pthread_mutex_destroy(&p->mutex);
+		hfree(p->mem);
+	}
+
+	return start;
+}
+
+static void bench_inbox_print(struct bench_inbox_run_t *run, const char *name)
+{
+	long deferred = 0;
+	int i;
+
+	for (i = 0; i < run->producers; i++)
+		deferred += run->prod[i].deferred;
+
+	printf("%-40s deferred flushes %ld, latency us: p50 %u p99 %u p99.9 %u max %u\n",
+		name, deferred, latency_percentile(&run->latency, 50), latency_percentile(&run->latency, 99),
+		latency_percentile(&run->latency, 99.9), run->latency.max);
+}
+
+int bench_inbox(void)
+{
+	struct bench_inbox_run_t *run;
+	char name[64];
+	double secs;
+	int r, n;
+
+	run = hmalloc(sizeof(*run));
+	memset(run, 0, sizeof(*run));
+
+	/* stress: all producers in a single inbox, stalling */
+	run->mutex = 0;
+	run->shared = 1;
+	run->stall = 1;
+	run->producers = BENCH_INBOX_PRODUCERS_MAX;
+	run->packets = bench_opts.packets / 4;
+	secs = bench_inbox_run(run, bench_opts.seed);
+	printf("stress test passed: %d producers, %ld packets through a single inbox, %.3f s\n",
+		run->producers, run->packets * run->producers, secs);
+
+	/* throughput, without stalls */
+	run->shared = 0;
+	run->stall = 0;
+	for (r = 0; r < bench_opts.rounds; r++) {
+		for (n = 1; n <= BENCH_INBOX_PRODUCERS_MAX; n *= 4) {
+			run->producers = n;
+			run->packets = bench_opts.packets * 10L / n;
+
+			run->mutex = 1;
+			snprintf(name, sizeof(name), "mutex, %d workers", n);
+			bench_report("inbox", name, run->packets * n, bench_inbox_run(run, bench_opts.seed));
+			bench_inbox_print(run, name);
+
+			run->mutex = 0;
+			snprintf(name, sizeof(name), "inbox, %d workers", n);
+			bench_report("inbox", name, run->packets * n, bench_inbox_run(run, bench_opts.seed));
+			bench_inbox_print(run, name);
+		}
+	}
+
+	hfree(run);
+
+	return 0;
+}
@@ -0,0 +1,199 @@
+/*
+ *	aprsc-bench
+ *
+ *	(c) Heikki Hannikainen, OH7LZB <hessu@hes.iki.fi>
+ *
+ *	This program is licensed under the BSD license, which can be found
+ *	in the file LICENSE.
+ *
+ */
+
+/*
+ *	bench_keyhash: the hash of the hash tables, 8 bytes at a time, vs.
+ *	the FNV-1a a byte at a time
+ *
+ *	keyhashuc() must give the same hash as keyhash() of the key in
+ *	upper case, for keys of any length and with any bytes in them, and
+ *	a new seed must give different hashes. The hashes of a million
+ *	callsigns must not collide much more than random numbers would,
+ *	in 32 bits or in the low bits used to pick a hash table bucket.
+ *	The speed is measured on callsigns, and on the packets of the feed.
+ */
+
+#include <string.h>
+#include <ctype.h>
+
+#include "keyhash.h"
+#include "hmalloc.h"
+#include "bench.h"
+
+#define BENCH_KEYHASH_FUZZ	200000
+#define BENCH_KEYHASH_CALLS	1000000
+#define BENCH_KEYHASH_BITS	16	/* buckets for the distribution check */
+#define BENCH_KEYHASH_SEEDED	1000	/* keys hashed again with a new seed */
+
+typedef uint32_t (*bench_keyhash_fn)(const void *s, int len, uint32_t hash0);
+
+static const struct {
+	const char *name;
+	bench_keyhash_fn fn;
+} bench_keyhashes[] = {
+	{ "fnv", keyhash_fnv },
+	{ "fnv uc", keyhashuc_fnv },
+	{ "keyhash", keyhash },
+	{ "keyhash uc", keyhashuc },
+};
+#define BENCH_KEYHASHES (sizeof(bench_keyhashes) / sizeof(bench_keyhashes[0]))
+
+static void bench_keyhash_fuzz(void)
+{
+	char buf[300], uc[300];
+	int i, j, len;
+
+	for (i = 0; i < BENCH_KEYHASH_FUZZ; i++) {
+		len = bench_rand() % sizeof(buf);
+		for (j = 0; j < len; j++) {
+			/* letters mostly, and the ones around them */
+			switch (bench_rand() % 4) {
+			case 0: buf[j] = bench_rand(); break;
+			case 1: buf[j] = 'a' - 2 + bench_rand() % 4; break;
+			case 2: buf[j] = 'z' - 1 + bench_rand() % 4; break;
+			default: buf[j] = 'A' + bench_rand() % 58; break;
+			}
+			uc[j] = (buf[j] >= 'a' && buf[j] <= 'z') ? buf[j] - 'a' + 'A' : buf[j];
+		}
+		if (keyhashuc(buf, len, 0) != keyhash(uc, len, 0))
+			bench_fail("keyhashuc differs from keyhash of the key in upper case, %d bytes", len);
+		if (keyhashuc_fnv(buf, len, 0) != keyhash_fnv(uc, len, 0))
+			bench_fail("keyhashuc_fnv differs from keyhash_fnv of the key in upper case, %d bytes", len);
+	}
+
+	printf("keyhashuc matches keyhash of the key in upper case on %d fuzzed keys\n", BENCH_KEYHASH_FUZZ);
+}
+
+static int bench_keyhash_cmp(const void *a, const void *b)
+{
+	uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+
+	return (x > y) - (x < y);
+}
+
+/*
+ *	Count the hashes which are the same as some other one, and the
+ *	most keys in a bucket, picked with the low bits
+ */
+
+static void bench_keyhash_quality(const char *name, bench_keyhash_fn fn, char (*calls)[CALLSIGNLEN_MAX+1])
+{
+	uint32_t *h = hmalloc(sizeof(*h) * BENCH_KEYHASH_CALLS);
+	int *buckets = hmalloc(sizeof(*buckets) * (1 << BENCH_KEYHASH_BITS));
+	double expected, chi = 0;
+	long collisions = 0;
+	int i, max = 0;
+
+	memset(buckets, 0, sizeof(*buckets) * (1 << BENCH_KEYHASH_BITS));
+	for (i = 0; i < BENCH_KEYHASH_CALLS; i++) {
+		h[i] = fn(calls[i], strlen(calls[i]), 0);
+		if (++buckets[h[i] & ((1 << BENCH_KEYHASH_BITS) - 1)] > max)
+			max = buckets[h[i] & ((1 << BENCH_KEYHASH_BITS) - 1)];
+	}
+
+	expected = (double)BENCH_KEYHASH_CALLS / (1 << BENCH_KEYHASH_BITS);
+	for (i = 0; i < (1 << BENCH_KEYHASH_BITS); i++)
+		chi += (buckets[i] - expected) * (buckets[i] - expected) / expected;
+
+	qsort(h, BENCH_KEYHASH_CALLS, sizeof(*h), bench_keyhash_cmp);
+	for (i = 1; i < BENCH_KEYHASH_CALLS; i++)
+		collisions += (h[i] == h[i-1]);
+
+	/* random 32-bit numbers would have n^2 / 2^33 collisions, and
+	 * the chi-square would be about the number of buckets
+	 */
+	printf("%-12s %d callsigns: %ld 32-bit collisions (random: %.0f), %d buckets: up to %d in one (average %.1f), chi-square %.0f\n",
+		name, BENCH_KEYHASH_CALLS, collisions, (double)BENCH_KEYHASH_CALLS * BENCH_KEYHASH_CALLS / 8589934592.0,
+		1 << BENCH_KEYHASH_BITS, max, expected, chi);
+
+	if (fn == keyhash || fn == keyhashuc) {
+		if (collisions > 4 * (double)BENCH_KEYHASH_CALLS * BENCH_KEYHASH_CALLS / 8589934592.0)
+			bench_fail("%s: too many collisions", name);
+		if (chi > 1.2 * (1 << BENCH_KEYHASH_BITS))
+			bench_fail("%s: the low bits are not evenly distributed", name);
+	}
+
+	hfree(h);
+	hfree(buckets);
+}
+
+static double bench_keyhash_run(bench_keyhash_fn fn, char **keys, int *lens, int count, int loops, uint32_t *sum)
+{
+	double start = bench_time();
+	uint32_t s = 0;
+	int i, j;
+
+	for (j = 0; j < loops; j++)
+		for (i = 0; i < count; i++)
+			s += fn(keys[i], lens[i], 0);
+
+	*sum = s;
+
+	return bench_time() - start;
+}
+
+int bench_keyhash(void)
+{
+	static char calls[BENCH_KEYHASH_CALLS][CALLSIGNLEN_MAX+1];
+	struct bench_feed_t *feed = bench_feed_get();
+	char **keys;
+	int *lens;
+	char name[64];
+	uint32_t seeded[BENCH_KEYHASH_SEEDED];
+	uint32_t sum;
+	int i, r, n, changed;
+
+	bench_keyhash_fuzz();
+
+	/* callsigns with a prefix, a number, a suffix and an SSID */
+	for (i = 0; i < BENCH_KEYHASH_CALLS; i++)
+		snprintf(calls[i], sizeof(calls[i]), "%c%c%d%c%c%c-%d",
+			'A' + i % 26, 'A' + (i / 26) % 26, (i / 676) % 10,
+			'A' + (i / 6760) % 26, 'A' + (i / 175760) % 26, (i % 3) ? 'A' + (i / 7) % 26 : 'X',
+			(i / 4569760) % 16);
+	for (i = 0; i < (int)BENCH_KEYHASHES; i++)
+		bench_keyhash_quality(bench_keyhashes[i].name, bench_keyhashes[i].fn, calls);
+
+	/* a new seed gives different hashes */
+	for (i = 0; i < BENCH_KEYHASH_SEEDED; i++)
+		seeded[i] = keyhash(calls[i], strlen(calls[i]), 0);
+	keyhash_init();
+	for (i = changed = 0; i < BENCH_KEYHASH_SEEDED; i++)
+		changed += (keyhash(calls[i], strlen(calls[i]), 0) != seeded[i]);
+	if (changed < BENCH_KEYHASH_SEEDED - 1)
+		bench_fail("keyhash does not change with the seed: %d of %d changed", changed, BENCH_KEYHASH_SEEDED);
+
+	keys = hmalloc(sizeof(*keys) * BENCH_KEYHASH_CALLS);
+	lens = hmalloc(sizeof(*lens) * BENCH_KEYHASH_CALLS);
+
+	for (r = 0; r < bench_opts.rounds; r++) {
+		n = BENCH_KEYHASH_CALLS;
+		for (i = 0; i < n; i++) {
+			keys[i] = calls[i];
+			lens[i] = strlen(calls[i]);
+		}
+		for (i = 0; i < (int)BENCH_KEYHASHES; i++) {
+			snprintf(name, sizeof(name), "callsigns, %s", bench_keyhashes[i].name);
+			bench_report("keyhash", name, n, bench_keyhash_run(bench_keyhashes[i].fn, keys, lens, n, 1, &sum));
+		}
+
+		n = feed->count;
+		for (i = 0; i < (int)BENCH_KEYHASHES; i++) {
+			snprintf(name, sizeof(name), "packets, %s", bench_keyhashes[i].name);
+			bench_report("keyhash", name, n * 10L,
+				bench_keyhash_run(bench_keyhashes[i].fn, feed->lines, feed->lens, n, 10, &sum));
+		}
+	}
+
+	hfree(keys);
+	hfree(lens);
+
+	return 0;
+}
@@ -0,0 +1,202 @@
+/*
+ *	aprsc-bench
+ *
+ *	(c) Heikki Hannikainen, OH7LZB <hessu@hes.iki.fi>
+ *
+ *	This program is licensed under the BSD license, which can be found
+ *	in the file LICENSE.
+ *
+ */
+
+/*
+ *	bench_range: the range filter distance check, and the batch kernels
+ *
+ *	Every batch kernel must give exactly the same result as
+ *	range_within() for every centre, and range_within() must agree
+ *	with the haversine distance the range filters used to calculate,
+ *	except for points within a few metres of the edge of the range.
+ */
+
+#include <string.h>
+#include <math.h>
+
+#include "range.h"
+#include "filter.h"
+#include "hmalloc.h"
+#include "bench.h"
+
+#define BENCH_RANGE_CENTRES	1024
+#define BENCH_RANGE_EDGE_KM	0.01	/* allowed disagreement with the old formula */
+#define BENCH_KM_PER_RAD	(111.2 * 180.0 / M_PI)
+
+/* the distance calculation the range filters used before range.c */
+static float bench_km_distance(float lat1, float coslat1, float lon1, float lat2, float coslat2, float lon2)
+{
+	float sindlat2 = sinf((lat1 - lat2) * 0.5);
+	float sindlon2 = sinf((lon1 - lon2) * 0.5);
+
+	float a = (sindlat2 * sindlat2 +
+		   coslat1 * coslat2 * sindlon2 * sindlon2);
+
+	float c = 2.0 * atan2f( sqrtf(a), sqrtf(1.0 - a));
+
+	return ((111.2 * 180.0 / M_PI) * c);
+}
+
+struct bench_point_t {
+	float lat, lng, coslat;
+	struct range_point_t pt;
+};
+
+static void bench_point_set(struct bench_point_t *p, float lat, float lng)
+{
+	p->lat = lat;
+	p->lng = lng;
+	p->coslat = cosf(lat);
+	range_point_set(&p->pt, p->lat, p->lng, p->coslat);
+}
+
+/* a random point on the sphere, including the poles and the date line */
+static void bench_point_random(struct bench_point_t *p)
+{
+	bench_point_set(p, asin(bench_rand_range(-1, 1)), bench_rand_range(-M_PI, M_PI));
+}
+
+/* a point at a distance from another, in a random direction */
+static void bench_point_at(struct bench_point_t *p, const struct bench_point_t *from, double km)
+{
+	double d = km / BENCH_KM_PER_RAD;
+	double b = bench_rand_range(-M_PI, M_PI);
+	double lat, lng;
+
+	lat = asin(sin(from->lat) * cos(d) + cos(from->lat) * sin(d) * cos(b));
+	lng = from->lng + atan2(sin(b) * sin(d) * cos(from->lat), cos(d) - sin(from->lat) * sin(lat));
+	if (lng > M_PI)
+		lng -= 2 * M_PI;
+	if (lng < -M_PI)
+		lng += 2 * M_PI;
+
+	bench_point_set(p, lat, lng);
+}
+
+int bench_range(void)
+{
+	struct bench_feed_t *feed;
+	struct bench_point_t *points, *centres;
+	struct range_set_t rs;
+	const struct range_kernel_t *k;
+	struct pbuf_t *pb;
+	float *dists, *limits;
+	uint32_t bits[RANGE_BITS_WORDS(BENCH_RANGE_CENTRES)];
+	int i, j, r, n, npoints = 0, hits = 0, edge = 0;
+	long ops;
+	double start, km;
+	char name[64];
+	volatile int sink = 0;
+
+	range_init();
+	feed = bench_feed_get();
+
+	/* packet positions from the feed, and random ones */
+	points = hmalloc(sizeof(*points) * feed->count * 2);
+	for (i = 0; i < feed->count; i++) {
+		pb = bench_pbuf_parse(feed->lines[i], feed->lens[i]);
+		if (!pb)
+			continue;
+		if (pb->flags & F_HASPOS)
+			bench_point_set(&points[npoints++], pb->lat, pb->lng);
+		bench_pbuf_free(pb);
+		bench_point_random(&points[npoints++]);
+	}
+
+	/* centres near the packets, with ranges from 0.1 km to around the
+	 * world, and a few which are just at the edge of some packet
+	 */
+	centres = hmalloc(sizeof(*centres) * BENCH_RANGE_CENTRES);
+	dists = hmalloc(sizeof(*dists) * BENCH_RANGE_CENTRES);
+	limits = hmalloc(sizeof(*limits) * BENCH_RANGE_CENTRES);
+	range_set_init(&rs, BENCH_RANGE_CENTRES);
+	for (i = 0; i < BENCH_RANGE_CENTRES; i++) {
+		dists[i] = exp(bench_rand_range(log(0.1), log(25000)));
+		if (i % 8 == 0)
+			bench_point_at(&centres[i], &points[bench_rand() % npoints], dists[i]);
+		else if (i % 2)
+			bench_point_random(&centres[i]);
+		else
+			bench_point_at(&centres[i], &points[bench_rand() % npoints], bench_rand_range(0, dists[i] * 2));
+		limits[i] = range_limit(dists[i]);
+		range_set_put(&rs, i, &centres[i].pt, limits[i]);
+	}
+
+	printf("%d points, %d centres, kernels:", npoints, BENCH_RANGE_CENTRES);
+	for (k = range_kernels(); k->name; k++)
+		printf(" %s", k->name);
+	printf(" (using %s)\n", range_kernel->name);
+
+	/* range_within() vs. the old distance, and every kernel vs. range_within() */
+	for (i = 0; i < npoints; i++) {
+		for (j = 0; j < BENCH_RANGE_CENTRES; j++) {
+			n = range_within(&centres[j].pt, limits[j], &points[i].pt);
+			hits += n;
+			km = bench_km_distance(centres[j].lat, centres[j].coslat, centres[j].lng,
+				points[i].lat, points[i].coslat, points[i].lng);
+			if (n != (km < dists[j])) {
+				edge++;
+				if (fabs(km - dists[j]) > BENCH_RANGE_EDGE_KM)
+					bench_fail("range_within %d for distance %.4f km, range %.4f km", n, km, dists[j]);
+			}
+		}
+
+		for (k = range_kernels(); k->name; k++) {
+			k->hits(&rs, &points[i].pt, bits);
+			for (j = 0; j < BENCH_RANGE_CENTRES; j++) {
+				n = (bits[j >> 5] >> (j & 31)) & 1;
+				if (n != range_within(&centres[j].pt, limits[j], &points[i].pt))
+					bench_fail("%s kernel result %d differs from range_within for centre %d point %d",
+						k->name, n, j, i);
+			}
+		}
+	}
+
+	printf("results verified, %.2f%% within range, %d at the edge differ from the old distance\n",
+		100.0 * hits / ((double)npoints * BENCH_RANGE_CENTRES), edge);
+
+	/* a client with a few range filters, and many of them */
+	ops = (long)npoints * BENCH_RANGE_CENTRES;
+	for (r = 0; r < bench_opts.rounds; r++) {
+		start = bench_time();
+		for (i = 0; i < npoints; i++)
+			for (j = 0; j < BENCH_RANGE_CENTRES; j++)
+				sink += bench_km_distance(centres[j].lat, centres[j].coslat, centres[j].lng,
+					points[i].lat, points[i].coslat, points[i].lng) < dists[j];
+		bench_report("range", "old distance", ops, bench_time() - start);
+
+		start = bench_time();
+		for (i = 0; i < npoints; i++)
+			for (j = 0; j < BENCH_RANGE_CENTRES; j++)
+				sink += range_within(&centres[j].pt, limits[j], &points[i].pt);
+		bench_report("range", "range_within", ops, bench_time() - start);
+
+		for (n = 8; n <= BENCH_RANGE_CENTRES; n *= 16) {
+			rs.count = n;
+			rs.size = n;
+			for (k = range_kernels(); k->name; k++) {
+				snprintf(name, sizeof(name), "%s set of %d", k->name, n);
+				start = bench_time();
+				for (j = 0; j < BENCH_RANGE_CENTRES / n; j++)
+					for (i = 0; i < npoints; i++)
+						k->hits(&rs, &points[i].pt, bits);
+				bench_report("range", name, ops, bench_time() - start);
+			}
+		}
+		rs.count = rs.size = BENCH_RANGE_CENTRES;
+	}
+
+	range_set_free(&rs);
+	hfree(centres);
+	hfree(dists);
+	hfree(limits);
+	hfree(points);
+
+	return 0;
+}
@@ -0,0 +1,351 @@
+/*
+ *	aprsc-bench
+ *
+ *	(c) Heikki Hannikainen, OH7LZB <hessu@hes.iki.fi>
+ *
+ *	This program is licensed under the BSD license, which can be found
+ *	in the file LICENSE.
+ *
+ */
+
+/*
+ *	bench_ring: the global packet queue, from the dupecheck thread to
+ *	the workers
+ *
+ *	The stress test runs many consumer threads, which stall randomly,
+ *	on a small ring, so that the ring wraps around all the time and
+ *	the producer has to keep packets in the backlog. The producer
+ *	recycles the packets it reclaims, so a consumer would see a
+ *	packet being freed or reused under it. Every consumer must see
+ *	every packet, in order.
+ *
+ *	The throughput test compares the ring with the linked list and
+ *	the rwlock the queue used to be.
+ */
+
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+#include "pbufring.h"
+#include "rwlock.h"
+#include "hmalloc.h"
+#include "bench.h"
+
+#define BENCH_RING_CONSUMERS_MAX	16
+#define BENCH_RING_BATCH		32
+
+struct bench_ring_consumer_t {
+	pthread_t th;
+	struct bench_ring_run_t *run;
+	int id;
+	unsigned int rand_state;
+
+	struct pbuf_ring_cursor_t cursor;	/* ring */
+	struct pbuf_t **prevp;			/* rwlock list */
+	uint32_t last_seq;
+	int seen;
+
+	long count;
+	uint64_t sum;
+} __attribute__((aligned(64)));
+
+struct bench_ring_run_t {
+	int list;		/* 1: rwlock list, 0: ring */
+	int consumers;
+	long packets;
+	int stall;		/* consumers stall every now and then */
+
+	struct pbuf_ring_t ring;
+
+	rwlock_t lock;
+	struct pbuf_t *head;
+	struct pbuf_t **tailp;
+
+	struct pbuf_t *pool;	/* free packets, producer only */
+	int pool_size;
+	int backlog_max;
+
+	struct bench_ring_consumer_t cons[BENCH_RING_CONSUMERS_MAX];
+};
+
+static unsigned int bench_ring_rand(unsigned int *state)
+{
+	unsigned int x = *state;
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+
+	return *state = x;
+}
+
+static void bench_ring_check(struct bench_ring_consumer_t *cs, struct pbuf_t *pb, uint32_t seq)
+{
+	if (!pb)
+		bench_fail("consumer %d: packet %u was reclaimed", cs->id, seq);
+	if (pb->is_free)
+		bench_fail("consumer %d: packet %u is free", cs->id, seq);
+	if ((uint32_t)pb->seqnum != seq)
+		bench_fail("consumer %d: expected packet %u, got %u", cs->id, seq, (uint32_t)pb->seqnum);
+
+	cs->sum += (uint32_t)pb->packet_len * (uint64_t)seq;
+	cs->count++;
+
+	if (cs->run->stall && bench_ring_rand(&cs->rand_state) % 512 == 0) {
+		if (cs->rand_state & 1)
+			sched_yield();
+		else
+			usleep(cs->rand_state % 200);
+	}
+}
+
+static void *bench_ring_consumer(void *arg)
+{
+	struct bench_ring_consumer_t *cs = arg;
+	struct bench_ring_run_t *run = cs->run;
+	struct pbuf_t *pb;
+	uint32_t seq, head;
+
+	if (!run->list)
+		pbuf_ring_join(&run->ring, &cs->cursor);
+
+	while (cs->count < run->packets) {
+		if (run->list) {
+			rwl_rdlock(&run->lock);
+			while ((pb = *cs->prevp)) {
+				bench_ring_check(cs, pb, pb->seqnum);
+				cs->prevp = &pb->next;
+				__atomic_store_n(&cs->last_seq, pb->seqnum, __ATOMIC_RELEASE);
+				__atomic_store_n(&cs->seen, 1, __ATOMIC_RELEASE);
+			}
+			rwl_rdunlock(&run->lock);
+		} else {
+			head = pbuf_ring_head(&run->ring);
+			for (seq = cs->cursor.seq; seq != head; seq++) {
+				bench_ring_check(cs, pbuf_ring_get(&run->ring, seq), seq);
+				pbuf_ring_advance(&cs->cursor, seq + 1);
+			}
+		}
+
+		if (cs->count < run->packets)
+			sched_yield();
+	}
+
+	return NULL;
+}
+
+static void bench_ring_pool_put(struct bench_ring_run_t *run, struct pbuf_t *pb)
+{
+	pb->is_free = 1;
+	pb->next = run->pool;
+	run->pool = pb;
+}
+
+/* reclaim the packets all of the consumers have passed, to the pool */
+static void bench_ring_reclaim(struct bench_ring_run_t *run)
+{
+	struct pbuf_t *freeset[256];
+	struct pbuf_t *pb;
+	uint32_t min;
+	int i, n, freed = 0;
+
+	if (run->list) {
+		/* like the old purger: everything strictly older than the
+		 * packet the slowest consumer processed last
+		 */
+		for (i = 0; i < run->consumers; i++)
+			if (!__atomic_load_n(&run->cons[i].seen, __ATOMIC_ACQUIRE))
+				return;
+		min = __atomic_load_n(&run->cons[0].last_seq, __ATOMIC_ACQUIRE);
+		for (i = 1; i < run->consumers; i++) {
+			uint32_t s = __atomic_load_n(&run->cons[i].last_seq, __ATOMIC_ACQUIRE);
+			if ((int32_t)(s - min) < 0)
+				min = s;
+		}
+		while ((pb = run->head) && (int32_t)(pb->seqnum - min) < 0) {
+			run->head = pb->next;
+			bench_ring_pool_put(run, pb);
+		}
+		return;
+	}
+
+	min = pbuf_ring_head(&run->ring);
+	for (i = 0; i < run->consumers; i++)
+		if (!pbuf_ring_cursor_min(&run->cons[i].cursor, &min))
+			return;
+
+	do {
+		n = pbuf_ring_reclaim(&run->ring, min, freeset, 256);
+		for (i = 0; i < n; i++)
+			bench_ring_pool_put(run, freeset[i]);
+		freed += n;
+	} while (n == 256);
+
+	if (freed && run->ring.backlog)
+		pbuf_ring_publish(&run->ring, NULL);
+}
+
+/*
+ *	Run the producer in this thread, and the consumers in threads of
+ *	their own. Returns the time it took for all of the consumers to
+ *	see all of the packets.
+ */
+
+static double bench_ring_run(struct bench_ring_run_t *run, int ring_size, unsigned int seed)
+{
+	struct pbuf_t *pool_mem, *pb, *chain, **chainp;
+	uint32_t seq = -2000; /* wraps around, like the dupecheck seqnums */
+	uint64_t sum = 0;
+	long published = 0;
+	int i, n, joined;
+	double start;
+
+	run->ring.slots = NULL;
+	if (run->list) {
+		rwl_init(&run->lock);
+		run->head = NULL;
+		run->tailp = &run->head;
+	} else {
+		pbuf_ring_init(&run->ring, ring_size, seq);
+	}
+
+	run->pool = NULL;
+	pool_mem = hmalloc(sizeof(*pool_mem) * run->pool_size);
+	memset(pool_mem, 0, sizeof(*pool_mem) * run->pool_size);
+	for (i = 0; i < run->pool_size; i++)
+		bench_ring_pool_put(run, &pool_mem[i]);
+	run->backlog_max = 0;
+
+	for (i = 0; i < run->consumers; i++) {
+		memset(&run->cons[i], 0, sizeof(run->cons[i]));
+		run->cons[i].run = run;
+		run->cons[i].id = i;
+		run->cons[i].rand_state = seed + i * 7919 + 1;
+		run->cons[i].prevp = &run->head;
+		if (pthread_create(&run->cons[i].th, NULL, bench_ring_consumer, &run->cons[i]))
+			bench_fail("pthread_create failed");
+	}
+
+	/* the ring consumers must have joined before the first packet,
+	 * so that all of them see all of the packets
+	 */
+	if (!run->list) {
+		do {
+			sched_yield();
+			for (i = joined = 0; i < run->consumers; i++)
+				joined += __atomic_load_n(&run->cons[i].cursor.joined, __ATOMIC_ACQUIRE);
+		} while (joined < run->consumers);
+	}
+
+	start = bench_time();
+
+	while (published < run->packets) {
+		chain = NULL;
+		chainp = &chain;
+		n = (run->stall) ? 1 + bench_rand() % (BENCH_RING_BATCH * 2) : BENCH_RING_BATCH;
+		for (i = 0; i < n && published < run->packets; i++) {
+			while (!run->pool) {
+				bench_ring_reclaim(run);
+				if (!run->pool)
+					sched_yield();
+			}
+			pb = run->pool;
+			run->pool = pb->next;
+
+			pb->next = NULL;
+			pb->is_free = 0;
+			pb->seqnum = seq;
+			pb->packet_len = bench_rand() & 0xffff;
+			sum += (uint32_t)pb->packet_len * (uint64_t)seq;
+			seq++;
+			published++;
+
+			*chainp = pb;
+			chainp = &pb->next;
+		}
+
+		if (run->list) {
+			rwl_wrlock(&run->lock);
+			*run->tailp = chain;
+			run->tailp = chainp;
+			rwl_wrunlock(&run->lock);
+		} else {
+			n = pbuf_ring_publish(&run->ring, chain);
+			if (n > run->backlog_max)
+				run->backlog_max = n;
+		}
+
+		bench_ring_reclaim(run);
+	}
+
+	/* let the consumers get the rest of the backlog */
+	while (!run->list && run->ring.backlog) {
+		sched_yield();
+		bench_ring_reclaim(run);
+	}
+
+	for (i = 0; i < run->consumers; i++)
+		pthread_join(run->cons[i].th, NULL);
+
+	start = bench_time() - start;
+
+	for (i = 0; i < run->consumers; i++) {
+		if (run->cons[i].count != run->packets)
+			bench_fail("consumer %d got %ld packets, expected %ld", i, run->cons[i].count, run->packets);
+		if (run->cons[i].sum != sum)
+			bench_fail("consumer %d checksum differs", i);
+	}
+
+	if (run->list)
+		rwl_destroy(&run->lock);
+	else
+		pbuf_ring_free(&run->ring);
+	hfree(pool_mem);
+
+	return start;
+}
+
+int bench_ring(void)
+{
+	struct bench_ring_run_t *run;
+	char name[64];
+	double secs;
+	int r, n;
+
+	run = hmalloc(sizeof(*run));
+	memset(run, 0, sizeof(*run));
+
+	/* stress: a tiny ring, and stalling consumers */
+	run->list = 0;
+	run->consumers = BENCH_RING_CONSUMERS_MAX;
+	run->packets = bench_opts.packets * 4L;
+	run->stall = 1;
+	run->pool_size = 1024;
+	secs = bench_ring_run(run, 64, bench_opts.seed);
+	printf("stress test passed: %d consumers, %ld packets through a ring of 64, %.3f s, backlog up to %d\n",
+		run->consumers, run->packets, secs, run->backlog_max);
+
+	/* throughput, without stalls */
+	run->stall = 0;
+	run->packets = bench_opts.packets * 10L;
+	for (r = 0; r < bench_opts.rounds; r++) {
+		for (n = 1; n <= BENCH_RING_CONSUMERS_MAX; n *= 4) {
+			run->consumers = n;
+			run->pool_size = PBUF_GLOBAL_RING_SIZE;
+
+			run->list = 1;
+			snprintf(name, sizeof(name), "rwlock list, %d workers", n);
+			bench_report("ring", name, run->packets, bench_ring_run(run, 0, bench_opts.seed));
+
+			run->list = 0;
+			snprintf(name, sizeof(name), "ring, %d workers", n);
+			bench_report("ring", name, run->packets, bench_ring_run(run, PBUF_GLOBAL_RING_SIZE, bench_opts.seed));
+		}
+	}
+
+	hfree(run);
+
+	return 0;
+}
@@ -271,9 +271,14 @@ var app = angular.module('aprsc', [ 'pascalprecht.translate', 'graph', 'ngDialog
 			MEM_TH_cell_size: 'Cell size',
 			MEM_TH_cells_used: 'Cells used',
 			MEM_TH_cells_free: 'Cells free',
+			MEM_TH_cells_cached: 'Cells cached',
 			MEM_TH_used_bytes: 'Bytes used',
 			MEM_TH_allocated_bytes: 'Bytes allocated',
+			MEM_TH_rss_bytes: 'Bytes resident',
 			MEM_TH_blocks: 'Blocks allocated',
+			MEM_TH_blocks_peak: 'Peak blocks',
+			MEM_TH_releases: 'Blocks released',
+			MEM_TH_saved_bytes: 'Bytes saved by size class',
 			
 			TH_proto: 'Proto',
 			TH_addr: 'Address',
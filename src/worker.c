@@ -13,6 +13,7 @@
  */
 
 #include <errno.h>
+#include <stddef.h>
 #include <string.h>
 #include <signal.h>
 #include <time.h>
@@ -30,6 +31,8 @@
 #include "incoming.h"
 #include "outgoing.h"
 #include "filter.h"
+#include "geoindex.h"
+#include "callindex.h"
 #include "dupecheck.h"
 #include "clientlist.h"
 #include "client_heard.h"
@@ -53,16 +56,15 @@ int workers_running;
 int sock_write_expire  = 25;    /* 25 seconds, smaller than the 30-second dupe check window. */
 int keepalive_interval = 20;    /* 20 seconds for individual socket, NOT all in sync! */
 #define KEEPALIVE_POLL_FREQ 2	/* keepalive analysis scan interval */
+#define WORKER_POLL_TIMEOUT 200	/* ms, new packets and clients wake the worker up earlier */
+#define WORKER_POLL_TIMEOUT_NOWAKEUP 30	/* ms, if the wakeup fd could not be set up */
 int obuf_writes_threshold = 16;	/* This many writes per keepalive scan interval switch socket
 				   output to buffered. */
 int obuf_writes_threshold_hys = 6; /* Less than this, and switch back. */
 
 /* global packet buffer */
-rwlock_t pbuf_global_rwlock = RWL_INITIALIZER;
-struct pbuf_t  *pbuf_global       = NULL;
-struct pbuf_t **pbuf_global_prevp = &pbuf_global;
-struct pbuf_t  *pbuf_global_dupe       = NULL;
-struct pbuf_t **pbuf_global_dupe_prevp = &pbuf_global_dupe;
+struct pbuf_ring_t pbuf_global;
+struct pbuf_ring_t pbuf_global_dupe;
 
 
 /* global inbound connects, and protocol traffic accounters */
@@ -342,12 +344,154 @@ static void corepeer_close_all(struct worker_t *self)
 }
 
 
+/*
+ *	Client handles. A packet remembers the client it came from by a
+ *	handle, which is a slot in the global client table and the
+ *	generation of the slot. The generation is bumped every time a slot
+ *	is freed, so a handle of a client which is gone does not refer to
+ *	the next client in the same slot. Free slots are reused in FIFO
+ *	order to make that take as long as possible.
+ *
+ *	Handles are not carried over a live upgrade - the packets are not
+ *	either, and the restored clients get new handles in client_alloc().
+ */
+
+#define CLIENT_HANDLE_SLOT_BITS	16
+#define CLIENT_HANDLE_SLOTS	(1 << CLIENT_HANDLE_SLOT_BITS)
+#define CLIENT_HANDLE_SLOT(h)	((h) & (CLIENT_HANDLE_SLOTS - 1))
+
+struct client_slot_t {
+	struct client_t *c;
+	struct worker_t *owner;	/* worker serving the client */
+	uint32_t handle;	/* handle of the client, or the next one if free */
+	int next_free;
+};
+
+static struct client_slot_t *client_slots;
+static int client_slots_free = -1;
+static int client_slots_free_last = -1;
+static pthread_mutex_t client_slots_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void client_handle_init(void)
+{
+	int i;
+	
+	client_slots = hmalloc(sizeof(*client_slots) * CLIENT_HANDLE_SLOTS);
+	for (i = 0; i < CLIENT_HANDLE_SLOTS; i++) {
+		client_slots[i].c = NULL;
+		client_slots[i].owner = NULL;
+		client_slots[i].handle = (1 << CLIENT_HANDLE_SLOT_BITS) | i;
+		client_slots[i].next_free = i + 1;
+	}
+	client_slots[CLIENT_HANDLE_SLOTS - 1].next_free = -1;
+	client_slots_free = 0;
+	client_slots_free_last = CLIENT_HANDLE_SLOTS - 1;
+}
+
+static uint32_t client_handle_alloc(struct client_t *c)
+{
+	struct client_slot_t *slot;
+	int pe;
+	
+	if ((pe = pthread_mutex_lock(&client_slots_mutex))) {
+		hlog(LOG_ERR, "client_handle_alloc: could not lock client_slots_mutex: %s", strerror(pe));
+		return 0;
+	}
+	
+	if (client_slots_free < 0) {
+		pthread_mutex_unlock(&client_slots_mutex);
+		hlog(LOG_ERR, "client_handle_alloc: all %d client handles in use", CLIENT_HANDLE_SLOTS);
+		return 0;
+	}
+	
+	slot = &client_slots[client_slots_free];
+	client_slots_free = slot->next_free;
+	if (client_slots_free < 0)
+		client_slots_free_last = -1;
+	
+	slot->c = c;
+	slot->owner = NULL;
+	c->handle = slot->handle;
+	
+	pthread_mutex_unlock(&client_slots_mutex);
+	
+	return c->handle;
+}
+
+static void client_handle_free(struct client_t *c)
+{
+	struct client_slot_t *slot;
+	int i, pe;
+	
+	if (!c->handle)
+		return;
+	
+	if ((pe = pthread_mutex_lock(&client_slots_mutex))) {
+		hlog(LOG_ERR, "client_handle_free: could not lock client_slots_mutex: %s", strerror(pe));
+		return;
+	}
+	
+	i = CLIENT_HANDLE_SLOT(c->handle);
+	slot = &client_slots[i];
+	slot->c = NULL;
+	slot->owner = NULL;
+	
+	/* next generation, skipping 0 so that a handle is never 0 */
+	slot->handle += CLIENT_HANDLE_SLOTS;
+	if (slot->handle < CLIENT_HANDLE_SLOTS)
+		slot->handle += CLIENT_HANDLE_SLOTS;
+	
+	slot->next_free = -1;
+	if (client_slots_free_last >= 0)
+		client_slots[client_slots_free_last].next_free = i;
+	else
+		client_slots_free = i;
+	client_slots_free_last = i;
+	
+	pthread_mutex_unlock(&client_slots_mutex);
+	
+	c->handle = 0;
+}
+
+/*
+ *	Mark the client to be served by a worker. Only the worker thread
+ *	itself frees its clients, so it can look them up by handle without
+ *	locking.
+ */
+
+void client_handle_own(struct worker_t *self, struct client_t *c)
+{
+	if (c->handle)
+		client_slots[CLIENT_HANDLE_SLOT(c->handle)].owner = self;
+}
+
+/*
+ *	Find a client of this worker by handle, or NULL if the client is
+ *	gone or served by another worker.
+ */
+
+struct client_t *client_handle_get(struct worker_t *self, uint32_t handle)
+{
+	struct client_slot_t *slot;
+	
+	if (!handle)
+		return NULL;
+	
+	slot = &client_slots[CLIENT_HANDLE_SLOT(handle)];
+	if (slot->owner != self || slot->handle != handle)
+		return NULL;
+	
+	return slot->c;
+}
+
 /*
  *	set up cellmalloc for clients
  */
 
 void client_init(void)
 {
+	client_handle_init();
+	
 #ifndef _FOR_VALGRIND_
 	client_cells  = cellinit( "clients",
 				  sizeof(struct client_t),
@@ -372,6 +516,15 @@ struct client_t *client_alloc(void)
 	memset((void *)c, 0, sizeof(*c));
 	c->fd = -1;
 	c->state = CSTATE_INIT;
+	
+	if (!client_handle_alloc(c)) {
+#ifndef _FOR_VALGRIND_
+		cellfree(client_cells, c);
+#else
+		hfree(c);
+#endif
+		return NULL;
+	}
 
 #ifdef FIXED_IOBUFS
 	c->ibuf_size = sizeof(c->ibuf);
@@ -407,6 +560,11 @@ void client_free(struct client_t *c)
 	filter_free(c->negdefaultfilters);
 	filter_free(c->posuserfilters);
 	filter_free(c->neguserfilters);
+	filter_prog_free(c);
+	if (c->geo_cells)
+		hfree(c->geo_cells);
+	if (c->call_entries)
+		hfree(c->call_entries);
 	
 	client_heard_free(c);
 
@@ -418,6 +576,8 @@ void client_free(struct client_t *c)
 		ssl_free_connection(c);
 #endif
 
+	client_handle_free(c);
+	
 	memset(c, 0, sizeof(*c));
 
 #ifndef _FOR_VALGRIND_
@@ -555,9 +715,97 @@ int pass_client_to_worker(struct worker_t *wc, struct client_t *c)
 		return -1;
 	}
 	
+	worker_wakeup(wc);
+	
 	return 0;
 }
 
+/*
+ *	Wake a worker up from xpoll, to process new packets in the global
+ *	queue, or new clients. If it has been signalled already, and has
+ *	not woken up yet, once is enough. Called by the dupecheck thread
+ *	after publishing packets, and the accept thread.
+ */
+
+void worker_wakeup(struct worker_t *w)
+{
+	uint64_t u = 1;
+	int fd = w->wakeup_wfd;
+	
+	if (fd < 0)
+		return;
+	
+	if (__atomic_exchange_n(&w->wakeup_pending, 1, __ATOMIC_SEQ_CST))
+		return;
+	
+	if (write(fd, &u, sizeof(u)) != sizeof(u) && errno != EAGAIN)
+		hlog(LOG_ERR, "worker_wakeup: failed to wake up worker %d: %s", w->id, strerror(errno));
+}
+
+/*
+ *	The worker has woken up. Clear the flag before looking at the
+ *	global queue, so that the packets published after that will
+ *	signal it again.
+ */
+
+static void worker_wakeup_read(struct worker_t *self)
+{
+	char buf[64];
+	
+	/* an eventfd gives the counter in one read, a pipe may have more */
+	while (read(self->wakeup_fd, buf, sizeof(buf)) > 0)
+		;
+	
+	self->wakeups++;
+	__atomic_store_n(&self->wakeup_pending, 0, __ATOMIC_SEQ_CST);
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+static void worker_wakeup_init(struct worker_t *w)
+{
+#ifdef USE_WORKER_EVENTFD
+	w->wakeup_fd = w->wakeup_wfd = eventfd(0, EFD_NONBLOCK|EFD_CLOEXEC);
+	if (w->wakeup_fd < 0) {
+		hlog(LOG_ERR, "worker %d: eventfd init failed, polling instead: %s", w->id, strerror(errno));
+		return;
+	}
+#else
+	int fds[2], i;
+	
+	if (pipe(fds)) {
+		hlog(LOG_ERR, "worker %d: wakeup pipe init failed, polling instead: %s", w->id, strerror(errno));
+		return;
+	}
+	
+	for (i = 0; i < 2; i++) {
+		if (fcntl(fds[i], F_SETFL, O_NONBLOCK) == -1 || fcntl(fds[i], F_SETFD, FD_CLOEXEC) == -1)
+			hlog(LOG_ERR, "worker %d: wakeup pipe fcntl failed: %s", w->id, strerror(errno));
+	}
+	
+	w->wakeup_fd = fds[0];
+	w->wakeup_wfd = fds[1];
+#endif
+	
+	w->wakeup_xfd = xpoll_add(&w->xp, w->wakeup_fd, NULL);
+}
+
+static void worker_wakeup_free(struct worker_t *w)
+{
+	int fd = w->wakeup_fd;
+	int wfd = w->wakeup_wfd;
+	
+	/* the worker is off the list, and the dupecheck thread
+	 * has gone past it, see dupecheck_sync()
+	 */
+	w->wakeup_fd = w->wakeup_wfd = -1;
+	w->wakeup_xfd = NULL;
+	
+	if (wfd >= 0 && wfd != fd)
+		close(wfd);
+	if (fd >= 0)
+		close(fd);
+}
+
 char *strsockaddr(const struct sockaddr *sa, const int addr_len)
 {
 	char eb[200], *s;
@@ -814,6 +1062,53 @@ static const char *protocol_str(struct client_t *c)
 	return unknown;
 }
 
+/*
+ *	Put a client in a class, with a hot record made of its current
+ *	fields, and take it out: the last client of the class takes the
+ *	place of the removed one.
+ */
+
+static void client_class_add(struct client_class_t *cl, struct client_t *c)
+{
+	struct client_hot_t *h;
+	
+	if (cl->count == cl->size) {
+		cl->size = (cl->size) ? cl->size * 2 : 16;
+		cl->hot = hrealloc(cl->hot, sizeof(*cl->hot) * cl->size);
+	}
+	
+	h = &cl->hot[cl->count];
+	h->c = c;
+	h->filter_shared = c->filter_shared;
+	h->handle = c->handle;
+	h->filter_kinds = c->filter_kinds;
+	h->flags = c->flags;
+	h->no_tx = c->no_tx;
+	
+	c->class_list = cl;
+	c->class_pos = cl->count++;
+}
+
+static void client_class_remove(struct client_t *c)
+{
+	struct client_class_t *cl = c->class_list;
+	int last = --cl->count;
+	
+	if (c->class_pos != last) {
+		cl->hot[c->class_pos] = cl->hot[last];
+		cl->hot[c->class_pos].c->class_pos = c->class_pos;
+	}
+	
+	c->class_list = NULL;
+	c->class_pos = 0;
+}
+
+static void client_class_free(struct client_class_t *cl)
+{
+	hfree(cl->hot);
+	memset(cl, 0, sizeof(*cl));
+}
+
 /*
  *	close and forget a client connection
  */
@@ -904,13 +1199,14 @@ void client_close(struct worker_t *self, struct client_t *c, int errnum)
 		c->next->prevp = c->prevp;
 	*c->prevp = c->next;
 	
-	/* link the classified clients list together over this node, but only if
-	 * the client has fully logged in and classification has been done
+	/* take the client out of its class, but only if the client has
+	 * fully logged in and classification has been done
 	 */
-	if (c->class_prevp) {
-		*c->class_prevp = c->class_next;
-		if (c->class_next)
-			c->class_next->class_prevp = c->class_prevp;
+	if (c->class_list)
+		client_class_remove(c);
+	if (c->geo_indexed) {
+		geoindex_remove(self->geoindex, c);
+		callindex_remove(self->callindex, c);
 	}
 
 	/* If this happens to be the uplink, tell the uplink connection
@@ -966,8 +1262,10 @@ int udp_client_write(struct worker_t *self, struct client_t *c, char *p, int len
 
 	// hlog( LOG_DEBUG, "UDP from %d to client port %d, sendto rc=%d", c->udpclient->portnum, c->udp_port, i );
 
-	if (i > 0)
+	if (i > 0) {
 		clientaccount_add_tx( c, IPPROTO_UDP, i, 0);
+		client_obuf_written(self, c);
+	}
 		
 	return i;
 }
@@ -1119,6 +1417,7 @@ static int tcp_client_write(struct worker_t *self, struct client_t *c, char *p,
 		//hlog(LOG_DEBUG, "client_write(%s) obuf empty", c->addr_rem);
 		c->obuf_start = 0;
 		c->obuf_end   = 0;
+		client_obuf_written(self, c);
 		return len;
 	}
 
@@ -1162,6 +1461,16 @@ int client_bad_filter_notify(struct worker_t *self, struct client_t *c, const ch
 	return 0;
 }
 
+/*
+ *	Stamp the packets of a read() for the latency histograms, if
+ *	sampling, see incoming_handler()
+ */
+
+static inline void worker_read_stamp(struct worker_t *self)
+{
+	self->read_time = (latency_sampling) ? latency_now() : 0;
+}
+
 /*
  *	Receive UDP packets from a core peer
  */
@@ -1233,6 +1542,7 @@ static int handle_corepeer_readable(struct worker_t *self, struct client_t *c)
 	hlog(LOG_DEBUG, "worker thread passing UDP packet from %s to handler: %*s", addrs, r, c->ibuf);
 	hfree(addrs);
 	*/
+	worker_read_stamp(self);
 	clientaccount_add_rx(rc, IPPROTO_UDP, r, 0, 0, 0); /* Account byte count. incoming_handler() will account packets. */
 	rc->last_read = tick;
 	
@@ -1294,6 +1604,8 @@ static int deframe_aprsis_input_lines(struct worker_t *self, struct client_t *c)
 
 int client_postread(struct worker_t *self, struct client_t *c, int r)
 {
+	worker_read_stamp(self);
+	
 	clientaccount_add_rx(c, c->ai_protocol, r, 0, 0, 0); /* Number of packets is now unknown,
 					     byte count is collected.
 					     The incoming_handler() will account
@@ -1384,6 +1696,7 @@ static int handle_client_writable(struct worker_t *self, struct client_t *c)
 	if (c->obuf_start == c->obuf_end) {
 		xpoll_outgoing(&self->xp, c->xfd, 0);
 		c->obuf_start = c->obuf_end = 0;
+		client_obuf_written(self, c);
 	}
 	
 	return 0;
@@ -1395,6 +1708,12 @@ static int handle_client_event(struct xpoll_t *xp, struct xpoll_fd_t *xfd)
 	struct client_t *c    = (struct client_t *)xfd->p;
 	
 	//hlog(LOG_DEBUG, "handle_client_event(%d): %d", xfd->fd, xfd->result);
+	
+	if (xfd == self->wakeup_xfd) {
+		/* new packets or clients, the main loop will get to them */
+		worker_wakeup_read(self);
+		return 0;
+	}
 
 	if (xfd->result & XP_OUT) {  /* priorize doing output */
 		/* ah, the client is writable */
@@ -1434,35 +1753,79 @@ static int handle_client_event(struct xpoll_t *xp, struct xpoll_fd_t *xfd)
 
 static void worker_classify_client(struct worker_t *self, struct client_t *c)
 {
-	struct client_t *class_next = NULL;
-	struct client_t **class_prevp = NULL;
+	struct client_class_t *cl;
 	
 	if (c->flags & CLFLAGS_PORT_RO) {
 		//hlog(LOG_DEBUG, "classify_client(worker %d): client fd %d classified readonly", self->id, c->fd);
-		class_next = self->clients_ro;
-		class_prevp = &self->clients_ro;
+		cl = &self->clients_ro;
 	} else if (c->state == CSTATE_COREPEER || (c->flags & CLFLAGS_UPLINKPORT)) {
 		//hlog(LOG_DEBUG, "classify_client(worker %d): client fd %d classified upstream/peer", self->id, c->fd);
-		class_next = self->clients_ups;
-		class_prevp = &self->clients_ups;
+		cl = &self->clients_ups;
 	} else if (c->flags & CLFLAGS_DUPEFEED) {
 		//hlog(LOG_DEBUG, "classify_client(worker %d): client fd %d classified dupefeed", self->id, c->fd);
-		class_next = self->clients_dupe;
-		class_prevp = &self->clients_dupe;
+		cl = &self->clients_dupe;
 	} else if (c->flags & CLFLAGS_INPORT) {
+		/* clients having only position and callsign set filters
+		 * go in the geoindex and the callindex
+		 */
+		if ((c->flags & CLFLAGS_FULLFEED) != CLFLAGS_FULLFEED) {
+			if (!self->geoindex) {
+				self->geoindex = geoindex_alloc();
+				self->callindex = callindex_alloc();
+				self->filter_intern = filter_intern_alloc();
+				self->filter_centres = filter_centres_alloc();
+			}
+			filter_intern(self->filter_intern, c);
+			filter_centres_bind(self->filter_centres, c);
+			if (geoindex_add(self->geoindex, c) == 0) {
+				callindex_add(self->callindex, c);
+				//hlog(LOG_DEBUG, "classify_client(worker %d): client fd %d indexed, %d cells, %d callsigns", self->id, c->fd, c->geo_cell_count, c->call_entry_count);
+				return;
+			}
+		}
 		//hlog(LOG_DEBUG, "classify_client(worker %d): client fd %d classified other", self->id, c->fd);
-		class_next = self->clients_other;
-		class_prevp = &self->clients_other;
+		cl = &self->clients_other;
 	} else {
 		hlog(LOG_ERR, "classify_client(worker %d): client fd %d NOT CLASSIFIED - will not get any packets", self->id, c->fd);
 		return;
 	}
 	
-	c->class_next = class_next;
-	if (class_next)
-		class_next->class_prevp = &c->class_next;
-	*class_prevp = c;
-	c->class_prevp = class_prevp;
+	client_class_add(cl, c);
+}
+
+/*
+ *	Classify the client again after its filters have changed, or
+ *	the regions of its position filters have moved.
+ */
+
+void worker_reclassify_client(struct worker_t *self, struct client_t *c)
+{
+	if (c->geo_indexed) {
+		geoindex_remove(self->geoindex, c);
+		callindex_remove(self->callindex, c);
+	} else if (c->class_list) {
+		client_class_remove(c);
+	} else {
+		/* not logged in yet, will be classified then */
+		return;
+	}
+	
+	worker_classify_client(self, c);
+}
+
+/*
+ *	Refresh the historydb positions of the f/ and m/ filters of the
+ *	clients in the geoindex, and move the clients in the index
+ *	if the positions have changed.
+ */
+
+static void worker_geo_refresh(struct worker_t *self)
+{
+	struct client_t *c;
+	
+	for (c = self->clients; (c); c = c->next)
+		if (c->geo_indexed && filter_geo_refresh(c))
+			worker_reclassify_client(self, c);
 }
 
 /*
@@ -1538,6 +1901,7 @@ static void collect_new_clients(struct worker_t *self)
 		
 		self->client_count++;
 		// hlog(LOG_DEBUG, "collect_new_clients(worker %d): got client fd %d", self->id, c->fd);
+		client_handle_own(self, c);
 		c->next = self->clients;
 		if (c->next)
 			c->next->prevp = &c->next;
@@ -1802,18 +2166,42 @@ void worker_thread(struct worker_t *self)
 	
 	hlog(LOG_DEBUG, "Worker %d started.", self->id);
 	
+	/* process the packets published from now on */
+	pbuf_ring_join(&pbuf_global, &self->pbuf_cursor);
+	pbuf_ring_join(&pbuf_global_dupe, &self->pbuf_dupe_cursor);
+	
 	while (!self->shutting_down) {
 		t1 = tick;
 		
+		/* once a second, update the geoindex for moved f/ and m/ centres,
+		 * and free the callindex entries of clients gone
+		 */
+		if (tick != self->geo_refresh_tick && self->geoindex) {
+			self->geo_refresh_tick = tick;
+			filter_centres_expire(self->filter_centres);
+			if (self->geoindex->clients)
+				worker_geo_refresh(self);
+			callindex_gc(self->callindex);
+		}
+		
+		/* new positions of the f/ and m/ filter centres from the historydb,
+		 * move the clients in the geoindex before the packets having them
+		 * are processed
+		 */
+		if (self->filter_centres && self->filter_centres->queue.head) {
+			if (filter_centres_update(self->filter_centres) && self->geoindex->clients)
+				worker_geo_refresh(self);
+		}
+		
 		/* if we have new stuff in the global packet buffer, process it */
-		if (*self->pbuf_global_prevp || *self->pbuf_global_dupe_prevp)
+		if (pbuf_ring_pending(&pbuf_global, &self->pbuf_cursor) || pbuf_ring_pending(&pbuf_global_dupe, &self->pbuf_dupe_cursor))
 			process_outgoing(self);
 
 		t2 = tick;
 
 		// TODO: calculate different delay based on outgoing lag ?
 		/* poll for incoming traffic */
-		xpoll(&self->xp, 30); // was 200, but gave too big latency
+		xpoll(&self->xp, (self->wakeup_xfd) ? WORKER_POLL_TIMEOUT : WORKER_POLL_TIMEOUT_NOWAKEUP);
 		
 		/* if we have stuff in the local queue, try to flush it and make
 		 * it available to the dupecheck thread
@@ -1895,16 +2283,16 @@ void worker_thread(struct worker_t *self)
 	
 	/* check if there is stuff in the incoming queue (not taken by dupecheck) */
 	int pbuf_incoming_found = 0;
-	for (p = self->pbuf_incoming; p; p = p->next) {
+	for (p = __atomic_load_n(&self->pbuf_incoming.head, __ATOMIC_ACQUIRE); p; p = p->next) {
 		pbuf_incoming_found++;
 	}
-	if (pbuf_incoming_found != self->pbuf_incoming_count) {
+	if (pbuf_incoming_found != self->pbuf_incoming.count) {
 		hlog(LOG_ERR, "Worker %d: found %d packets in incoming queue, does not match count %d",
-			self->id, pbuf_incoming_found, self->pbuf_incoming_count);
+			self->id, pbuf_incoming_found, self->pbuf_incoming.count);
 	}
-	if (self->pbuf_incoming_count)
+	if (self->pbuf_incoming.count)
 		hlog(LOG_INFO, "Worker %d: %d packets left in incoming queue",
-			self->id, self->pbuf_incoming_count);
+			self->id, self->pbuf_incoming.count);
 	
 	/* clean up thread-local pbuf pools */
 	worker_free_buffers(self);
@@ -1953,6 +2341,19 @@ void workers_stop(int stop_all)
 		}
 
 		*(w->prevp) = NULL;
+		/* the dupecheck thread may still be draining or waking
+		 * up the worker, wait until it is done with it
+		 */
+		dupecheck_sync();
+		worker_wakeup_free(w);
+		geoindex_free(w->geoindex);
+		callindex_free(w->callindex);
+		filter_intern_free(w->filter_intern);
+		filter_centres_free(w->filter_centres);
+		client_class_free(&w->clients_dupe);
+		client_class_free(&w->clients_ro);
+		client_class_free(&w->clients_ups);
+		client_class_free(&w->clients_other);
 		hfree(w);
 		
 		workers_running--;
@@ -1988,14 +2389,10 @@ struct worker_t *worker_alloc(void)
 	pthread_mutex_init(&w->new_clients_mutex, NULL);
 	
 	w->pbuf_incoming_local = NULL;
-	w->pbuf_incoming_local_last = &w->pbuf_incoming_local;
-	
-	w->pbuf_incoming      = NULL;
-	w->pbuf_incoming_last = &w->pbuf_incoming;
-	pthread_mutex_init(&w->pbuf_incoming_mutex, NULL);
+	w->pbuf_incoming_local_last = NULL;
+	pbuf_cache_init(w);
 	
-	w->pbuf_global_prevp      = pbuf_global_prevp;
-	w->pbuf_global_dupe_prevp = pbuf_global_dupe_prevp;
+	w->wakeup_fd = w->wakeup_wfd = -1;
 	
 	return w;
 }
@@ -2006,21 +2403,14 @@ struct worker_t *worker_alloc(void)
 
 void worker_free_buffers(struct worker_t *self)
 {
-	struct pbuf_t *p, *pn;
+	int c;
 	
-	/* clean up thread-local pbuf pools */
-	for (p = self->pbuf_free_small; p; p = pn) {
-		pn = p->next;
-		pbuf_free(NULL, p); // free to global pool
-	}
-	for (p = self->pbuf_free_medium; p; p = pn) {
-		pn = p->next;
-		pbuf_free(NULL, p); // free to global pool
-	}
-	for (p = self->pbuf_free_large; p; p = pn) {
-		pn = p->next;
-		pbuf_free(NULL, p); // free to global pool
-	}
+	/* the buffers on their way back go in the caches first */
+	pbuf_home_close(self);
+	
+	/* clean up thread-local pbuf caches, to the global pools */
+	for (c = 0; c < PBUF_CLASSES; c++)
+		cellcache_flush(&self->pbuf_cache[c]);
 }
 
 /*
@@ -2056,6 +2446,7 @@ void workers_start(void)
 		
 		w->id = i;
 		xpoll_initialize(&w->xp, (void *)w, &handle_client_event);
+		worker_wakeup_init(w);
 		
 		/* start the worker thread */
 		if (pthread_create(&w->th, &pthr_attrs, (void *)worker_thread, w))
@@ -2248,23 +2639,68 @@ static struct cJSON *worker_client_json(struct client_t *c, int liveup_info)
 	return jc;
 }
 
+/* the per-stage latency histograms of a worker, in the order a packet goes through them */
+static const struct {
+	const char *name;
+	size_t offset;
+} worker_latencies[] = {
+	{ "parse_latency", offsetof(struct worker_t, parse_latency) },
+	{ "flush_latency", offsetof(struct worker_t, flush_latency) },
+	{ "outgoing_latency", offsetof(struct worker_t, outgoing_latency) },
+	{ "write_latency", offsetof(struct worker_t, write_latency) },
+	{ "total_latency", offsetof(struct worker_t, total_latency) },
+};
+#define WORKER_LATENCIES (sizeof(worker_latencies) / sizeof(worker_latencies[0]))
+
+#define worker_latency(w, i) ((struct latency_hist_t *)((char *)(w) + worker_latencies[i].offset))
+
 int worker_client_list(cJSON *workers, cJSON *clients, cJSON *uplinks, cJSON *peers, cJSON *totals, cJSON *memory)
 {
 	struct worker_t *w = worker_threads;
 	struct client_t *c;
-	int pe;
+	long long filter_calls = 0, filter_prefiltered = 0, filter_shared_hits = 0;
+	int filter_sets = 0, filter_set_clients = 0;
+	struct latency_hist_t *latencies;
+	int pe, i;
+	
+	latencies = hmalloc(sizeof(*latencies) * WORKER_LATENCIES);
+	memset(latencies, 0, sizeof(*latencies) * WORKER_LATENCIES);
 	
 	while (w) {
 		if ((pe = pthread_mutex_lock(&w->clients_mutex))) {
 			hlog(LOG_ERR, "worker_client_list(worker %d): could not lock clients_mutex: %s", w->id, strerror(pe));
+			hfree(latencies);
 			return -1;
 		}
 		
 		cJSON *jw = cJSON_CreateObject();
 		cJSON_AddNumberToObject(jw, "id", w->id);
 		cJSON_AddNumberToObject(jw, "clients", w->client_count);
-		cJSON_AddNumberToObject(jw, "pbuf_incoming_count", w->pbuf_incoming_count);
+		cJSON_AddNumberToObject(jw, "pbuf_incoming_count", w->pbuf_incoming.count);
 		cJSON_AddNumberToObject(jw, "pbuf_incoming_local_count", w->pbuf_incoming_local_count);
+		cJSON_AddNumberToObject(jw, "filter_calls", w->filter_calls);
+		cJSON_AddNumberToObject(jw, "filter_prefiltered", w->filter_prefiltered);
+		cJSON_AddNumberToObject(jw, "filter_shared_hits", w->filter_shared_hits);
+		filter_calls += w->filter_calls;
+		filter_prefiltered += w->filter_prefiltered;
+		filter_shared_hits += w->filter_shared_hits;
+		if (w->filter_intern) {
+			/* distinct filter sets, and the clients having them */
+			cJSON_AddNumberToObject(jw, "filter_sets", w->filter_intern->entries);
+			cJSON_AddNumberToObject(jw, "filter_set_clients", w->filter_intern->clients);
+			filter_sets += w->filter_intern->entries;
+			filter_set_clients += w->filter_intern->clients;
+		}
+		cJSON_AddNumberToObject(jw, "wakeups", w->wakeups);
+		for (i = 0; i < (int)WORKER_LATENCIES; i++) {
+			cJSON_AddItemToObject(jw, worker_latencies[i].name, latency_json(worker_latency(w, i)));
+			latency_merge(&latencies[i], worker_latency(w, i));
+		}
+		if (w->filter_centres) {
+			/* subscribed f/ and m/ filter centres */
+			cJSON_AddNumberToObject(jw, "filter_centres", w->filter_centres->entries);
+			cJSON_AddNumberToObject(jw, "filter_centre_updates", w->filter_centres->updates);
+		}
 		
 		for (c = w->clients; (c); c = c->next) {
 			/* clients on hidden listener sockets are not shown */
@@ -2317,21 +2753,20 @@ int worker_client_list(cJSON *workers, cJSON *clients, cJSON *uplinks, cJSON *pe
 	cJSON_AddNumberToObject(totals, "sctp_pkts_ign", client_connects_sctp.rxdrops);
 	json_add_rxerrs(totals, "sctp_rx_errs", client_connects_sctp.rxerrs);
 #endif
+	cJSON_AddNumberToObject(totals, "filter_calls", filter_calls);
+	cJSON_AddNumberToObject(totals, "filter_prefiltered", filter_prefiltered);
+	cJSON_AddNumberToObject(totals, "filter_shared_hits", filter_shared_hits);
+	cJSON_AddNumberToObject(totals, "filter_sets", filter_sets);
+	cJSON_AddNumberToObject(totals, "filter_set_clients", filter_set_clients);
+	cJSON_AddNumberToObject(totals, "filter_intern_ratio", (filter_sets) ? (double)filter_set_clients / filter_sets : 0);
+	for (i = 0; i < (int)WORKER_LATENCIES; i++)
+		cJSON_AddItemToObject(totals, worker_latencies[i].name, latency_json(&latencies[i]));
+	hfree(latencies);
 
 #ifndef _FOR_VALGRIND_
 	struct cellstatus_t cellst;
 	cellstatus(client_cells, &cellst);
-	int used = cellst.cellcount - cellst.freecount;
-	cJSON_AddNumberToObject(memory, "client_cells_used", used);
-	cJSON_AddNumberToObject(memory, "client_cells_free", cellst.freecount);
-	cJSON_AddNumberToObject(memory, "client_used_bytes", used*cellst.cellsize_aligned);
-	cJSON_AddNumberToObject(memory, "client_allocated_bytes", (long)cellst.blocks * (long)cellst.block_size);
-	cJSON_AddNumberToObject(memory, "client_block_size", (long)cellst.block_size);
-	cJSON_AddNumberToObject(memory, "client_blocks", (long)cellst.blocks);
-	cJSON_AddNumberToObject(memory, "client_blocks_max", (long)cellst.blocks_max);
-	cJSON_AddNumberToObject(memory, "client_cell_size", cellst.cellsize);
-	cJSON_AddNumberToObject(memory, "client_cell_size_aligned", cellst.cellsize_aligned);
-	cJSON_AddNumberToObject(memory, "client_cell_align", cellst.alignment);
+	status_cell_json(memory, "client", &cellst, cellst.cellcount - cellst.freecount);
 #endif
 	
 	return 0;
@@ -33,6 +33,10 @@
 #include "cJSON.h"
 #include "errno_aprsc.h"
 #include "tls.h"
+#include "range.h"
+#include "pbufring.h"
+#include "latency.h"
+#include "cellmalloc.h"
 
 extern time_t now;	/* current wallclock time */
 extern time_t tick;	/* clocktick - monotonously increasing for timers, not affected by NTP et al */
@@ -66,10 +70,22 @@ extern pthread_attr_t pthr_attrs;  /* used to setup new threads */
 #define PACKETLEN_MAX_MEDIUM 180 /* about 99.5% are smaller than this */
 #define PACKETLEN_MAX_LARGE  PACKETLEN_MAX
 
-/* number of pbuf_t structures to allocate at a time */
-#define PBUF_ALLOCATE_BUNCH_SMALL  2000 /* grow to 2000 in production use */
-#define PBUF_ALLOCATE_BUNCH_MEDIUM 2000 /* grow to 2000 in production use */
-#define PBUF_ALLOCATE_BUNCH_LARGE    50 /* grow to 50 in production use */
+/*
+ *  The size classes of the packet buffers, each has an arena of its
+ *  own. They start at the lengths above, and are picked again from
+ *  the lengths of the packets received, see pbuf_classes_adapt().
+ *  A class can be any multiple of PBUF_SLOT_LEN bytes long, each of
+ *  the lengths is a slot, and a set of classes is packed in 32 bits.
+ */
+#define PBUF_CLASS_SMALL	0
+#define PBUF_CLASS_MEDIUM	1
+#define PBUF_CLASS_LARGE	2
+#define PBUF_CLASSES		3
+
+#define PBUF_SLOT_LEN		4
+#define PBUF_SLOTS		(PACKETLEN_MAX / PBUF_SLOT_LEN)
+#define PBUF_SLOT_BITS		7	/* PBUF_SLOTS fit */
+#define PBUF_CLASS_SLOT(set, c)	(((set) >> ((c) * PBUF_SLOT_BITS)) & (PBUF_SLOTS - 1))
 
 /* a packet buffer */
 /* Type flags -- some can happen in combinations: T_CWOP + T_WX / T_CWOP + T_POSITION ... */
@@ -96,20 +112,38 @@ extern pthread_attr_t pthr_attrs;  /* used to setup new threads */
 
 struct client_t; /* forward declarator */
 
+/* an element of the digipeater path before the Q construct,
+ * split up once by incoming_parse_path() for the filters
+ */
+#define PBUF_PATH_MAX		10	/* the filters look at this many */
+#define PBUF_PATH_STAR		1	/* has a trailing '*' */
+#define PBUF_PATH_DIGIPEATED	2	/* this or a following element has a '*' */
+
+struct pbuf_path_t {
+	uint16_t off;		/* offset in data[] */
+	uint8_t  len;		/* length without the '*' */
+	uint8_t  flags;		/* PBUF_PATH_* */
+};
+
+/* a mangled version of the packet, hashed by dupecheck_prepare() in the
+ * worker, so that the dupecheck thread only needs to look it up
+ */
+#define PBUF_DUPE_VARIANTS_MAX	8
+
+struct pbuf_dupe_variant_t {
+	uint32_t hash;
+	uint16_t len;
+	uint8_t  dtype;		/* DTYPE_*, how the packet was mangled */
+	uint8_t  pad;
+};
+
 struct pbuf_t {
 	struct pbuf_t *next;
-	struct client_t *origin;
-		/* where did we get it from (don't send it back)
-		   NOTE: This pointer is NOT guaranteed to be valid!
-		   It does get invalidated by originating connection close,
-		   but it is only used as read-only comparison reference
-		   against output client connection pointer.  It may
-		   point to reused connection entry, but even that does
-		   not matter much -- a few packets may be left unrelayed
-		   to the a client in some situations, but packets sent
-		   a few seconds latter will go through just fine. 
-		   In case of "dump history" (if we ever do) this pointer
-		   is ignored while history dumping is being done.
+	uint32_t origin;
+		/* handle of the client we got it from (don't send it back),
+		   see client_handle_get(). The client may be gone by the
+		   time the packet is processed, and its handle is then not
+		   valid any more. 0 for none.
 		*/
 
 	uint32_t srcname_hash;	/* source name hash */
@@ -120,9 +154,21 @@ struct pbuf_t {
 	uint16_t srcname_len;	/* parsed length of source (object, item, srcall) name 3..9 */
 	uint16_t dstcall_len;	/* parsed length of destination callsign *including* SSID */
 	uint16_t dstname_len;   /* parsed length of message destination including SSID */
-	uint16_t entrycall_len;
+	uint16_t entrycall_len;	/* length of the entry callsign after the Q construct, 0 if bad */
+	char     qconst_type;	/* the Q construct type: the R of qAR */
+	uint8_t  path_count;	/* elements in path[] */
 	uint32_t seqnum;	/* ever increasing counter, dupecheck sets */
 	time_t t;		/* when the packet was received */
+	uint64_t received;	/* latency_now() of the read() it came in, if sampled for the latency histograms, or 0 */
+	uint64_t queued;	/* latency_now() when the worker queued it for the dupecheck, if sampled */
+	uint64_t flushed;	/* latency_now() when the worker put it in the dupecheck inbox, if sampled */
+	uint64_t published;	/* latency_now() when dupecheck published it in pbuf_global */
+	uint8_t  dupecheck_result; /* verdict of a dupecheck shard thread */
+	uint8_t  dupe_variant_count; /* elements in dupe_variant[] */
+	uint8_t  home;		/* pbuf_homes[] of the worker which allocated it, 0 for none */
+	uint8_t  size_class;	/* the slot of its size class, and arena, buf_len is its length */
+	uint32_t dupe_hash;	/* hash of the address and payload, for the dupecheck */
+	struct pbuf_dupe_variant_t dupe_variant[PBUF_DUPE_VARIANTS_MAX];
 	
 	int packet_len;		/* the actual length of the packet, including CRLF */
 	int buf_len;		/* the length of this buffer */
@@ -138,6 +184,9 @@ struct pbuf_t {
 	float lat;	/* if the packet is PT_POSITION, latitude and longitude go here */
 	float lng;	/* .. in RADIAN */
 	float cos_lat;	/* cache of COS of LATitude for radial distance filter    */
+	struct range_point_t range_pt; /* .. and the rest of it, see range.c */
+
+	struct pbuf_path_t path[PBUF_PATH_MAX]; /* the digipeater path before the Q construct */
 
 	char symbol[3]; /* 2(+1) chars of symbol, if any, NUL for not found */
 	char is_free;   /* 1: in global free list, 0: not in global free list */
@@ -145,12 +194,26 @@ struct pbuf_t {
 	char data[1];	/* contains the whole packet, including CRLF, ready to transmit */
 };
 
-/* global packet buffer */
-extern rwlock_t pbuf_global_rwlock;
-extern struct pbuf_t  *pbuf_global;
-extern struct pbuf_t **pbuf_global_prevp;
-extern struct pbuf_t  *pbuf_global_dupe;
-extern struct pbuf_t **pbuf_global_dupe_prevp;
+/*
+ *	The packets the workers are done with go back to the caches of the
+ *	worker which allocated them, through an inbox, instead of the
+ *	global cellmalloc arenas, see pbuf_return_many(). A home is indexed
+ *	by the worker id + 1, the http and udp workers have ids 80 and 81.
+ */
+#define PBUF_HOMES	128
+
+struct pbuf_home_t {
+	struct pbuf_inbox_t returned;
+	int live;		/* the worker is running and takes the packets back */
+} __attribute__((aligned(64)));
+
+extern struct pbuf_home_t pbuf_homes[PBUF_HOMES];
+
+/* global packet buffer, see pbufring.h */
+#define PBUF_GLOBAL_RING_SIZE		65536
+#define PBUF_GLOBAL_DUPE_RING_SIZE	16384
+extern struct pbuf_ring_t pbuf_global;
+extern struct pbuf_ring_t pbuf_global_dupe;
 
 /* a network client */
 typedef enum {
@@ -163,7 +226,11 @@ typedef enum {
 } CStateEnum;
 
 struct worker_t; /* used in client_t, but introduced later */
+struct geoindex_t; /* used in worker_t, see geoindex.h */
+struct callindex_t; /* used in worker_t, see callindex.h */
+struct callindex_entry_t;
 struct filter_t; /* used in client_t, but introduced later */
+struct filter_prog_t; /* compiled form of the filter chains, in filter.c */
 
 union sockaddr_u {
 	struct sockaddr     sa;
@@ -280,12 +347,45 @@ struct client_udp_t {			/* UDP services can be available at multiple
 #define IBUF_SIZE  8000
 #endif
 
+/*
+ *	The clients of a worker are classified for the outgoing packets
+ *	in arrays of hot records, which have the few fields looked at for
+ *	every client and packet, so that walking the clients which do not
+ *	want a packet does not touch the client_t at all. The records are
+ *	copies, made when the client is classified: a classified client
+ *	is reclassified whenever these fields change.
+ */
+struct client_hot_t {
+	struct client_t *c;
+	struct filter_shared_t *filter_shared;
+	uint32_t handle;
+	uint32_t filter_kinds;
+	int32_t  flags;
+	char     no_tx;
+};
+
+struct client_class_t {
+	struct client_hot_t *hot;	/* newest last */
+	int count;
+	int size;
+};
+
 struct client_t {
 	struct client_t *next;
 	struct client_t **prevp;
 	
-	struct client_t *class_next;
-	struct client_t **class_prevp;
+	uint32_t handle;	/* slot and generation in the client handle table */
+	
+	struct client_class_t *class_list; /* the class the client is in, if any */
+	int   class_pos;	/* ... and its hot record in it */
+	
+	/* registered in the worker's geoindex and callindex, instead of a class list */
+	char  geo_indexed;
+	int   geo_cell_count;
+	int  *geo_cells;
+	int   call_entry_count;
+	struct callindex_entry_t **call_entries;
+	uint32_t index_stamp; /* last packet the client was visited for from the indexes */
 	
 	union sockaddr_u addr;
 	struct portaccount_t *portaccount; /* port specific global account accumulator */
@@ -331,6 +431,8 @@ struct client_t {
 	int   obuf_flushsize; /* how much data in buf before forced write() at adding ? */
 	int   obuf_writes;    /* how many times (since last check) the socket has been written ? */
 	int   obuf_wtime;     /* when was last write? */
+	uint64_t obuf_sample_received; /* latency sample in obuf: when it was read, 0 for none */
+	uint64_t obuf_sample_taken;    /* ... and when this worker took it from pbuf_global */
 #if WBUF_ADJUSTER
 	int   wbuf_size;      /* socket wbuf size */
 #endif
@@ -374,6 +476,10 @@ struct client_t {
 	struct filter_t *negdefaultfilters;
 	struct filter_t *posuserfilters;
 	struct filter_t *neguserfilters;
+	/* the four chains above flattened into a single array, run by filter_process */
+	struct filter_prog_t *filter_prog;
+	uint32_t filter_kinds; /* packet kinds the filters may pass, see filter_packet_kinds() */
+	struct filter_shared_t *filter_shared; /* shared with clients having the same filters */
 	
 	/* List of station callsigns (not objects/items!) which have been
 	 * heard by this client. Only collected for filtered ports!
@@ -389,6 +495,7 @@ struct client_t {
 	
 	/* coordinates of client, if transmitted */
 	float lat, lng, cos_lat;
+	struct range_point_t loc_pt; /* for the m/ filter, see range.c */
 
 	// Maybe we use these four items, or maybe not.
 	// They are there for experimenting with outgoing queue processing algorithms.
@@ -423,7 +530,9 @@ extern struct client_t *client_alloc(void);
 extern void client_free(struct client_t *c);
 extern int set_client_sockopt(struct client_t *c);
 extern int pass_client_to_worker(struct worker_t *wc, struct client_t *c);
+extern void worker_wakeup(struct worker_t *w);
 extern void worker_mark_client_connected(struct worker_t *self, struct client_t *c);
+extern void worker_reclassify_client(struct worker_t *self, struct client_t *c);
 extern struct client_t *pseudoclient_setup(int portnum);
 
 
@@ -438,11 +547,17 @@ struct worker_t {
 	int shutting_down;			/* should I shut down? */
 	
 	struct client_t *clients;		/* all clients handled by this thread */
-	/* c->class_next lists, classified clients for optimized outbound */
-	struct client_t *clients_dupe;		/* dupeclient port clients */
-	struct client_t *clients_ro;		/* read-only clients */
-	struct client_t *clients_ups;		/* upstreams and peers */
-	struct client_t *clients_other;		/* other clients (unoptimized) */
+	/* classified clients for optimized outbound, see client_hot_t */
+	struct client_class_t clients_dupe;	/* dupeclient port clients */
+	struct client_class_t clients_ro;	/* read-only clients */
+	struct client_class_t clients_ups;	/* upstreams and peers */
+	struct client_class_t clients_other;	/* other clients (unoptimized) */
+	struct geoindex_t *geoindex;		/* clients having position and callsign set filters only */
+	struct callindex_t *callindex;		/* ... the callsign set filters of those */
+	uint32_t packet_stamp;			/* incremented for each outgoing packet */
+	time_t geo_refresh_tick;		/* last refresh of the geoindex f/ and m/ centres */
+	struct filter_intern_t *filter_intern;	/* filter sets shared by the clients */
+	struct filter_centres_t *filter_centres; /* subscribed f/ and m/ filter centres */
 	pthread_mutex_t clients_mutex;		/* mutex to protect access to the client list by the status dumps */
 	
 	struct client_t *new_clients;		/* new clients which passed in by accept */
@@ -452,45 +567,92 @@ struct worker_t {
 	
 	struct xpoll_t xp;			/* poll/epoll/select wrapper */
 	
-	/* thread-local packet buffer freelist */
-	struct pbuf_t *pbuf_free_small;  /* <= 130 bytes */
-	struct pbuf_t *pbuf_free_medium; /* 131 >= x <= 300 */
-	struct pbuf_t *pbuf_free_large;  /* 301 >= x <= 600 */
+	/* thread-local packet buffer caches, by size class */
+	struct cellcache_t pbuf_cache[PBUF_CLASSES];
+	uint32_t pbuf_class_set;		/* the slots of the classes of the caches */
 	
 	/* packets which have been parsed, waiting to be moved into
-	 * pbuf_incoming
+	 * pbuf_incoming - newest first, like in the inbox
 	 */
 	struct pbuf_t *pbuf_incoming_local;
-	struct pbuf_t **pbuf_incoming_local_last;
+	struct pbuf_t *pbuf_incoming_local_last;	/* the oldest one */
 	
 	/* packets which have been parsed, waiting for dupe check */
-	struct pbuf_t *pbuf_incoming;
-	struct pbuf_t **pbuf_incoming_last;
-	pthread_mutex_t pbuf_incoming_mutex;
+	struct pbuf_inbox_t pbuf_incoming;
 	
 	int pbuf_incoming_local_count; /* number of packets parsed, not yet in dupecheck's inbox */
-	int pbuf_incoming_count;       /* number of packets waiting for dupecheck thread to get */
+	int pbuf_incoming_local_sampled; /* ... of which are sampled for the latency histograms */
 	
-	/* Pointer to last pointer in pbuf_global(_dupe) */
-	struct pbuf_t **pbuf_global_prevp;
-	struct pbuf_t **pbuf_global_dupe_prevp;
-
-	uint32_t	last_pbuf_seqnum;
-	uint32_t	last_pbuf_dupe_seqnum;
+	/* position in pbuf_global(_dupe) */
+	struct pbuf_ring_cursor_t pbuf_cursor;
+	struct pbuf_ring_cursor_t pbuf_dupe_cursor;
+	
+	/* the dupecheck thread wakes the worker up from xpoll when it
+	 * publishes new packets, see worker_wakeup()
+	 */
+	int wakeup_fd;			/* eventfd, or the reading end of a pipe */
+	int wakeup_wfd;			/* the same eventfd, or the writing end of the pipe */
+	struct xpoll_fd_t *wakeup_xfd;
+	int wakeup_pending;		/* signalled, and not woken up yet */
+	long long wakeups;
+	
+	/* Latencies of the stages of the packets sampled, every
+	 * latency_sampling'th packet read by the worker. The packets
+	 * read by this worker are stamped at read(), see read_time.
+	 */
+	uint64_t read_time;			/* latency_now() of the last read(), if sampling */
+	int latency_countdown;			/* packets to the next sample */
+	uint64_t outgoing_sample_received;	/* the sampled packet being sent out now, or 0 */
+	uint64_t outgoing_sample_taken;
+	struct latency_hist_t parse_latency;	/* from read() to parsed, and queued for the dupecheck */
+	struct latency_hist_t flush_latency;	/* from queued to put in the dupecheck's inbox */
+	struct latency_hist_t outgoing_latency;	/* from published in pbuf_global to sent to the clients */
+	struct latency_hist_t write_latency;	/* from taken from pbuf_global to written to a socket */
+	struct latency_hist_t total_latency;	/* from read() to written to a socket */
 	
 	/* how many packets were dropped internally within this worker
 	 * (process hangs and time jumps)
 	 */
 	unsigned int internal_packet_drops;
+	
+	/* outgoing filtering: filter_process() calls, the calls
+	 * avoided by the c->filter_kinds check, and the shared verdicts
+	 */
+	long long filter_calls;
+	long long filter_prefiltered;
+	long long filter_shared_hits;	/* filter_process() verdicts reused from another client */
 };
 
+/*
+ *	The output buffer of a client has been written to the socket, with
+ *	the latency sample in it, if there was one
+ */
+
+static inline void client_obuf_written(struct worker_t *self, struct client_t *c)
+{
+	uint64_t now;
+	
+	if (!c->obuf_sample_received)
+		return;
+	
+	now = latency_now();
+	latency_add(&self->write_latency, now - c->obuf_sample_taken);
+	latency_add(&self->total_latency, now - c->obuf_sample_received);
+	c->obuf_sample_received = 0;
+}
+
 extern cJSON *worker_shutdown_clients;
 
 extern int workers_running;
 
 extern void pbuf_init(void);
+extern void pbuf_cache_init(struct worker_t *self);
+extern void pbuf_classes_adapt(int reconfiguring);
 extern void pbuf_free(struct worker_t *self, struct pbuf_t *p);
 extern void pbuf_free_many(struct pbuf_t **array, int numbufs);
+extern int  pbuf_return_many(struct pbuf_t **array, int numbufs);
+extern void pbuf_homes_free(void);
+extern void pbuf_home_close(struct worker_t *self);
 extern void pbuf_dump(FILE *fp);
 extern void pbuf_dupe_dump(FILE *fp);
 
@@ -502,6 +664,8 @@ extern int client_write(struct worker_t *self, struct client_t *c, char *p, int
 extern int client_bad_filter_notify(struct worker_t *self, struct client_t *c, const char *filt);
 extern void client_close(struct worker_t *self, struct client_t *c, int errnum);
 extern void client_init(void);
+extern void client_handle_own(struct worker_t *self, struct client_t *c);
+extern struct client_t *client_handle_get(struct worker_t *self, uint32_t handle);
 
 extern struct worker_t *worker_threads;
 extern struct worker_t *worker_alloc(void);
@@ -3,7 +3,7 @@
 #
 
 use Test;
-BEGIN { plan tests => 6 + 4 + 2 + 6 + 1 };
+BEGIN { plan tests => 6 + 4 + 2 + 3 + 6 + 1 };
 use runproduct;
 use istest;
 use Ham::APRS::IS;
@@ -75,6 +75,22 @@ $pass = "OH1UK>APRS,TCPIP*,qAC,T2FINLAND:;OH2TA    *101302z6014.89N/02447.00Ey";
 $drop = "OH2FOI>APRS,qAR,$login:!6013.90N/02500.05E-";
 istest::should_drop(\&ok, $i_tx, $i_rx, $drop, $pass);
 
+###############################################
+# a friend moves, and the range around it moves along
+# right away, starting with the packet which moved it
+$i_rx->sendline("#filter f/OH2MOV/10");
+sleep(0.5);
+
+$tx = "OH2MOV>APRS,qAR,$login:!6011.24N/02450.18E-";
+istest::txrx(\&ok, $i_tx, $i_rx, $tx, $tx);
+
+$tx = "OH2MOV>APRS,qAR,$login:!2334.10S/04719.70W-";
+istest::txrx(\&ok, $i_tx, $i_rx, $tx, $tx);
+
+$pass = "T3ST-2>APRS,qAR,$login:!2334.20S/04719.80W-";
+$drop = "DR0P-2>APRS,qAR,$login:!6011.30N/02450.18E-";
+istest::should_drop(\&ok, $i_tx, $i_rx, $drop, $pass);
+
 ###############################################
 # reconnect and see if the m/ filter still works based
 # on a cached position in historydb
@@ -3,11 +3,15 @@
 # TODO: run this threaded, with multiple copies, has a better chance of finding
 # a bug.
 #
+# Then test matching with large budlists, which are matched using a hash
+# instead of scanning through all of the callsigns.
+#
 
-my $buddyrounds = 300;
+my $buddyrounds = 400;
+my @budlist_sizes = (1, 15, 16, 17, 100, 500, 800);
 
 use Test;
-BEGIN { plan tests => 2 + 3*300 + 1 };
+BEGIN { plan tests => 2 + 3*400 + 3 + 6*7 + 1 };
 use runproduct;
 use istest;
 use Ham::APRS::IS;
@@ -35,5 +39,40 @@ for (my $i = 0; $i < $buddyrounds; $i++) {
 	ok($ret, 1, "Failed to disconnect from the server: " . $i_tx->{'error'});
 }
 
+$i_tx = new Ham::APRS::IS("localhost:55580", $login);
+ok(defined $i_tx, 1, "Failed to initialize Ham::APRS::IS");
+$ret = $i_tx->connect('retryuntil' => 8);
+ok($ret, 1, "Failed to connect to the server: " . $i_tx->{'error'});
+
+foreach my $n (@budlist_sizes) {
+	my @calls = map { 'BUD' . $_ } (0 .. $n-1);
+	my $i_rx = new Ham::APRS::IS("localhost:55581", "N5CAL-2", 'filter' => 'b/' . join('/', @calls) . ' b/WILD*');
+	$ret = $i_rx->connect('retryuntil' => 8);
+	ok($ret, 1, "Failed to connect to the server with a budlist of $n: " . $i_rx->{'error'});
+	
+	# the first and the last callsign of the list
+	my($tx, $helper);
+	$tx = "BUD0>APRS,OH2RDG*,WIDE,qAR,$login:!6028.51N/02505.68E# should pass budlist of $n";
+	istest::txrx(\&ok, $i_tx, $i_rx, $tx, $tx, 1);
+	
+	$tx = "BUD" . ($n-1) . ">APRS,OH2RDG*,WIDE,qAR,$login:!6028.51N/02505.68E# should pass budlist of $n";
+	istest::txrx(\&ok, $i_tx, $i_rx, $tx, $tx, 1);
+	
+	# wildcard after the list
+	$tx = "WILDCAT>APRS,OH2RDG*,WIDE,qAR,$login:!6028.51N/02505.68E# should pass wildcard after budlist of $n";
+	istest::txrx(\&ok, $i_tx, $i_rx, $tx, $tx, 1);
+	
+	# not in the list, but starting with a callsign which is (BUD1 -> BUD15)
+	$tx = "BUD${n}>APRS,OH2RDG*,WIDE,qAR,$login:!6028.51N/02505.68E# should drop budlist of $n";
+	$helper = "BUD0>APRS,OH2RDG*,WIDE,qAR,$login:!6028.51N/02505.68E# helper for budlist of $n";
+	istest::should_drop(\&ok, $i_tx, $i_rx, $tx, $helper);
+	
+	$ret = $i_rx->disconnect();
+	ok($ret, 1, "Failed to disconnect from the server: " . $i_rx->{'error'});
+}
+
+$ret = $i_tx->disconnect();
+ok($ret, 1, "Failed to disconnect from the server: " . $i_tx->{'error'});
+
 
 ok($p->stop(), 1, "Failed to stop product");
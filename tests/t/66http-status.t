@@ -6,7 +6,7 @@
 use Test;
 
 BEGIN {
-	plan tests => (!defined $ENV{'TEST_PRODUCT'} || $ENV{'TEST_PRODUCT'} =~ /aprsc/) ? 2 + 16 + 1 : 0;
+	plan tests => (!defined $ENV{'TEST_PRODUCT'} || $ENV{'TEST_PRODUCT'} =~ /aprsc/) ? 2 + 18 + 1 : 0;
 };
 
 if (defined $ENV{'TEST_PRODUCT'} && $ENV{'TEST_PRODUCT'} !~ /aprsc/) {
@@ -67,6 +67,8 @@ ok($res->code, 200, "HTTP GET of status server status.json returned wrong respon
 $j = $json->decode($res->decoded_content(charset => 'none'));
 ok(defined $j, 1, "JSON decoding of status.json failed");
 ok(defined $j->{'server'}, 1, "status.json does not define 'server'");
+ok(defined $j->{'totals'}->{'outgoing_latency'}->{'p99_us'}, 1, "status.json does not define outgoing latency percentiles");
+ok(defined $j->{'workers'}->[0]->{'wakeups'}, 1, "status.json does not define worker wakeups");
 
 $req->header('Accept-Encoding', $can_accept);
 $res = $ua->simple_request($req);